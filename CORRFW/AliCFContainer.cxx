@@ -175,7 +175,7 @@ AliCFContainer* AliCFContainer::MakeSlice(Int_t nSteps, const Int_t* steps,
   for (Int_t iStep=0; iStep<nSteps; iStep++) grids[iStep] = fGrid[steps[iStep]]->MakeSlice(nVars,vars,varMin,varMax,useBins);
 
   TAxis ** axis = new TAxis*[nVars];
-  for (Int_t iVar=0; iVar<nVars; iVar++) axis[iVar] = ((AliCFGridSparse*)grids[0])->GetGrid()->GetAxis(iVar); //same axis for every grid
+  for (Int_t iVar=0; iVar<nVars; iVar++) axis[iVar] = grids[0]->GetAxis(iVar); //same axis for every grid
 
   //define new binning for new container
   Int_t* bins=new Int_t[nVars];
@@ -45,8 +45,8 @@ class AliCFContainer : public AliCFFrame
   virtual Int_t    * GetNBins()                                      const {return fGrid[0]->GetNBins();}
   virtual Float_t    GetBinCenter(Int_t ivar,Int_t ibin)             const {return fGrid[0]->GetBinCenter(ivar,ibin);}
   virtual Float_t    GetBinSize  (Int_t ivar,Int_t ibin)             const {return fGrid[0]->GetBinSize  (ivar,ibin);}
-  virtual Float_t    GetBinContent(const Int_t* coordinates, Int_t step) const {return fGrid[step]->GetGrid()->GetBinContent(coordinates);}
-  virtual Float_t    GetBinError  (const Int_t* coordinates, Int_t step) const {return fGrid[step]->GetGrid()->GetBinError  (coordinates);}
+  virtual Float_t    GetBinContent(const Int_t* coordinates, Int_t step) const {return fGrid[step]->GetElement     (coordinates);}
+  virtual Float_t    GetBinError  (const Int_t* coordinates, Int_t step) const {return fGrid[step]->GetElementError(coordinates);}
   virtual const Char_t* GetBinLabel (Int_t ivar,Int_t ibin)          const {return GetAxis(ivar,0)->GetBinLabel(ibin);}
 
   virtual void       Print(const Option_t*) const ;
@@ -86,6 +86,11 @@ class AliCFContainer : public AliCFFrame
   virtual void  SetGrid(Int_t step, AliCFGridSparse* grid) {if (fGrid[step]) delete fGrid[step]; fGrid[step]=grid;}
   virtual AliCFGridSparse * GetGrid(Int_t istep) const {return fGrid[istep];};
 
+  // storage layout of the step grids (see AliCFGridSparse::SetStorage)
+  virtual void  SetExpectedOccupancy(Double_t occupancy) ;
+  virtual void  SetExpectedOccupancy(Int_t istep, Double_t occupancy) {fGrid[istep]->SetExpectedOccupancy(occupancy);}
+  virtual void  OptimizeStorage() ;
+
   virtual void  Scale(Double_t factor) const;
 
   /****   TO BE REMOVED SOON ******/
@@ -139,6 +144,16 @@ inline void AliCFContainer::SetBinLabel(Int_t iVar, Int_t iBin, const Char_t* la
   for (Int_t iStep=0; iStep<GetNStep(); iStep++) GetAxis(iVar,iStep)->SetBinLabel(iBin,label);
 }
 
+inline void AliCFContainer::SetExpectedOccupancy(Double_t occupancy) {
+  // each step picks the layout needing the least memory
+  for (Int_t iStep=0; iStep<fNStep; iStep++) fGrid[iStep]->SetExpectedOccupancy(occupancy);
+}
+
+inline void AliCFContainer::OptimizeStorage() {
+  // each step picks its layout from the fraction of bins it has filled
+  for (Int_t iStep=0; iStep<fNStep; iStep++) fGrid[iStep]->OptimizeStorage();
+}
+
 inline void  AliCFContainer::Scale(Double_t factor) const {
   Double_t fact[2] = {factor,0} ;
   for (Int_t iStep=0; iStep<fNStep; iStep++) fGrid[iStep]->Scale(fact);
@@ -147,13 +162,13 @@ inline void  AliCFContainer::Scale(Double_t factor) const {
 inline void AliCFContainer::SetBinContent(Int_t* bin, Int_t step, Double_t value) {
   // sets the content 'value' to the current container, at step 'step'
   // 'bin' is the array of the bin coordinates
-  GetGrid(step)->GetGrid()->SetBinContent(bin,value);
+  GetGrid(step)->SetElement(bin,value);
 }
 
 inline void AliCFContainer::SetBinError(Int_t* bin, Int_t step, Double_t value) {
   // sets the error 'value' to the current container, at step 'step'
   // 'bin' is the array of the bin coordinates
-  GetGrid(step)->GetGrid()->SetBinError(bin,value);
+  GetGrid(step)->SetElementError(bin,value);
 }
 
 #endif
@@ -0,0 +1,253 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+///////////////////////////////////////////////////////////////////////////
+// The class AliCFCutChain holds the cuts of one selection step, as
+// resolved by AliCFManager::CompileParticleCuts, so that no cut name
+// has to be compared when checking a particle.
+// The cuts are checked in order and the first rejection stops the
+// chain, as in AliCFManager::CheckParticleCuts. Select() checks a whole
+// array of particles, one cut after the other, on the particles still
+// selected.
+// For each cut the number of checked and rejected particles, and if
+// profiling is on (SetProfiling, off by default since it costs two clock
+// calls per cut and particle) the time spent, are recorded; Print() dumps them as a
+// cut-flow table. If a reorder interval is set (SetReorderInterval), the
+// chain is periodically sorted by increasing time per rejected particle,
+// which changes the particles seen by the QA histograms of the later cuts.
+// By default the order of the cut list is kept.
+///////////////////////////////////////////////////////////////////////////
+#include "AliCFCutChain.h"
+#include "AliCFCutBase.h"
+#include "AliLog.h"
+#include "TObjArray.h"
+#include <chrono>
+
+ClassImp(AliCFCutChain)
+
+namespace {
+  inline Double_t GetTime() {
+    return std::chrono::duration<Double_t>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+//_____________________________________________________________________________
+AliCFCutChain::AliCFCutChain() :
+  TNamed(),
+  fNCuts(0),
+  fCuts(0x0),
+  fNChecked(),
+  fNRejected(),
+  fTime(),
+  fNCandidates(0),
+  fNSelected(0),
+  fProfiling(kFALSE),
+  fReorderInterval(0),
+  fAliveSize(0),
+  fAlive(0x0)
+{
+  //
+  // ctor
+  //
+}
+
+//_____________________________________________________________________________
+AliCFCutChain::AliCFCutChain(const Char_t* name, const Char_t* title) :
+  TNamed(name,title),
+  fNCuts(0),
+  fCuts(0x0),
+  fNChecked(),
+  fNRejected(),
+  fTime(),
+  fNCandidates(0),
+  fNSelected(0),
+  fProfiling(kFALSE),
+  fReorderInterval(0),
+  fAliveSize(0),
+  fAlive(0x0)
+{
+  //
+  // ctor
+  //
+}
+
+//_____________________________________________________________________________
+AliCFCutChain::~AliCFCutChain() {
+  //
+  // dtor (the cuts are not owned)
+  //
+  delete [] fCuts;
+  delete [] fAlive;
+}
+
+//_____________________________________________________________________________
+void AliCFCutChain::Add(AliCFCutBase* cut) {
+  //
+  // appends a cut at the end of the chain
+  //
+  AliCFCutBase **cuts = new AliCFCutBase*[fNCuts+1];
+  for (Int_t icut=0; icut<fNCuts; icut++) cuts[icut] = fCuts[icut];
+  cuts[fNCuts] = cut;
+  delete [] fCuts;
+  fCuts = cuts;
+  fNCuts++;
+  fNChecked .Set(fNCuts);
+  fNRejected.Set(fNCuts);
+  fTime     .Set(fNCuts);
+}
+
+//_____________________________________________________________________________
+Bool_t AliCFCutChain::IsSelected(TObject *obj) {
+  //
+  // checks obj against the cuts, in order, until one rejects it
+  //
+  Bool_t isSelected = kTRUE;
+  for (Int_t icut=0; icut<fNCuts; icut++) {
+    Double_t start = fProfiling ? GetTime() : 0.;
+    Bool_t pass = fCuts[icut]->IsSelected(obj);
+    if (fProfiling) fTime.fArray[icut] += GetTime()-start;
+    fNChecked.fArray[icut]++;
+    if (!pass) {
+      fNRejected.fArray[icut]++;
+      isSelected = kFALSE;
+      break;
+    }
+  }
+  if (isSelected) fNSelected++;
+  CheckReorder(1);
+  return isSelected;
+}
+
+//_____________________________________________________________________________
+Int_t AliCFCutChain::Select(const TObjArray *objects, Bool_t *selected) {
+  //
+  // checks every object of the array, cut by cut, each cut seeing only the
+  // objects accepted by the previous ones: the decisions are the same as
+  // calling IsSelected() on each object, with a single timer call per cut.
+  //
+  Int_t nObjects = objects->GetEntriesFast();
+  if (fAliveSize < nObjects) {
+    delete [] fAlive;
+    fAliveSize = nObjects;
+    fAlive = new Int_t[fAliveSize];
+  }
+
+  Int_t nAlive = 0;
+  for (Int_t iobj=0; iobj<nObjects; iobj++) {
+    selected[iobj] = kFALSE;
+    if (objects->UncheckedAt(iobj)) fAlive[nAlive++] = iobj;
+  }
+  Long64_t nCandidates = nAlive;
+
+  for (Int_t icut=0; icut<fNCuts && nAlive>0; icut++) {
+    AliCFCutBase *cut = fCuts[icut];
+    Double_t start = fProfiling ? GetTime() : 0.;
+    Int_t nPass = 0;
+    for (Int_t ialive=0; ialive<nAlive; ialive++) {
+      Int_t iobj = fAlive[ialive];
+      if (cut->IsSelected(objects->UncheckedAt(iobj))) fAlive[nPass++] = iobj;
+    }
+    if (fProfiling) fTime.fArray[icut] += GetTime()-start;
+    fNChecked .fArray[icut] += nAlive;
+    fNRejected.fArray[icut] += nAlive-nPass;
+    nAlive = nPass;
+  }
+
+  for (Int_t ialive=0; ialive<nAlive; ialive++) selected[fAlive[ialive]] = kTRUE;
+  fNSelected += nAlive;
+  CheckReorder(nCandidates);
+  return nAlive;
+}
+
+//_____________________________________________________________________________
+void AliCFCutChain::CheckReorder(Long64_t nCandidates) {
+  //
+  // counts the candidates and reorders the chain when an interval is completed
+  //
+  Long64_t before = fNCandidates;
+  fNCandidates += nCandidates;
+  if (fReorderInterval>0 && fNCandidates/fReorderInterval != before/fReorderInterval) Reorder();
+}
+
+//_____________________________________________________________________________
+void AliCFCutChain::Reorder() {
+  //
+  // sorts the cuts by increasing time per rejected object (or by decreasing
+  // rejected fraction when the time is not measured); cuts which never
+  // rejected anything go last. The sort is stable, so the original
+  // order is kept among equivalent cuts.
+  //
+  Double_t *cost = new Double_t[fNCuts];
+  for (Int_t icut=0; icut<fNCuts; icut++) {
+    Long64_t nChecked  = fNChecked .fArray[icut];
+    Long64_t nRejected = fNRejected.fArray[icut];
+    if (nRejected==0) cost[icut] = 1.e30;
+    else if (fProfiling) cost[icut] = fTime.fArray[icut]/nRejected;
+    else cost[icut] = (Double_t)nChecked/nRejected;
+  }
+
+  // insertion sort, the chains are short
+  for (Int_t icut=1; icut<fNCuts; icut++) {
+    Double_t      c  = cost[icut];
+    AliCFCutBase *cut = fCuts[icut];
+    Long64_t      nChecked  = fNChecked .fArray[icut];
+    Long64_t      nRejected = fNRejected.fArray[icut];
+    Double_t      time      = fTime     .fArray[icut];
+    Int_t jcut = icut-1;
+    for (; jcut>=0 && cost[jcut]>c; jcut--) {
+      cost[jcut+1]             = cost[jcut];
+      fCuts[jcut+1]            = fCuts[jcut];
+      fNChecked .fArray[jcut+1] = fNChecked .fArray[jcut];
+      fNRejected.fArray[jcut+1] = fNRejected.fArray[jcut];
+      fTime     .fArray[jcut+1] = fTime     .fArray[jcut];
+    }
+    cost[jcut+1]             = c;
+    fCuts[jcut+1]            = cut;
+    fNChecked .fArray[jcut+1] = nChecked;
+    fNRejected.fArray[jcut+1] = nRejected;
+    fTime     .fArray[jcut+1] = time;
+  }
+  delete [] cost;
+}
+
+//_____________________________________________________________________________
+void AliCFCutChain::ResetStatistics() {
+  //
+  // clears the counters and timers, the order of the cuts is kept
+  //
+  fNChecked .Reset();
+  fNRejected.Reset();
+  fTime     .Reset();
+  fNCandidates = 0;
+  fNSelected   = 0;
+}
+
+//_____________________________________________________________________________
+void AliCFCutChain::Print(Option_t *) const {
+  //
+  // cut-flow table, cuts in evaluation order
+  //
+  AliInfo("====================================================================================");
+  AliInfo(Form("AliCFCutChain : name = %s   title = %s",GetName(),GetTitle()));
+  AliInfo(Form("candidates %lld \t selected %lld",fNCandidates,fNSelected));
+  AliInfo(Form("%3s %-30s %12s %12s %10s %14s %12s","#","cut","checked","rejected","rej. frac","time/check(ns)","time (s)"));
+  for (Int_t icut=0; icut<fNCuts; icut++) {
+    Long64_t nChecked  = fNChecked .fArray[icut];
+    Long64_t nRejected = fNRejected.fArray[icut];
+    Double_t time      = fTime     .fArray[icut];
+    AliInfo(Form("%3d %-30s %12lld %12lld %10.4f %14.1f %12.4f",icut,fCuts ? fCuts[icut]->GetName() : "",nChecked,nRejected,
+		 nChecked ? (Double_t)nRejected/nChecked : 0.,nChecked ? 1.e9*time/nChecked : 0.,time));
+  }
+  AliInfo("====================================================================================");
+}
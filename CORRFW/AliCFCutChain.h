@@ -0,0 +1,74 @@
+#ifndef ALICFCUTCHAIN_H
+#define ALICFCUTCHAIN_H
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+// Ordered list of AliCFCutBase selections, resolved once from a cut list
+// by AliCFManager. Keeps per-cut statistics (checks, rejections, time)
+// which can be printed as a cut-flow table, and can move the cuts with
+// the best rejection per unit of time to the front of the chain.
+
+#include "TNamed.h"
+#include "TArrayD.h"
+#include "TArrayL64.h"
+
+class AliCFCutBase;
+class TObjArray;
+
+//____________________________________________________________________________
+class AliCFCutChain : public TNamed
+{
+ public :
+  AliCFCutChain() ;
+  AliCFCutChain(const Char_t* name, const Char_t* title) ;
+  virtual ~AliCFCutChain();
+
+  virtual void   Add(AliCFCutBase* cut) ;
+  Int_t          GetNCuts() const {return fNCuts;}
+  AliCFCutBase * GetCut(Int_t icut) const {return fCuts[icut];} // in evaluation order
+
+  // and. of all the cuts, stopping at the first rejection
+  virtual Bool_t IsSelected(TObject *obj) ;
+  // same for every (non-null) object of the array, cut by cut: selected[i] holds the
+  // decision for objects->At(i). Returns the number of selected objects.
+  virtual Int_t  Select(const TObjArray *objects, Bool_t *selected) ;
+
+  void           SetProfiling(Bool_t b=kTRUE) {fProfiling=b;}           // measure the time spent in each cut
+  void           SetReorderInterval(Long64_t n) {fReorderInterval=n;}  // reorder every n candidates, 0 = never
+  virtual void   Reorder() ;
+  virtual void   ResetStatistics() ;
+  virtual void   Print(Option_t *opt="") const ; // cut-flow table
+
+ private :
+  AliCFCutChain(const AliCFCutChain& c) ;
+  AliCFCutChain& operator=(const AliCFCutChain& c) ;
+
+  void           CheckReorder(Long64_t nCandidates) ;
+
+  Int_t          fNCuts;            //! number of cuts in the chain (rebuilt by AliCFManager::CompileParticleCuts)
+  AliCFCutBase **fCuts;             //! cuts, in evaluation order (not owned)
+  TArrayL64      fNChecked;         // number of objects checked by each cut
+  TArrayL64      fNRejected;        // number of objects rejected by each cut
+  TArrayD        fTime;             // time spent in each cut (s)
+  Long64_t       fNCandidates;      // number of objects given to the chain
+  Long64_t       fNSelected;        // number of objects passing all the cuts
+  Bool_t         fProfiling;        // flag to measure the time spent in the cuts
+  Long64_t       fReorderInterval;  // number of candidates between two reorderings (0 = never)
+  Int_t          fAliveSize;        //! size of fAlive
+  Int_t         *fAlive;            //! indexes of the objects still selected in Select()
+
+  ClassDef(AliCFCutChain,1);
+};
+
+#endif
@@ -66,8 +66,8 @@ AliCFDataGrid::AliCFDataGrid(const Char_t* name, const Char_t* title, const AliC
   // assign directly the selection step
   //
 
-  //simply clones the container's data at specified step
-  fData = (THnSparse*) fContainer->GetGrid(fSelData)->GetGrid()->Clone();
+  //simply clones the container's data at specified step (whatever its storage)
+  fData = fContainer->GetGrid(fSelData)->CreateSparseGrid();
   SumW2();
   AliInfo(Form("retrieving measured data from Container %s at selection step %i.",fContainer->GetName(),fSelData));
 }
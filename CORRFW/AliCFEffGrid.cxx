@@ -146,11 +146,15 @@ Double_t AliCFEffGrid::GetAverage() const
   Double_t valnum=0;
   Double_t valden=0;
 
-  THnSparse* num = ((AliCFGridSparse*)GetNum())->GetGrid() ;
-  THnSparse* den = ((AliCFGridSparse*)GetDen())->GetGrid() ;
+  const AliCFGridSparse* gridNum = GetNum();
+  const AliCFGridSparse* gridDen = GetDen();
+  THnSparse* num = gridNum->IsDense() ? gridNum->CreateSparseGrid() : gridNum->GetGrid() ;
+  THnSparse* den = gridDen->IsDense() ? gridDen->CreateSparseGrid() : gridDen->GetGrid() ;
 
   for (Long_t iBin=0; iBin<num->GetNbins(); iBin++) valnum+=num->GetBinContent(iBin);
   for (Long_t iBin=0; iBin<den->GetNbins(); iBin++) valden+=den->GetBinContent(iBin);
+  if (gridNum->IsDense()) delete num;
+  if (gridDen->IsDense()) delete den;
   if (valden>0) val=valnum/valden;
   AliInfo(Form(" The Average Efficiency = %f ",val)); 
   return val;
@@ -169,34 +173,41 @@ TH1* AliCFEffGrid::Project(Int_t ivar1, Int_t ivar2, Int_t ivar3) const
   const Int_t nDim = 3 ;
   Int_t dim[nDim] = {ivar1,ivar2,ivar3} ;
   
+  const AliCFGridSparse* gridNum = GetNum();
+  const AliCFGridSparse* gridDen = GetDen();
+  THnSparse* num = gridNum->IsDense() ? gridNum->CreateSparseGrid() : gridNum->GetGrid() ;
+  THnSparse* den = gridDen->IsDense() ? gridDen->CreateSparseGrid() : gridDen->GetGrid() ;
+
   THnSparse *hNum, *hDen, *ratio;
   TH1* h ;
 
   if (ivar3<0) {
     if (ivar2<0) {
-      hNum = ((AliCFGridSparse*)GetNum())->GetGrid()->Projection(nDim-2,dim);
-      hDen = ((AliCFGridSparse*)GetDen())->GetGrid()->Projection(nDim-2,dim);
+      hNum = num->Projection(nDim-2,dim);
+      hDen = den->Projection(nDim-2,dim);
       ratio = (THnSparse*)hNum->Clone();
       ratio->Divide(hNum,hDen,1.,1.,"B");
       h = ratio->Projection(0);
     }
     else{
-      hNum = ((AliCFGridSparse*)GetNum())->GetGrid()->Projection(nDim-1,dim);
-      hDen = ((AliCFGridSparse*)GetDen())->GetGrid()->Projection(nDim-1,dim);
+      hNum = num->Projection(nDim-1,dim);
+      hDen = den->Projection(nDim-1,dim);
       ratio = (THnSparse*)hNum->Clone();
       ratio->Divide(hNum,hDen,1.,1.,"B");
       h = ratio->Projection(1,0);
     }
   }
   else {
-    hNum = ((AliCFGridSparse*)GetNum())->GetGrid()->Projection(nDim,dim);
-    hDen = ((AliCFGridSparse*)GetDen())->GetGrid()->Projection(nDim,dim);
+    hNum = num->Projection(nDim,dim);
+    hDen = den->Projection(nDim,dim);
     ratio = (THnSparse*)hNum->Clone();
     ratio->Divide(hNum,hDen,1.,1.,"B");
     h = ratio->Projection(0,1,2);
   }
 
   delete hNum; delete hDen; delete ratio;
+  if (gridNum->IsDense()) delete num;
+  if (gridDen->IsDense()) delete den;
   return h ;
 } 
 //___________________________________________________________________
@@ -18,6 +18,8 @@
 // Class to accumulate data on an N-dimensional grid, to be used      //
 // as input to get corrections for Reconstruction & Trigger efficiency// 
 // Based on root THnSparse                                            //
+// Grids whose bins are mostly filled can keep their contents in a    //
+// dense array of cells instead (see SetStorage)                      //
 // -- Author : S.Arcelli                                              //
 // Still to be done:                                                  //
 // --Interpolate among bins in a range                                // 
@@ -35,14 +37,37 @@
 #include "TAxis.h"
 #include "AliCFUnfolding.h"
 
+namespace {
+  //
+  // Access to the sums of weights of THnBase: in dense mode the bins are
+  // not filled in the THnSparse, so the grid updates them itself
+  //
+  class AliCFTHnStatistics : public THnBase {
+  public:
+    static Double_t THnBase::* Sumw()   {return &AliCFTHnStatistics::fTsumw;}
+    static Double_t THnBase::* Sumw2()  {return &AliCFTHnStatistics::fTsumw2;}
+    static TArrayD  THnBase::* Sumwx()  {return &AliCFTHnStatistics::fTsumwx;}
+    static TArrayD  THnBase::* Sumwx2() {return &AliCFTHnStatistics::fTsumwx2;}
+  };
+}
+
 //____________________________________________________________________
 ClassImp(AliCFGridSparse)
 
+Long64_t AliCFGridSparse::fgMaxDenseBins = 1<<24 ;
+
 //____________________________________________________________________
 AliCFGridSparse::AliCFGridSparse() : 
   AliCFFrame(),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseContent(),
+  fDenseSumw2(),
+  fDenseStrides(),
+  fDenseNBins(),
+  fDenseFilled(),
+  fDenseFilledValid(kFALSE)
 {
   // default constructor
 }
@@ -50,7 +75,14 @@ AliCFGridSparse::AliCFGridSparse() :
 AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title) : 
   AliCFFrame(name,title),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseContent(),
+  fDenseSumw2(),
+  fDenseStrides(),
+  fDenseNBins(),
+  fDenseFilled(),
+  fDenseFilledValid(kFALSE)
 {
   // default constructor
 }
@@ -58,7 +90,14 @@ AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title) :
 AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title, Int_t nVarIn, const Int_t * nBinIn) :  
   AliCFFrame(name,title),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseContent(),
+  fDenseSumw2(),
+  fDenseStrides(),
+  fDenseNBins(),
+  fDenseFilled(),
+  fDenseFilledValid(kFALSE)
 {
   //
   // main constructor
@@ -80,7 +119,14 @@ AliCFGridSparse::~AliCFGridSparse()
 AliCFGridSparse::AliCFGridSparse(const AliCFGridSparse& c) :
   AliCFFrame(c),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fStorage(kSparse),
+  fDenseContent(),
+  fDenseSumw2(),
+  fDenseStrides(),
+  fDenseNBins(),
+  fDenseFilled(),
+  fDenseFilledValid(kFALSE)
 {
   //
   // copy constructor
@@ -128,6 +174,14 @@ void AliCFGridSparse::Fill(const Double_t *var, Double_t weight)
   // given a set of values of the input variable, 
   // with weight (by default w=1)
   //
+  if (fStorage==kDense) {
+    Long64_t index = GetDenseIndex(var);
+    fDenseContent.fArray[index] += weight;
+    if (fDenseSumw2.GetSize()) fDenseSumw2.fArray[index] += weight*weight;
+    FillDenseStatistics(var,weight);
+    fDenseFilledValid=kFALSE;
+    return;
+  }
   fData->Fill(var,weight);
 }
 
@@ -150,7 +204,7 @@ AliCFGridSparse* AliCFGridSparse::MakeSlice(Int_t nVars, const Int_t* vars, cons
   AliCFGridSparse* out = new AliCFGridSparse(fName,fTitle,nVars,bins);
 
   //set the range in the THnSparse to project
-  THnSparse* clone = ((THnSparse*)fData->Clone());
+  THnSparse* clone = CreateSparseGrid();
   if (varMin && varMax) {
     for (Int_t iAxis=0; iAxis<GetNVar(); iAxis++) {
       SetAxisRange(clone->GetAxis(iAxis),varMin[iAxis],varMax[iAxis],useBins);
@@ -159,6 +213,7 @@ AliCFGridSparse* AliCFGridSparse::MakeSlice(Int_t nVars, const Int_t* vars, cons
   else AliInfo("Keeping same axis ranges");
 
   out->SetGrid(clone->Projection(nVars,vars));
+  if (IsDense()) out->SetStorage(kDense); // a slice is at least as densely filled
   delete [] bins;
   delete clone;
   return out;
@@ -200,8 +255,13 @@ Float_t AliCFGridSparse::GetElement(Long_t index) const
 {
   //
   // Returns content of grid element index 
+  // (0 <= index < GetNFilledBins() whatever the storage)
   //
   
+  if (fStorage==kDense) {
+    Long64_t cell = GetDenseCell(index);
+    return (cell<0) ? 0. : fDenseContent.fArray[cell];
+  }
   return fData->GetBinContent(index);
 }
 //____________________________________________________________________
@@ -210,6 +270,7 @@ Float_t AliCFGridSparse::GetElement(const Int_t *bin) const
   //
   // Get the content in a bin corresponding to a set of bin indexes
   //
+  if (fStorage==kDense) return fDenseContent.fArray[GetDenseIndex(bin)];
   return fData->GetBinContent(bin);
 
 }  
@@ -220,6 +281,7 @@ Float_t AliCFGridSparse::GetElement(const Double_t *var) const
   // Get the content in a bin corresponding to a set of input variables
   //
 
+  if (fStorage==kDense) return fDenseContent.fArray[GetDenseIndex(var)];
   Long_t index = fData->GetBin(var,kFALSE);
   if (index<0) return 0.;
   return fData->GetBinContent(index);
@@ -232,6 +294,10 @@ Float_t AliCFGridSparse::GetElementError(Long_t index) const
   // Returns the error on the content 
   //
 
+  if (fStorage==kDense) {
+    Long64_t cell = GetDenseCell(index);
+    return (cell<0) ? 0. : TMath::Sqrt(GetDenseError2(cell));
+  }
   return fData->GetBinError(index);
 }
 //____________________________________________________________________
@@ -240,6 +306,7 @@ Float_t AliCFGridSparse::GetElementError(const Int_t *bin) const
  //
   // Get the error in a bin corresponding to a set of bin indexes
   //
+  if (fStorage==kDense) return TMath::Sqrt(GetDenseError2(GetDenseIndex(bin)));
   return fData->GetBinError(bin);
 
 }  
@@ -250,6 +317,7 @@ Float_t AliCFGridSparse::GetElementError(const Double_t *var) const
   // Get the error in a bin corresponding to a set of input variables
   //
 
+  if (fStorage==kDense) return TMath::Sqrt(GetDenseError2(GetDenseIndex(var)));
   Long_t index=fData->GetBin(var,kFALSE); //this is the THnSparse index (do not allocate new cells if content is empy)
   if (index<0) return 0.;
   return fData->GetBinError(index);
@@ -261,6 +329,12 @@ void AliCFGridSparse::SetElement(Long_t index, Float_t val)
   //
   // Sets grid element value
   //
+  if (fStorage==kDense) {
+    // the cell stays a filled bin, even if set to 0, as in THnSparse
+    Long64_t cell = GetDenseCell(index);
+    if (cell>=0) fDenseContent.fArray[cell] = val;
+    return;
+  }
   Int_t* bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //affects the bin coordinates
   SetElement(bin,val);
@@ -273,6 +347,11 @@ void AliCFGridSparse::SetElement(const Int_t *bin, Float_t val)
   //
   // Sets grid element of bin indeces bin to val
   //
+  if (fStorage==kDense) {
+    fDenseContent.fArray[GetDenseIndex(bin)] = val;
+    fDenseFilledValid=kFALSE;
+    return;
+  }
   fData->SetBinContent(bin,val);
 }
 //____________________________________________________________________
@@ -281,6 +360,11 @@ void AliCFGridSparse::SetElement(const Double_t *var, Float_t val)
   //
   // Set the content in a bin to value val corresponding to a set of input variables
   //
+  if (fStorage==kDense) {
+    fDenseContent.fArray[GetDenseIndex(var)] = val;
+    fDenseFilledValid=kFALSE;
+    return;
+  }
   Long_t index=fData->GetBin(var,kTRUE); //THnSparse index: allocate the cell
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //trick to access the array of bins
@@ -294,6 +378,11 @@ void AliCFGridSparse::SetElementError(Long_t index, Float_t val)
   //
   // Sets grid element iel error to val (linear indexing) in AliCFFrame
   //
+  if (fStorage==kDense) {
+    Long64_t cell = GetDenseCell(index);
+    if (cell>=0) SetDenseError(cell,val);
+    return;
+  }
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin);
   SetElementError(bin,val);
@@ -306,6 +395,11 @@ void AliCFGridSparse::SetElementError(const Int_t *bin, Float_t val)
   //
   // Sets grid element error of bin indeces bin to val
   //
+  if (fStorage==kDense) {
+    SetDenseError(GetDenseIndex(bin),val);
+    fDenseFilledValid=kFALSE;
+    return;
+  }
   fData->SetBinError(bin,val);
 }
 //____________________________________________________________________
@@ -314,6 +408,11 @@ void AliCFGridSparse::SetElementError(const Double_t *var, Float_t val)
   //
   // Set the error in a bin to value val corresponding to a set of input variables
   //
+  if (fStorage==kDense) {
+    SetDenseError(GetDenseIndex(var),val);
+    fDenseFilledValid=kFALSE;
+    return;
+  }
   Long_t index=fData->GetBin(var); //THnSparse index
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //trick to access the array of bins
@@ -329,6 +428,7 @@ void AliCFGridSparse::SumW2()
   //
   if(!fSumW2){
     fData->CalculateErrors(kTRUE); 
+    if (fStorage==kDense && !fDenseSumw2.GetSize()) InitDenseSumw2();
   }
   fSumW2=kTRUE;
 }
@@ -346,7 +446,42 @@ void AliCFGridSparse::Add(const AliCFGridSparse* aGrid, Double_t c)
   } 
   
   if (!fSumW2  && aGrid->GetSumW2()) SumW2();
-  fData->Add(aGrid->GetGrid(),c);
+
+  if (fStorage==kDense) {
+    fDenseFilledValid=kFALSE;
+    if (IsDenseCompatible(aGrid)) {
+      Bool_t errors = fDenseSumw2.GetSize()>0;
+      for (Long64_t i=0; i<fDenseContent.GetSize(); i++) {
+        fDenseContent.fArray[i] += c*aGrid->fDenseContent.fArray[i];
+        if (errors) fDenseSumw2.fArray[i] += c*c*aGrid->GetDenseError2(i);
+      }
+      fData->SetEntries(fData->GetEntries()+aGrid->GetEntries());
+      return;
+    }
+    if (!aGrid->IsDense()) {
+      // only the filled bins of the sparse grid are visited
+      THnSparse* h = aGrid->fData;
+      Bool_t errors = fDenseSumw2.GetSize()>0;
+      Int_t* bin = new Int_t[GetNVar()];
+      for (Long64_t i=0; i<h->GetNbins(); i++) {
+        Double_t v = h->GetBinContent(i,bin);
+        Long64_t index = GetDenseIndex(bin);
+        fDenseContent.fArray[index] += c*v;
+        if (errors) fDenseSumw2.fArray[index] += c*c*h->GetBinError2(i);
+      }
+      delete [] bin;
+      fData->SetEntries(fData->GetEntries()+h->GetEntries());
+      return;
+    }
+    SetStorage(kSparse); // different binning: let THnSparse check it
+  }
+
+  if (aGrid->IsDense()) {
+    THnSparse* h = aGrid->CreateSparseGrid();
+    fData->Add(h,c);
+    delete h;
+  }
+  else fData->Add(aGrid->fData,c);
 }
 
 //____________________________________________________________________
@@ -363,9 +498,18 @@ void AliCFGridSparse::Add(const AliCFGridSparse* aGrid1, const AliCFGridSparse*
   
   if (!fSumW2  && (aGrid1->GetSumW2() || aGrid2->GetSumW2())) SumW2();
 
+  if (fStorage==kDense) {
+    fDenseContent.Reset();
+    if (fDenseSumw2.GetSize()) fDenseSumw2.Reset();
+    fData->SetEntries(0);
+    Add(aGrid1,c1);
+    Add(aGrid2,c2);
+    return;
+  }
+
   fData->Reset();
-  fData->Add(aGrid1->GetGrid(),c1);
-  fData->Add(aGrid2->GetGrid(),c2);
+  Add(aGrid1,c1);
+  Add(aGrid2,c2);
 }
 
 //____________________________________________________________________
@@ -381,9 +525,26 @@ void AliCFGridSparse::Multiply(const AliCFGridSparse* aGrid, Double_t c)
   } 
   
   if(!fSumW2  && aGrid->GetSumW2()) SumW2();
-  THnSparse *h = aGrid->GetGrid();
+
+  if (fStorage==kDense) {
+    fDenseFilledValid=kFALSE;
+    if (IsDenseCompatible(aGrid)) {
+      Bool_t errors = fDenseSumw2.GetSize()>0;
+      for (Long64_t i=0; i<fDenseContent.GetSize(); i++) {
+        Double_t v1 = fDenseContent.fArray[i];
+        Double_t v2 = aGrid->fDenseContent.fArray[i];
+        fDenseContent.fArray[i] = c*v1*v2;
+        if (errors) fDenseSumw2.fArray[i] = c*c*(fDenseSumw2.fArray[i]*v2*v2 + aGrid->GetDenseError2(i)*v1*v1);
+      }
+      return;
+    }
+    SetStorage(kSparse);
+  }
+
+  THnSparse *h = aGrid->IsDense() ? aGrid->CreateSparseGrid() : aGrid->fData;
   fData->Multiply(h);
   fData->Scale(c);
+  if (aGrid->IsDense()) delete h;
 }
 
 //____________________________________________________________________
@@ -400,12 +561,29 @@ void AliCFGridSparse::Multiply(const AliCFGridSparse* aGrid1, const AliCFGridSpa
   
   if(!fSumW2  && (aGrid1->GetSumW2() || aGrid2->GetSumW2())) SumW2();
 
+  if (fStorage==kDense) {
+    fDenseFilledValid=kFALSE;
+    if (IsDenseCompatible(aGrid1) && IsDenseCompatible(aGrid2)) {
+      Bool_t errors = fDenseSumw2.GetSize()>0;
+      for (Long64_t i=0; i<fDenseContent.GetSize(); i++) {
+        Double_t v1 = aGrid1->fDenseContent.fArray[i];
+        Double_t v2 = aGrid2->fDenseContent.fArray[i];
+        fDenseContent.fArray[i] = c1*c2*v1*v2;
+        if (errors) fDenseSumw2.fArray[i] = c1*c1*c2*c2*(aGrid1->GetDenseError2(i)*v2*v2 + aGrid2->GetDenseError2(i)*v1*v1);
+      }
+      return;
+    }
+    SetStorage(kSparse);
+  }
+
   fData->Reset();
-  THnSparse *h1 = aGrid1->GetGrid();
-  THnSparse *h2 = aGrid2->GetGrid();
+  THnSparse *h1 = aGrid1->IsDense() ? aGrid1->CreateSparseGrid() : aGrid1->fData;
+  THnSparse *h2 = aGrid2->IsDense() ? aGrid2->CreateSparseGrid() : aGrid2->fData;
   h2->Multiply(h1);
   h2->Scale(c1*c2);
   fData->Add(h2);
+  if (aGrid1->IsDense()) delete h1;
+  if (aGrid2->IsDense()) delete h2;
 }
 
 //____________________________________________________________________
@@ -422,10 +600,32 @@ void AliCFGridSparse::Divide(const AliCFGridSparse* aGrid, Double_t c)
   
   if (!fSumW2  && aGrid->GetSumW2()) SumW2();
 
-  THnSparse *h1 = aGrid->GetGrid();
+  if (fStorage==kDense) {
+    fDenseFilledValid=kFALSE;
+    if (IsDenseCompatible(aGrid)) {
+      Bool_t errors = fDenseSumw2.GetSize()>0;
+      for (Long64_t i=0; i<fDenseContent.GetSize(); i++) {
+        Double_t v1 = fDenseContent.fArray[i];
+        Double_t v2 = aGrid->fDenseContent.fArray[i];
+        if (v2==0) {
+          fDenseContent.fArray[i] = 0.;
+          if (errors) fDenseSumw2.fArray[i] = 0.;
+          continue;
+        }
+        fDenseContent.fArray[i] = c*v1/v2;
+        if (errors) fDenseSumw2.fArray[i] = c*c*(fDenseSumw2.fArray[i]*v2*v2 + aGrid->GetDenseError2(i)*v1*v1)/(v2*v2*v2*v2);
+      }
+      return;
+    }
+    SetStorage(kSparse);
+  }
+
+  THnSparse *h1 = aGrid->IsDense() ? aGrid->CreateSparseGrid() : aGrid->fData;
   THnSparse *h2 = (THnSparse*)fData->Clone();
   fData->Divide(h2,h1);
   fData->Scale(c);
+  if (aGrid->IsDense()) delete h1;
+  delete h2;
 }
 
 //____________________________________________________________________
@@ -443,9 +643,39 @@ void AliCFGridSparse::Divide(const AliCFGridSparse* aGrid1, const AliCFGridSpars
   
   if (!fSumW2  && (aGrid1->GetSumW2() || aGrid2->GetSumW2())) SumW2();
 
-  THnSparse *h1= aGrid1->GetGrid();
-  THnSparse *h2= aGrid2->GetGrid();
+  if (fStorage==kDense) {
+    fDenseFilledValid=kFALSE;
+    if (IsDenseCompatible(aGrid1) && IsDenseCompatible(aGrid2)) {
+      TString opt = option;
+      opt.ToUpper();
+      Bool_t binomial = opt.Contains("B");
+      Bool_t errors = fDenseSumw2.GetSize()>0;
+      for (Long64_t i=0; i<fDenseContent.GetSize(); i++) {
+        Double_t v1 = c1*aGrid1->fDenseContent.fArray[i];
+        Double_t v2 = c2*aGrid2->fDenseContent.fArray[i];
+        if (v2==0) {
+          fDenseContent.fArray[i] = 0.;
+          if (errors) fDenseSumw2.fArray[i] = 0.;
+          continue;
+        }
+        Double_t w = v1/v2;
+        fDenseContent.fArray[i] = w;
+        if (!errors) continue;
+        Double_t e1 = c1*c1*aGrid1->GetDenseError2(i);
+        Double_t e2 = c2*c2*aGrid2->GetDenseError2(i);
+        if (binomial) fDenseSumw2.fArray[i] = (v1!=v2) ? TMath::Abs(((1.-2.*w)*e1 + w*w*e2)/(v2*v2)) : 0.;
+        else          fDenseSumw2.fArray[i] = (e1*v2*v2 + e2*v1*v1)/(v2*v2*v2*v2);
+      }
+      return;
+    }
+    SetStorage(kSparse);
+  }
+
+  THnSparse *h1= aGrid1->IsDense() ? aGrid1->CreateSparseGrid() : aGrid1->fData;
+  THnSparse *h2= aGrid2->IsDense() ? aGrid2->CreateSparseGrid() : aGrid2->fData;
   fData->Divide(h1,h2,c1,c2,option);
+  if (aGrid1->IsDense()) delete h1;
+  if (aGrid2->IsDense()) delete h2;
 }
 
 
@@ -462,9 +692,12 @@ void AliCFGridSparse::Rebin(const Int_t* group)
     if (group[i]!=1) AliInfo(Form(" merging bins along dimension %i in groups of %i bins", i,group[i]));
   }
 
+  Int_t storage = fStorage;
+  SetStorage(kSparse);
   THnSparse *rebinned =fData->Rebin(group);
   fData->Reset();
   fData = rebinned;
+  SetStorage(storage);
 }
 //____________________________________________________________________
 void AliCFGridSparse::Scale(Long_t index, const Double_t *fact)
@@ -521,7 +754,8 @@ void AliCFGridSparse::Scale(const Double_t* fact)
   //scale contents of the whole grid by fact
   //
 
-  for (Long_t iel=0; iel<GetNFilledBins(); iel++) {
+  Long_t nElements = GetNFilledBins();
+  for (Long_t iel=0; iel<nElements; iel++) {
     Scale(iel,fact);
   }
 }
@@ -553,6 +787,12 @@ Double_t AliCFGridSparse::GetIntegral() const
   //
   // Get full Integral
   //
+  if (fStorage==kDense) {
+    THnSparse* h = CreateSparseGrid();
+    Double_t integral = h->ComputeIntegral();
+    delete h;
+    return integral;
+  }
   return fData->ComputeIntegral();  
 } 
 
@@ -609,6 +849,11 @@ void AliCFGridSparse::Copy(TObject& c) const
   if (fData) {
     target.fData = (THnSparse*)fData->Clone();
   }
+  target.fStorage      = fStorage ;
+  target.fDenseContent = fDenseContent ;
+  target.fDenseSumw2   = fDenseSumw2 ;
+  target.fDenseStrides.Set(0);
+  target.fDenseFilledValid = kFALSE;
 }
 
 //____________________________________________________________________
@@ -620,6 +865,8 @@ TH1* AliCFGridSparse::Slice(Int_t iVar1, Int_t iVar2, Int_t iVar3, const Double_
   // therefore varMin and varMax must have their dimensions equal to GetNVar()
   // If useBins=true, varMin and varMax are taken as bin numbers
   // if varmin or varmax point to null, all the range is taken, including over- and underflows
+  // In dense mode the clone only carries the axes: THnSparse books the projection
+  // with the right binning, which is then filled directly from the cells.
 
   THnSparse* clone = (THnSparse*)fData->Clone();
   if (varMin != 0x0 && varMax != 0x0) {
@@ -689,6 +936,8 @@ TH1* AliCFGridSparse::Slice(Int_t iVar1, Int_t iVar2, Int_t iVar3, const Double_
     }
   }
   
+  if (fStorage==kDense) FillDenseProjection(clone,projection,iVar1,iVar2,iVar3);
+
   projection->SetName (name .Data());
   projection->SetTitle(title.Data());
 
@@ -749,8 +998,15 @@ Float_t AliCFGridSparse::GetOverFlows(Int_t ivar, Bool_t exclusive) const
   Int_t* bin = new Int_t[GetNVar()];
   memset(bin, 0, sizeof(Int_t) * GetNVar());
   Float_t ovfl=0.;
-  for (Long64_t i = 0; i < fData->GetNbins(); i++) {
-    Double_t v = fData->GetBinContent(i, bin);
+  Long64_t nBins = (fStorage==kDense) ? fDenseContent.GetSize() : fData->GetNbins();
+  if (fStorage==kDense) InitDenseStrides();
+  for (Long64_t i = 0; i < nBins; i++) {
+    Double_t v = 0.;
+    if (fStorage==kDense) {
+      if (i>0) NextDenseBin(bin);
+      v = fDenseContent.fArray[i];
+    }
+    else v = fData->GetBinContent(i, bin);
     Bool_t add=kTRUE;
     if (exclusive) {
       for(Int_t j=0;j<GetNVar();j++){
@@ -775,8 +1031,15 @@ Float_t AliCFGridSparse::GetUnderFlows(Int_t ivar, Bool_t exclusive) const
   Int_t* bin = new Int_t[GetNVar()];
   memset(bin, 0, sizeof(Int_t) * GetNVar());
   Float_t unfl=0.;
-  for (Long64_t i = 0; i < fData->GetNbins(); i++) {
-    Double_t v = fData->GetBinContent(i, bin);
+  Long64_t nBins = (fStorage==kDense) ? fDenseContent.GetSize() : fData->GetNbins();
+  if (fStorage==kDense) InitDenseStrides();
+  for (Long64_t i = 0; i < nBins; i++) {
+    Double_t v = 0.;
+    if (fStorage==kDense) {
+      if (i>0) NextDenseBin(bin);
+      v = fDenseContent.fArray[i];
+    }
+    else v = fData->GetBinContent(i, bin);
     Bool_t add=kTRUE;
     if (exclusive) {
       for(Int_t j=0;j<GetNVar();j++){
@@ -801,5 +1064,361 @@ void AliCFGridSparse::Smooth() {
   AliInfo("Your GridSparse is going to be smoothed");
   AliInfo(Form("N TOTAL  BINS : %li",GetNBinsTotal()));
   AliInfo(Form("N FILLED BINS : %li",GetNFilledBins()));
+  Int_t storage = fStorage;
+  SetStorage(kSparse);
   AliCFUnfolding::SmoothUsingNeighbours(fData);
+  SetStorage(storage);
+}
+
+//____________________________________________________________________
+Long_t AliCFGridSparse::GetNFilledBins() const
+{
+  //
+  // Returns the number of filled bins (the non-empty cells in dense mode)
+  //
+  if (fStorage!=kDense) return fData->GetNbins();
+  UpdateDenseFilled();
+  return fDenseFilled.GetSize();
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::SetGrid(THnSparse* grid)
+{
+  //
+  // replaces the data container, the grid goes back to sparse storage
+  //
+  if (fData) delete fData ;
+  fData=grid;
+  fDenseContent.Set(0);
+  fDenseSumw2.Set(0);
+  fDenseFilledValid=kFALSE;
+  fStorage=kSparse;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::SetStorage(Int_t storage)
+{
+  //
+  // Moves the bin contents to the given storage layout:
+  // kSparse keeps them in the THnSparse, kDense in an array holding
+  // every cell (including under/overflows), which makes Fill and
+  // element access plain array indexing.
+  //
+  if (storage==fStorage) return;
+  if (storage!=kSparse && storage!=kDense) {
+    AliError(Form("Unknown storage layout %d",storage));
+    return;
+  }
+
+  if (storage==kSparse) {
+    THnSparse* sparse = CreateSparseGrid();
+    delete fData;
+    fData = sparse;
+    fDenseContent.Set(0);
+    fDenseSumw2.Set(0);
+    fDenseFilledValid = kFALSE;
+    fStorage = kSparse;
+    return;
+  }
+
+  Double_t nCells = 1.;
+  for (Int_t iVar=0; iVar<GetNVar(); iVar++) nCells *= GetNBins(iVar)+2;
+  if (nCells > fgMaxDenseBins) {
+    AliWarning(Form("%s: %.0f cells exceed the dense storage limit (%lld), keeping sparse storage",GetName(),nCells,fgMaxDenseBins));
+    return;
+  }
+
+  InitDenseStrides();
+  Bool_t errors = fData->GetCalculateErrors();
+  fDenseContent.Set((Int_t)nCells);
+  fDenseContent.Reset();
+  fDenseSumw2.Set(errors ? (Int_t)nCells : 0);
+  fDenseSumw2.Reset();
+
+  Int_t* bin = new Int_t[GetNVar()];
+  for (Long64_t i=0; i<fData->GetNbins(); i++) {
+    Double_t v = fData->GetBinContent(i,bin);
+    Long64_t index = GetDenseIndex(bin);
+    fDenseContent.fArray[index] = v;
+    if (errors) fDenseSumw2.fArray[index] = fData->GetBinError2(i);
+  }
+  delete [] bin;
+
+  // the THnSparse only keeps the axes and the statistics
+  Double_t entries = fData->GetEntries();
+  Double_t sumw    = fData->*AliCFTHnStatistics::Sumw();
+  Double_t sumw2   = fData->*AliCFTHnStatistics::Sumw2();
+  TArrayD  sumwx   = fData->*AliCFTHnStatistics::Sumwx();
+  TArrayD  sumwx2  = fData->*AliCFTHnStatistics::Sumwx2();
+  fData->Reset();
+  fData->CalculateErrors(errors);
+  fData->SetEntries(entries);
+  fData->*AliCFTHnStatistics::Sumw()   = sumw;
+  fData->*AliCFTHnStatistics::Sumw2()  = sumw2;
+  fData->*AliCFTHnStatistics::Sumwx()  = sumwx;
+  fData->*AliCFTHnStatistics::Sumwx2() = sumwx2;
+  fDenseFilledValid = kFALSE;
+  fStorage = kDense;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::SetExpectedOccupancy(Double_t occupancy)
+{
+  //
+  // Chooses the storage layout needing the least memory, given
+  // the fraction of bins expected to be filled
+  //
+  Int_t* bins = GetNBins();
+  SetStorage(GetOptimalStorage(GetNVar(),bins,occupancy,fData->GetCalculateErrors() || fDenseSumw2.GetSize()>0));
+  delete [] bins;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::OptimizeStorage()
+{
+  //
+  // Chooses the storage layout needing the least memory, given
+  // the fraction of bins (including under/overflows) filled so far
+  //
+  Double_t nCells = 1.;
+  for (Int_t iVar=0; iVar<GetNVar(); iVar++) nCells *= GetNBins(iVar)+2;
+  SetExpectedOccupancy(GetNFilledBins()/nCells);
+}
+
+//____________________________________________________________________
+Int_t AliCFGridSparse::GetOptimalStorage(Int_t nVar, const Int_t* nBin, Double_t occupancy, Bool_t sumW2)
+{
+  //
+  // Returns the storage layout needing the least memory for a grid of
+  // nVar variables with nBin bins each, a fraction 'occupancy' of which
+  // is expected to be filled. A filled THnSparseF bin costs its content,
+  // its compacted coordinates and a slot in the hash map; a dense cell
+  // costs its content only, but empty cells are stored as well.
+  //
+  const Double_t kHashBytes = 24.; // one TExMap slot
+  Double_t nCells = 1.;
+  Int_t    nBits  = 0;
+  for (Int_t iVar=0; iVar<nVar; iVar++) {
+    nCells *= nBin[iVar]+2;
+    nBits  += TMath::CeilNint(TMath::Log2(nBin[iVar]+2));
+  }
+  if (nCells > fgMaxDenseBins) return kSparse;
+
+  Double_t cellBytes   = sizeof(Float_t) + (sumW2 ? sizeof(Double_t) : 0);
+  Double_t denseBytes  = nCells * cellBytes;
+  Double_t sparseBytes = occupancy * nCells * (cellBytes + (nBits+7)/8 + kHashBytes);
+  return (denseBytes <= sparseBytes) ? kDense : kSparse;
+}
+
+//____________________________________________________________________
+Long64_t AliCFGridSparse::InitDenseStrides() const
+{
+  //
+  // Computes the strides of the dense layout (first variable running
+  // fastest) and returns the total number of cells
+  //
+  Int_t nVar = GetNVar();
+  fDenseStrides.Set(nVar);
+  fDenseNBins.Set(nVar);
+  Long64_t nCells = 1;
+  for (Int_t iVar=0; iVar<nVar; iVar++) {
+    fDenseStrides.fArray[iVar] = nCells;
+    fDenseNBins.fArray[iVar]   = GetNBins(iVar)+2;
+    nCells *= fDenseNBins.fArray[iVar];
+  }
+  return nCells;
+}
+
+//____________________________________________________________________
+Long64_t AliCFGridSparse::GetDenseIndex(const Int_t *bin) const
+{
+  //
+  // Returns the dense cell index of a set of bin indexes
+  //
+  if (fDenseStrides.GetSize()!=GetNVar()) InitDenseStrides();
+  Long64_t index=0;
+  for (Int_t iVar=0; iVar<fDenseStrides.GetSize(); iVar++) index += bin[iVar]*fDenseStrides.fArray[iVar];
+  return index;
+}
+
+//____________________________________________________________________
+Long64_t AliCFGridSparse::GetDenseIndex(const Double_t *var) const
+{
+  //
+  // Returns the dense cell index of a set of input variables
+  //
+  if (fDenseStrides.GetSize()!=GetNVar()) InitDenseStrides();
+  Long64_t index=0;
+  for (Int_t iVar=0; iVar<fDenseStrides.GetSize(); iVar++) {
+    index += fData->GetAxis(iVar)->FindFixBin(var[iVar])*fDenseStrides.fArray[iVar];
+  }
+  return index;
+}
+
+//____________________________________________________________________
+Bool_t AliCFGridSparse::NextDenseBin(Int_t *bin) const
+{
+  //
+  // Moves the bin indexes to the next dense cell,
+  // returns kFALSE after the last one.
+  // InitDenseStrides() must have been called.
+  //
+  for (Int_t iVar=0; iVar<fDenseNBins.GetSize(); iVar++) {
+    if (++bin[iVar] < fDenseNBins.fArray[iVar]) return kTRUE;
+    bin[iVar]=0;
+  }
+  return kFALSE;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::InitDenseSumw2()
+{
+  //
+  // Starts keeping squared weights in dense mode,
+  // the errors of the existing cells being those of Poisson statistics
+  //
+  fDenseSumw2.Set(fDenseContent.GetSize());
+  for (Long64_t i=0; i<fDenseContent.GetSize(); i++) fDenseSumw2.fArray[i] = fDenseContent.fArray[i];
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::SetDenseError(Long64_t cell, Float_t val)
+{
+  //
+  // Sets the error of a dense cell
+  //
+  if (!fDenseSumw2.GetSize()) InitDenseSumw2();
+  fDenseSumw2.fArray[cell] = val*val;
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::FillDenseStatistics(const Double_t *var, Double_t weight)
+{
+  //
+  // Updates the entries and the sums of weights of the THnSparse
+  // for one entry filled in dense mode, as THnBase::Fill does
+  //
+  fData->SetEntries(fData->GetEntries()+1);
+  if (!fData->GetCalculateErrors()) return;
+  fData->*AliCFTHnStatistics::Sumw()  += weight;
+  fData->*AliCFTHnStatistics::Sumw2() += weight*weight;
+  TArrayD& sumwx  = fData->*AliCFTHnStatistics::Sumwx();
+  TArrayD& sumwx2 = fData->*AliCFTHnStatistics::Sumwx2();
+  for (Int_t iVar=0; iVar<sumwx.GetSize(); iVar++) {
+    sumwx.fArray[iVar]  += weight*var[iVar];
+    sumwx2.fArray[iVar] += weight*var[iVar]*var[iVar];
+  }
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::UpdateDenseFilled() const
+{
+  //
+  // Lists the non-empty cells in dense mode, in the order of the cells.
+  // They play the role of the filled THnSparse bins for the bin index.
+  //
+  if (fDenseFilledValid) return;
+  Bool_t errors = fDenseSumw2.GetSize()>0;
+  Long64_t nFilled=0;
+  for (Long64_t i=0; i<fDenseContent.GetSize(); i++) {
+    if (fDenseContent.fArray[i]!=0 || (errors && fDenseSumw2.fArray[i]!=0)) nFilled++;
+  }
+  fDenseFilled.Set((Int_t)nFilled);
+  nFilled=0;
+  for (Long64_t i=0; i<fDenseContent.GetSize(); i++) {
+    if (fDenseContent.fArray[i]!=0 || (errors && fDenseSumw2.fArray[i]!=0)) fDenseFilled.fArray[nFilled++] = i;
+  }
+  fDenseFilledValid = kTRUE;
+}
+
+//____________________________________________________________________
+Long64_t AliCFGridSparse::GetDenseCell(Long_t index) const
+{
+  //
+  // Returns the dense cell of the filled bin 'index', -1 if out of range
+  //
+  UpdateDenseFilled();
+  if (index<0 || index>=fDenseFilled.GetSize()) return -1;
+  return fDenseFilled.fArray[index];
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::FillDenseProjection(const THnSparse* ranges, TH1* projection, Int_t iVar1, Int_t iVar2, Int_t iVar3) const
+{
+  //
+  // Fills the (empty) projection booked from the axes of 'ranges'
+  // with the dense cells inside the axis ranges, following
+  // THnSparse::Projection: axes without a range include their
+  // under/overflows, projected axes with a range start at its first bin.
+  //
+  Int_t nVar = GetNVar();
+  Long64_t nCells = InitDenseStrides();
+  Int_t* bin    = new Int_t[nVar];
+  Int_t* first  = new Int_t[nVar];
+  Int_t* last   = new Int_t[nVar];
+  Int_t* offset = new Int_t[nVar];
+  for (Int_t iVar=0; iVar<nVar; iVar++) {
+    TAxis* axis = ranges->GetAxis(iVar);
+    Bool_t hasRange = axis->TestBit(TAxis::kAxisRange);
+    first [iVar] = hasRange ? axis->GetFirst() : 0;
+    last  [iVar] = hasRange ? axis->GetLast()  : axis->GetNbins()+1;
+    offset[iVar] = hasRange ? axis->GetFirst()-1 : 0;
+    bin   [iVar] = 0;
+  }
+
+  Double_t* content = dynamic_cast<TArrayD*>(projection)->GetArray();
+  Double_t* sumw2   = projection->GetSumw2N() ? projection->GetSumw2()->GetArray() : 0x0;
+  Int_t nx = projection->GetNbinsX()+2;
+  Int_t ny = projection->GetNbinsY()+2;
+  Bool_t errors = fDenseSumw2.GetSize()>0;
+
+  for (Long64_t i=0; i<nCells; i++) {
+    if (i>0) NextDenseBin(bin);
+    Double_t v = fDenseContent.fArray[i];
+    if (v==0 && (!errors || fDenseSumw2.fArray[i]==0)) continue;
+    Bool_t inside = kTRUE;
+    for (Int_t iVar=0; iVar<nVar && inside; iVar++) inside = (bin[iVar]>=first[iVar] && bin[iVar]<=last[iVar]);
+    if (!inside) continue;
+    Int_t hBin = bin[iVar1]-offset[iVar1];
+    if (iVar2>=0) hBin += nx*(bin[iVar2]-offset[iVar2]);
+    if (iVar3>=0) hBin += nx*ny*(bin[iVar3]-offset[iVar3]);
+    content[hBin] += v;
+    if (sumw2) sumw2[hBin] += GetDenseError2(i);
+  }
+
+  projection->ResetStats();
+  projection->SetEntries(fData->GetEntries());
+  delete [] bin;
+  delete [] first;
+  delete [] last;
+  delete [] offset;
+}
+
+//____________________________________________________________________
+THnSparse* AliCFGridSparse::CreateSparseGrid() const
+{
+  //
+  // Returns a new THnSparse holding a copy of the grid,
+  // whatever the storage layout. The caller owns it.
+  //
+  THnSparse* sparse = (THnSparse*)fData->Clone();
+  if (fStorage!=kDense) return sparse;
+
+  Bool_t errors = fDenseSumw2.GetSize()>0;
+  if (errors) sparse->CalculateErrors(kTRUE);
+  Long64_t nCells = InitDenseStrides();
+  Int_t* bin = new Int_t[GetNVar()];
+  memset(bin, 0, sizeof(Int_t) * GetNVar());
+  for (Long64_t i=0; i<nCells; i++) {
+    if (i>0) NextDenseBin(bin);
+    Double_t v  = fDenseContent.fArray[i];
+    Double_t e2 = errors ? fDenseSumw2.fArray[i] : 0.;
+    if (v==0 && e2==0) continue;
+    Long64_t index = sparse->GetBin(bin,kTRUE);
+    sparse->SetBinContent(index,v);
+    if (errors) sparse->SetBinError2(index,e2);
+  }
+  delete [] bin;
+  sparse->SetEntries(fData->GetEntries());
+  return sparse;
 }
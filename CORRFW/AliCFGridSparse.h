@@ -4,7 +4,8 @@
 //                                                                    //
 // AliCFGridSparse.cxx Class                                          //
 // Class to handle N-dim maps for the correction Framework            // 
-// uses a THnSparse to store the grid                                 //
+// uses a THnSparse to store the grid, or a dense array of cells     //
+// when most of the bins are expected to be filled                    //
 // Author:S.Arcelli, silvia.arcelli@cern.ch
 //--------------------------------------------------------------------//
 
@@ -12,6 +13,10 @@
 #include "THnSparse.h"
 #include "AliLog.h"
 #include "TAxis.h"
+#include "TArrayF.h"
+#include "TArrayD.h"
+#include "TArrayI.h"
+#include "TArrayL64.h"
 
 class TH1D;
 class TH2D;
@@ -20,6 +25,8 @@ class TH3D;
 class AliCFGridSparse : public AliCFFrame
 {
  public:
+  enum EStorage {kSparse=0, kDense=1}; // storage layout of the bin contents
+
   AliCFGridSparse();
   AliCFGridSparse(const Char_t* name, const Char_t* title);
   AliCFGridSparse(const Char_t* name, const Char_t* title, Int_t nVarIn, const Int_t* nBinIn);
@@ -37,7 +44,7 @@ class AliCFGridSparse : public AliCFFrame
   virtual void       GetBinLimits(Int_t ivar, Double_t * array) const ;
   virtual Double_t * GetBinLimits(Int_t ivar) const ;
   virtual Long_t     GetNBinsTotal() const ;
-  virtual Long_t     GetNFilledBins() const {return fData->GetNbins();}
+  virtual Long_t     GetNFilledBins() const ;
   virtual Int_t      GetNBins(Int_t ivar) const {return fData->GetAxis(ivar)->GetNbins();}
   virtual Int_t *    GetNBins() const ;
   virtual Float_t    GetBinCenter(Int_t ivar,Int_t ibin) const ;
@@ -99,8 +106,20 @@ class AliCFGridSparse : public AliCFFrame
   //virtual Double_t GetIntegral(const Double_t *varMin, const Double_t *varMax) const;
   virtual Long64_t Merge(TCollection* list);
 
-  virtual void     SetGrid(THnSparse* grid) {if (fData) delete fData ; fData=grid;}
-  THnSparse   *    GetGrid() const {return fData;}
+  virtual void     SetGrid(THnSparse* grid) ;
+  THnSparse   *    GetGrid() const {return fData;} // in dense mode, only the axes and the statistics (see FlushToSparse)
+  void             FlushToSparse() {SetStorage(kSparse);} // to be called before modifying the bins of GetGrid() directly
+  THnSparse   *    CreateSparseGrid() const; // copy of the grid in a THnSparse, whatever the storage (owned by the caller)
+
+  // storage layout
+  virtual void     SetStorage(Int_t storage) ;
+  Int_t            GetStorage() const {return fStorage;}
+  Bool_t           IsDense() const {return fStorage==kDense;}
+  virtual void     SetExpectedOccupancy(Double_t occupancy) ; // chooses the layout needing the least memory
+  virtual void     OptimizeStorage() ;                        // same, from the fraction of bins actually filled
+  static  Int_t    GetOptimalStorage(Int_t nVar, const Int_t* nBin, Double_t occupancy, Bool_t sumW2=kTRUE) ;
+  static  void     SetMaxDenseBins(Long64_t nBins) {fgMaxDenseBins=nBins;}
+  static  Long64_t GetMaxDenseBins() {return fgMaxDenseBins;}
 
   virtual Float_t GetOverFlows (Int_t var, Bool_t excl=kFALSE) const;
   virtual Float_t GetUnderFlows(Int_t var, Bool_t excl=kFALSE) const;
@@ -119,11 +138,34 @@ class AliCFGridSparse : public AliCFFrame
   void     GetProjectionName (TString& s,Int_t var0, Int_t var1=-1, Int_t var2=-1) const;
   void     GetProjectionTitle(TString& s,Int_t var0, Int_t var1=-1, Int_t var2=-1) const;
 
+  // dense storage helpers
+  Long64_t   InitDenseStrides() const;
+  Long64_t   GetDenseIndex(const Int_t *bin) const;
+  Long64_t   GetDenseIndex(const Double_t *var) const;
+  Bool_t     NextDenseBin(Int_t *bin) const;
+  void       InitDenseSumw2();
+  Double_t   GetDenseError2(Long64_t index) const {return fDenseSumw2.GetSize() ? fDenseSumw2.fArray[index] : fDenseContent.fArray[index];}
+  Bool_t     IsDenseCompatible(const AliCFGridSparse* aGrid) const {return aGrid->IsDense() && aGrid->fDenseContent.GetSize()==fDenseContent.GetSize();}
+  void       FillDenseProjection(const THnSparse* ranges, TH1* projection, Int_t iVar1, Int_t iVar2, Int_t iVar3) const;
+  void       FillDenseStatistics(const Double_t *var, Double_t weight);
+  void       SetDenseError(Long64_t cell, Float_t val);
+  void       UpdateDenseFilled() const;
+  Long64_t   GetDenseCell(Long_t index) const;
+
   // data members:
   Bool_t      fSumW2    ; // Flag to check if calculation of squared weights enabled
-  THnSparse  *fData     ; // The data Container: a THnSparse  
+  THnSparse  *fData     ; // The data Container: a THnSparse, holding only the axes in dense mode
+  Int_t       fStorage  ; // Storage layout (kSparse or kDense)
+  TArrayF     fDenseContent ; // Bin contents in dense mode, including under/overflows
+  TArrayD     fDenseSumw2   ; // Squared weights in dense mode (empty if errors are not calculated)
+  mutable TArrayL64 fDenseStrides ; //! Strides of the dense layout
+  mutable TArrayI   fDenseNBins   ; //! Number of cells along each axis, including under/overflows
+  mutable TArrayL64 fDenseFilled  ; //! Cells of the filled bins in dense mode, i.e. the cells reached by the bin index
+  mutable Bool_t    fDenseFilledValid ; //! Whether fDenseFilled is up to date
+
+  static Long64_t fgMaxDenseBins ; // Largest number of cells allowed in dense mode
 
-  ClassDef(AliCFGridSparse,3);
+  ClassDef(AliCFGridSparse,4);
 };
 
 
@@ -22,7 +22,9 @@
 // prototype version by S.Arcelli silvia.arcelli@cern.ch
 ///////////////////////////////////////////////////////////////////////////
 #include "AliCFCutBase.h"
+#include "AliCFCutChain.h"
 #include "AliCFManager.h"
+#include "TObjArray.h"
 
 ClassImp(AliCFManager)
 
@@ -34,7 +36,9 @@ AliCFManager::AliCFManager() :
   fEvtContainer(0x0),
   fPartContainer(0x0),
   fEvtCutList(0x0),
-  fPartCutList(0x0)
+  fPartCutList(0x0),
+  fPartCutChain(0x0),
+  fNPartCutChain(0)
 { 
   //
   // ctor
@@ -48,7 +52,9 @@ AliCFManager::AliCFManager(const Char_t* name, const Char_t* title) :
   fEvtContainer(0x0),
   fPartContainer(0x0),
   fEvtCutList(0x0),
-  fPartCutList(0x0)
+  fPartCutList(0x0),
+  fPartCutChain(0x0),
+  fNPartCutChain(0)
 { 
    //
    // ctor
@@ -62,10 +68,12 @@ AliCFManager::AliCFManager(const AliCFManager& c) :
   fEvtContainer(c.fEvtContainer),
   fPartContainer(c.fPartContainer),
   fEvtCutList(c.fEvtCutList),
-  fPartCutList(c.fPartCutList)
+  fPartCutList(c.fPartCutList),
+  fPartCutChain(0x0),
+  fNPartCutChain(0)
 { 
    //
-   //copy ctor
+   //copy ctor (the compiled cuts are not copied)
    //
 }
 //_____________________________________________________________________________
@@ -76,6 +84,7 @@ AliCFManager& AliCFManager::operator=(const AliCFManager& c)
   //
   if (this != &c) {
     TNamed::operator=(c) ;
+    DeleteParticleCutChains();
   }
   
   this->fNStepEvt=c.fNStepEvt;
@@ -92,6 +101,35 @@ AliCFManager::~AliCFManager() {
    //
    //dtor
    //
+  DeleteParticleCutChains();
+}
+
+//_____________________________________________________________________________
+void AliCFManager::DeleteParticleCutChains() {
+  //
+  // deletes the compiled particle cuts
+  //
+  if (!fPartCutChain) return;
+  for (Int_t isel=0; isel<fNPartCutChain; isel++) delete fPartCutChain[isel];
+  delete [] fPartCutChain;
+  fPartCutChain = 0x0;
+  fNPartCutChain = 0;
+}
+
+//_____________________________________________________________________________
+void AliCFManager::SetNStepParticle(Int_t nstep) {
+  //
+  // sets the number of particle-selection steps, the compiled cuts
+  // of the steps which remain are kept
+  //
+  fNStepPart = nstep;
+  if (!fPartCutChain || nstep == fNPartCutChain) return;
+  AliCFCutChain **chains = new AliCFCutChain*[nstep] ;
+  for (Int_t istep = 0; istep < nstep; istep++) chains[istep] = (istep < fNPartCutChain) ? fPartCutChain[istep] : 0x0;
+  for (Int_t istep = nstep; istep < fNPartCutChain; istep++) delete fPartCutChain[istep];
+  delete [] fPartCutChain;
+  fPartCutChain = chains;
+  fNPartCutChain = nstep;
 }
 
 //_____________________________________________________________________________
@@ -115,6 +153,96 @@ Bool_t AliCFManager::CheckParticleCuts(Int_t isel, TObject *obj, const TString
   return kTRUE;
 }
 
+//_____________________________________________________________________________
+void AliCFManager::CompileParticleCuts(Int_t isel, const TString &selcuts, Bool_t profile) {
+  //
+  // resolves the cuts of particle-level selection isel matching selcuts
+  // into a cut chain, used by CheckCompiledParticleCuts
+  //
+
+  if(isel<0 || isel>=fNStepPart){
+    AliWarning(Form("Selection index out of Range! isel=%i, max. number of selections= %i", isel,fNStepPart));
+    return;
+  }
+  if (!fPartCutChain) {
+    fPartCutChain = new AliCFCutChain*[fNStepPart] ;
+    fNPartCutChain = fNStepPart;
+    for (Int_t istep = 0; istep < fNStepPart; istep++)  fPartCutChain[istep] = 0; 
+  }
+  delete fPartCutChain[isel];
+  fPartCutChain[isel] = new AliCFCutChain(Form("%s_part%d",GetName(),isel),selcuts.Data());
+  fPartCutChain[isel]->SetProfiling(profile);
+  if(!fPartCutList || !fPartCutList[isel])return;
+  TObjArrayIter iter(fPartCutList[isel]);
+  AliCFCutBase *cut = 0;
+  while ( (cut = (AliCFCutBase*)iter.Next()) ) {
+    if(CompareStrings(cut->GetName(),selcuts)) fPartCutChain[isel]->Add(cut);
+  }
+}
+
+//_____________________________________________________________________________
+Bool_t AliCFManager::CheckCompiledParticleCuts(Int_t isel, TObject *obj) const {
+  //
+  // check whether object obj passes the compiled particle-level selection isel
+  //
+
+  if(isel>=fNStepPart){
+    AliWarning(Form("Selection index out of Range! isel=%i, max. number of selections= %i", isel,fNStepPart));
+    return kTRUE;
+  }
+  AliCFCutChain *chain = GetParticleCutChain(isel);
+  if(!chain){
+    AliError(Form("Particle cuts of step %d not compiled, checking all the cuts",isel));
+    return CheckParticleCuts(isel,obj);
+  }
+  return chain->IsSelected(obj);
+}
+
+//_____________________________________________________________________________
+Int_t AliCFManager::CheckCompiledParticleCuts(Int_t isel, const TObjArray *objects, Bool_t *selected) const {
+  //
+  // checks all the objects of the array against the compiled particle-level
+  // selection isel, returns the number of selected objects
+  //
+
+  Int_t nObjects = objects->GetEntriesFast();
+  if(isel>=fNStepPart){
+    AliWarning(Form("Selection index out of Range! isel=%i, max. number of selections= %i", isel,fNStepPart));
+    Int_t nSelected = 0;
+    for (Int_t iobj=0; iobj<nObjects; iobj++) {
+      selected[iobj] = objects->UncheckedAt(iobj) != 0x0;
+      if (selected[iobj]) nSelected++;
+    }
+    return nSelected;
+  }
+  AliCFCutChain *chain = GetParticleCutChain(isel);
+  if(!chain){
+    AliError(Form("Particle cuts of step %d not compiled, checking all the cuts",isel));
+    Int_t nSelected = 0;
+    for (Int_t iobj=0; iobj<nObjects; iobj++) {
+      TObject *obj = objects->UncheckedAt(iobj);
+      selected[iobj] = obj && CheckParticleCuts(isel,obj);
+      if (selected[iobj]) nSelected++;
+    }
+    return nSelected;
+  }
+  return chain->Select(objects,selected);
+}
+
+//_____________________________________________________________________________
+void AliCFManager::PrintCutFlow() const {
+  //
+  // prints the cut-flow table of the compiled particle-level selections
+  //
+  if (!fPartCutChain) {
+    AliInfo("No compiled particle cuts");
+    return;
+  }
+  for (Int_t isel=0; isel<fNPartCutChain; isel++) {
+    if (fPartCutChain[isel]) fPartCutChain[isel]->Print();
+  }
+}
+
 //_____________________________________________________________________________
 Bool_t AliCFManager::CheckEventCuts(Int_t isel, TObject *obj, const TString  &selcuts) const{
   //
@@ -267,4 +395,9 @@ void AliCFManager::SetParticleCutsList(Int_t isel, TObjArray* array) {
     return;
   }
   fPartCutList[isel] = array;
+  if (GetParticleCutChain(isel)) {
+    AliWarning(Form("Cut list of step %d changed, the compiled cuts are removed",isel));
+    delete fPartCutChain[isel];
+    fPartCutChain[isel] = 0x0;
+  }
 }
@@ -28,6 +28,8 @@
 #include "AliCFContainer.h"
 #include "AliLog.h"
 
+class AliCFCutChain;
+
 //____________________________________________________________________________
 class AliCFManager : public TNamed 
 {
@@ -79,7 +81,7 @@ class AliCFManager : public TNamed
   
   //Set the number of steps (already done if you have defined your containers)
   virtual void SetNStepEvent   (Int_t nstep) {fNStepEvt  = nstep;}
-  virtual void SetNStepParticle(Int_t nstep) {fNStepPart = nstep;}
+  virtual void SetNStepParticle(Int_t nstep) ;
 
   //Setter for event-level selection cut list at selection step isel
   virtual void SetEventCutsList(Int_t isel, TObjArray* array) ;
@@ -116,6 +118,16 @@ class AliCFManager : public TNamed
   virtual Bool_t CheckEventCuts(Int_t isel, TObject *obj, const TString &selcuts="all") const;
   virtual Bool_t CheckParticleCuts(Int_t isel, TObject *obj, const TString &selcuts="all") const;
 
+  //Compiled particle cuts: the cuts of step isel matching selcuts are resolved
+  //once into an AliCFCutChain, which also records the time and rejections of
+  //each cut (see AliCFCutChain for the reordering of the cuts)
+  virtual void   CompileParticleCuts(Int_t isel, const TString &selcuts="all", Bool_t profile=kFALSE);
+  virtual Bool_t CheckCompiledParticleCuts(Int_t isel, TObject *obj) const;
+  //same on all the particles of an array, selected[i] is the decision for objects->At(i)
+  virtual Int_t  CheckCompiledParticleCuts(Int_t isel, const TObjArray *objects, Bool_t *selected) const;
+  virtual AliCFCutChain* GetParticleCutChain(Int_t isel) const {return (fPartCutChain && isel>=0 && isel<fNPartCutChain) ? fPartCutChain[isel] : 0x0;}
+  virtual void   PrintCutFlow() const;
+
  private:
   
   //number of steps
@@ -129,8 +141,11 @@ class AliCFManager : public TNamed
   TObjArray **fEvtCutList;   //[fNStepEvt] arrays of cuts for each event-selection level
   //Particle-level selections
   TObjArray **fPartCutList ; //[fNStepPart] arrays of cuts for each particle-selection level
+  AliCFCutChain **fPartCutChain ; //! compiled cuts for each particle-selection level
+  Int_t fNPartCutChain ;          //! number of entries allocated in fPartCutChain
 
   Bool_t CompareStrings(const TString  &cutname,const TString  &selcuts) const;
+  void   DeleteParticleCutChains();
 
   ClassDef(AliCFManager,2);
 };
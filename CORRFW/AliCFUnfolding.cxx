@@ -57,6 +57,14 @@
 // found in AliCFUnfolding::CalculateCorrelatedErrors()                //
 // Author: marta.verweij@cern.ch                                       //
 //                                                                     //
+// Unless smoothing is used, the iterations run on flat arrays holding //
+// every cell of the spectra (::SetUseDenseMatrices), and the          //
+// randomised iterations of the correlated error calculation can be    //
+// shared among threads (::SetNThreads). Each randomised iteration     //
+// draws from its own random stream, seeded from the random seed given //
+// in the constructor, so the errors do not depend on the number of    //
+// threads.                                                            //
+//                                                                     //
 // An optional possibility is to smooth the unfolded spectrum at the   //
 // end of each iteration, either using a fit function                  //
 // (only if #dimensions <=3)                                           //
@@ -92,10 +100,197 @@
 #include "TH2D.h"
 #include "TH3D.h"
 #include "TRandom3.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 
 ClassImp(AliCFUnfolding)
 
+namespace {
+
+  const Double_t kMaxDenseCells  = 1<<24 ; // largest spectrum handled by the dense fast path
+  const Int_t    kNErrorBlocks   = 16 ;    // randomised iterations are summed in this many fixed blocks
+
+  //
+  // Flat view of the unfolding problem used by the dense fast path :
+  // spectra are arrays over all the cells of the N-dim measured (M) or
+  // true (T) space, under/overflows included, and the conditional matrix
+  // is the list of its filled bins as (M cell, T cell, value) triplets
+  //
+  struct DenseProblem {
+    std::vector<Long64_t> fStridesM;
+    std::vector<Long64_t> fStridesT;
+    Long64_t              fNCellsM;
+    Long64_t              fNCellsT;
+    std::vector<Long64_t> fCellM;
+    std::vector<Long64_t> fCellT;
+    std::vector<Double_t> fConditional;
+  };
+
+  // filled bins of a spectrum to be randomised, with their mean and sigma
+  struct RandomisedSpectrum {
+    std::vector<Long64_t> fCell;
+    std::vector<Double_t> fValue;
+    std::vector<Double_t> fError;
+  };
+
+  //______________________________________________________________
+  Long64_t InitStrides(const THnSparse* h, Int_t firstAxis, Int_t nAxes, std::vector<Long64_t>& strides) {
+    // strides of the cells of axes [firstAxis,firstAxis+nAxes[, returns the number of cells
+    strides.resize(nAxes);
+    Long64_t nCells = 1;
+    for (Int_t iAxis=0; iAxis<nAxes; iAxis++) {
+      strides[iAxis] = nCells;
+      nCells *= h->GetAxis(firstAxis+iAxis)->GetNbins()+2;
+    }
+    return nCells;
+  }
+
+  //______________________________________________________________
+  Long64_t GetCell(const Int_t* coordinates, const std::vector<Long64_t>& strides) {
+    Long64_t cell = 0;
+    for (UInt_t iAxis=0; iAxis<strides.size(); iAxis++) cell += coordinates[iAxis]*strides[iAxis];
+    return cell;
+  }
+
+  //______________________________________________________________
+  void ToDense(const THnSparse* h, const std::vector<Long64_t>& strides, Long64_t nCells,
+	       std::vector<Double_t>& values, std::vector<Char_t>* filled) {
+    // copies the content of h into values; filled flags the bins existing in h
+    values.assign(nCells,0.);
+    if (filled) filled->assign(nCells,0);
+    Int_t* coordinates = new Int_t[h->GetNdimensions()];
+    for (Long64_t iBin=0; iBin<h->GetNbins(); iBin++) {
+      Double_t value = h->GetBinContent(iBin,coordinates);
+      Long64_t cell  = GetCell(coordinates,strides);
+      values[cell] = value;
+      if (filled) (*filled)[cell] = 1;
+    }
+    delete [] coordinates;
+  }
+
+  //______________________________________________________________
+  void ToSparse(const std::vector<Double_t>& values, const std::vector<Char_t>& filled, THnSparse* h) {
+    // resets h and sets the content of the flagged cells, with zero errors
+    h->Reset();
+    Int_t  nDim = h->GetNdimensions();
+    Int_t* coordinates = new Int_t[nDim];
+    for (Long64_t cell=0; cell<(Long64_t)values.size(); cell++) {
+      if (!filled[cell]) continue;
+      Long64_t rest = cell;
+      for (Int_t iDim=0; iDim<nDim; iDim++) {
+	Int_t nCells = h->GetAxis(iDim)->GetNbins()+2;
+	coordinates[iDim] = rest % nCells;
+	rest /= nCells;
+      }
+      h->SetBinContent(coordinates,values[cell]);
+      h->SetBinError  (coordinates,0.);
+    }
+    delete [] coordinates;
+  }
+
+  //______________________________________________________________
+  void GetRandomisedSpectrum(const THnSparse* h, const std::vector<Long64_t>& strides, RandomisedSpectrum& spectrum) {
+    Int_t* coordinates = new Int_t[h->GetNdimensions()];
+    for (Long64_t iBin=0; iBin<h->GetNbins(); iBin++) {
+      spectrum.fValue.push_back(h->GetBinContent(iBin,coordinates));
+      spectrum.fError.push_back(h->GetBinError(iBin));
+      spectrum.fCell .push_back(GetCell(coordinates,strides));
+    }
+    delete [] coordinates;
+  }
+
+  //______________________________________________________________
+  void Randomise(const RandomisedSpectrum& spectrum, Long64_t nCells, TRandom3* random, std::vector<Double_t>& values) {
+    // same draws as AliCFUnfolding::CreateRandomizedDist()
+    values.assign(nCells,0.);
+    for (UInt_t iBin=0; iBin<spectrum.fCell.size(); iBin++) {
+      values[spectrum.fCell[iBin]] = random->Gaus(spectrum.fValue[iBin],spectrum.fError[iBin]);
+    }
+  }
+
+  //______________________________________________________________
+  void BayesIteration(const DenseProblem& p, const std::vector<Double_t>& prior, const std::vector<Double_t>& efficiency,
+		      const std::vector<Double_t>& measured, std::vector<Double_t>& estMeasured,
+		      std::vector<Double_t>& unfolded, std::vector<Char_t>& unfoldedFilled, std::vector<Double_t>* inverse) {
+    //
+    // One Bayes iteration, following CreateEstMeasured(), CreateInvResponse() and CreateUnfolded()
+    //
+    const Long64_t nBins = p.fConditional.size();
+    estMeasured.assign(p.fNCellsM,0.);
+    for (Long64_t iBin=0; iBin<nBins; iBin++) {
+      Long64_t cellT = p.fCellT[iBin];
+      Double_t fill  = p.fConditional[iBin] * prior[cellT] * efficiency[cellT];
+      if (fill>0.) estMeasured[p.fCellM[iBin]] += fill;
+    }
+
+    unfolded.assign(p.fNCellsT,0.);
+    unfoldedFilled.assign(p.fNCellsT,0);
+    for (Long64_t iBin=0; iBin<nBins; iBin++) {
+      Long64_t cellM = p.fCellM[iBin];
+      Long64_t cellT = p.fCellT[iBin];
+      Double_t estMeasuredValue = estMeasured[cellM];
+      Double_t effValue         = efficiency[cellT];
+      Double_t invResponseValue = (estMeasuredValue>0. ? p.fConditional[iBin] * prior[cellT] * effValue / estMeasuredValue : 0.);
+      if (inverse) (*inverse)[iBin] = invResponseValue;
+      Double_t fill = (effValue>0. ? invResponseValue * measured[cellM] / effValue : 0.);
+      if (fill>0.) {
+	unfolded[cellT] += fill;
+	unfoldedFilled[cellT] = 1;
+      }
+    }
+  }
+
+  //______________________________________________________________
+  Double_t GetDenseConvergence(const std::vector<Double_t>& prior, const std::vector<Char_t>& priorFilled,
+			       const std::vector<Double_t>& unfolded, Int_t& nEmpty) {
+    // same as AliCFUnfolding::GetConvergence(), nEmpty counts the filled prior bins which are not positive
+    Double_t convergence = 0.;
+    nEmpty = 0;
+    for (UInt_t cell=0; cell<prior.size(); cell++) {
+      if (!priorFilled[cell]) continue;
+      Double_t priorValue = prior[cell];
+      if (priorValue > 0.) {
+	Double_t delta = (priorValue-unfolded[cell])/priorValue;
+	convergence += delta*delta;
+      }
+      else nEmpty++;
+    }
+    return convergence;
+  }
+
+  //______________________________________________________________
+  void RunRandomIterations(const DenseProblem& p, const std::vector<Double_t>& priorOrig,
+			   const RandomisedSpectrum& efficiencyOrig, const RandomisedSpectrum& measuredOrig,
+			   const std::vector<Long64_t>& finalCells, const std::vector<Double_t>& finalValues,
+			   Int_t nBayesIterations, const UInt_t* seeds, Int_t firstIteration, Int_t lastIteration,
+			   TRandom3* random, Double_t* sumDelta, Double_t* sumDelta2) {
+    //
+    // Unfolds randomised spectra for iterations [firstIteration,lastIteration[
+    // and sums the deviations from the final unfolded spectrum (and their squares).
+    // Only touches its own buffers : safe to run concurrently.
+    //
+    std::vector<Double_t> efficiency, measured, prior, estMeasured, unfolded;
+    std::vector<Char_t>   unfoldedFilled;
+    for (Int_t iIter=firstIteration; iIter<lastIteration; iIter++) {
+      random->SetSeed(seeds[iIter]);
+      Randomise(efficiencyOrig,p.fNCellsT,random,efficiency);
+      Randomise(measuredOrig  ,p.fNCellsM,random,measured);
+      prior = priorOrig;
+      for (Int_t iIterBayes=0; iIterBayes<nBayesIterations; iIterBayes++) {
+	BayesIteration(p,prior,efficiency,measured,estMeasured,unfolded,unfoldedFilled,0x0);
+	prior.swap(unfolded); // the unfolded spectrum is the prior of the next iteration
+      }
+      for (UInt_t iBin=0; iBin<finalCells.size(); iBin++) {
+	Double_t delta = finalValues[iBin] - prior[finalCells[iBin]];
+	sumDelta [iBin] += delta;
+	sumDelta2[iBin] += delta*delta;
+      }
+    }
+  }
+}
+
 //______________________________________________________________
 
 AliCFUnfolding::AliCFUnfolding() :
@@ -130,7 +325,9 @@ AliCFUnfolding::AliCFUnfolding() :
   fDeltaUnfoldedP(0x0),
   fDeltaUnfoldedN(0x0),
   fNCalcCorrErrors(0),
-  fRandomSeed(0)
+  fRandomSeed(0),
+  fUseDenseMatrices(kTRUE),
+  fNThreads(1)
 {
   //
   // default constructor
@@ -174,7 +371,9 @@ AliCFUnfolding::AliCFUnfolding(const Char_t* name, const Char_t* title, const In
   fDeltaUnfoldedP(0x0),
   fDeltaUnfoldedN(0x0),
   fNCalcCorrErrors(0),
-  fRandomSeed(randomSeed)
+  fRandomSeed(randomSeed),
+  fUseDenseMatrices(kTRUE),
+  fNThreads(1)
 {
   //
   // named constructor
@@ -350,6 +549,11 @@ void AliCFUnfolding::Unfold() {
   // several iterations are performed until a reasonable chi2 or convergence criterion is reached
   //
 
+  if (fNCalcCorrErrors == 0 && CanUnfoldDense()) {
+    UnfoldDense();
+    return;
+  }
+
   Int_t iIterBayes     = 0 ;
   Double_t convergence = 0.;
 
@@ -456,6 +660,10 @@ void AliCFUnfolding::CalculateCorrelatedErrors() {
   // Step 5: The spread of fDeltaUnfoldedP for each bin is the error on the unfolded spectrum of that specific bin
 
 
+  // Each iteration draws from its own random stream, see UnfoldDense()
+  std::vector<UInt_t> seeds(fNRandomIterations);
+  for (int i=0; i<fNRandomIterations; i++) seeds[i] = 1 + fRandom3->Integer(kMaxInt);
+
   //Do fNRandomIterations = bayes iterations performed
   for (int i=0; i<fNRandomIterations; i++) {
     
@@ -464,6 +672,7 @@ void AliCFUnfolding::CalculateCorrelatedErrors() {
     fPrior = (THnSparse*) fPriorOrig->Clone();
 
     // create randomized distribution and stick measured spectrum to it
+    fRandom3->SetSeed(seeds[i]);
     CreateRandomizedDist();
 
     if (fResponse) delete fResponse ;
@@ -509,15 +718,10 @@ void AliCFUnfolding::CreateRandomizedDist() {
   //
   // Create randomized dist from original measured distribution
   // This distribution is created several times, each time with a different random number
+  // The response is drawn last: the conditional matrix is not recomputed from it,
+  // so the dense fast path can skip it and still draw the same spectra.
   //
 
-  for (Long_t iBin=0; iBin<fResponseOrig->GetNbins(); iBin++) {
-    Double_t val = fResponseOrig->GetBinContent(iBin,fCoordinatesN_M); //used as mean
-    Double_t err = fResponseOrig->GetBinError(fCoordinatesN_M);        //used as sigma
-    Double_t ran = fRandom3->Gaus(val,err);
-    // random        = fRandom3->PoissonD(measuredValue); //doesn't work for normalized spectra, use Gaus (assuming raw counts in bin is large >10)
-    fRandomResponse->SetBinContent(iBin,ran);
-  }
   for (Long_t iBin=0; iBin<fEfficiencyOrig->GetNbins(); iBin++) {
     Double_t val = fEfficiencyOrig->GetBinContent(iBin,fCoordinatesN_M); //used as mean
     Double_t err = fEfficiencyOrig->GetBinError(fCoordinatesN_M);        //used as sigma
@@ -532,6 +736,13 @@ void AliCFUnfolding::CreateRandomizedDist() {
     // random        = fRandom3->PoissonD(measuredValue); //doesn't work for normalized spectra, use Gaus (assuming raw counts in bin is large >10)
     fRandomMeasured->SetBinContent(iBin,ran);
   }
+  for (Long_t iBin=0; iBin<fResponseOrig->GetNbins(); iBin++) {
+    Double_t val = fResponseOrig->GetBinContent(iBin,fCoordinates2N); //used as mean
+    Double_t err = fResponseOrig->GetBinError(fCoordinates2N);        //used as sigma
+    Double_t ran = fRandom3->Gaus(val,err);
+    // random        = fRandom3->PoissonD(measuredValue); //doesn't work for normalized spectra, use Gaus (assuming raw counts in bin is large >10)
+    fRandomResponse->SetBinContent(iBin,ran);
+  }
 }
 
 //______________________________________________________________
@@ -862,3 +1073,165 @@ void AliCFUnfolding::CreateFlatPrior() {
   delete [] bin;
   delete [] bins;
 }
+
+//______________________________________________________________
+
+Bool_t AliCFUnfolding::CanUnfoldDense() const {
+  //
+  // The dense fast path is used unless disabled, or smoothing is required,
+  // or the measured or true spectra have too many cells to be held in arrays
+  //
+
+  if (!fUseDenseMatrices || fUseSmoothing) return kFALSE;
+  Double_t nCellsM = 1., nCellsT = 1.;
+  for (Int_t iVar=0; iVar<fNVariables; iVar++) {
+    nCellsM *= fMeasured->GetAxis(iVar)->GetNbins()+2;
+    nCellsT *= fPrior   ->GetAxis(iVar)->GetNbins()+2;
+  }
+  return (nCellsM <= kMaxDenseCells && nCellsT <= kMaxDenseCells);
+}
+
+//______________________________________________________________
+
+void AliCFUnfolding::UnfoldDense() {
+  //
+  // Same as Unfold() followed by CalculateCorrelatedErrors(), with the spectra
+  // held in flat arrays and the conditional matrix as the list of its filled bins :
+  // each Bayes iteration is two passes over this list.
+  // The THnSparse outputs (unfolded, prior, inverse response, measured estimate)
+  // are filled at the end.
+  //
+  // The randomised iterations are split in a fixed number of blocks, summed
+  // separately and merged in order, and are shared among fNThreads threads.
+  // The spectra left in fPrior, fEfficiency, fMeasured and fUnfolded are those
+  // of the main unfolding, not of the last randomised one.
+  //
+
+  DenseProblem p;
+  p.fNCellsM = InitStrides(fMeasured,0,fNVariables,p.fStridesM);
+  p.fNCellsT = InitStrides(fPrior   ,0,fNVariables,p.fStridesT);
+  p.fCellM      .reserve(fConditional->GetNbins());
+  p.fCellT      .reserve(fConditional->GetNbins());
+  p.fConditional.reserve(fConditional->GetNbins());
+  for (Long_t iBin=0; iBin<fConditional->GetNbins(); iBin++) {
+    p.fConditional.push_back(fConditional->GetBinContent(iBin,fCoordinates2N));
+    GetCoordinates();
+    p.fCellM.push_back(GetCell(fCoordinatesN_M,p.fStridesM));
+    p.fCellT.push_back(GetCell(fCoordinatesN_T,p.fStridesT));
+  }
+
+  std::vector<Double_t> prior, efficiency, measured, estMeasured, unfolded, inverse(p.fConditional.size());
+  std::vector<Char_t>   priorFilled, unfoldedFilled;
+  ToDense(fPrior     ,p.fStridesT,p.fNCellsT,prior     ,&priorFilled);
+  ToDense(fEfficiency,p.fStridesT,p.fNCellsT,efficiency,0x0);
+  ToDense(fMeasured  ,p.fStridesM,p.fNCellsM,measured  ,0x0);
+  std::vector<Double_t> priorOrig(prior);
+
+  Int_t    iIterBayes   = 0 ;
+  Double_t convergence  = 0.;
+  Bool_t   priorUpdated = kFALSE;
+  for (iIterBayes=0; iIterBayes<fMaxNumIterations; iIterBayes++) { // bayes iterations
+    BayesIteration(p,prior,efficiency,measured,estMeasured,unfolded,unfoldedFilled,&inverse);
+
+    Int_t nEmpty = 0;
+    convergence = GetDenseConvergence(prior,priorFilled,unfolded,nEmpty);
+    if (nEmpty) AliWarning(Form("%d bins with priorValue <= 0. Adding 0 to convergence criterion.",nEmpty));
+    AliDebug(0,Form("convergence at iteration %d is %e",iIterBayes,convergence));
+
+    if (fMaxConvergence>0. && convergence<fMaxConvergence) {
+      fNRandomIterations = iIterBayes;
+      AliDebug(0,Form("convergence is met at iteration %d",iIterBayes));
+      break;
+    }
+
+    // update the prior distribution
+    prior       = unfolded;
+    priorFilled = unfoldedFilled;
+    priorUpdated = kTRUE;
+  } // end bayes iteration
+
+  // fill the THnSparse outputs
+  std::vector<Char_t> estFilled(estMeasured.size());
+  for (UInt_t cell=0; cell<estMeasured.size(); cell++) estFilled[cell] = (estMeasured[cell]>0.);
+  ToSparse(estMeasured,estFilled     ,fMeasuredEstimate);
+  ToSparse(unfolded   ,unfoldedFilled,fUnfolded);
+  ToSparse(prior      ,priorFilled   ,fPrior);
+  if (priorUpdated) fPrior->SetTitle("Prior");
+  for (Long_t iBin=0; iBin<fConditional->GetNbins(); iBin++) {
+    fConditional->GetBinContent(iBin,fCoordinates2N);
+    if (inverse[iBin]>0. || fInverseResponse->GetBinContent(fCoordinates2N)>0.) {
+      fInverseResponse->SetBinContent(fCoordinates2N,inverse[iBin]);
+      fInverseResponse->SetBinError  (fCoordinates2N,0.);
+    }
+  }
+  fUnfoldedFinal = (THnSparse*) fUnfolded->Clone() ;
+
+  AliInfo("\n================================================\nFinished bayes iteration, now calculating errors...\n================================================\n");
+  fNCalcCorrErrors = 1;
+
+  // inputs of the randomised iterations
+  RandomisedSpectrum efficiencyOrig, measuredOrig;
+  GetRandomisedSpectrum(fEfficiencyOrig,p.fStridesT,efficiencyOrig);
+  GetRandomisedSpectrum(fMeasuredOrig  ,p.fStridesM,measuredOrig);
+  std::vector<Long64_t> finalCells;
+  std::vector<Double_t> finalValues;
+  for (Long_t iBin=0; iBin<fUnfoldedFinal->GetNbins(); iBin++) {
+    finalValues.push_back(fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_T));
+    finalCells .push_back(GetCell(fCoordinatesN_T,p.fStridesT));
+  }
+
+  Int_t nRandom = TMath::Max(fNRandomIterations,0);
+  std::vector<UInt_t> seeds(nRandom+1);
+  for (Int_t i=0; i<nRandom; i++) seeds[i] = 1 + fRandom3->Integer(kMaxInt);
+
+  const Int_t nBlocks = TMath::Min(nRandom,kNErrorBlocks);
+  const Long64_t nFinal = finalCells.size();
+  std::vector<Double_t> sumDelta (nBlocks*nFinal,0.);
+  std::vector<Double_t> sumDelta2(nBlocks*nFinal,0.);
+
+  Int_t nThreads = fNThreads>0 ? fNThreads : (Int_t)std::thread::hardware_concurrency();
+  nThreads = TMath::Max(1,TMath::Min(nThreads,nBlocks));
+  AliInfo(Form("Running %d randomised unfoldings on %d thread(s)",nRandom,nThreads));
+
+  std::vector<TRandom3*> randoms(nThreads);
+  for (Int_t iThread=0; iThread<nThreads; iThread++) randoms[iThread] = new TRandom3();
+
+  std::atomic<Int_t> nextBlock(0);
+  std::vector<std::thread> workers;
+  for (Int_t iThread=0; iThread<nThreads; iThread++) {
+    workers.push_back(std::thread([&,iThread]() {
+	  for (Int_t iBlock=nextBlock++; iBlock<nBlocks; iBlock=nextBlock++) {
+	    RunRandomIterations(p,priorOrig,efficiencyOrig,measuredOrig,finalCells,finalValues,fMaxNumIterations,
+				&seeds[0],iBlock*nRandom/nBlocks,(iBlock+1)*nRandom/nBlocks,randoms[iThread],
+				&sumDelta[iBlock*nFinal],&sumDelta2[iBlock*nFinal]);
+	  }
+	}));
+  }
+  for (UInt_t iThread=0; iThread<workers.size(); iThread++) workers[iThread].join();
+  for (Int_t iThread=0; iThread<nThreads; iThread++) delete randoms[iThread];
+
+  // same profile and errors as FillDeltaUnfoldedProfile() and CalculateCorrelatedErrors()
+  Double_t entriesInBin = nRandom;
+  for (Long_t iBin=0; iBin<fUnfoldedFinal->GetNbins(); iBin++) {
+    fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_T);
+    Double_t sum = 0., sum2 = 0.;
+    for (Int_t iBlock=0; iBlock<nBlocks; iBlock++) {
+      sum  += sumDelta [iBlock*nFinal+iBin];
+      sum2 += sumDelta2[iBlock*nFinal+iBin];
+    }
+    Double_t checksigma = 0.;
+    if (entriesInBin > 0.) {
+      Double_t mean   = sum /entriesInBin;
+      Double_t meanx2 = sum2/entriesInBin;
+      fDeltaUnfoldedP->SetBinError  (fCoordinatesN_T,meanx2);
+      fDeltaUnfoldedP->SetBinContent(fCoordinatesN_T,mean);
+      fDeltaUnfoldedN->SetBinContent(fCoordinatesN_T,entriesInBin);
+      if (entriesInBin > 1.) checksigma = TMath::Sqrt((entriesInBin/(entriesInBin-1.))*TMath::Abs(meanx2-mean*mean));
+    }
+    fUnfoldedFinal->SetBinError(fCoordinatesN_T,checksigma);
+  }
+
+  // now errors are calculated
+  fNCalcCorrErrors = 2;
+  AliInfo(Form("\n\n=======================\nFinished at iteration %d : convergence is %e and you required it to be < %e\n=======================\n\n",iIterBayes,convergence,fMaxConvergence));
+}
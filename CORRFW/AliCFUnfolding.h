@@ -36,6 +36,8 @@ class AliCFUnfolding : public TNamed {
   }
 
   void SetNRandomIterations(Int_t n = 100) {fNRandomIterations = n;};
+  void SetUseDenseMatrices(Bool_t b = kTRUE) {fUseDenseMatrices = b;} // iterate on flat arrays (default), ignored when smoothing
+  void SetNThreads(Int_t n = 1)              {fNThreads = n;}         // threads for the correlated error iterations, 0 = one per core
 
   void UseSmoothing(TF1* fcn=0x0, Option_t* opt="iremn") { // if fcn=0x0 then smooth using neighbouring bins 
     fUseSmoothing=kTRUE;                                   // this function must NOT be used if fNVariables > 3
@@ -111,6 +113,8 @@ class AliCFUnfolding : public TNamed {
   THnSparse     *fDeltaUnfoldedN;    // Entries of the delta-unfolded distribution (count for each bin)
   Short_t        fNCalcCorrErrors;   // Book-keeping to prevend infinite loop
   UInt_t         fRandomSeed;        // Random seed
+  Bool_t         fUseDenseMatrices;  // Run the iterations on flat arrays when the spectra are small enough
+  Int_t          fNThreads;          // Number of threads running the randomised iterations (dense mode only)
 
 
   // functions
@@ -132,7 +136,11 @@ class AliCFUnfolding : public TNamed {
   void     FillDeltaUnfoldedProfile();  // Fills the fDeltaUnfoldedP profile
   void     SetMaxConvergencePerDOF (Double_t val);
 
-  ClassDef(AliCFUnfolding,1);
+  /* dense fast path */
+  Bool_t   CanUnfoldDense() const;      // checks the spectra fit in flat arrays and no smoothing is required
+  void     UnfoldDense();               // Unfold() and CalculateCorrelatedErrors() running on flat arrays
+
+  ClassDef(AliCFUnfolding,2);
 };
 
 #endif
@@ -11,6 +11,7 @@
 #pragma link C++ class  AliCFContainer+;
 #pragma link C++ class  AliCFManager+;
 #pragma link C++ class  AliCFCutBase+;
+#pragma link C++ class  AliCFCutChain+;
 #pragma link C++ class  AliCFEventClassCuts+;
 #pragma link C++ class  AliCFEventClassCuts+;
 #pragma link C++ class  AliCFEventGenCuts+;
@@ -8,6 +8,8 @@
 //          Martin Vala (martin.vala@cern.ch)
 //
 
+#include <TMath.h>
+
 #include "AliLog.h"
 #include "AliESDEvent.h"
 #include "AliAODEvent.h"
@@ -27,7 +29,10 @@ AliMixEventCutObj::AliMixEventCutObj(AliMixEventCutObj::EEPAxis_t type, Float_t
    fCutMax(max),
    fCutStep(step),
    fCutSmallVal(0),
-   fCurrentVal(min)
+   fCurrentVal(min),
+   fBinEdges(),
+   fCurrentBin(-1),
+   fLowEdges()
 {
    //
    // Default constructor
@@ -37,6 +42,30 @@ AliMixEventCutObj::AliMixEventCutObj(AliMixEventCutObj::EEPAxis_t type, Float_t
    AliDebug(AliLog::kDebug + 5, "->");
 }
 
+//_________________________________________________________________________________________________
+AliMixEventCutObj::AliMixEventCutObj(AliMixEventCutObj::EEPAxis_t type, Int_t nBins, const Double_t *edges, const char *opt) : TObject(),
+   fCutType((Int_t)type),
+   fCutOpt(opt),
+   fCutMin(nBins > 0 ? edges[0] : 0),
+   fCutMax(nBins > 0 ? edges[nBins] : 0),
+   fCutStep(nBins > 0 ? (edges[nBins] - edges[0]) / nBins : 0),
+   fCutSmallVal(0),
+   fCurrentVal(fCutMin),
+   fBinEdges(nBins > 0 ? nBins + 1 : 0, edges),
+   fCurrentBin(-1),
+   fLowEdges()
+{
+   //
+   // Constructor with variable bin widths
+   //
+   AliDebug(AliLog::kDebug + 5, "<-");
+   for (Int_t i = 0; i < nBins; i++) {
+      if (edges[i + 1] <= edges[i]) AliError("Bin edges are not increasing !!! This cut will not work !!!");
+   }
+   if (fCutStep < 1e-5) AliError("fCutStep is too small !!! This cut will not work !!!");
+   AliDebug(AliLog::kDebug + 5, "->");
+}
+
 //_________________________________________________________________________________________________
 AliMixEventCutObj::AliMixEventCutObj(const AliMixEventCutObj &obj) : TObject(obj),
    fCutType(obj.fCutType),
@@ -45,7 +74,10 @@ AliMixEventCutObj::AliMixEventCutObj(const AliMixEventCutObj &obj) : TObject(obj
    fCutMax(obj.fCutMax),
    fCutStep(obj.fCutStep),
    fCutSmallVal(obj.fCutSmallVal),
-   fCurrentVal(obj.fCurrentVal)
+   fCurrentVal(obj.fCurrentVal),
+   fBinEdges(obj.fBinEdges),
+   fCurrentBin(obj.fCurrentBin),
+   fLowEdges()
 {
    //
    // Copy constructor
@@ -69,6 +101,9 @@ AliMixEventCutObj &AliMixEventCutObj::operator=(const AliMixEventCutObj &obj)
       fCutStep = obj.fCutStep;
       fCutSmallVal = obj.fCutSmallVal;
       fCurrentVal = obj.fCurrentVal;
+      fBinEdges = obj.fBinEdges;
+      fCurrentBin = obj.fCurrentBin;
+      fLowEdges.Set(0);
 //       fNoMore = obj.fNoMore;
    }
    return *this;
@@ -83,6 +118,7 @@ void AliMixEventCutObj::Reset()
    //
    AliDebug(AliLog::kDebug + 5, "<-");
    fCurrentVal = fCutMin - fCutStep;
+   fCurrentBin = -1;
    AliDebug(AliLog::kDebug + 5, "->");
 }
 //_________________________________________________________________________________________________
@@ -91,6 +127,7 @@ Bool_t AliMixEventCutObj::HasMore() const
    //
    // Return kTRUE when fCurrentVal is in interval of cut range
    //
+   if (fBinEdges.GetSize() > 1) return (fCurrentBin + 1 < fBinEdges.GetSize() - 1);
    return ((fCurrentVal + fCutStep) < fCutMax);
 }
 
@@ -100,9 +137,24 @@ void AliMixEventCutObj::AddStep()
    //
    // Adds step
    //
+   if (fBinEdges.GetSize() > 1) {
+      fCurrentBin++;
+      fCurrentVal = fBinEdges[fCurrentBin];
+      return;
+   }
    fCurrentVal += fCutStep;
 }
 
+//_________________________________________________________________________________________________
+Float_t AliMixEventCutObj::GetCurrentMax() const
+{
+   //
+   // Returns upper edge of current interval
+   //
+   if (fBinEdges.GetSize() > 1 && fCurrentBin >= 0) return fBinEdges[fCurrentBin + 1];
+   return fCurrentVal + fCutStep - fCutSmallVal;
+}
+
 //_________________________________________________________________________________________________
 void AliMixEventCutObj::Print(const Option_t *) const
 {
@@ -124,10 +176,26 @@ void AliMixEventCutObj::PrintCurrentInterval()
 Int_t AliMixEventCutObj::GetNumberOfBins() const
 {
    //
-   // Returns number of bins
+   // Returns number of bins (same number of steps as done by Reset(), AddStep() and HasMore())
    //
+   if (fBinEdges.GetSize() > 1) return fBinEdges.GetSize() - 1;
    if (fCutStep < 1e-5) return -1;
-   return (Int_t)((fCutMax - fCutMin) / fCutStep);
+   if (!fLowEdges.GetSize()) FillLowEdges();
+   return fLowEdges.GetSize();
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventCutObj::FillLowEdges() const
+{
+   //
+   // Caches lower edges of fixed step bins. They are accumulated
+   // in Float_t as when stepping through the cut intervals.
+   //
+   Int_t n = 0;
+   for (Float_t iCurrent = fCutMin; iCurrent < fCutMax; iCurrent += fCutStep) n++;
+   fLowEdges.Set(n);
+   n = 0;
+   for (Float_t iCurrent = fCutMin; iCurrent < fCutMax; iCurrent += fCutStep) fLowEdges[n++] = iCurrent;
 }
 
 //_________________________________________________________________________________________________
@@ -137,13 +205,15 @@ Int_t AliMixEventCutObj::GetBinNumber(Float_t num) const
    // Returns bin (index) number in current cut.
    // Returns -1 in case of out of range
    //
-   Int_t binNum = 0;
-   for (Float_t iCurrent = fCutMin; iCurrent < fCutMax; iCurrent += fCutStep) {
-      binNum++;
-      if ((num >= iCurrent) && (num < iCurrent + fCutStep - fCutSmallVal)) {
-         return binNum;
-      }
+   if (fBinEdges.GetSize() > 1) {
+      if (num < fBinEdges[0] || num >= fBinEdges[fBinEdges.GetSize() - 1]) return -1;
+      return TMath::BinarySearch(fBinEdges.GetSize(), fBinEdges.GetArray(), (Double_t)num) + 1;
    }
+   if (fCutStep < 1e-5) return -1;
+   if (!fLowEdges.GetSize()) FillLowEdges();
+   Int_t bin = TMath::BinarySearch(fLowEdges.GetSize(), fLowEdges.GetArray(), num);
+   if (bin < 0) return -1;
+   if (num < fLowEdges[bin] + fCutStep - fCutSmallVal) return bin + 1;
    return -1;
 }
 
@@ -322,6 +392,7 @@ void AliMixEventCutObj::SetCurrentValueToIndex(Int_t index)
    //
 
    fCurrentVal = fCutMin;
+   fCurrentBin = 0;
    for (Int_t i = 0; i < index-1; i++) AddStep();
 }
 
@@ -13,6 +13,8 @@
 
 #include <TObject.h>
 #include <TString.h>
+#include <TArrayD.h>
+#include <TArrayF.h>
 
 class AliVEvent;
 class AliAODEvent;
@@ -24,6 +26,8 @@ public:
                   };
 
    AliMixEventCutObj(AliMixEventCutObj::EEPAxis_t type = kMultiplicity, Float_t min = 0.0, Float_t max = 0.0, Float_t step = 1.0, const char *opt = "");
+   // cut with variable bin widths (nBins+1 edges)
+   AliMixEventCutObj(AliMixEventCutObj::EEPAxis_t type, Int_t nBins, const Double_t *edges, const char *opt = "");
    AliMixEventCutObj(const AliMixEventCutObj &obj);
    AliMixEventCutObj &operator=(const AliMixEventCutObj &obj);
 
@@ -37,7 +41,7 @@ public:
 
    Int_t       GetNumberOfBins() const;
    Float_t     GetCurrentMin() const { return fCurrentVal; }
-   Float_t     GetCurrentMax() const { return fCurrentVal + fCutStep - fCutSmallVal; }
+   Float_t     GetCurrentMax() const;
    Float_t     GetMin() const { return fCutMin; }
    Float_t     GetMax() const { return fCutMax; }
    Float_t     GetStep() const { return fCutStep; }
@@ -64,7 +68,13 @@ private:
 
    Float_t     fCurrentVal;    // current value
 
-   ClassDef(AliMixEventCutObj, 3)
+   TArrayD     fBinEdges;      // variable bin edges (empty for fixed step)
+   Int_t       fCurrentBin;    //! current bin (variable bin edges)
+   mutable TArrayF fLowEdges;  //! lower edges of fixed step bins
+
+   void        FillLowEdges() const;
+
+   ClassDef(AliMixEventCutObj, 4)
 };
 
 #endif
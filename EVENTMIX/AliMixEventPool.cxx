@@ -8,10 +8,16 @@
 //        Martin Vala (martin.vala@cern.ch)
 //
 
+#include <algorithm>
+#include <vector>
+
 #include <TEntryList.h>
+#include <TMath.h>
 
 #include "AliLog.h"
 #include "AliMixEventCutObj.h"
+#include "AliMixEventRingBuffer.h"
+#include "AliMixEventSnapshot.h"
 
 #include "AliMixEventPool.h"
 
@@ -23,7 +29,15 @@ AliMixEventPool::AliMixEventPool(const char *name, const char *title) : TNamed(n
    fListOfEventCuts(),
    fBinNumber(0),
    fBufferSize(0),
-   fMixNumber(0)
+   fMixNumber(0),
+   fMaxEventsPerBin(0),
+   fMaxBytesPerBin(0),
+   fMaxBytesTotal(0),
+   fListOfRingBuffers(),
+   fMemorySize(0),
+   fNumSnapshots(0),
+   fBinStrides(),
+   fBinCounts()
 {
    //
    // Default constructor.
@@ -37,7 +51,15 @@ AliMixEventPool::AliMixEventPool(const AliMixEventPool &obj) : TNamed(obj),
    fListOfEventCuts(obj.fListOfEventCuts),
    fBinNumber(obj.fBinNumber),
    fBufferSize(obj.fBufferSize),
-   fMixNumber(obj.fMixNumber)
+   fMixNumber(obj.fMixNumber),
+   fMaxEventsPerBin(obj.fMaxEventsPerBin),
+   fMaxBytesPerBin(obj.fMaxBytesPerBin),
+   fMaxBytesTotal(obj.fMaxBytesTotal),
+   fListOfRingBuffers(),
+   fMemorySize(0),
+   fNumSnapshots(0),
+   fBinStrides(),
+   fBinCounts()
 {
    //
    // Copy constructor
@@ -59,6 +81,14 @@ AliMixEventPool &AliMixEventPool::operator=(const AliMixEventPool &obj)
       fBinNumber = obj.fBinNumber;
       fBufferSize = obj.fBufferSize;
       fMixNumber = obj.fMixNumber;
+      fMaxEventsPerBin = obj.fMaxEventsPerBin;
+      fMaxBytesPerBin = obj.fMaxBytesPerBin;
+      fMaxBytesTotal = obj.fMaxBytesTotal;
+      fListOfRingBuffers.Delete();
+      fMemorySize = 0;
+      fNumSnapshots = 0;
+      fBinStrides.Set(0);
+      fBinCounts.Set(0);
    }
    return *this;
 }
@@ -71,6 +101,7 @@ AliMixEventPool::~AliMixEventPool()
    // Destructor
    //
    AliDebug(AliLog::kDebug + 5, "<-");
+   fListOfRingBuffers.Delete();
    AliDebug(AliLog::kDebug + 5, "->");
 }
 //_________________________________________________________________________________________________
@@ -80,6 +111,7 @@ void AliMixEventPool::AddCut(AliMixEventCutObj *cut)
    // Adds cut
    //
    if (cut && cut->IsValid()) fListOfEventCuts.Add(new AliMixEventCutObj(*cut));
+   fBinStrides.Set(0);
 }
 //_________________________________________________________________________________________________
 void AliMixEventPool::Print(const Option_t *option) const
@@ -185,6 +217,26 @@ Bool_t AliMixEventPool::AddEntry(Long64_t entry, AliVEvent *ev)
    return kFALSE;
 }
 
+//_________________________________________________________________________________________________
+void AliMixEventPool::InitBinStrides()
+{
+   //
+   // Computes strides of cut axes in bin index. First cut is the fastest
+   // changing one, as in CreateEntryListsRecursivly()
+   //
+   Int_t num = fListOfEventCuts.GetEntriesFast();
+   fBinStrides.Set(num);
+   fBinCounts.Set(num);
+   Int_t stride = 1;
+   AliMixEventCutObj *cut;
+   for (Int_t i = 0; i < num; i++) {
+      cut = (AliMixEventCutObj *) fListOfEventCuts.UncheckedAt(i);
+      fBinStrides[i] = stride;
+      fBinCounts[i] = cut->GetNumberOfBins();
+      stride *= fBinCounts[i];
+   }
+}
+
 //_________________________________________________________________________________________________
 TEntryList *AliMixEventPool::FindEntryList(AliVEvent *ev, Int_t &idEntryList)
 {
@@ -194,38 +246,68 @@ TEntryList *AliMixEventPool::FindEntryList(AliVEvent *ev, Int_t &idEntryList)
    AliDebug(AliLog::kDebug + 5, "<-");
    Int_t num = fListOfEventCuts.GetEntriesFast();
    if (num < 1) return 0;
-   Int_t *indexes = new Int_t[num] ;
-   Int_t *lenght = new Int_t[num];
-   Int_t i = 0;
-   TObjArrayIter next(&fListOfEventCuts);
+   if (fBinStrides.GetSize() != num) InitBinStrides();
+   Int_t index = 0, binIndex;
    AliMixEventCutObj *cut;
-   while ((cut = (AliMixEventCutObj *) next())) {
-      indexes[i] = cut->GetIndex(ev);
-      if (indexes[i] < 0) {
+   for (Int_t i = 0; i < num; i++) {
+      cut = (AliMixEventCutObj *) fListOfEventCuts.UncheckedAt(i);
+      binIndex = cut->GetIndex(ev);
+      if (binIndex < 0) {
          AliDebug(AliLog::kDebug, Form("idEntryList %d", -1));
-         delete [] indexes;
-         delete [] lenght;
          return 0;
       }
-      lenght[i] = cut->GetNumberOfBins();
-      AliDebug(AliLog::kDebug + 1, Form("indexes[%d] %d", i, indexes[i]));
-      i++;
+      AliDebug(AliLog::kDebug + 1, Form("indexes[%d] %d", i, binIndex));
+      index += (binIndex - 1) * fBinStrides[i];
    }
-   idEntryList = 0;
-   SearchIndexRecursive(fListOfEventCuts.GetEntries() - 1, &indexes[0], &lenght[0], idEntryList);
+   // index which start with 1
+   idEntryList = index + 1;
    AliDebug(AliLog::kDebug, Form("idEntryList %d", idEntryList - 1));
-   // index which start with 0 (idEntryList-1)
-   delete [] indexes;
-   delete [] lenght;
    AliDebug(AliLog::kDebug + 5, "->");
-   return (TEntryList *) fListOfEntryList.At(idEntryList - 1);
+   return (TEntryList *) fListOfEntryList.At(index);
+}
+
+//_________________________________________________________________________________________________
+Int_t AliMixEventPool::GetNeighbourBins(Int_t idEntryList, TArrayI &neighbours, Int_t distance)
+{
+   //
+   // Fills neighbours with idEntryList of bins which differ by at most
+   // distance bins on each cut axis, sorted by distance (bin itself excluded)
+   //
+   neighbours.Set(0);
+   Int_t num = fListOfEventCuts.GetEntriesFast();
+   if (num < 1 || idEntryList < 1 || distance < 1) return 0;
+   if (fBinStrides.GetSize() != num) InitBinStrides();
+
+   std::vector<Int_t> center(num), offset(num, -distance);
+   for (Int_t i = 0; i < num; i++) center[i] = ((idEntryList - 1) / fBinStrides[i]) % fBinCounts[i];
+
+   // (distance, idEntryList) of all bins in the box around center
+   std::vector<std::pair<Int_t, Int_t> > found;
+   while (kTRUE) {
+      Int_t index = 0, dist = 0, i;
+      for (i = 0; i < num; i++) {
+         Int_t bin = center[i] + offset[i];
+         if (bin < 0 || bin >= fBinCounts[i]) break;
+         index += bin * fBinStrides[i];
+         dist = TMath::Max(dist, TMath::Abs(offset[i]));
+      }
+      if (i == num && dist > 0) found.push_back(std::make_pair(dist, index + 1));
+      // next offset
+      for (i = 0; i < num && ++offset[i] > distance; i++) offset[i] = -distance;
+      if (i == num) break;
+   }
+   std::stable_sort(found.begin(), found.end());
+
+   neighbours.Set(found.size());
+   for (UInt_t i = 0; i < found.size(); i++) neighbours[i] = found[i].second;
+   return neighbours.GetSize();
 }
 
 //_________________________________________________________________________________________________
 void AliMixEventPool::SearchIndexRecursive(Int_t num, Int_t *i, Int_t *d, Int_t &index)
 {
    //
-   // Search for index of entrylist
+   // Search for index of entrylist (not used anymore, see FindEntryList)
    //
    AliDebug(AliLog::kDebug + 5, "<-");
    if (num > 0) {
@@ -289,3 +371,81 @@ Bool_t AliMixEventPool::SetCutValuesFromBinIndex(Int_t index)
 
    return kTRUE;
 }
+
+//_________________________________________________________________________________________________
+void AliMixEventPool::SetInMemory(Int_t maxEventsPerBin, Long64_t maxBytesPerBin, Long64_t maxBytesTotal)
+{
+   //
+   // Enables in-memory mixing. Each bin keeps the last maxEventsPerBin
+   // snapshots, limited to maxBytesPerBin. When maxBytesTotal is reached,
+   // oldest snapshots of the least recently used bins are removed.
+   //
+   fMaxEventsPerBin = maxEventsPerBin;
+   fMaxBytesPerBin = maxBytesPerBin;
+   fMaxBytesTotal = maxBytesTotal;
+   fListOfRingBuffers.Delete();
+   fMemorySize = 0;
+}
+
+//_________________________________________________________________________________________________
+AliMixEventRingBuffer *AliMixEventPool::GetRingBuffer(Int_t idEntryList)
+{
+   //
+   // Returns ring buffer of bin idEntryList (same numbering as FindEntryList)
+   //
+   if (!IsInMemory() || idEntryList < 1 || idEntryList > fListOfEntryList.GetEntriesFast()) return 0;
+   if (fListOfRingBuffers.GetSize() < fListOfEntryList.GetEntriesFast()) fListOfRingBuffers.Expand(fListOfEntryList.GetEntriesFast());
+   AliMixEventRingBuffer *rb = (AliMixEventRingBuffer *) fListOfRingBuffers.At(idEntryList - 1);
+   if (!rb) {
+      rb = new AliMixEventRingBuffer(fMaxEventsPerBin);
+      fListOfRingBuffers.AddAt(rb, idEntryList - 1);
+   }
+   return rb;
+}
+
+//_________________________________________________________________________________________________
+AliMixEventSnapshot *AliMixEventPool::AddSnapshot(Int_t idEntryList, AliVEvent *ev, Long64_t entry, const AliMixEventSnapshot *prototype)
+{
+   //
+   // Stores snapshot of event in ring buffer of bin idEntryList
+   //
+   AliMixEventRingBuffer *rb = GetRingBuffer(idEntryList);
+   if (!rb || !prototype) return 0;
+   fMemorySize -= rb->GetMemorySize();
+   AliMixEventSnapshot *s = rb->NextSlot(prototype);
+   s->Fill(ev);
+   s->SetEntry(entry);
+   rb->SetLastUsed(fNumSnapshots++);
+   if (fMaxBytesPerBin > 0) {
+      while (rb->GetN() > 1 && rb->GetMemorySize() > fMaxBytesPerBin) rb->RemoveOldest();
+   }
+   fMemorySize += rb->GetMemorySize();
+   if (fMaxBytesTotal > 0 && fMemorySize > fMaxBytesTotal) EvictLeastRecentlyUsed(rb);
+   AliDebug(AliLog::kDebug + 1, Form("Snapshot %lld added to bin %d (memory %lld)", entry, idEntryList, fMemorySize));
+   return s;
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventPool::EvictLeastRecentlyUsed(AliMixEventRingBuffer *keep)
+{
+   //
+   // Removes oldest snapshots of the least recently used bins until
+   // memory is below fMaxBytesTotal (bin keep is the last to be touched)
+   //
+   AliMixEventRingBuffer *rb, *lru;
+   while (fMemorySize > fMaxBytesTotal) {
+      lru = 0;
+      for (Int_t i = 0; i < fListOfRingBuffers.GetEntriesFast(); i++) {
+         rb = (AliMixEventRingBuffer *) fListOfRingBuffers.At(i);
+         if (!rb || rb == keep || !rb->GetN()) continue;
+         if (!lru || rb->GetLastUsed() < lru->GetLastUsed()) lru = rb;
+      }
+      if (!lru) {
+         if (keep->GetN() <= 1) break;
+         lru = keep;
+      }
+      fMemorySize -= lru->GetMemorySize();
+      lru->RemoveOldest();
+      fMemorySize += lru->GetMemorySize();
+   }
+}
@@ -13,9 +13,12 @@
 
 #include <TObjArray.h>
 #include <TNamed.h>
+#include <TArrayI.h>
 
 class TEntryList;
 class AliMixEventCutObj;
+class AliMixEventRingBuffer;
+class AliMixEventSnapshot;
 class AliVEvent;
 class AliMixEventPool : public TNamed {
 public:
@@ -36,6 +39,8 @@ public:
 
    Bool_t      AddEntry(Long64_t entry, AliVEvent *ev);
    TEntryList *FindEntryList(AliVEvent *ev, Int_t &idEntryList);
+   // fills idEntryList of bins around idEntryList (up to distance bins on each axis), closest first
+   Int_t       GetNeighbourBins(Int_t idEntryList, TArrayI &neighbours, Int_t distance = 1);
 
    void        AddCut(AliMixEventCutObj *cut);
 
@@ -49,6 +54,13 @@ public:
    Int_t       GetBufferSize() const { return fBufferSize; }
    Int_t       GetMixNumber() const { return fMixNumber; }
 
+   // in-memory mixing (snapshots of events are kept in ring buffer per bin)
+   void        SetInMemory(Int_t maxEventsPerBin, Long64_t maxBytesPerBin = 0, Long64_t maxBytesTotal = 0);
+   Bool_t      IsInMemory() const { return fMaxEventsPerBin > 0; }
+   AliMixEventRingBuffer *GetRingBuffer(Int_t idEntryList);
+   AliMixEventSnapshot   *AddSnapshot(Int_t idEntryList, AliVEvent *ev, Long64_t entry, const AliMixEventSnapshot *prototype);
+   Long64_t    GetMemorySize() const { return fMemorySize; }
+
 private:
 
    TObjArray   fListOfEntryList;       // list of entry lists
@@ -58,7 +70,19 @@ private:
    Int_t       fBufferSize;            // buffer size
    Int_t       fMixNumber;             // mixing number
 
-   ClassDef(AliMixEventPool, 1)
+   Int_t       fMaxEventsPerBin;       // number of snapshots per bin (in-memory mixing)
+   Long64_t    fMaxBytesPerBin;        // memory limit per bin (0 = no limit)
+   Long64_t    fMaxBytesTotal;         // memory limit for all bins (0 = no limit)
+   TObjArray   fListOfRingBuffers;     //! ring buffers of snapshots per bin
+   Long64_t    fMemorySize;            //! memory used by snapshots
+   Long64_t    fNumSnapshots;          //! number of snapshots added (used as LRU clock)
+   TArrayI     fBinStrides;            //! stride of each cut axis in bin index
+   TArrayI     fBinCounts;             //! number of bins of each cut axis
+
+   void        EvictLeastRecentlyUsed(AliMixEventRingBuffer *keep);
+   void        InitBinStrides();
+
+   ClassDef(AliMixEventPool, 2)
 };
 
 #endif
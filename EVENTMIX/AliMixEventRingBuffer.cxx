@@ -0,0 +1,88 @@
+//
+// Class AliMixEventRingBuffer
+//
+// AliMixEventRingBuffer holds the last N event snapshots of one
+// AliMixEventPool bin. When full, the oldest snapshot is reused.
+//
+
+#include <TClass.h>
+
+#include "AliMixEventSnapshot.h"
+
+#include "AliMixEventRingBuffer.h"
+
+ClassImp(AliMixEventRingBuffer)
+
+//_________________________________________________________________________________________________
+AliMixEventRingBuffer::AliMixEventRingBuffer(Int_t capacity) : TObject(),
+   fSnapshots(capacity > 0 ? capacity : 1),
+   fCapacity(capacity > 0 ? capacity : 1),
+   fFirst(0),
+   fN(0),
+   fLastUsed(-1)
+{
+   //
+   // Default constructor.
+   //
+   fSnapshots.SetOwner(kTRUE);
+}
+
+//_________________________________________________________________________________________________
+AliMixEventRingBuffer::~AliMixEventRingBuffer()
+{
+   //
+   // Destructor
+   //
+   fSnapshots.Delete();
+}
+
+//_________________________________________________________________________________________________
+AliMixEventSnapshot *AliMixEventRingBuffer::NextSlot(const AliMixEventSnapshot *prototype)
+{
+   //
+   // Returns snapshot which should be filled with the new event
+   //
+   Int_t slot = (fFirst + fN) % fCapacity;
+   if (fN == fCapacity) fFirst = (fFirst + 1) % fCapacity;
+   else fN++;
+   AliMixEventSnapshot *s = (AliMixEventSnapshot *) fSnapshots.At(slot);
+   if (!s) {
+      s = (AliMixEventSnapshot *) prototype->IsA()->New();
+      fSnapshots.AddAt(s, slot);
+   }
+   s->Clear();
+   return s;
+}
+
+//_________________________________________________________________________________________________
+AliMixEventSnapshot *AliMixEventRingBuffer::GetSnapshot(Int_t age) const
+{
+   //
+   // Returns snapshot (age 0 is the most recent one)
+   //
+   if (age < 0 || age >= fN) return 0;
+   return (AliMixEventSnapshot *) fSnapshots.At((fFirst + fN - 1 - age) % fCapacity);
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventRingBuffer::RemoveOldest()
+{
+   //
+   // Removes oldest snapshot and frees its memory
+   //
+   if (!fN) return;
+   delete fSnapshots.RemoveAt(fFirst);
+   fFirst = (fFirst + 1) % fCapacity;
+   fN--;
+}
+
+//_________________________________________________________________________________________________
+Long64_t AliMixEventRingBuffer::GetMemorySize() const
+{
+   //
+   // Returns memory used by stored snapshots
+   //
+   Long64_t size = 0;
+   for (Int_t i = 0; i < fN; i++) size += GetSnapshot(i)->GetMemorySize();
+   return size;
+}
@@ -0,0 +1,44 @@
+//
+// Class AliMixEventRingBuffer
+//
+// AliMixEventRingBuffer holds the last N event snapshots of one
+// AliMixEventPool bin. When full, the oldest snapshot is reused.
+//
+
+#ifndef ALIMIXEVENTRINGBUFFER_H
+#define ALIMIXEVENTRINGBUFFER_H
+
+#include <TObjArray.h>
+
+class AliMixEventSnapshot;
+class AliMixEventRingBuffer : public TObject {
+public:
+   AliMixEventRingBuffer(Int_t capacity = 1);
+   virtual ~AliMixEventRingBuffer();
+
+   // returns snapshot to be filled (oldest one is reused when buffer is full)
+   AliMixEventSnapshot *NextSlot(const AliMixEventSnapshot *prototype);
+   // returns snapshot by age (0 is the most recent)
+   AliMixEventSnapshot *GetSnapshot(Int_t age) const;
+   void                 RemoveOldest();
+
+   Int_t                GetN() const { return fN; }
+   Int_t                GetCapacity() const { return fCapacity; }
+   Long64_t             GetMemorySize() const;
+   Long64_t             GetLastUsed() const { return fLastUsed; }
+   void                 SetLastUsed(Long64_t counter) { fLastUsed = counter; }
+
+private:
+   TObjArray   fSnapshots;   // snapshots (owned)
+   Int_t       fCapacity;    // maximum number of snapshots
+   Int_t       fFirst;       // slot of the oldest snapshot
+   Int_t       fN;           // number of stored snapshots
+   Long64_t    fLastUsed;    // event counter of the last use (for LRU eviction)
+
+   AliMixEventRingBuffer(const AliMixEventRingBuffer &obj);
+   AliMixEventRingBuffer &operator=(const AliMixEventRingBuffer &obj);
+
+   ClassDef(AliMixEventRingBuffer, 1)
+};
+
+#endif
@@ -0,0 +1,87 @@
+//
+// Class AliMixEventSnapshot
+//
+// AliMixEventSnapshot keeps a slimmed copy of one event (tracks stored
+// as arrays of pt, eta, phi and charge) used by the in-memory mixing of
+// AliMixInputEventHandler. Tasks can derive from it and override Fill()
+// to store their own selection of the event.
+//
+
+#include "AliVEvent.h"
+#include "AliVParticle.h"
+#include "AliVVertex.h"
+
+#include "AliMixEventSnapshot.h"
+
+ClassImp(AliMixEventSnapshot)
+
+//_________________________________________________________________________________________________
+AliMixEventSnapshot::AliMixEventSnapshot() : TObject(),
+   fEntry(-1),
+   fZVertex(0),
+   fPt(),
+   fEta(),
+   fPhi(),
+   fCharge()
+{
+   //
+   // Default constructor.
+   //
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventSnapshot::Fill(AliVEvent *ev)
+{
+   //
+   // Fills snapshot with all tracks of the event
+   //
+   Clear();
+   if (!ev) return;
+   const AliVVertex *v = ev->GetPrimaryVertex();
+   if (v) fZVertex = v->GetZ();
+   Int_t nTracks = ev->GetNumberOfTracks();
+   fPt.reserve(nTracks);
+   fEta.reserve(nTracks);
+   fPhi.reserve(nTracks);
+   fCharge.reserve(nTracks);
+   AliVParticle *track;
+   for (Int_t i = 0; i < nTracks; i++) {
+      track = ev->GetTrack(i);
+      if (track) AddTrack(track->Pt(), track->Eta(), track->Phi(), track->Charge());
+   }
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventSnapshot::Clear(Option_t *)
+{
+   //
+   // Clears tracks (allocated memory is kept for the next event)
+   //
+   fEntry = -1;
+   fZVertex = 0;
+   fPt.clear();
+   fEta.clear();
+   fPhi.clear();
+   fCharge.clear();
+}
+
+//_________________________________________________________________________________________________
+Long64_t AliMixEventSnapshot::GetMemorySize() const
+{
+   //
+   // Returns approximate memory used by snapshot
+   //
+   return sizeof(*this) + fPt.capacity() * (3 * sizeof(Float_t) + sizeof(Short_t));
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventSnapshot::AddTrack(Float_t pt, Float_t eta, Float_t phi, Short_t charge)
+{
+   //
+   // Adds track
+   //
+   fPt.push_back(pt);
+   fEta.push_back(eta);
+   fPhi.push_back(phi);
+   fCharge.push_back(charge);
+}
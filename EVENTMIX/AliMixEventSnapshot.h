@@ -0,0 +1,51 @@
+//
+// Class AliMixEventSnapshot
+//
+// AliMixEventSnapshot keeps a slimmed copy of one event (tracks stored
+// as arrays of pt, eta, phi and charge) used by the in-memory mixing of
+// AliMixInputEventHandler. Tasks can derive from it and override Fill()
+// to store their own selection of the event.
+//
+
+#ifndef ALIMIXEVENTSNAPSHOT_H
+#define ALIMIXEVENTSNAPSHOT_H
+
+#include <vector>
+
+#include <TObject.h>
+
+class AliVEvent;
+class AliMixEventSnapshot : public TObject {
+public:
+   AliMixEventSnapshot();
+   virtual ~AliMixEventSnapshot() {}
+
+   // fills snapshot from event (default: all tracks)
+   virtual void      Fill(AliVEvent *ev);
+   virtual void      Clear(Option_t *option = "");
+   // approximate memory used by the snapshot in bytes
+   virtual Long64_t  GetMemorySize() const;
+
+   void              AddTrack(Float_t pt, Float_t eta, Float_t phi, Short_t charge);
+
+   void              SetEntry(Long64_t entry) { fEntry = entry; }
+   Long64_t          GetEntry() const { return fEntry; }
+   Float_t           GetZVertex() const { return fZVertex; }
+   Int_t             GetNTracks() const { return fPt.size(); }
+   const Float_t    *GetPt() const { return fPt.data(); }
+   const Float_t    *GetEta() const { return fEta.data(); }
+   const Float_t    *GetPhi() const { return fPhi.data(); }
+   const Short_t    *GetCharge() const { return fCharge.data(); }
+
+protected:
+   Long64_t             fEntry;     //! entry counter of the stored event
+   Float_t              fZVertex;   //! z of primary vertex
+   std::vector<Float_t> fPt;        //! track pt
+   std::vector<Float_t> fEta;       //! track eta
+   std::vector<Float_t> fPhi;       //! track phi
+   std::vector<Short_t> fCharge;    //! track charge
+
+   ClassDef(AliMixEventSnapshot, 1)
+};
+
+#endif
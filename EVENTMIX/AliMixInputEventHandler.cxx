@@ -17,6 +17,8 @@
 #include "AliInputEventHandler.h"
 
 #include "AliMixEventPool.h"
+#include "AliMixEventRingBuffer.h"
+#include "AliMixEventSnapshot.h"
 #include "AliMixInputEventHandler.h"
 #include "AliMixInputHandlerInfo.h"
 
@@ -43,7 +45,10 @@ AliMixInputEventHandler::AliMixInputEventHandler(const Int_t size, const Int_t m
    fCurrentBinIndex(-1),
    fOfflineTriggerMask(0),
    fCurrentMixEntry(),
-   fCurrentEntryMainTree(0)
+   fCurrentEntryMainTree(0),
+   fEventSnapshot(0),
+   fCurrentSnapshot(0),
+   fNeighbourBinsDistance(0)
 {
    //
    // Default constructor.
@@ -59,6 +64,7 @@ AliMixInputEventHandler::~AliMixInputEventHandler() {
    // Destructor
    //
    fMixTrees.Clear();
+   delete fEventSnapshot;
 }
 
 //_____________________________________________________________________________
@@ -195,6 +201,10 @@ Bool_t AliMixInputEventHandler::GetEntry()
    if (!fEventPool) {
       MixStd();
    }
+   // if snapshots are kept in memory
+   else if (fEventPool->IsInMemory()) {
+      MixInMemory();
+   }
    // if buffer size is higher then 1
    else if (fBufferSize > 1) {
       MixBuffer();
@@ -495,6 +505,88 @@ Bool_t AliMixInputEventHandler::MixEventsMoreTimesWithBuffer()
    return kFALSE;
 }
 
+//_____________________________________________________________________________
+Bool_t AliMixInputEventHandler::MixInMemory()
+{
+   //
+   // Mix with snapshots of previous events kept in memory by event pool
+   // (no GetEntry of mixed events is done)
+   //
+   AliDebug(AliLog::kDebug + 5, "<-");
+   AliDebug(AliLog::kDebug + 1, "Mix method");
+   // get correct handler
+   AliAnalysisManager *mgr = AliAnalysisManager::GetAnalysisManager();
+   AliMultiInputEventHandler *mh = dynamic_cast<AliMultiInputEventHandler *>(mgr->GetInputEventHandler());
+   AliInputEventHandler *inEvHMain = 0;
+   if (mh) inEvHMain = dynamic_cast<AliInputEventHandler *>(mh->GetFirstInputEventHandler());
+   else inEvHMain = dynamic_cast<AliInputEventHandler *>(mgr->GetInputEventHandler());
+   if (!inEvHMain) return kFALSE;
+
+   // check for PhysSelection
+   if (!IsEventCurrentSelected()) return kFALSE;
+
+   if (!fEventSnapshot) fEventSnapshot = new AliMixEventSnapshot();
+
+   AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ BEGIN SETUP EVENT %lld +++++++++++++++++++", fEntryCounter));
+   // reset mix number
+   fNumberMixed = 0;
+   fCurrentSnapshot = 0;
+   Int_t idEntryList = -1;
+   fEventPool->FindEntryList(inEvHMain->GetEvent(), idEntryList);
+   AliMixEventRingBuffer *rb = fEventPool->GetRingBuffer(idEntryList);
+   if (!rb) {
+      AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ END SETUP EVENT %lld SKIPPED (rb null) +++++++++++++++++++", fEntryCounter));
+      UserExecMixAllTasks(fEntryCounter, -1, fEntryCounter, -1, 0);
+      return kTRUE;
+   }
+
+   // snapshots of current bin first, then of neighbour bins if needed
+   TObjArray snapshots(fMixNumber > 0 ? fMixNumber : 1);
+   for (Int_t i = 0; i < rb->GetN() && snapshots.GetEntriesFast() < fMixNumber; i++) snapshots.Add(rb->GetSnapshot(i));
+   if (fNeighbourBinsDistance > 0 && snapshots.GetEntriesFast() < fMixNumber) {
+      TArrayI neighbours;
+      fEventPool->GetNeighbourBins(idEntryList, neighbours, fNeighbourBinsDistance);
+      for (Int_t iBin = 0; iBin < neighbours.GetSize() && snapshots.GetEntriesFast() < fMixNumber; iBin++) {
+         AliMixEventRingBuffer *rbNeighbour = fEventPool->GetRingBuffer(neighbours[iBin]);
+         for (Int_t i = 0; i < rbNeighbour->GetN() && snapshots.GetEntriesFast() < fMixNumber; i++) snapshots.Add(rbNeighbour->GetSnapshot(i));
+      }
+   }
+
+   Int_t numStored = snapshots.GetEntriesFast();
+   if (!numStored || (!fDoMixIfNotEnoughEvents && numStored < fMixNumber)) {
+      if (!fDoMixIfNotEnoughEvents) idEntryList = -1;
+      UserExecMixAllTasks(fEntryCounter, idEntryList, fEntryCounter, -1, 0);
+      AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ END SETUP EVENT %lld SKIPPED (%d) NOT ENOUGH EVENTS TO MIX => NEED=%d +++++++++++++++++++", fEntryCounter, numStored, fMixNumber));
+   } else {
+      for (Int_t counter = 0; counter < numStored; counter++) {
+         fCurrentSnapshot = (AliMixEventSnapshot *) snapshots.UncheckedAt(counter);
+         fNumberMixed++;
+         // runs UserExecMix for all tasks
+         UserExecMixAllTasks(fEntryCounter, idEntryList, fEntryCounter, fCurrentSnapshot->GetEntry(), fNumberMixed);
+      }
+      fCurrentSnapshot = 0;
+   }
+
+   // current event is stored after mixing, so it is not mixed with itself
+   fEventPool->AddSnapshot(idEntryList, inEvHMain->GetEvent(), fEntryCounter, fEventSnapshot);
+
+   AliDebug(AliLog::kDebug + 3, Form("fEntryCounter=%lld fMixEventNumber=%d", fEntryCounter, fNumberMixed));
+   AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ END SETUP EVENT %lld +++++++++++++++++++", fEntryCounter));
+   AliDebug(AliLog::kDebug + 5, "->");
+   return kTRUE;
+}
+
+//_____________________________________________________________________________
+void AliMixInputEventHandler::SetEventSnapshot(AliMixEventSnapshot *snapshot)
+{
+   //
+   // Sets prototype of snapshot stored for in-memory mixing (handler takes ownership).
+   // Tasks can derive from AliMixEventSnapshot to store only what they need.
+   //
+   if (fEventSnapshot != snapshot) delete fEventSnapshot;
+   fEventSnapshot = snapshot;
+}
+
 //_____________________________________________________________________________
 Bool_t AliMixInputEventHandler::FinishEvent()
 {
@@ -21,6 +21,7 @@
 class TChain;
 class TChainElement;
 class AliMixEventPool;
+class AliMixEventSnapshot;
 class AliMixInputHandlerInfo;
 class AliInputEventHandler;
 class AliMixInputEventHandler : public AliMultiInputEventHandler {
@@ -73,6 +74,14 @@ public:
 
    Bool_t                  GetEntryMainEvent();
    Bool_t                  GetEntryMixedEvent(Int_t idHandler=0);
+
+   // in-memory mixing (enabled by AliMixEventPool::SetInMemory)
+   void                    SetEventSnapshot(AliMixEventSnapshot *snapshot);
+   AliMixEventSnapshot    *GetEventSnapshot() const { return fEventSnapshot; }
+   // takes snapshots also from bins up to distance away when current bin has not enough
+   void                    SetNeighbourBinsDistance(Int_t distance) { fNeighbourBinsDistance = distance; }
+   // snapshot of mixed event (should be used in UserExecMix() only)
+   AliMixEventSnapshot    *GetMixedEventSnapshot() const { return fCurrentSnapshot; }
 protected:
 
    TObjArray               fMixTrees;              // buffer of input handlers
@@ -100,17 +109,22 @@ private:
    TEntryList fCurrentMixEntry;    //! array of mix entries currently used (user should touch)
    Long64_t fCurrentEntryMainTree; //! current entry in current tree (main event)
 
+   AliMixEventSnapshot *fEventSnapshot;   // prototype of snapshot stored for in-memory mixing
+   AliMixEventSnapshot *fCurrentSnapshot; //! snapshot of current mixed event
+   Int_t    fNeighbourBinsDistance; // distance of bins used when current bin has not enough snapshots
+
    virtual Bool_t          MixStd();
    virtual Bool_t          MixBuffer();
    virtual Bool_t          MixEventsMoreTimesWithOneEvent();
    virtual Bool_t          MixEventsMoreTimesWithBuffer();
+   virtual Bool_t          MixInMemory();
 
    void                    UserExecMixAllTasks(Long64_t entryCounter, Int_t idEntryList, Long64_t entryMainReal, Long64_t entryMixReal, Int_t numMixed);
 
    AliMixInputEventHandler(const AliMixInputEventHandler &handler);
    AliMixInputEventHandler &operator=(const AliMixInputEventHandler &handler);
 
-   ClassDef(AliMixInputEventHandler, 5)
+   ClassDef(AliMixInputEventHandler, 7)
 };
 
 #endif
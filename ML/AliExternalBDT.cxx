@@ -12,10 +12,24 @@
 
 #include "AliExternalBDT.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef TREELITE_VERSION_TAG
+#define TREELITE_VERSION_TAG "unknown"
+#endif
 
 namespace {
   inline bool checkFile (const std::string name) {
@@ -27,6 +41,31 @@ namespace {
       return false;
     }
   }
+
+  const std::string kCompileFlags = "-O1 -fPIC";
+
+  std::string gCacheDirectory = getenv("ALIEXTERNALBDT_CACHE_DIR") ? getenv("ALIEXTERNALBDT_CACHE_DIR") : "";
+  std::atomic<int> gCacheHits{0};
+  std::atomic<int> gCacheMisses{0};
+
+  /// creates <path> and all its missing parents, true if the directory exists afterwards
+  inline bool makeDirectories(const std::string &path) {
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+      const std::string dir = path.substr(0, pos);
+      if (!dir.empty() && mkdir(dir.data(), 0755) != 0 && errno != EEXIST) return false;
+      if (pos == std::string::npos) break;
+    }
+    struct stat info;
+    return stat(path.data(), &info) == 0 && S_ISDIR(info.st_mode);
+  }
+
+  /// FNV-1a hash, used to address the cached libraries by content
+  inline void hashBytes(unsigned long long &hash, const char *data, size_t size) {
+    for (size_t iByte = 0; iByte < size; ++iByte) {
+      hash ^= static_cast<unsigned char>(data[iByte]);
+      hash *= 1099511628211ull;
+    }
+  }
 }
 
 AliExternalBDT::AliExternalBDT(std::string name) :
@@ -35,25 +74,51 @@ AliExternalBDT::AliExternalBDT(std::string name) :
   fModelPath{""},
   fModelName{""},
   fCompiler{},
-  fPredictor{}
+  fPredictor{},
+  fEntries{},
+  fBatchOutput{},
+  fNativeForest{}
 {
 }
 
 
-bool AliExternalBDT::CompileAndLoadModelLibrary() {
-  std::string path = GetUniquePath();
+void AliExternalBDT::SetCacheDirectory(std::string dir) {
+  gCacheDirectory = dir;
+}
+
+std::string AliExternalBDT::GetCacheDirectory() {
+  return gCacheDirectory;
+}
+
+int AliExternalBDT::GetCacheHits() {
+  return gCacheHits;
+}
+
+int AliExternalBDT::GetCacheMisses() {
+  return gCacheMisses;
+}
+
+bool AliExternalBDT::CompileAndLoadModelLibrary(const std::string &path) {
   if (checkFile(path + "/main.so")) {
     std::cout << "Library found: " << path.data() << "/main.so . Loading it!" << std::endl;
-  } else {
-    std::cout << "Starting the model compilation, depending on the model size it can take a while..." << std::endl;
-    system((std::string("gcc -c -O1 -fPIC ") + path + "/main.c -o " + path + "/main.o && gcc -shared " + path + \
-          "/main.o -o " + path + "/main.so").data());
+  } else if (!CompileModelLibrary(path)) {
+    return false;
   }
   return LoadModelLibrary(path + "/main.so");
 }
 
-bool AliExternalBDT::CreateModelCode() {
-  std::string path = GetUniquePath();
+bool AliExternalBDT::CompileModelLibrary(const std::string &path) {
+  std::cout << "Starting the model compilation, depending on the model size it can take a while..." << std::endl;
+  system((std::string("gcc -c ") + kCompileFlags + " " + path + "/main.c -o " + path + "/main.o && gcc -shared " + \
+        path + "/main.o -o " + path + "/main.so").data());
+  if (!checkFile(path + "/main.so")) {
+    std::cerr << "Library compilation failed" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool AliExternalBDT::CreateModelCode(const std::string &path) {
   if (checkFile(path + "/main.c")) {
     std::cout << "Code found: " << path.data() << "/main.c . \
       Remove it or unset/change the AliExternalBDT name to force its regeneration." << std::endl;
@@ -72,6 +137,57 @@ bool AliExternalBDT::CreateModelCode() {
   return true;
 }
 
+std::string AliExternalBDT::GetCachePath() {
+  std::ifstream model(fModelPath, std::ios::binary);
+  if (!model) return "";
+  std::stringstream content;
+  content << model.rdbuf();
+  const std::string key = content.str() + "|" + TREELITE_VERSION_TAG + "|" + kCompileFlags;
+  unsigned long long hash = 14695981039346656037ull;
+  hashBytes(hash, key.data(), key.size());
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", hash);
+  return gCacheDirectory + "/" + hex;
+}
+
+bool AliExternalBDT::LoadFromCache(const std::string &cachepath) {
+  if (checkFile(cachepath + "/main.so")) {
+    std::cout << "Cached library found: " << cachepath.data() << "/main.so . Loading it!" << std::endl;
+    ++gCacheHits;
+    return LoadModelLibrary(cachepath + "/main.so");
+  }
+  /// the lock serialises the jobs sharing the cache, the ones waiting load the library built by the first
+  if (!makeDirectories(gCacheDirectory)) {
+    std::cerr << "Cannot create the model cache directory " << gCacheDirectory.data() << std::endl;
+    return false;
+  }
+  const int lock = open((cachepath + ".lock").data(), O_CREAT | O_RDWR, 0644);
+  if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+    std::cerr << "Cannot lock the model cache entry " << cachepath.data() << std::endl;
+    if (lock >= 0) close(lock);
+    return false;
+  }
+  bool status = true;
+  if (checkFile(cachepath + "/main.so")) {
+    ++gCacheHits;
+  } else {
+    ++gCacheMisses;
+    /// under the lock no other job builds this entry, build directories left over by crashed jobs can go
+    system((std::string("rm -rf ") + cachepath + ".tmp*").data());
+    /// build in a private directory and publish it with an atomic rename
+    const std::string buildpath = cachepath + ".tmp" + std::to_string(getpid());
+    status = CreateModelCode(buildpath) && CompileModelLibrary(buildpath) &&
+             rename(buildpath.data(), cachepath.data()) == 0;
+    if (!status) {
+      std::cerr << "Cannot store the compiled model in the cache " << cachepath.data() << std::endl;
+      system((std::string("rm -rf ") + buildpath).data());
+    }
+  }
+  flock(lock, LOCK_UN);
+  close(lock);
+  return status && LoadModelLibrary(cachepath + "/main.so");
+}
+
 std::string AliExternalBDT::GetUniquePath() {
   if (fBDTname.empty()) {
     return fModelName + std::to_string((unsigned long)this);
@@ -103,8 +219,14 @@ bool AliExternalBDT::LoadModel(const std::string &path, int type) {
     std::cerr << "Model loading failed" << std::endl;
     return false;
   }
-  if (!CreateModelCode()) return false;
-  if (!CompileAndLoadModelLibrary()) return false;
+  if (!gCacheDirectory.empty()) {
+    const std::string cachepath = GetCachePath();
+    if (!cachepath.empty() && LoadFromCache(cachepath)) return true;
+    std::cerr << "Model cache not usable, compiling the model without it" << std::endl;
+  }
+  const std::string codepath = GetUniquePath();
+  if (!CreateModelCode(codepath)) return false;
+  if (!CompileAndLoadModelLibrary(codepath)) return false;
   return true;
 }
 
@@ -118,6 +240,21 @@ bool AliExternalBDT::LoadLightGBMModel(std::string path) {
   return true;
 }
 
+bool AliExternalBDT::LoadXGBoostDump(std::string path, const std::vector<std::string> &featureNames,
+    float baseScore) {
+  fModelPath = path;
+  fModelName = fModelPath.substr(fModelPath.find_last_of("\\/")+1,fModelPath.size());
+  if (!fNativeForest.LoadXGBoostDump(fModelPath, featureNames)) return false;
+  fNativeForest.SetBaseScore(baseScore);
+  return true;
+}
+
+bool AliExternalBDT::LoadLightGBMDump(std::string path) {
+  fModelPath = path;
+  fModelName = fModelPath.substr(fModelPath.find_last_of("\\/")+1,fModelPath.size());
+  return fNativeForest.LoadLightGBMDump(fModelPath);
+}
+
 bool AliExternalBDT::LoadModelLibrary(std::string path) {
   const int status = TreelitePredictorLoad(path.data(), 1, &fPredictor);
   if (status != 0) {
@@ -128,16 +265,46 @@ bool AliExternalBDT::LoadModelLibrary(std::string path) {
 }
 
 double AliExternalBDT::Predict(double *features, int size, bool useRawScore) {
-  std::vector<TreelitePredictorEntry> entries(size);
-  for (size_t iEntry = 0; iEntry < entries.size(); ++iEntry) {
-    entries[iEntry].fvalue = static_cast<float>(features[iEntry]);
+  if (fNativeForest.IsLoaded()) return fNativeForest.Predict(features, size, useRawScore);
+  fEntries.resize(size);
+  for (size_t iEntry = 0; iEntry < fEntries.size(); ++iEntry) {
+    fEntries[iEntry].fvalue = static_cast<float>(features[iEntry]);
   }
   size_t out_size{0u};
   TreelitePredictorQueryResultSizeSingleInst(fPredictor, &out_size);
   assert(out_size == 1);
   float output = 0.f;
-  TreelitePredictorPredictInst(fPredictor, entries.data(),
+  TreelitePredictorPredictInst(fPredictor, fEntries.data(),
       static_cast<int>(useRawScore), &output,
       &out_size);
   return output;
 }
+
+bool AliExternalBDT::PredictBatch(const float *matrix, int nRows, int nCols, double *out, bool useRawScore) {
+  if (nRows <= 0) return true;
+  if (fNativeForest.IsLoaded()) {
+    fNativeForest.PredictBatch(matrix, nRows, nCols, out, useRawScore);
+    return true;
+  }
+  /// NaN entries are flagged as missing values, as treelite does for dense matrices
+  DenseBatchHandle batch;
+  const int status_batch = TreeliteAssembleDenseBatch(matrix, std::numeric_limits<float>::quiet_NaN(),
+      static_cast<size_t>(nRows), static_cast<size_t>(nCols), &batch);
+  if (status_batch != 0) {
+    std::cerr << "Batch assembly failed" << std::endl;
+    return false;
+  }
+  size_t out_size{0u};
+  TreelitePredictorQueryResultSize(fPredictor, batch, 0, &out_size);
+  assert(out_size == static_cast<size_t>(nRows));
+  fBatchOutput.resize(out_size);
+  const int status_pred = TreelitePredictorPredictBatch(fPredictor, batch, 0, 0,
+      static_cast<int>(useRawScore), fBatchOutput.data(), &out_size);
+  TreeliteDeleteDenseBatch(batch);
+  if (status_pred != 0) {
+    std::cerr << "Batch prediction failed" << std::endl;
+    return false;
+  }
+  std::copy(fBatchOutput.begin(), fBatchOutput.begin() + nRows, out);
+  return true;
+}
@@ -17,6 +17,7 @@
 
 #include "treelite/c_api.h"
 #include "treelite/c_api_runtime.h"
+#include "AliMLNativeForest.h"
 #include <string>
 #include <vector>
 
@@ -28,12 +29,27 @@ public:
   bool LoadLightGBMModel(std::string path);
   bool LoadModelLibrary(std::string path);
   bool LoadXGBoostModel(std::string path);
+  /// Load JSON dumps in the native evaluator, no code generation nor compilation
+  bool LoadXGBoostDump(std::string path, const std::vector<std::string> &featureNames, float baseScore = 0.5);
+  bool LoadLightGBMDump(std::string path);
+
+  /// Directory of the compiled model cache shared between jobs, empty to disable it.
+  /// Defaults to the ALIEXTERNALBDT_CACHE_DIR environment variable.
+  static void SetCacheDirectory(std::string dir);
+  static std::string GetCacheDirectory();
+  static int GetCacheHits();
+  static int GetCacheMisses();
 
   double Predict(double *features, int size, bool useRaw = false);
+  /// Score nRows candidates at once; matrix is row-major with nCols features per row
+  bool PredictBatch(const float *matrix, int nRows, int nCols, double *out, bool useRaw = false);
 
 private:
-  bool CompileAndLoadModelLibrary();
-  bool CreateModelCode();
+  bool CompileAndLoadModelLibrary(const std::string &path);
+  bool CompileModelLibrary(const std::string &path);
+  bool CreateModelCode(const std::string &path);
+  std::string GetCachePath();
+  bool LoadFromCache(const std::string &cachepath);
   std::string GetUniquePath();
   bool LoadModel(const std::string &path, int type);
 
@@ -43,6 +59,10 @@ private:
   std::string fModelName;
   CompilerHandle fCompiler;
   PredictorHandle fPredictor;
+
+  std::vector<TreelitePredictorEntry> fEntries; /// Reused single instance buffer
+  std::vector<float> fBatchOutput;              /// Reused batch output buffer
+  AliMLNativeForest fNativeForest;              //! Native evaluator, used instead of treelite when loaded
 };
 
 #endif
@@ -0,0 +1,70 @@
+// Copyright CERN. This software is distributed under the terms of the GNU
+// General Public License v3 (GPL Version 3).
+//
+// See http://www.gnu.org/licenses/ for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file AliMLFeatureBinding.cxx
+
+#include "AliMLFeatureBinding.h"
+
+#include <algorithm>
+#include <iostream>
+
+//_______________________________________________________________________________
+AliMLFeatureBinding::AliMLFeatureBinding() : fNames{}, fValues{}, fDoubles{}, fFloats{}, fBound{} {
+  //
+  // Default constructor
+  //
+}
+
+//_______________________________________________________________________________
+AliMLFeatureBinding::AliMLFeatureBinding(const std::vector<std::string> &varnames)
+    : fNames{varnames}, fValues(varnames.size(), 0.), fDoubles(varnames.size(), nullptr),
+      fFloats(varnames.size(), nullptr), fBound{} {
+  //
+  // Standard constructor
+  //
+}
+
+//_______________________________________________________________________________
+int AliMLFeatureBinding::GetHandle(const std::string &varname) const {
+  auto var = std::find(fNames.begin(), fNames.end(), varname);
+  return var == fNames.end() ? -1 : var - fNames.begin();
+}
+
+//_______________________________________________________________________________
+bool AliMLFeatureBinding::Bind(const std::string &varname, const double *address) {
+  int handle = GetHandle(varname);
+  if (handle < 0) {
+    std::cerr << "Variable " << varname << " not used by the models, it cannot be bound" << std::endl;
+    return false;
+  }
+  if (!fDoubles[handle] && !fFloats[handle]) fBound.push_back(handle);
+  fDoubles[handle] = address;
+  fFloats[handle] = nullptr;
+  return true;
+}
+
+//_______________________________________________________________________________
+bool AliMLFeatureBinding::Bind(const std::string &varname, const float *address) {
+  int handle = GetHandle(varname);
+  if (handle < 0) {
+    std::cerr << "Variable " << varname << " not used by the models, it cannot be bound" << std::endl;
+    return false;
+  }
+  if (!fDoubles[handle] && !fFloats[handle]) fBound.push_back(handle);
+  fDoubles[handle] = nullptr;
+  fFloats[handle] = address;
+  return true;
+}
+
+//_______________________________________________________________________________
+void AliMLFeatureBinding::Update() {
+  for (int slot : fBound) {
+    fValues[slot] = fDoubles[slot] ? *fDoubles[slot] : *fFloats[slot];
+  }
+}
@@ -0,0 +1,49 @@
+#ifndef ALIMLFEATUREBINDING_H
+#define ALIMLFEATUREBINDING_H
+
+// Copyright CERN. This software is distributed under the terms of the GNU
+// General Public License v3 (GPL Version 3).
+//
+// See http://www.gnu.org/licenses/ for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file AliMLFeatureBinding.h
+/// \brief Fixed-slot feature vector for AliMLResponse, filled either through
+///        integer handles or through pointers bound to the task variables
+
+#include <string>
+#include <vector>
+
+class AliMLFeatureBinding {
+public:
+  AliMLFeatureBinding();
+  AliMLFeatureBinding(const std::vector<std::string> &varnames);
+  ~AliMLFeatureBinding() {}
+
+  /// return the slot of a variable, -1 if the models do not use it
+  int GetHandle(const std::string &varname) const;
+  /// set the value of a slot obtained with GetHandle
+  void Set(int handle, double value) { fValues[handle] = value; }
+
+  /// bind a slot to a task variable, its value is read at each Update
+  bool Bind(const std::string &varname, const double *address);
+  bool Bind(const std::string &varname, const float *address);
+  /// copy the values of the bound variables into their slots
+  void Update();
+
+  double *GetValues() { return fValues.data(); }
+  int GetNVariables() const { return static_cast<int>(fValues.size()); }
+  std::string const &GetName(int handle) const { return fNames[handle]; }
+
+private:
+  std::vector<std::string> fNames;         /// variable names, in the model order
+  std::vector<double> fValues;             /// feature vector passed to the models
+  std::vector<const double *> fDoubles;    //!<! bound double variables (nullptr if unbound)
+  std::vector<const float *> fFloats;      //!<! bound float variables (nullptr if unbound)
+  std::vector<int> fBound;                 //!<! slots with a bound variable
+};
+
+#endif
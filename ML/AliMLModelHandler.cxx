@@ -26,7 +26,8 @@ ClassImp(AliMLModelHandler);
 /// \endcond
 
 //_______________________________________________________________________________
-AliMLModelHandler::AliMLModelHandler() : TNamed(), fModel{nullptr}, fPath{}, fLibrary{}, fScoreCut{} {
+AliMLModelHandler::AliMLModelHandler()
+    : TNamed(), fModel{nullptr}, fPath{}, fLibrary{}, fScoreCut{}, fBaseScore{0.5}, fFeatureNames{} {
   //
   // Default constructor
   //
@@ -35,7 +36,8 @@ AliMLModelHandler::AliMLModelHandler() : TNamed(), fModel{nullptr}, fPath{}, fLi
 //_______________________________________________________________________________
 AliMLModelHandler::AliMLModelHandler(const YAML::Node &node)
     : TNamed(), fModel{nullptr}, fPath{node["path"].as<std::string>()},
-      fLibrary{node["library"].as<std::string>()}, fScoreCut{node["cut"].as<double>()} {
+      fLibrary{node["library"].as<std::string>()}, fScoreCut{node["cut"].as<double>()},
+      fBaseScore{node["base_score"] ? node["base_score"].as<double>() : 0.5}, fFeatureNames{} {
   //
   // Standard constructor
   //
@@ -53,7 +55,8 @@ AliMLModelHandler::~AliMLModelHandler() {
 //_______________________________________________________________________________
 AliMLModelHandler::AliMLModelHandler(const AliMLModelHandler &source)
     : TNamed(source.GetName(), source.GetTitle()), fModel{nullptr}, fPath{source.fPath},
-      fLibrary{source.fLibrary}, fScoreCut{source.fScoreCut} {
+      fLibrary{source.fLibrary}, fScoreCut{source.fScoreCut}, fBaseScore{source.fBaseScore},
+      fFeatureNames{source.fFeatureNames} {
   //
   // Copy constructor
   //
@@ -75,18 +78,25 @@ AliMLModelHandler &AliMLModelHandler::operator=(const AliMLModelHandler &source)
   fPath      = source.fPath;
   fLibrary   = source.fLibrary;
   fScoreCut  = source.fScoreCut;
+  fBaseScore = source.fBaseScore;
+  fFeatureNames = source.fFeatureNames;
 
   return *this;
 }
 
 //_______________________________________________________________________________
 bool AliMLModelHandler::CompileModel() {
+  return CompileModel(ImportFile(fPath));
+}
+
+//_______________________________________________________________________________
+bool AliMLModelHandler::CompileModel(const std::string &localpath) {
 
   std::map<std::string, int> libraryMap = {{"kXGBoost", AliMLModelHandler::kXGBoost}, 
                                            {"kLightGBM", AliMLModelHandler::kLightGBM},
-                                           {"kModelLibrary", AliMLModelHandler::kModelLibrary}};
-
-  std::string localpath = ImportFile(fPath);
+                                           {"kModelLibrary", AliMLModelHandler::kModelLibrary},
+                                           {"kXGBoostDump", AliMLModelHandler::kXGBoostDump},
+                                           {"kLightGBMDump", AliMLModelHandler::kLightGBMDump}};
 
   switch (libraryMap[GetLibrary()]) {
     case kXGBoost: {
@@ -101,6 +111,14 @@ bool AliMLModelHandler::CompileModel() {
       return fModel->LoadModelLibrary(localpath.data());
       break;
     }
+    case kXGBoostDump: {
+      return fModel->LoadXGBoostDump(localpath.data(), fFeatureNames, fBaseScore);
+      break;
+    }
+    case kLightGBMDump: {
+      return fModel->LoadLightGBMDump(localpath.data());
+      break;
+    }
     default: {
       return fModel->LoadXGBoostModel(localpath.data());
       break;
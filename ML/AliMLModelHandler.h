@@ -15,6 +15,7 @@
 /// \author pietro.fecchio@cern.ch, maximiliano.puccio@cern.ch, fabio.catalano@cern.ch
 
 #include <string>
+#include <vector>
 
 #include "TNamed.h"
 
@@ -25,7 +26,7 @@ class AliExternalBDT;
 
 class AliMLModelHandler : public TNamed {
 public:
-  enum {kXGBoost, kLightGBM, kModelLibrary};
+  enum {kXGBoost, kLightGBM, kModelLibrary, kXGBoostDump, kLightGBMDump};
 
   AliMLModelHandler();
   AliMLModelHandler(const YAML::Node &node);
@@ -38,8 +39,12 @@ public:
   std::string const &GetPath() const { return fPath; }
   std::string const &GetLibrary() const { return fLibrary; }
   double const &GetScoreCut() const { return fScoreCut; }
+  /// feature names used to resolve the splits of the XGBoost dumps
+  void SetFeatureNames(const std::vector<std::string> &names) { fFeatureNames = names; }
 
   bool CompileModel();
+  /// compile a model already imported in localpath, does not use ROOT I/O
+  bool CompileModel(const std::string &localpath);
   static std::string ImportFile(std::string path);
 
 private:
@@ -49,9 +54,12 @@ private:
   std::string fLibrary;    ///
 
   double fScoreCut;        ///
+  double fBaseScore;       /// base_score of XGBoost dumps, not stored in the dump
+
+  std::vector<std::string> fFeatureNames;  //!<!
 
 /// \cond CLASSIMP
-ClassDef(AliMLModelHandler, 1);    ///
+ClassDef(AliMLModelHandler, 2);    ///
 /// \endcond
 };
 
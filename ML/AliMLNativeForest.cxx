@@ -0,0 +1,237 @@
+// Copyright CERN. This software is distributed under the terms of the GNU
+// General Public License v3 (GPL Version 3).
+//
+// See http://www.gnu.org/licenses/ for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file AliMLNativeForest.cxx
+
+#include "AliMLNativeForest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include "yaml-cpp/yaml.h"
+
+namespace {
+  /// candidates walked in lock-step through each tree
+  const int kBlockSize = 8;
+}
+
+//_______________________________________________________________________________
+AliMLNativeForest::AliMLNativeForest()
+    : fNodes{}, fLeafValues{}, fTreeRoots{}, fTreeDepths{}, fInstance{}, fNFeatures{0}, fCurrentDepth{0},
+      fBaseMargin{0.f}, fSigmoidAlpha{1.f} {
+  //
+  // Default constructor
+  //
+}
+
+//_______________________________________________________________________________
+void AliMLNativeForest::SetBaseScore(float baseScore) {
+  /// same conversion of the probability to a margin as treelite for binary:logistic
+  fBaseMargin = -std::log(1.0f / baseScore - 1.0f);
+}
+
+//_______________________________________________________________________________
+int AliMLNativeForest::AddLeaf(float value) {
+  int index = fNodes.size();
+  fNodes.push_back(Node{std::numeric_limits<float>::infinity(), 0, index, index, kDefaultLeft});
+  fLeafValues.push_back(value);
+  return index;
+}
+
+//_______________________________________________________________________________
+int AliMLNativeForest::AddXGBoostNode(const YAML::Node &node, const std::vector<std::string> &featureNames,
+                                      int depth) {
+  fCurrentDepth = std::max(fCurrentDepth, depth);
+  if (node["leaf"]) {
+    return AddLeaf(node["leaf"].as<float>());
+  }
+
+  std::string split = node["split"].as<std::string>();
+  int feature = -1;
+  auto name = std::find(featureNames.begin(), featureNames.end(), split);
+  if (name != featureNames.end()) {
+    feature = name - featureNames.begin();
+  } else if (split.size() > 1 && split[0] == 'f' && split.find_first_not_of("0123456789", 1) == std::string::npos) {
+    feature = std::stoi(split.substr(1));
+  } else {
+    throw std::runtime_error("unknown split feature " + split);
+  }
+  fNFeatures = std::max(fNFeatures, feature + 1);
+
+  int index = fNodes.size();
+  int yes = node["yes"].as<int>();
+  int flags = node["missing"].as<int>() == yes ? kDefaultLeft : 0;
+  fNodes.push_back(Node{node["split_condition"].as<float>(), feature, -1, -1, flags});
+  fLeafValues.push_back(0.f);
+
+  /// children are matched by node id, not by their position in the list
+  const YAML::Node &children = node["children"];
+  if (children.size() != 2) {
+    throw std::runtime_error("split node without two children");
+  }
+  int first = children[0]["nodeid"].as<int>() == yes ? 0 : 1;
+  int left = AddXGBoostNode(children[first], featureNames, depth + 1);
+  int right = AddXGBoostNode(children[1 - first], featureNames, depth + 1);
+  fNodes[index].fLeft = left;
+  fNodes[index].fRight = right;
+  return index;
+}
+
+//_______________________________________________________________________________
+int AliMLNativeForest::AddLightGBMNode(const YAML::Node &node, int depth) {
+  fCurrentDepth = std::max(fCurrentDepth, depth);
+  if (node["leaf_value"]) {
+    return AddLeaf(node["leaf_value"].as<float>());
+  }
+
+  if (node["decision_type"].as<std::string>() != "<=") {
+    throw std::runtime_error("only numerical splits are supported");
+  }
+  int feature = node["split_feature"].as<int>();
+  fNFeatures = std::max(fNFeatures, feature + 1);
+
+  /// value <= t is value < nextafter(t) for floats, the threshold is rounded to float as done by treelite
+  float threshold = std::nextafter(static_cast<float>(node["threshold"].as<double>()),
+                                   std::numeric_limits<float>::infinity());
+  int flags = node["default_left"].as<bool>() ? kDefaultLeft : 0;
+  std::string missing = node["missing_type"] ? node["missing_type"].as<std::string>() : "None";
+  if (missing == "None") {
+    flags |= kNaNAsZero;
+  } else if (missing == "Zero") {
+    flags |= kNaNAsZero | kZeroMissing;
+  }
+
+  int index = fNodes.size();
+  fNodes.push_back(Node{threshold, feature, -1, -1, flags});
+  fLeafValues.push_back(0.f);
+  int left = AddLightGBMNode(node["left_child"], depth + 1);
+  int right = AddLightGBMNode(node["right_child"], depth + 1);
+  fNodes[index].fLeft = left;
+  fNodes[index].fRight = right;
+  return index;
+}
+
+//_______________________________________________________________________________
+bool AliMLNativeForest::LoadXGBoostDump(const std::string &path, const std::vector<std::string> &featureNames) {
+  fNodes.clear();
+  fLeafValues.clear();
+  fTreeRoots.clear();
+  fTreeDepths.clear();
+  fNFeatures = 0;
+  try {
+    YAML::Node trees = YAML::LoadFile(path);
+    for (const auto &tree : trees) {
+      fCurrentDepth = 0;
+      fTreeRoots.push_back(AddXGBoostNode(tree, featureNames, 0));
+      fTreeDepths.push_back(fCurrentDepth);
+    }
+  } catch (std::exception &e) {
+    std::cerr << "XGBoost dump loading failed: " << e.what() << std::endl;
+    fTreeRoots.clear();
+    return false;
+  }
+  fSigmoidAlpha = 1.f;
+  return IsLoaded();
+}
+
+//_______________________________________________________________________________
+bool AliMLNativeForest::LoadLightGBMDump(const std::string &path) {
+  fNodes.clear();
+  fLeafValues.clear();
+  fTreeRoots.clear();
+  fTreeDepths.clear();
+  fNFeatures = 0;
+  fBaseMargin = 0.f;
+  fSigmoidAlpha = 1.f;
+  try {
+    YAML::Node model = YAML::LoadFile(path);
+    if (model["num_tree_per_iteration"] && model["num_tree_per_iteration"].as<int>() != 1) {
+      throw std::runtime_error("only binary classification models are supported");
+    }
+    std::string objective = model["objective"] ? model["objective"].as<std::string>() : "";
+    size_t sigmoid = objective.find("sigmoid:");
+    if (sigmoid != std::string::npos) {
+      fSigmoidAlpha = std::stof(objective.substr(sigmoid + 8));
+    }
+    for (const auto &tree : model["tree_info"]) {
+      fCurrentDepth = 0;
+      fTreeRoots.push_back(AddLightGBMNode(tree["tree_structure"], 0));
+      fTreeDepths.push_back(fCurrentDepth);
+    }
+  } catch (std::exception &e) {
+    std::cerr << "LightGBM dump loading failed: " << e.what() << std::endl;
+    fTreeRoots.clear();
+    return false;
+  }
+  return IsLoaded();
+}
+
+//_______________________________________________________________________________
+inline int AliMLNativeForest::Next(const Node &node, float value) {
+  /// written with selects only, so that the lock-step loops stay branch free
+  float x = (value != value && (node.fFlags & kNaNAsZero)) ? 0.f : value;
+  bool missing = (x != x) || ((node.fFlags & kZeroMissing) && std::fabs(x) <= 1e-35f);
+  bool left = missing ? (node.fFlags & kDefaultLeft) : (x < node.fThreshold);
+  return left ? node.fLeft : node.fRight;
+}
+
+//_______________________________________________________________________________
+float AliMLNativeForest::Transform(float margin, bool useRaw) const {
+  /// same float arithmetic as the treelite generated code
+  margin = margin + fBaseMargin;
+  return useRaw ? margin : 1.0f / (1.0f + std::exp(-fSigmoidAlpha * margin));
+}
+
+//_______________________________________________________________________________
+double AliMLNativeForest::Predict(const double *features, int size, bool useRaw) {
+  fInstance.assign(std::max(size, fNFeatures), std::numeric_limits<float>::quiet_NaN());
+  for (int iFeature = 0; iFeature < size; ++iFeature) {
+    fInstance[iFeature] = static_cast<float>(features[iFeature]);
+  }
+  double score{0.};
+  PredictBatch(fInstance.data(), 1, fInstance.size(), &score, useRaw);
+  return score;
+}
+
+//_______________________________________________________________________________
+void AliMLNativeForest::PredictBatch(const float *matrix, int nRows, int nCols, double *out, bool useRaw) const {
+  if (nCols < fNFeatures) {
+    std::cerr << "The model uses " << fNFeatures << " features, only " << nCols << " given" << std::endl;
+    std::fill(out, out + nRows, std::numeric_limits<double>::quiet_NaN());
+    return;
+  }
+  const Node *nodes = fNodes.data();
+  const float *leaves = fLeafValues.data();
+  int index[kBlockSize];
+  float sum[kBlockSize];
+  for (int first = 0; first < nRows; first += kBlockSize) {
+    const int nBlock = std::min(kBlockSize, nRows - first);
+    const float *rows = matrix + static_cast<size_t>(first) * nCols;
+    std::fill(sum, sum + kBlockSize, 0.f);
+    /// trees are summed in order, as in the compiled code, to get the same float rounding
+    for (size_t iTree = 0; iTree < fTreeRoots.size(); ++iTree) {
+      std::fill(index, index + kBlockSize, fTreeRoots[iTree]);
+      for (int iDepth = 0; iDepth < fTreeDepths[iTree]; ++iDepth) {
+        for (int iRow = 0; iRow < nBlock; ++iRow) {
+          const Node &node = nodes[index[iRow]];
+          index[iRow] = Next(node, rows[iRow * nCols + node.fFeature]);
+        }
+      }
+      for (int iRow = 0; iRow < nBlock; ++iRow) {
+        sum[iRow] += leaves[index[iRow]];
+      }
+    }
+    for (int iRow = 0; iRow < nBlock; ++iRow) {
+      out[first + iRow] = Transform(sum[iRow], useRaw);
+    }
+  }
+}
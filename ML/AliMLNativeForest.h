@@ -0,0 +1,72 @@
+#ifndef ALIMLNATIVEFOREST_H
+#define ALIMLNATIVEFOREST_H
+
+// Copyright CERN. This software is distributed under the terms of the GNU
+// General Public License v3 (GPL Version 3).
+//
+// See http://www.gnu.org/licenses/ for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file AliMLNativeForest.h
+/// \brief In-process evaluator for XGBoost and LightGBM JSON dumps. The trees are
+///        flattened in a single node array and evaluated without a compiler step.
+
+#include <string>
+#include <vector>
+
+namespace YAML {
+class Node;
+}
+
+class AliMLNativeForest {
+public:
+  AliMLNativeForest();
+  ~AliMLNativeForest() {}
+
+  /// dump written by Booster.dump_model(path, dump_format='json'), splits named as fN or as in featureNames
+  bool LoadXGBoostDump(const std::string &path, const std::vector<std::string> &featureNames);
+  /// dump written by Booster.dump_model() and saved to a JSON file
+  bool LoadLightGBMDump(const std::string &path);
+  /// base_score of the XGBoost training, not stored in the dumps (default 0.5)
+  void SetBaseScore(float baseScore);
+
+  bool IsLoaded() const { return !fTreeRoots.empty(); }
+  int GetNFeatures() const { return fNFeatures; }
+
+  double Predict(const double *features, int size, bool useRaw);
+  void PredictBatch(const float *matrix, int nRows, int nCols, double *out, bool useRaw) const;
+
+private:
+  enum { kDefaultLeft = 1, kNaNAsZero = 2, kZeroMissing = 4 };
+
+  /// leaves point to themselves on both sides, so every tree is walked for a fixed number of steps
+  struct Node {
+    float fThreshold;    /// go left if value < threshold
+    int fFeature;        /// feature index
+    int fLeft;           /// left child index in fNodes
+    int fRight;          /// right child index in fNodes
+    int fFlags;          /// missing value handling
+  };
+
+  static int Next(const Node &node, float value);
+  int AddXGBoostNode(const YAML::Node &node, const std::vector<std::string> &featureNames, int depth);
+  int AddLightGBMNode(const YAML::Node &node, int depth);
+  int AddLeaf(float value);
+  float Transform(float margin, bool useRaw) const;
+
+  std::vector<Node> fNodes;        /// nodes of all the trees
+  std::vector<float> fLeafValues;  /// leaf value of each node (0 for split nodes)
+  std::vector<int> fTreeRoots;     /// index of the root of each tree
+  std::vector<int> fTreeDepths;    /// maximum depth of each tree
+  std::vector<float> fInstance;    /// single candidate buffer
+
+  int fNFeatures;          /// largest feature index used + 1
+  int fCurrentDepth;       /// depth of the tree being loaded
+  float fBaseMargin;       /// margin added to the sum of the trees
+  float fSigmoidAlpha;     /// slope of the sigmoid transformation
+};
+
+#endif
@@ -12,6 +12,11 @@
 
 #include "AliMLResponse.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "yaml-cpp/yaml.h"
 
 #include "AliExternalBDT.h"
@@ -29,7 +34,7 @@ ClassImp(AliMLResponse);
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse()
     : TNamed(), fConfigFilePath{}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{}, fNVariables{},
-      fBinsBegin{}, fRaw{} {
+      fBinsBegin{}, fRaw{}, fNCompileThreads{1}, fBinding{}, fBatchBins{}, fBatchOffsets{}, fBatchOrder{}, fBatchFeatures{}, fBatchScores{} {
   //
   // Default constructor
   //
@@ -38,7 +43,8 @@ AliMLResponse::AliMLResponse()
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const Char_t *name, const Char_t *title)
     : TNamed(name, title), fConfigFilePath{""}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{},
-      fNVariables{}, fBinsBegin{}, fRaw{} {
+      fNVariables{}, fBinsBegin{}, fRaw{}, fNCompileThreads{1}, fBinding{}, fBatchBins{}, fBatchOffsets{}, fBatchOrder{}, fBatchFeatures{},
+      fBatchScores{} {
   //
   // Standard constructor
   //
@@ -55,7 +61,8 @@ AliMLResponse::~AliMLResponse() {
 AliMLResponse::AliMLResponse(const AliMLResponse &source)
     : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath}, fModels{source.fModels},
       fCentClasses{source.fCentClasses}, fBins{source.fBins}, fVariableNames{source.fVariableNames},
-      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw} {
+      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw}, fNCompileThreads{source.fNCompileThreads}, fBinding{source.fVariableNames}, fBatchBins{}, fBatchOffsets{}, fBatchOrder{},
+      fBatchFeatures{}, fBatchScores{} {
   //
   // Copy constructor
   //
@@ -78,6 +85,8 @@ AliMLResponse &AliMLResponse::operator=(const AliMLResponse &source) {
   fNVariables     = source.fNVariables;
   fBinsBegin      = source.fBinsBegin;
   fRaw            = source.fRaw;
+  fNCompileThreads = source.fNCompileThreads;
+  fBinding        = AliMLFeatureBinding{fVariableNames};
 
   return *this;
 }
@@ -122,14 +131,48 @@ void AliMLResponse::CompileModels(std::string configLocalPath) {
 
   for (const auto &model : nodeList["MODELS"]) {
     fModels.push_back(AliMLModelHandler{model});
+    fModels.back().SetFeatureNames(fVariableNames);
+  }
+
+  /// the import uses ROOT I/O and stays sequential, code generation and compilation run on the thread pool
+  int nModels = fModels.size();
+  vector<string> localPaths;
+  for (const auto &model : fModels) {
+    localPaths.push_back(AliMLModelHandler::ImportFile(model.GetPath()));
   }
 
-  for (auto &model : fModels) {
-    bool comp = model.CompileModel();
-    if (!comp) {
+  int nThreads = fNCompileThreads > 0 ? fNCompileThreads : std::thread::hardware_concurrency();
+  nThreads     = std::max(1, std::min(nThreads, nModels));
+
+  vector<char> status(nModels, 0);
+  vector<double> compTimes(nModels, 0.);
+  std::atomic<int> nextModel{0};
+  auto compile = [&]() {
+    for (int iModel = nextModel++; iModel < nModels; iModel = nextModel++) {
+      auto start        = std::chrono::steady_clock::now();
+      status[iModel]    = fModels[iModel].CompileModel(localPaths[iModel]);
+      compTimes[iModel] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  vector<std::thread> pool;
+  for (int iThread = 1; iThread < nThreads; ++iThread) {
+    pool.emplace_back(compile);
+  }
+  compile();
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  double totTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for (int iModel = 0; iModel < nModels; ++iModel) {
+    AliInfo(Form("Model %d (%s) compiled in %.2f s", iModel, fModels[iModel].GetPath().data(), compTimes[iModel]));
+    if (!status[iModel]) {
       AliFatal("Error in model compilation! Exit");
     }
   }
+  AliInfo(Form("%d models compiled in %.2f s using %d threads", nModels, totTime, nThreads));
 }
 
 //_______________________________________________________________________________
@@ -137,6 +180,7 @@ void AliMLResponse::MLResponseInit() {
   /// import config file from alien path
   string configLocalPath = ImportConfigFile();
   CompileModels(configLocalPath);
+  fBinding = AliMLFeatureBinding{fVariableNames};
 }
 
 //_______________________________________________________________________________
@@ -147,17 +191,18 @@ int AliMLResponse::FindBin(double binvar) {
 }
 
 //_______________________________________________________________________________
-double AliMLResponse::Predict(double binvar, map<string, double> varmap) {
+double AliMLResponse::Predict(double binvar, const map<string, double> &varmap) {
   if ((int)varmap.size() < fNVariables) {
     AliFatal("The variable map you provided to the predictor has a size smaller than the variable list size! Exit");
   }
 
   vector<double> features;
   for (const auto &varname : fVariableNames) {
-    if (varmap.find(varname) == varmap.end()) {
+    auto var = varmap.find(varname);
+    if (var == varmap.end()) {
       AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", varname.data()));
     }
-    features.push_back(varmap[varname]);
+    features.push_back(var->second);
   }
 
   int bin = FindBin(binvar);
@@ -186,7 +231,91 @@ double AliMLResponse::Predict(double binvar, vector<double> variables) {
 }
 
 //_______________________________________________________________________________
-bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap) {
+double AliMLResponse::Predict(double binvar, AliMLFeatureBinding &binding) {
+  if (binding.GetNVariables() != fNVariables) {
+    AliFatal(Form("Number of variables in the binding (%d) different from the one used in the model (%d)! Exit",
+                  binding.GetNVariables(), fNVariables));
+  }
+
+  int bin = FindBin(binvar);
+  if (bin == 0 || bin >= fNBins) {
+    AliWarning("Binned variable outside range, no model available!");
+    return -999.;
+  }
+
+  binding.Update();
+  return fModels[bin - 1].GetModel()->Predict(binding.GetValues(), fNVariables, fRaw);
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::GetVariableIndex(const string &varname) const {
+  auto var = std::find(fVariableNames.begin(), fVariableNames.end(), varname);
+  return var == fVariableNames.end() ? -1 : var - fVariableNames.begin();
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictBatch(const double *binvars, const float *features, int ncand, double *scores) {
+  /// bucket the candidates per bin so that each model is called once on a contiguous block
+  fBatchBins.resize(ncand);
+  fBatchOffsets.assign(fNBins + 2, 0);
+  int nOutside{0};
+  for (int iCand = 0; iCand < ncand; ++iCand) {
+    int bin = FindBin(binvars[iCand]);
+    if (bin == 0 || bin >= fNBins) {
+      scores[iCand] = -999.;
+      fBatchBins[iCand] = -1;
+      ++nOutside;
+      continue;
+    }
+    fBatchBins[iCand] = bin;
+    ++fBatchOffsets[bin + 1];
+  }
+  if (nOutside) {
+    AliWarning(Form("Binned variable outside range for %d candidates, no model available!", nOutside));
+  }
+  for (int iBin = 1; iBin <= fNBins; ++iBin) {
+    fBatchOffsets[iBin] += fBatchOffsets[iBin - 1];
+  }
+
+  /// after the scatter fBatchOffsets[bin] points to the end of the bin block
+  int nSorted = ncand - nOutside;
+  fBatchOrder.resize(nSorted);
+  fBatchFeatures.resize(nSorted * fNVariables);
+  fBatchScores.resize(nSorted);
+  for (int iCand = 0; iCand < ncand; ++iCand) {
+    if (fBatchBins[iCand] < 0) continue;
+    int row = fBatchOffsets[fBatchBins[iCand]]++;
+    fBatchOrder[row] = iCand;
+    std::copy(features + iCand * fNVariables, features + (iCand + 1) * fNVariables,
+              fBatchFeatures.begin() + row * fNVariables);
+  }
+
+  for (int iBin = 1; iBin < fNBins; ++iBin) {
+    int first = fBatchOffsets[iBin - 1];
+    int nRows = fBatchOffsets[iBin] - first;
+    if (nRows == 0) continue;
+    if (!fModels[iBin - 1].GetModel()->PredictBatch(&fBatchFeatures[first * fNVariables], nRows, fNVariables,
+                                                    &fBatchScores[first], fRaw)) {
+      AliFatal("Error in batch prediction! Exit");
+    }
+  }
+  for (int iRow = 0; iRow < nSorted; ++iRow) {
+    scores[fBatchOrder[iRow]] = fBatchScores[iRow];
+  }
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictBatch(const vector<double> &binvars, const vector<float> &features, vector<double> &scores) {
+  if (features.size() != binvars.size() * fNVariables) {
+    AliFatal(Form("Number of features passed (%d) different from candidates x model variables (%d)! Exit",
+                  (int)features.size(), (int)binvars.size() * fNVariables));
+  }
+  scores.resize(binvars.size());
+  PredictBatch(binvars.data(), features.data(), (int)binvars.size(), scores.data());
+}
+
+//_______________________________________________________________________________
+bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap) {
   double score{0.};
   return IsSelected(binvar, varmap, score);
 }
@@ -195,4 +324,10 @@ bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varm
 bool AliMLResponse::IsSelected(double binvar, std::vector<double> variables) {
   double score{0.};
   return IsSelected(binvar, variables, score);
-}
\ No newline at end of file
+}
+
+//_______________________________________________________________________________
+bool AliMLResponse::IsSelected(double binvar, AliMLFeatureBinding &binding) {
+  double score{0.};
+  return IsSelected(binvar, binding, score);
+}
@@ -21,6 +21,7 @@
 
 #include "TNamed.h"
 
+#include "AliMLFeatureBinding.h"
 #include "AliMLModelHandler.h"
 
 namespace YAML {
@@ -44,20 +45,37 @@ public:
   void CheckConfigFile(YAML::Node nodelist);
   /// methods to configure the AliMLResponse object from the config file and compile the models usign treelite
   void CompileModels(std::string configLocalPath);     /// (it has to be done run time)
+  /// number of threads used to compile the models concurrently (0 = number of cores)
+  void SetNCompileThreads(int nthreads) { fNCompileThreads = nthreads; }
   void MLResponseInit();    /// (it has to be done run time)
 
   /// return the bin index
   int FindBin(double binvar);
   /// return the ML model predicted score (raw or proba, depending on useraw)
-  double Predict(double binvar, std::map<std::string, double> varmap);
+  double Predict(double binvar, const std::map<std::string, double> &varmap);
   /// overload to pass directly a vector of variables
   double Predict(double binvar, std::vector<double> variables);
+  /// return the binding filled by the task before calling the binding overloads (set up in MLResponseInit)
+  AliMLFeatureBinding &GetFeatureBinding() { return fBinding; }
+  /// overload to use the values stored in a feature binding, no allocation nor name lookup
+  double Predict(double binvar, AliMLFeatureBinding &binding);
+  /// return the position of a variable in the feature rows expected by PredictBatch (-1 if not used)
+  int GetVariableIndex(const std::string &varname) const;
+  /// return the scores of ncand candidates, features are row-major following the config variable order
+  void PredictBatch(const double *binvars, const float *features, int ncand, double *scores);
+  /// overload to pass vectors, scores is resized to the number of candidates
+  void PredictBatch(const std::vector<double> &binvars, const std::vector<float> &features,
+                    std::vector<double> &scores);
   /// return true if predicted score for map is above the threshold given in the config
-  bool IsSelected(double binvar, std::map<std::string, double> varmap);
+  bool IsSelected(double binvar, const std::map<std::string, double> &varmap);
   /// overload for getting the model score too
-  template <typename F> bool IsSelected(double binvar, std::map<std::string, double> varmap, F &score);
+  template <typename F> bool IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score);
   /// overload to pass directly a vector of variables
   bool IsSelected(double binvar, std::vector<double> variables);
+  /// overload to use the values stored in a feature binding
+  bool IsSelected(double binvar, AliMLFeatureBinding &binding);
+  /// overload for getting the model score too
+  template <typename F> bool IsSelected(double binvar, AliMLFeatureBinding &binding, F &score);
   /// overload for getting the model score too
   template <typename F> bool IsSelected(double binvar, std::vector<double> variables, F &score);
 
@@ -76,12 +94,23 @@ protected:
 
   bool fRaw;    /// set to true to use raw score instead of probability
 
+  int fNCompileThreads;    /// number of threads compiling the models (0 = number of cores)
+
+  AliMLFeatureBinding fBinding;        //!<! feature slots in the model variable order
+
+  std::vector<int> fBatchBins;         //!<! bin of each candidate in the batch
+  std::vector<int> fBatchOffsets;      //!<! first sorted row of each bin in the batch
+  std::vector<int> fBatchOrder;        //!<! candidate index of each sorted row
+  std::vector<float> fBatchFeatures;   //!<! feature rows sorted by bin
+  std::vector<double> fBatchScores;    //!<! scores of the sorted rows
+
   /// \cond CLASSIMP
-  ClassDef(AliMLResponse, 2);    ///
+  ClassDef(AliMLResponse, 5);    ///
   /// \endcond
 };
 
-template <typename F> bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap, F &score) {
+template <typename F>
+bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score) {
   int bin = FindBin(binvar);
   score   = Predict(binvar, varmap);
   return score >= fModels[bin - 1].GetScoreCut();
@@ -93,4 +122,14 @@ template <typename F> bool AliMLResponse::IsSelected(double binvar, std::vector<
   return score >= fModels[bin - 1].GetScoreCut();
 }
 
+template <typename F> bool AliMLResponse::IsSelected(double binvar, AliMLFeatureBinding &binding, F &score) {
+  int bin = FindBin(binvar);
+  score   = Predict(binvar, binding);
+  /// outside the binning there is no model (and no score cut) to compare with
+  if (bin == 0 || bin >= fNBins) {
+    return false;
+  }
+  return score >= fModels[bin - 1].GetScoreCut();
+}
+
 #endif
@@ -10,6 +10,7 @@
 #ifdef __CLING__
 #pragma link C++ class AliMLResponse+;
 #pragma link C++ class AliMLModelHandler+;
+#pragma link C++ class AliMLFeatureBinding+;
 #endif
 
 #endif
@@ -0,0 +1,100 @@
+#include <TFile.h>
+#include <TStopwatch.h>
+#include <TTree.h>
+#include <TTreeReader.h>
+#include <TTreeReaderValue.h>
+
+#include <array>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "AliMLResponse.h"
+
+#define NREPEAT 20
+
+int bench_AliMLResponse(string path = "") {
+
+  string tree_path, config_path;
+
+  if (path == "") {
+    tree_path   = "test_tree_pt8_12.root";
+    config_path = "config_bench.yml";
+  } else {
+    tree_path   = path + "/" + "test_tree_pt8_12.root";
+    config_path = path + "/" + "config_bench.yml";
+  }
+
+  const std::vector<string> names = {"delta_mass_KK", "d_len",       "norm_dl_xy",  "sig_vert",
+                                     "cos_PiKPhi_3",  "norm_IP",     "sigComb_K_0", "sigComb_K_1",
+                                     "sigComb_K_2",   "sigComb_Pi_0", "sigComb_Pi_1", "sigComb_Pi_2"};
+
+  /// load the candidates in memory, so that only the scoring path is timed
+  std::vector<std::array<float, 12>> candidates;
+  TFile *fInput = new TFile(tree_path.data(), "READ");
+  TTreeReader fReader("tree_real_data", fInput);
+  std::vector<TTreeReaderValue<float>> values;
+  for (const auto &name : names) {
+    values.emplace_back(fReader, name.data());
+  }
+  while (fReader.Next()) {
+    std::array<float, 12> cand;
+    for (size_t iVar = 0; iVar < names.size(); ++iVar) {
+      cand[iVar] = *values[iVar];
+    }
+    candidates.push_back(cand);
+  }
+  fInput->Close();
+
+  AliMLResponse *fResponse = new AliMLResponse("bench", "bench");
+  fResponse->SetConfigFilePath(config_path);
+  fResponse->MLResponseInit();
+
+  const double pt = 10.;
+  const double nCalls = static_cast<double>(NREPEAT * candidates.size());
+  double sumMap{0.}, sumBinding{0.};
+  TStopwatch watch;
+
+  /// map path: one map filled per candidate, as done by the tasks
+  watch.Start();
+  for (int iRep = 0; iRep < NREPEAT; ++iRep) {
+    for (const auto &cand : candidates) {
+      std::map<std::string, double> varmap;
+      for (size_t iVar = 0; iVar < names.size(); ++iVar) {
+        varmap[names[iVar]] = cand[iVar];
+      }
+      sumMap += fResponse->Predict(pt, varmap);
+    }
+  }
+  watch.Stop();
+  const double timeMap = watch.RealTime();
+
+  /// binding path: task variables bound once, no allocation nor name lookup per candidate
+  std::array<float, 12> current;
+  AliMLFeatureBinding &binding = fResponse->GetFeatureBinding();
+  for (size_t iVar = 0; iVar < names.size(); ++iVar) {
+    binding.Bind(names[iVar], &current[iVar]);
+  }
+  watch.Start();
+  for (int iRep = 0; iRep < NREPEAT; ++iRep) {
+    for (const auto &cand : candidates) {
+      current = cand;
+      sumBinding += fResponse->Predict(pt, binding);
+    }
+  }
+  watch.Stop();
+  const double timeBinding = watch.RealTime();
+
+  std::cout << "Candidates scored per path: " << nCalls << std::endl;
+  std::cout << Form("map path:     %.1f ns/candidate", 1.e9 * timeMap / nCalls) << std::endl;
+  std::cout << Form("binding path: %.1f ns/candidate", 1.e9 * timeBinding / nCalls) << std::endl;
+  delete fResponse;
+
+  if (sumMap != sumBinding) {
+    std::cout << "BENCH: score mismatch between the two paths!" << std::endl;
+    return 1;
+  }
+  std::cout << "BENCH: Success!" << std::endl;
+  return 0;
+}
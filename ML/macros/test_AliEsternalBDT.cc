@@ -1,4 +1,5 @@
 #include <TFile.h>
+#include <TSystem.h>
 #include <TTree.h>
 #include <TTreeReader.h>
 #include <TTreeReaderValue.h>
@@ -14,14 +15,16 @@
 
 int test_AliEsternalBDT(string path = "") {
 
-  string tree_path, model_path;
+  string tree_path, model_path, dump_path;
 
   if (path == "") {
     tree_path  = "test_tree_pt8_12.root";
     model_path = "test_xgboost_pt8_12.model";
+    dump_path  = "test_xgboost_pt8_12.json";
   } else {
     tree_path  = path + "/" + "test_tree_pt8_12.root";
     model_path = path + "/" + "test_xgboost_pt8_12.model";
+    dump_path  = path + "/" + "test_xgboost_pt8_12.json";
   }
 
   fstream fAliExtBDT_Pred, fXGBoost_Pred;
@@ -51,6 +54,18 @@ int test_AliEsternalBDT(string path = "") {
     return 1;
   }
 
+  /// the native evaluator is checked against treelite only if the JSON dump is available
+  AliExternalBDT *fNativeBDT = nullptr;
+  if (!gSystem->AccessPathName(dump_path.data())) {
+    fNativeBDT = new AliExternalBDT();
+    if (!fNativeBDT->LoadXGBoostDump(dump_path.data(), {})) {
+      return 1;
+    }
+  } else {
+    std::cout << "TEST: native evaluator SKIP, no JSON dump at " << dump_path << std::endl;
+  }
+  int nNativeMismatch = 0;
+
   while (fReader.Next()) {
 
     double features[12] = {*fValueDeltaMass,  *fValueDLen,       *fValueNormDLXY,
@@ -58,10 +73,21 @@ int test_AliEsternalBDT(string path = "") {
                            *fValueSigCombK0,  *fValueSigCombK1,  *fValueSigCombK2,
                            *fValueSigCombPi0, *fValueSigCombPi1, *fValueSigCombPi2};
 
-    fAliExtBDT_Pred << Form("%.10f", fBDT->Predict(features, 12, true)) << std::endl;
+    double score = fBDT->Predict(features, 12, true);
+    fAliExtBDT_Pred << Form("%.10f", score) << std::endl;
+    if (fNativeBDT && fNativeBDT->Predict(features, 12, true) != score) {
+      ++nNativeMismatch;
+    }
   }
   fInput->Close();
   delete fBDT;
+  delete fNativeBDT;
+
+  if (nNativeMismatch) {
+    std::cout << "TEST: native evaluator differs from treelite for " << nNativeMismatch << " candidates!" << std::endl;
+    std::cout << "TEST: Fail!" << std::endl;
+    return 1;
+  }
 
   fAliExtBDT_Pred.clear();
   fAliExtBDT_Pred.seekg(0, ios::beg);
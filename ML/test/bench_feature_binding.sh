@@ -0,0 +1,21 @@
+#!/bin/bash
+
+DIRPATH="test_extBDT"
+mkdir -p ${DIRPATH}
+
+curl http://personalpages.to.infn.it/~fecchio/test_extBDT/test_xgboost_pt8_12.model -o ${DIRPATH}/test_xgboost_pt8_12.model
+curl http://personalpages.to.infn.it/~fecchio/test_extBDT/test_tree_pt8_12.root -o ${DIRPATH}/test_tree_pt8_12.root
+
+cat > ${DIRPATH}/config_bench.yml << CONFIG
+BINS: [8, 12, 24]
+N_MODELS: 2
+MODELS:
+  - {path: ${DIRPATH}/test_xgboost_pt8_12.model, library: kXGBoost, cut: 0.5}
+  - {path: ${DIRPATH}/test_xgboost_pt8_12.model, library: kXGBoost, cut: 0.5}
+NUM_VAR: 12
+VAR_NAMES: [delta_mass_KK, d_len, norm_dl_xy, sig_vert, cos_PiKPhi_3, norm_IP,
+            sigComb_K_0, sigComb_K_1, sigComb_K_2, sigComb_Pi_0, sigComb_Pi_1, sigComb_Pi_2]
+RAW_SCORE: true
+CONFIG
+
+root -q -b -l ../macros/bench_AliMLResponse.cc\(\"${DIRPATH}\"\)
@@ -7,4 +7,10 @@ curl http://personalpages.to.infn.it/~fecchio/test_extBDT/test_xgboost_pt8_12.mo
 curl http://personalpages.to.infn.it/~fecchio/test_extBDT/test_tree_pt8_12.root -o ${DIRPATH}/test_tree_pt8_12.root
 curl http://personalpages.to.infn.it/~fecchio/test_extBDT/xgboost_pred.txt -o ${DIRPATH}/xgboost_pred.txt
 
+# JSON dump for the native evaluator, checked only when the xgboost python package is available
+rm -f ${DIRPATH}/test_xgboost_pt8_12.json
+if ! python3 -c "import xgboost; xgboost.Booster(model_file='${DIRPATH}/test_xgboost_pt8_12.model').dump_model('${DIRPATH}/test_xgboost_pt8_12.json', dump_format='json')" 2>/dev/null; then
+  echo "SKIP: native evaluator check, the xgboost python package is not available"
+fi
+
 root -q -b -l ../macros/test_AliEsternalBDT.cc\(\"${DIRPATH}\"\)
@@ -35,6 +35,9 @@
 #include <TH1F.h>
 #include <TRandom3.h>
 #include <TList.h>
+#include <TEnv.h>
+#include <TChainElement.h>
+#include <TROOT.h>
 
 #include <AliLog.h>
 #include <AliAnalysisManager.h>
@@ -169,7 +172,10 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper() :
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fPrefetchDepth(0),
+  fPrefetchCacheSize(30000000),
+  fPrefetcher(nullptr)
 {
   if (fgInstance != nullptr) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -243,7 +249,10 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper(const c
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fPrefetchDepth(0),
+  fPrefetchCacheSize(30000000),
+  fPrefetcher(nullptr)
 {
   if (fgInstance != 0) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -265,6 +274,8 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper(const c
 AliAnalysisTaskEmcalEmbeddingHelper::~AliAnalysisTaskEmcalEmbeddingHelper()
 {
   if (fgInstance == this) fgInstance = nullptr;
+  // Stops the worker thread before the input goes away
+  if (fPrefetcher) delete fPrefetcher;
   if (fExternalEvent) delete fExternalEvent;
   if (fExternalFile) {
     fExternalFile->Close();
@@ -328,6 +339,8 @@ void AliAnalysisTaskEmcalEmbeddingHelper::RetrieveTaskPropertiesFromYAMLConfig()
   res = fYAMLConfig.GetProperty("randomFileAccess", fRandomFileAccess, false);
   res = fYAMLConfig.GetProperty("createHisto", fCreateHisto, false);
   res = fYAMLConfig.GetProperty("printTimingInfoInLog", fPrintTimingInfoToLog, false);
+  res = fYAMLConfig.GetProperty("prefetchDepth", fPrefetchDepth, false);
+  res = fYAMLConfig.GetProperty("prefetchCacheSize", fPrefetchCacheSize, false);
   // More general embedding helper properties
   res = fYAMLConfig.GetProperty("filePattern", fFilePattern, false);
   res = fYAMLConfig.GetProperty("inputFilename", fInputFilename, false);
@@ -1113,6 +1126,12 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::InitEvent()
  */
 void AliAnalysisTaskEmcalEmbeddingHelper::UserCreateOutputObjects()
 {
+  // The prefetcher parses the cross section files in a second thread. ROOT's thread safety
+  // has to be enabled before any file is opened.
+  if (fPrefetchDepth > 0) {
+    ROOT::EnableThreadSafety();
+  }
+
   SetupEmbedding();
 
   // Reinitialize the YAML config after it was streamed so that it can be used properly.
@@ -1267,6 +1286,12 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::SetupInputFiles()
   // Determine which file to start with
   DetermineFirstFileToEmbed();
 
+  // The tree cache reads the baskets of the upcoming entries in a background thread.
+  // It must be enabled before the first file is opened.
+  if (fPrefetchDepth > 0) {
+    gEnv->SetValue("TFile.AsyncPrefetching", 1);
+  }
+
   // Setup TChain
   fChain = new TChain(fTreeName);
 
@@ -1323,6 +1348,28 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::SetupInputFiles()
     AliErrorStream() << "Number of input files (" << fFilenames.size() << ") is larger than the number of available files (" << fMaxNumberOfFiles << "). Something went wrong when adding some of those files to the TChain!\n";
   }
 
+  // Setup read ahead of the following files, in the order of the chain
+  if (fPrefetchDepth > 0) {
+    fChain->SetCacheSize(fPrefetchCacheSize);
+    fChain->AddBranchToCache("*", kTRUE);
+
+    std::vector<std::string> chainFilenames;
+    TIter next(fChain->GetListOfFiles());
+    while (TChainElement * element = static_cast<TChainElement *>(next())) {
+      chainFilenames.push_back(element->GetTitle());
+    }
+    // The cross section files are only ordered like the chain if all files were added
+    std::vector<std::string> xsecFilenames;
+    if (fPythiaCrossSectionFilenames.size() == chainFilenames.size()) {
+      xsecFilenames = fPythiaCrossSectionFilenames;
+    }
+
+    delete fPrefetcher;
+    fPrefetcher = new AliEmcalEmbeddingInputPrefetcher(fPrefetchDepth);
+    fPrefetcher->Start(chainFilenames, xsecFilenames);
+    AliInfoStream() << "Prefetching the next " << fPrefetchDepth << " input files.\n";
+  }
+
   // Setup input event
   Bool_t res = InitEvent();
   if (!res) return kFALSE;
@@ -1478,7 +1525,15 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
   if (fPythiaCrossSectionFilenames.size() > 0) {
     // Need to check that fFileNumber is smaller than the size of the vector because we don't check if
     if (fFileNumber < fPythiaCrossSectionFilenames.size()) {
-      bool success = PythiaInfoFromCrossSectionFile(fPythiaCrossSectionFilenames.at(fFileNumber));
+      // Take the file content from the prefetcher if it was already read ahead
+      AliEmcalEmbeddingInputPrefetcher::CrossSectionInfo info;
+      bool success = false;
+      if (fPrefetcher && fPrefetcher->GetCrossSection(fFileNumber, info)) {
+        success = PythiaInfoFromCrossSectionInfo(info, fPythiaCrossSectionFilenames.at(fFileNumber));
+      }
+      else {
+        success = PythiaInfoFromCrossSectionFile(fPythiaCrossSectionFilenames.at(fFileNumber));
+      }
 
       if (!success) {
         AliDebugStream(3) << "Failed to retrieve cross section from xsec file. Will still attempt to get the information from the header.\n";
@@ -1497,6 +1552,11 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
   // (re)set whether we have wrapped the tree
   fWrappedAroundTree = false;
 
+  // Start opening the following files while this one is processed
+  if (fPrefetcher) {
+    fPrefetcher->PrefetchFiles(fFileNumber);
+  }
+
   // Note that the tree in the new file has been initialized
   fInitializedNewFile = kTRUE;
   
@@ -1519,66 +1579,51 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
  */
 bool AliAnalysisTaskEmcalEmbeddingHelper::PythiaInfoFromCrossSectionFile(std::string pythiaFileName)
 {
-  std::unique_ptr<TFile> fxsec(TFile::Open(pythiaFileName.c_str()));
-
-  if (fxsec)
-  {
-    int trials = 0;
-    double crossSection = 0;
-    double nEvents = 0;
-    // Check if it's a tree
-    TTree *xtree = dynamic_cast<TTree*>(fxsec->Get("Xsection"));
-    if (xtree) {
-      UInt_t ntrials  = 0;
-      Double_t xsection  = 0;
-      xtree->SetBranchAddress("xsection",&xsection);
-      xtree->SetBranchAddress("ntrials",&ntrials);
-      xtree->GetEntry(0);
-      trials = ntrials;
-      crossSection = xsection;
-      // TODO: Test this on a file which has pyxsec.root!
-      nEvents = 1.;
-      AliFatal("Have no tested pyxsec.root files. Need to determine the proper way to get nevents!!");
-    }
-    else {
-      // Check if it's instead the histograms
-      // find the Tlist we want to be independent of the name so use the Tkey
-      TKey* key = static_cast<TKey*>(fxsec->GetListOfKeys()->At(0));
-      if (!key) return false;
-      TList *list = dynamic_cast<TList*>(key->ReadObj());
-      if (!list) return false;
-      TProfile * crossSectionHist = static_cast<TProfile*>(list->FindObject("h1Xsec"));
-      // check for failure
-      if(!(crossSectionHist->GetEntries())) {
-        // No cross section information available - fall back to raw
-        AliErrorStream() << "No cross section information available in file \"" << fxsec->GetName() << "\". Will still attempt to extract cross section information from pythia header.\n";
-      } else {
-        // Cross section histogram filled - take it from there
-        crossSection = crossSectionHist->GetBinContent(1);
-        if(!crossSection) AliErrorStream() << GetName() << ": Cross section 0 for file " << pythiaFileName << std::endl;
-      }
-      TH1F * trialsHist = static_cast<TH1F*>(list->FindObject("h1Trials"));
-      trials = trialsHist->GetBinContent(1);
-      nEvents = trialsHist->GetEntries();
-    }
+  return PythiaInfoFromCrossSectionInfo(AliEmcalEmbeddingInputPrefetcher::ReadCrossSectionFile(pythiaFileName), pythiaFileName);
+}
 
-    // If successful in retrieving the values, normalize the xsec and trials by the number of events
-    // in the file. This way, we can use it as an approximate event-by-event value
-    // We do not want to just use the overall value because some of the events may be rejected by various
-    // event selections, so we only want that ones that were actually use. The easiest way to do so is by
-    // filling it for each event.
-    fPythiaTrialsFromFile = trials/nEvents;
-    // Do __NOT__ divide by nEvents here! The value is already from a TProfile and therefore is already the mean!
-    fPythiaCrossSectionFromFile = crossSection;
+/**
+ * Store the pythia information read from a cross section file (see
+ * AliEmcalEmbeddingInputPrefetcher::ReadCrossSectionFile()).
+ *
+ * @param info Content of the pythia cross section file.
+ * @param pythiaFileName Path to the pythia cross section file (for logging).
+ *
+ * @return True if the information has been successfully extracted.
+ */
+bool AliAnalysisTaskEmcalEmbeddingHelper::PythiaInfoFromCrossSectionInfo(const AliEmcalEmbeddingInputPrefetcher::CrossSectionInfo & info, const std::string & pythiaFileName)
+{
+  if (!info.fOpened) {
+    AliDebugStream(3) << "Unable to open file \"" << pythiaFileName << "\". Will attempt to use values from the header.";
+    return false;
+  }
 
-    return true;
+  if (info.fIsTree) {
+    // TODO: Test this on a file which has pyxsec.root!
+    AliFatal("Have no tested pyxsec.root files. Need to determine the proper way to get nevents!!");
   }
-  else {
-    AliDebugStream(3) << "Unable to open file \"" << pythiaFileName << "\". Will attempt to use values from the header.";
+  else if (!info.fFoundHists) {
+    return false;
+  }
+  else if (info.fEmptyXSec) {
+    // No cross section information available - fall back to raw
+    AliErrorStream() << "No cross section information available in file \"" << pythiaFileName << "\". Will still attempt to extract cross section information from pythia header.\n";
+  }
+  else if (!info.fCrossSection) {
+    AliErrorStream() << GetName() << ": Cross section 0 for file " << pythiaFileName << std::endl;
   }
 
-  // Could not open file
-  return false;
+  // If successful in retrieving the values, normalize the xsec and trials by the number of events
+  // in the file. This way, we can use it as an approximate event-by-event value
+  // We do not want to just use the overall value because some of the events may be rejected by various
+  // event selections, so we only want that ones that were actually use. The easiest way to do so is by
+  // filling it for each event.
+  int trials = info.fTrials;
+  fPythiaTrialsFromFile = trials/info.fNEvents;
+  // Do __NOT__ divide by nEvents here! The value is already from a TProfile and therefore is already the mean!
+  fPythiaCrossSectionFromFile = info.fCrossSection;
+
+  return true;
 }
 
 /**
@@ -1889,6 +1934,7 @@ std::string AliAnalysisTaskEmcalEmbeddingHelper::toString(bool includeFileList)
   tempSS << "File list filename: \"" << fFileListFilename << "\"\n";
   tempSS << "Tree name: " << fTreeName << "\n";
   tempSS << "Print timing info to log: " << fPrintTimingInfoToLog << "\n";
+  tempSS << "Prefetch depth (files): " << fPrefetchDepth << "\n";
   tempSS << "Random event number access: " << fRandomEventNumberAccess << "\n";
   tempSS << "Random file access: " << fRandomFileAccess << "\n";
   tempSS << "Starting file index: " << fFilenameIndex << "\n";
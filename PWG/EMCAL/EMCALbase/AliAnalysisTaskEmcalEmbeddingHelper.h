@@ -34,6 +34,7 @@ class AliEmcalList;
 #include "AliEventCuts.h"
 #include "AliYAMLConfiguration.h"
 #include "THistManager.h"
+#include "AliEmcalEmbeddingInputPrefetcher.h"
 
 /**
  * \class AliAnalysisTaskEmcalEmbeddingHelper
@@ -116,6 +117,8 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   Int_t GetStartingFileIndex()                              const { return fFilenameIndex; }
   TString GetFileListFilename()                             const { return fFileListFilename; }
   bool GetCreateHistos()                                    const { return fCreateHisto; }
+  UInt_t GetPrefetchDepth()                                 const { return fPrefetchDepth; }
+  Long64_t GetPrefetchCacheSize()                           const { return fPrefetchCacheSize; }
 
   // Set
   /// Set the pt hard bin which will be added into the file pattern. Can also be omitted and set directly in the pattern.
@@ -128,6 +131,14 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   void SetAOD(const char * treeName = "aodTree")                  { fTreeName     = treeName; }
   /// Set whether to print and plot execution time of InitTree()
   void SetPrintTimingInfoToLog(bool b)                            { fPrintTimingInfoToLog = b;}
+  /**
+   * Read the input ahead: the next n files of the chain and their pythia cross section files are
+   * opened asynchronously, and the cross section files are parsed in a background thread. 0 disables prefetching. It does not change
+   * which events are embedded.
+   */
+  void SetPrefetchDepth(UInt_t n)                                 { fPrefetchDepth = n; }
+  /// Size (in bytes) of the tree cache which is filled asynchronously while prefetching is enabled
+  void SetPrefetchCacheSize(Long64_t size)                        { fPrefetchCacheSize = size; }
   /**
    * Enable to begin embedding at a random entry in each embedded file. Will then loop around in order
    * so that all entries are made available.
@@ -300,6 +311,7 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   Bool_t          InitEvent()           ;
   void            InitTree()            ;
   bool            PythiaInfoFromCrossSectionFile(std::string filename);
+  bool            PythiaInfoFromCrossSectionInfo(const AliEmcalEmbeddingInputPrefetcher::CrossSectionInfo & info, const std::string & filename);
   // Validation helper
   void            ValidatePhysicsSelectionForInternalEventSelection();
   // Helper functions
@@ -375,6 +387,10 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   bool                                          fPrintTimingInfoToLog; ///< Flag to print time to execute InitTree(), for logging purposes
   TStopwatch                                    fTimer            ;    //!<! Timer for the InitTree() function
 
+  UInt_t                                        fPrefetchDepth    ; ///<  Number of files which are read ahead (0 disables prefetching)
+  Long64_t                                      fPrefetchCacheSize; ///<  Size of the asynchronously filled tree cache while prefetching
+  AliEmcalEmbeddingInputPrefetcher             *fPrefetcher       ; //!<! Reads the upcoming files ahead
+
   static AliAnalysisTaskEmcalEmbeddingHelper   *fgInstance        ; //!<! Global instance of this class
 
  private:
@@ -382,7 +398,7 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   AliAnalysisTaskEmcalEmbeddingHelper &operator=(const AliAnalysisTaskEmcalEmbeddingHelper&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 12);
+  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 13);
   /// \endcond
 };
 #endif
@@ -2164,6 +2164,89 @@ void AliEMCALRecoUtils::RecalibrateCells(AliVCaloCells * cells, Int_t bc)
   fCellsRecalibrated = kTRUE;
 }
 
+///
+/// Recalibrate time and energy of a set of cells stored in columns (one array per
+/// cell property) instead of an AliVCaloCells object. Same corrections as
+/// AcceptCalibrateCell() applied to each cell, but the geometry, the switches and
+/// the 2D channel index (only needed for 2D maps) are resolved once per call or only
+/// when needed. Rejected cells get energy 0 and time -1, as in RecalibrateCells(cells,bc).
+///
+/// \param ncells: number of cells in the arrays
+/// \param absIds: cell absolute ID numbers
+/// \param highGain: high gain flag of each cell (0 for low gain)
+/// \param amps: cell energies, recalibrated in place
+/// \param times: cell times, recalibrated in place
+/// \param bc: bunch crossing number returned by esdevent->GetBunchCrossNumber()
+/// \return kTRUE if the cells were rewritten, kFALSE if they were left untouched
+/// (all corrections switched off or no geometry available)
+///
+//_______________________________________________________________________
+Bool_t AliEMCALRecoUtils::RecalibrateCells(Int_t ncells, const Short_t * absIds, const UChar_t * highGain,
+                                           Double_t * amps, Double_t * times, Int_t bc)
+{
+  if (!IsRecalibrationOn() && !IsTimeRecalibrationOn() && !IsBadChannelsRemovalSwitchedOn()) 
+    return kFALSE;
+  
+  AliEMCALGeometry* geom = AliEMCALGeometry::GetInstance();
+  if (!geom)
+  {
+    AliError("No instance of the geometry is available");
+    return kFALSE;
+  }
+  
+  const Int_t  maxAbsId     = 24*48*geom->GetNumberOfSuperModules();
+  const Bool_t removeBad    = IsBadChannelsRemovalSwitchedOn();
+  const Bool_t recalibrate  = !fCellsRecalibrated && IsRecalibrationOn();
+  const Bool_t needEtaPhi   = (removeBad && !fUse1Dmap) || (recalibrate && !fUse1Drecalib);
+  const Double_t timeShift  = fConstantTimeShift*1e-9; // only in case of old Run1 simulation
+  
+  Int_t imod = -1, iphi =-1, ieta=-1,iTower = -1, iIphi = -1, iIeta = -1, status=0; 
+  for (Int_t iCell = 0; iCell < ncells; iCell++) 
+  {
+    Int_t absId = absIds[iCell];
+    
+    Bool_t accept = (absId >= 0 && absId < maxAbsId && geom->GetCellIndex(absId,imod,iTower,iIphi,iIeta));
+    if (accept && needEtaPhi)
+      geom->GetCellPhiEtaIndexInSModule(imod,iTower,iIphi, iIeta,iphi,ieta);
+    
+    if (accept && removeBad)
+    {
+      Bool_t bad = fUse1Dmap ? GetEMCALChannelStatus1D(absId,status) : GetEMCALChannelStatus(imod, ieta, iphi,status);
+      if ( bad ) accept = kFALSE;
+    }
+    
+    if (!accept)
+    {
+      amps[iCell]  = 0;
+      times[iCell] = -1;
+      continue;
+    }
+    
+    Bool_t isLowGain = !highGain[iCell];
+    
+    //Recalibrate energy, keep the single precision of AcceptCalibrateCell
+    Float_t amp = amps[iCell];
+    if (recalibrate)
+    {
+      Float_t factor = fUse1Drecalib ? GetEMCALChannelRecalibrationFactor1D(absId) : GetEMCALChannelRecalibrationFactor(imod,ieta,iphi);
+      amp *= factor;
+      if (fUseShaperNonlin && isLowGain)
+        amp = CorrectShaperNonLin(amp,factor);
+    }
+    amps[iCell] = amp;
+    
+    // Recalibrate time
+    Double_t time = times[iCell] - timeShift;
+    RecalibrateCellTime(absId,bc,time,isLowGain);
+    RecalibrateCellTimeL1Phase(imod, bc, time, fCurrentParNumber);
+    times[iCell] = time;
+  }
+  
+  fCellsRecalibrated = kTRUE;
+  
+  return kTRUE;
+}
+
 ///
 /// Recalibrate all the cells with energy>40 GeV for the shaper nonlinearity
 ///
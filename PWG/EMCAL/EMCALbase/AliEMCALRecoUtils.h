@@ -164,6 +164,8 @@ public:
   Bool_t   AcceptCalibrateCell(Int_t absId, Int_t bc,
                                Float_t & amp, Double_t & time, AliVCaloCells* cells) ; // Energy and Time
   void     RecalibrateCells(AliVCaloCells * cells, Int_t bc) ; // Energy and Time
+  Bool_t   RecalibrateCells(Int_t ncells, const Short_t * absIds, const UChar_t * highGain,
+                            Double_t * amps, Double_t * times, Int_t bc) ; // Energy and Time, columnar input
   void     RecalibrateClusterEnergy(const AliEMCALGeometry* geom, AliVCluster* cluster, AliVCaloCells * cells, Int_t bc=-1) ; // Energy and time
   void     ResetCellsCalibrated()                        { fCellsRecalibrated = kFALSE; }
 
@@ -24,9 +24,13 @@
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
  ************************************************************************************/
+#include <map>
+
+#include <TBufferFile.h>
 #include <TClonesArray.h>
 #include "AliVEvent.h"
 #include "AliLog.h"
+#include "AliAnalysisManager.h"
 #include "AliNamedArrayI.h"
 #include "AliVParticle.h"
 #include "AliTLorentzVector.h"
@@ -56,10 +60,13 @@ AliEmcalContainer::AliEmcalContainer():
   fMaxMCLabel(-1),
   fMassHypothesis(-1),
   fIsEmbedding(kFALSE),
+  fUseAcceptCache(kFALSE),
   fClArray(0),
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fAcceptCache(0),
+  fCutConfigurationKey(),
   fClassName()
 {
   fVertex[0] = 0;
@@ -86,10 +93,13 @@ AliEmcalContainer::AliEmcalContainer(const char *name):
   fMaxMCLabel(-1),
   fMassHypothesis(-1),
   fIsEmbedding(kFALSE),
+  fUseAcceptCache(kFALSE),
   fClArray(0),
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fAcceptCache(0),
+  fCutConfigurationKey(),
   fClassName()
 {
   fVertex[0] = 0;
@@ -155,6 +165,9 @@ void AliEmcalContainer::SetArray(const AliVEvent *event)
   }
 
   fLabelMap = dynamic_cast<AliNamedArrayI*>(event->FindListObject(fClArrayName + "_Map"));
+
+  // The cuts are set up at this point, the key is only rebuilt by ResetAcceptCache()
+  UpdateCutConfigurationKey();
 }
 
 void AliEmcalContainer::NextEvent(const AliVEvent * event)
@@ -168,6 +181,9 @@ void AliEmcalContainer::NextEvent(const AliVEvent * event)
 }
 
 Int_t AliEmcalContainer::GetNAcceptEntries() const{
+  const AliEmcalContainerAcceptCache *cache = GetAcceptCache();
+  if (cache) return cache->GetAcceptedIndices().size();
+
   Int_t result = 0;
   for(int index = 0; index < GetNEntries(); index++){
     UInt_t rejectionReason = 0;
@@ -176,6 +192,72 @@ Int_t AliEmcalContainer::GetNAcceptEntries() const{
   return result;
 }
 
+/**
+ * Returns the accept decisions of the current event, evaluating them if no
+ * container with the same cut configuration has done so yet in this event.
+ * The cut configuration key is built once, when the array is connected
+ * (see UpdateCutConfigurationKey()); after changing cuts, call ResetAcceptCache().
+ * @return Accept cache, NULL if caching is disabled or not possible (no array or analysis manager)
+ */
+const AliEmcalContainerAcceptCache *AliEmcalContainer::GetAcceptCache() const
+{
+  if (!fUseAcceptCache || !fClArray) return 0;
+  AliAnalysisManager *mgr = AliAnalysisManager::GetAnalysisManager();
+  if (!mgr) return 0;
+  const Long64_t event = mgr->GetNcalls();
+
+  if (!fAcceptCache) {
+    static std::map<std::string, AliEmcalContainerAcceptCache> caches;
+    fAcceptCache = &caches[fCutConfigurationKey];
+  }
+
+  AliEmcalContainerAcceptCache &cache = *fAcceptCache;
+  const Int_t n = GetNEntries();
+  if (cache.fEvent != event || cache.fArray != fClArray || cache.GetNEntries() != n) {
+    cache.fArray = fClArray;
+    cache.fEvent = event;
+    cache.fMask.assign((n + 31) / 32, 0);
+    cache.fRejectionReasons.resize(n);
+    cache.fAcceptedIndices.clear();
+    for (Int_t index = 0; index < n; index++) {
+      UInt_t rejectionReason = 0;
+      if (AcceptObject(index, rejectionReason)) {
+        cache.fMask[index >> 5] |= 1u << (index & 31);
+        cache.fAcceptedIndices.push_back(index);
+      }
+      cache.fRejectionReasons[index] = rejectionReason;
+    }
+  }
+
+  return fAcceptCache;
+}
+
+/**
+ * Builds the key identifying the cut configuration of the container: the class
+ * name and the streamed persistent data members, except the container name.
+ */
+void AliEmcalContainer::UpdateCutConfigurationKey()
+{
+  TString name(fName);
+  fName = "";
+  TBufferFile buffer(TBuffer::kWrite);
+  Streamer(buffer);
+  fName = name;
+
+  fCutConfigurationKey = IsA()->GetName();
+  fCutConfigurationKey.append(buffer.Buffer(), buffer.Length());
+}
+
+/**
+ * Forces a new lookup of the accept cache, with the cut configuration key rebuilt
+ * from the current cuts. To be called after changing cuts once the array is connected.
+ */
+void AliEmcalContainer::ResetAcceptCache()
+{
+  fAcceptCache = 0;
+  if (fClArray) UpdateCutConfigurationKey();
+}
+
 Int_t AliEmcalContainer::GetIndexFromLabel(Int_t lab) const
 { 
   if (fLabelMap) {
@@ -37,6 +37,9 @@ class AliVEvent;
 class AliNamedArrayI;
 class AliVParticle;
 
+#include <string>
+#include <vector>
+
 #include <TNamed.h>
 #include <TClonesArray.h>
 
@@ -45,6 +48,35 @@ typedef EMCALIterableContainer::AliEmcalIterableContainerT<TObject, EMCALIterabl
 typedef EMCALIterableContainer::AliEmcalIterableContainerT<TObject, EMCALIterableContainer::operator_star_pair<TObject> > AliEmcalIterableMomentumContainer;
 #endif
 
+/**
+ * @class AliEmcalContainerAcceptCache
+ * @brief Accept decisions of one event for one container cut configuration
+ * @ingroup EMCALCOREFW
+ *
+ * Holds, for each object in the array, the accept decision (as a bitset) and
+ * the rejection reason, and the list of accepted indices. The cache is shared
+ * by all containers with the same cut configuration, see
+ * AliEmcalContainer::SetUseAcceptCache().
+ */
+class AliEmcalContainerAcceptCache {
+ public:
+  AliEmcalContainerAcceptCache() : fArray(0), fEvent(-1), fMask(), fRejectionReasons(), fAcceptedIndices() {}
+
+  Int_t                       GetNEntries()                   const { return fRejectionReasons.size()   ; }
+  Bool_t                      IsAccepted(Int_t i)             const { return (fMask[i >> 5] >> (i & 31)) & 1; }
+  UInt_t                      GetRejectionReason(Int_t i)     const { return fRejectionReasons[i]       ; }
+  const std::vector<Int_t>&   GetAcceptedIndices()            const { return fAcceptedIndices           ; }
+
+ private:
+  friend class AliEmcalContainer;
+
+  const TClonesArray         *fArray;                   ///< array the decisions refer to
+  Long64_t                    fEvent;                   ///< event the decisions refer to
+  std::vector<UInt_t>         fMask;                    ///< accept decisions, one bit per object
+  std::vector<UInt_t>         fRejectionReasons;        ///< rejection reason per object (0 if accepted)
+  std::vector<Int_t>          fAcceptedIndices;         ///< indices of the accepted objects
+};
+
 /**
  * @class AliEmcalContainer
  * @brief Base class for container structures within the EMCAL framework
@@ -229,6 +261,27 @@ class AliEmcalContainer : public TObject {
    */
   Int_t                       GetNAcceptEntries() const;
 
+  /**
+   * @brief Memoise the accept decisions per event
+   *
+   * If enabled, the accept decisions and rejection reasons of all objects are
+   * evaluated once per event and shared by all containers with the same cut
+   * configuration (same class, array and persistent cut settings), e.g. the track
+   * containers of several tasks in a train. The accepted iterators and
+   * GetNAcceptEntries() then reuse the cached list of accepted indices.
+   * Only enable it for arrays which are not modified within the event after the
+   * first task has used the container, in a way that changes the selection.
+   * @param[in] b If true the accept decisions are cached
+   */
+  void                        SetUseAcceptCache(Bool_t b = kTRUE)   { fUseAcceptCache = b; fAcceptCache = 0; }
+  Bool_t                      GetUseAcceptCache()             const { return fUseAcceptCache            ; }
+  const AliEmcalContainerAcceptCache *GetAcceptCache()       const;
+
+  /**
+   * @brief Force a new lookup of the cut configuration, e.g. after changing cuts once the array is connected
+   */
+  void                        ResetAcceptCache();
+
   /**
    * @brief Reset the iterator to a given index
    * 
@@ -372,6 +425,8 @@ class AliEmcalContainer : public TObject {
    */
   void                        GetVertexFromEvent(const AliVEvent * event);
 
+  void                        UpdateCutConfigurationKey();
+
   TString                     fName;                    ///< object name
   TString                     fClArrayName;             ///< name of branch
   TString                     fBaseClassName;           ///< name of the base class that this container can handle
@@ -389,11 +444,14 @@ class AliEmcalContainer : public TObject {
   Int_t                       fMaxMCLabel;              ///< maximum MC label
   Double_t                    fMassHypothesis;          ///< if < 0 it will use a PID mass when available
   Bool_t                      fIsEmbedding;             ///< if true, this container will connect to an external event
+  Bool_t                      fUseAcceptCache;          ///< if true, the accept decisions are cached per event and shared between containers with the same cuts
   TClonesArray               *fClArray;                 //!<! Pointer to array in input event
   Int_t                       fCurrentID;               //!<! current ID for automatic loops
   AliNamedArrayI             *fLabelMap;                //!<! Label-Index map
   Double_t                    fVertex[3];               //!<! event vertex array
   TClass                     *fLoadedClass;             //!<! Class of the objects contained in the TClonesArray
+  mutable AliEmcalContainerAcceptCache *fAcceptCache;   //!<! Accept cache of the cut configuration of this container
+  std::string                 fCutConfigurationKey;     //!<! Key of the cut configuration, built when the array is connected
 
  private:
   TString                     fClassName;               ///< name of the class in the TClonesArray
@@ -401,6 +459,6 @@ class AliEmcalContainer : public TObject {
   AliEmcalContainer(const AliEmcalContainer& obj); // copy constructor
   AliEmcalContainer& operator=(const AliEmcalContainer& other); // assignment
 
-  ClassDef(AliEmcalContainer,9);
+  ClassDef(AliEmcalContainer,10);
 };
 #endif
@@ -0,0 +1,326 @@
+/************************************************************************************
+ * Copyright (C) 2018, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <memory>
+
+#include <TFile.h>
+#include <TH1.h>
+#include <TKey.h>
+#include <TList.h>
+#include <TProfile.h>
+#include <TTree.h>
+
+#include "AliEmcalEmbeddingInputPrefetcher.h"
+
+/**
+ * Default constructor
+ */
+AliEmcalEmbeddingInputPrefetcher::CrossSectionInfo::CrossSectionInfo():
+  fFileNumber(0),
+  fOpened(false),
+  fIsTree(false),
+  fFoundHists(false),
+  fEmptyXSec(false),
+  fCrossSection(0),
+  fTrials(0),
+  fNEvents(0)
+{
+}
+
+/**
+ * Constructor
+ *
+ * @param depth Number of files to read ahead of the current one
+ */
+AliEmcalEmbeddingInputPrefetcher::AliEmcalEmbeddingInputPrefetcher(UInt_t depth):
+  fDepth(depth > 0 ? depth : 1),
+  fFiles(),
+  fXSecFiles(),
+  fNextAsyncOpen(0),
+  fXSecOpening(),
+  fXSecPending(),
+  fXSecToParse(),
+  fQueue(),
+  fParsedFiles(),
+  fMutex(),
+  fCondition(),
+  fStop(false),
+  fWorker()
+{
+}
+
+/**
+ * Destructor. Stops the worker thread.
+ */
+AliEmcalEmbeddingInputPrefetcher::~AliEmcalEmbeddingInputPrefetcher()
+{
+  Stop();
+}
+
+/**
+ * Start reading ahead. ROOT's thread safety must already be enabled if cross section
+ * files are given (see the class description).
+ *
+ * @param files Files to embed, in the order of the chain
+ * @param xsecFiles Pythia cross section files in the same order (can be empty)
+ */
+void AliEmcalEmbeddingInputPrefetcher::Start(const std::vector<std::string> & files, const std::vector<std::string> & xsecFiles)
+{
+  Stop();
+
+  fFiles = files;
+  fXSecFiles = xsecFiles;
+  fNextAsyncOpen = 0;
+  fStop = false;
+
+  if (fXSecFiles.size() > 0) {
+    fWorker = std::thread(&AliEmcalEmbeddingInputPrefetcher::ReadCrossSections, this);
+  }
+}
+
+/**
+ * Stop the worker thread, drop everything which was read ahead and close the cross section files.
+ */
+void AliEmcalEmbeddingInputPrefetcher::Stop()
+{
+  if (fWorker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fCondition.notify_all();
+    fWorker.join();
+  }
+
+  // The pending asynchronous opens cannot be cancelled, they are left to ROOT
+  fXSecOpening.clear();
+  fXSecPending.clear();
+  for (auto & toParse : fXSecToParse) delete toParse.second;
+  fXSecToParse.clear();
+  fQueue.clear();
+  CloseParsedFiles();
+}
+
+/**
+ * Request an asynchronous open of the files following the current one in the chain,
+ * and of their cross section files. Files which were already requested are not requested
+ * again, unless the chain started over from its first file. The cross section files whose
+ * open has completed are handed to the worker thread.
+ *
+ * @param currentFile Position of the current file in the chain
+ */
+void AliEmcalEmbeddingInputPrefetcher::PrefetchFiles(UInt_t currentFile)
+{
+  // The chain started over from the beginning
+  if (fNextAsyncOpen > currentFile + fDepth + 1) fNextAsyncOpen = currentFile + 1;
+  if (fNextAsyncOpen < currentFile + 1) fNextAsyncOpen = currentFile + 1;
+
+  for (; fNextAsyncOpen <= currentFile + fDepth && fNextAsyncOpen < fFiles.size(); fNextAsyncOpen++) {
+    TFile::AsyncOpen(fFiles.at(fNextAsyncOpen).c_str());
+    if (fWorker.joinable() && fNextAsyncOpen < fXSecFiles.size()) {
+      fXSecOpening.push_back(std::make_pair(fNextAsyncOpen, TFile::AsyncOpen(fXSecFiles.at(fNextAsyncOpen).c_str())));
+    }
+  }
+
+  HandOverCrossSectionFiles(fXSecFiles.size(), false);
+  CloseParsedFiles();
+}
+
+/**
+ * Complete the asynchronous opens of the cross section files (in the order they were
+ * requested) and hand the opened files to the worker thread. Must be called on the main thread.
+ *
+ * @param lastFile Stop after the file at this position in the chain
+ * @param wait If true, wait for the opens to complete; otherwise stop at the first open still in progress
+ */
+void AliEmcalEmbeddingInputPrefetcher::HandOverCrossSectionFiles(UInt_t lastFile, bool wait)
+{
+  while (!fXSecOpening.empty()) {
+    UInt_t fileNumber = fXSecOpening.front().first;
+    TFileOpenHandle * handle = fXSecOpening.front().second;
+    if (!wait && TFile::GetAsyncOpenStatus(handle) == TFile::kAOSInProgress) break;
+    fXSecOpening.pop_front();
+
+    TFile * file = handle ? TFile::Open(handle) : nullptr;
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fXSecToParse.push_back(std::make_pair(fileNumber, file));
+    }
+    fCondition.notify_all();
+    fXSecPending.push_back(fileNumber);
+
+    if (fileNumber == lastFile) break;
+  }
+}
+
+/**
+ * Close the cross section files which were parsed by the worker thread. Must be called on the main thread.
+ */
+void AliEmcalEmbeddingInputPrefetcher::CloseParsedFiles()
+{
+  std::vector<TFile *> parsed;
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    parsed.swap(fParsedFiles);
+  }
+  for (auto file : parsed) delete file;
+}
+
+/**
+ * Retrieve the cross section information of a file, waiting for the worker thread if
+ * it has not been parsed yet. Entries for files before the requested one are dropped.
+ *
+ * @param[in] fileNumber Position of the file in the chain
+ * @param[out] info Cross section information of the file
+ *
+ * @return False if the information is not available (prefetcher not running, or the file was
+ *         not requested by PrefetchFiles()). The file should then be read directly.
+ */
+bool AliEmcalEmbeddingInputPrefetcher::GetCrossSection(UInt_t fileNumber, CrossSectionInfo & info)
+{
+  if (!fWorker.joinable() || fileNumber >= fXSecFiles.size()) return false;
+
+  bool requested = false;
+  for (auto & opening : fXSecOpening) requested |= (opening.first == fileNumber);
+  for (auto pending : fXSecPending) requested |= (pending == fileNumber);
+  if (!requested) return false;
+
+  // The file has to be opened (here, on the main thread) before it can be parsed
+  HandOverCrossSectionFiles(fileNumber, true);
+
+  bool found = false;
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    while (!found && !fXSecPending.empty()) {
+      fCondition.wait(lock, [this] { return !fQueue.empty(); });
+      info = fQueue.front();
+      fQueue.pop_front();
+      fXSecPending.pop_front();
+      found = (info.fFileNumber == fileNumber);
+    }
+  }
+
+  CloseParsedFiles();
+
+  return found;
+}
+
+/**
+ * Worker thread: parse the cross section files handed over by the main thread, in the
+ * order they were handed over. The files are not opened or closed here.
+ */
+void AliEmcalEmbeddingInputPrefetcher::ReadCrossSections()
+{
+  while (true) {
+    std::pair<UInt_t, TFile *> toParse;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCondition.wait(lock, [this] { return fStop || !fXSecToParse.empty(); });
+      if (fStop) return;
+      toParse = fXSecToParse.front();
+      fXSecToParse.pop_front();
+    }
+
+    CrossSectionInfo info = ReadCrossSection(toParse.second);
+    info.fFileNumber = toParse.first;
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fQueue.push_back(info);
+      if (toParse.second) fParsedFiles.push_back(toParse.second);
+    }
+    fCondition.notify_all();
+  }
+}
+
+/**
+ * Read a pythia cross section file, either containing the Xsection tree (pyxsec.root)
+ * or the h1Xsec and h1Trials histograms (pyxsec_hists.root). Does no logging.
+ *
+ * @param filename Path to the pythia cross section file.
+ *
+ * @return Content of the file, see CrossSectionInfo for the status flags.
+ */
+AliEmcalEmbeddingInputPrefetcher::CrossSectionInfo AliEmcalEmbeddingInputPrefetcher::ReadCrossSectionFile(const std::string & filename)
+{
+  std::unique_ptr<TFile> fxsec(TFile::Open(filename.c_str()));
+  return ReadCrossSection(fxsec.get());
+}
+
+/**
+ * Read the content of an already opened pythia cross section file (see ReadCrossSectionFile()).
+ * Neither opens nor closes the file and does no logging, such that it can be used from the
+ * worker thread.
+ *
+ * @param fxsec Opened pythia cross section file (can be null).
+ *
+ * @return Content of the file, see CrossSectionInfo for the status flags.
+ */
+AliEmcalEmbeddingInputPrefetcher::CrossSectionInfo AliEmcalEmbeddingInputPrefetcher::ReadCrossSection(TFile * fxsec)
+{
+  CrossSectionInfo info;
+
+  if (!fxsec || fxsec->IsZombie()) return info;
+  info.fOpened = true;
+
+  // Check if it's a tree
+  TTree *xtree = dynamic_cast<TTree*>(fxsec->Get("Xsection"));
+  if (xtree) {
+    UInt_t ntrials  = 0;
+    Double_t xsection  = 0;
+    xtree->SetBranchAddress("xsection",&xsection);
+    xtree->SetBranchAddress("ntrials",&ntrials);
+    xtree->GetEntry(0);
+    info.fIsTree = true;
+    info.fTrials = ntrials;
+    info.fCrossSection = xsection;
+    info.fNEvents = 1.;
+    return info;
+  }
+
+  // Check if it's instead the histograms
+  // find the Tlist we want to be independent of the name so use the Tkey
+  TKey* key = static_cast<TKey*>(fxsec->GetListOfKeys()->At(0));
+  if (!key) return info;
+  std::unique_ptr<TList> list(dynamic_cast<TList*>(key->ReadObj()));
+  if (!list) return info;
+  list->SetOwner(kTRUE);
+  TProfile * crossSectionHist = dynamic_cast<TProfile*>(list->FindObject("h1Xsec"));
+  TH1 * trialsHist = dynamic_cast<TH1*>(list->FindObject("h1Trials"));
+  if (!crossSectionHist || !trialsHist) return info;
+  info.fFoundHists = true;
+
+  if (!(crossSectionHist->GetEntries())) {
+    info.fEmptyXSec = true;
+  }
+  else {
+    info.fCrossSection = crossSectionHist->GetBinContent(1);
+  }
+  info.fTrials = trialsHist->GetBinContent(1);
+  info.fNEvents = trialsHist->GetEntries();
+
+  return info;
+}
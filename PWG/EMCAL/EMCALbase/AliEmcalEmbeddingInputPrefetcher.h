@@ -0,0 +1,120 @@
+/************************************************************************************
+ * Copyright (C) 2018, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALEMBEDDINGINPUTPREFETCHER_H
+#define ALIEMCALEMBEDDINGINPUTPREFETCHER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <Rtypes.h>
+
+class TFile;
+class TFileOpenHandle;
+
+/**
+ * @class AliEmcalEmbeddingInputPrefetcher
+ * @ingroup EMCALCOREFW
+ * @brief Reads ahead the input of the embedding helper while the current file is processed
+ *
+ * The embedding helper walks through the files of its TChain in a fixed order (determined
+ * once by the starting file index), so the next files are known in advance. The prefetcher
+ * uses this to hide the latency of switching files:
+ *  - PrefetchFiles() requests an asynchronous open (TFile::AsyncOpen) of the next files in
+ *    the chain and of their pythia cross section files. When the chain switches to such a
+ *    file, TFile::Open() picks up the pending request instead of opening the file again.
+ *  - The cross section files are opened on the calling (main) thread, as the grid access
+ *    (TGrid, TAlienFile) is not thread-safe. Only the parsing of the already opened files
+ *    is done by a background thread, whose results GetCrossSection() then consumes. The
+ *    files are closed again on the main thread.
+ *
+ * Nothing random happens here: the entries and files which are embedded, and the order in
+ * which they are embedded, are exactly the same as without the prefetcher.
+ *
+ * Since ROOT objects are read from a second thread, ROOT's thread safety has to be enabled
+ * (ROOT::EnableThreadSafety()) by the task at initialization, before using the prefetcher.
+ */
+class AliEmcalEmbeddingInputPrefetcher {
+ public:
+  /**
+   * @struct CrossSectionInfo
+   * @brief Content of a pythia cross section file
+   */
+  struct CrossSectionInfo {
+    CrossSectionInfo();
+    UInt_t      fFileNumber;      ///< Position of the corresponding file in the chain
+    bool        fOpened;          ///< True if the file could be opened
+    bool        fIsTree;          ///< True if the file contains the Xsection tree (pyxsec.root)
+    bool        fFoundHists;      ///< True if the cross section and trials histograms were found
+    bool        fEmptyXSec;       ///< True if the cross section histogram has no entries
+    double      fCrossSection;    ///< Cross section
+    double      fTrials;          ///< Number of trials
+    double      fNEvents;         ///< Number of events the trials are summed over
+  };
+
+  AliEmcalEmbeddingInputPrefetcher(UInt_t depth = 2);
+  ~AliEmcalEmbeddingInputPrefetcher();
+
+  UInt_t                      GetDepth()                            const { return fDepth; }
+
+  void                        Start(const std::vector<std::string> & files, const std::vector<std::string> & xsecFiles);
+  void                        Stop();
+  void                        PrefetchFiles(UInt_t currentFile);
+  bool                        GetCrossSection(UInt_t fileNumber, CrossSectionInfo & info);
+
+  static CrossSectionInfo     ReadCrossSectionFile(const std::string & filename);
+  static CrossSectionInfo     ReadCrossSection(TFile * file);
+
+ protected:
+  void                        ReadCrossSections();
+  void                        HandOverCrossSectionFiles(UInt_t lastFile, bool wait);
+  void                        CloseParsedFiles();
+
+  UInt_t                      fDepth;             ///< Number of files which are read ahead
+  std::vector<std::string>    fFiles;             ///< Files in the order of the chain
+  std::vector<std::string>    fXSecFiles;         ///< Cross section files, same order as fFiles
+  UInt_t                      fNextAsyncOpen;     ///< Number of files for which an asynchronous open was requested
+  std::deque<std::pair<UInt_t, TFileOpenHandle *> > fXSecOpening; ///< Cross section files being opened (main thread only)
+  std::deque<UInt_t>          fXSecPending;       ///< Cross section files handed to the worker and not yet consumed (main thread only)
+  std::deque<std::pair<UInt_t, TFile *> > fXSecToParse; ///< Opened cross section files waiting for the worker thread
+  std::deque<CrossSectionInfo> fQueue;            ///< Cross sections parsed by the worker thread, in chain order
+  std::vector<TFile *>        fParsedFiles;       ///< Files parsed by the worker thread, to be closed on the main thread
+  std::mutex                  fMutex;             ///< Protects fXSecToParse, fQueue, fParsedFiles and fStop
+  std::condition_variable     fCondition;         ///< Signals changes of fXSecToParse, fQueue and fStop
+  bool                        fStop;              ///< Asks the worker thread to finish
+  std::thread                 fWorker;            ///< Thread parsing the cross section files
+
+ private:
+  AliEmcalEmbeddingInputPrefetcher(const AliEmcalEmbeddingInputPrefetcher &);
+  AliEmcalEmbeddingInputPrefetcher &operator=(const AliEmcalEmbeddingInputPrefetcher &);
+};
+
+#endif
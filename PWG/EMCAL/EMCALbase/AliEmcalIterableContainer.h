@@ -329,10 +329,18 @@ T *AliEmcalIterableContainerT<T, STAR>::operator[](int index) const {
 /**
  * Build list of accepted indices inside the container.
  * For this all objects inside the container are checked
- * for being accepted or not.
+ * for being accepted or not, unless the container provides
+ * cached accept decisions (see AliEmcalContainer::SetUseAcceptCache).
  */
 template <typename T, typename STAR>
 void AliEmcalIterableContainerT<T, STAR>::BuildAcceptIndices(){
+  const AliEmcalContainerAcceptCache *cache = fkContainer->GetAcceptCache();
+  if (cache) {
+    const std::vector<Int_t> &accepted = cache->GetAcceptedIndices();
+    fAcceptIndices.Set(accepted.size(), accepted.data());
+    return;
+  }
+
   fAcceptIndices.Set(fkContainer->GetNAcceptEntries());
   int acceptCounter = 0;
   for(int index = 0; index < fkContainer->GetNEntries(); index++){
@@ -0,0 +1,282 @@
+/************************************************************************************
+ * Copyright (C) 2018, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <algorithm>
+#include <cfloat>
+
+#include <TMath.h>
+#include <TVector2.h>
+
+#include "AliEmcalSpatialIndex.h"
+
+/**
+ * Constructor.
+ * @param cellSize Cell size in eta and phi. A value close to the typical query radius
+ * (e.g. the jet resolution parameter) is a good choice.
+ */
+AliEmcalSpatialIndex::AliEmcalSpatialIndex(Double_t cellSize) :
+  fCellSize(cellSize),
+  fBuilt(kFALSE),
+  fNEtaCells(1),
+  fNPhiCells(1),
+  fEtaMin(0),
+  fEtaWidth(1),
+  fPhiWidth(TMath::TwoPi()),
+  fIds(),
+  fEta(),
+  fPhi(),
+  fCellOffsets(),
+  fScratch()
+{
+}
+
+/**
+ * Removes all entries. The memory is kept for the next event.
+ */
+void AliEmcalSpatialIndex::Clear()
+{
+  fIds.clear();
+  fEta.clear();
+  fPhi.clear();
+  fBuilt = kFALSE;
+}
+
+/**
+ * Adds an object to the index. Build() has to be called before the next query.
+ * @param id Identifier of the object, returned by the queries
+ * @param eta Pseudo-rapidity of the object
+ * @param phi Azimuthal angle of the object (any range)
+ */
+void AliEmcalSpatialIndex::Add(Int_t id, Double_t eta, Double_t phi)
+{
+  fIds.push_back(id);
+  fEta.push_back(eta);
+  fPhi.push_back(TVector2::Phi_0_2pi(phi));
+  fBuilt = kFALSE;
+}
+
+/**
+ * Sorts the entries into the eta-phi grid. The eta range of the grid is
+ * adapted to the entries, the phi range always covers the full azimuth.
+ */
+void AliEmcalSpatialIndex::Build()
+{
+  const Int_t n = fIds.size();
+  const Double_t cellSize = fCellSize > 0 ? fCellSize : 0.2;
+
+  Double_t etaMin = 0, etaMax = 0;
+  if (n > 0) {
+    etaMin = *std::min_element(fEta.begin(), fEta.end());
+    etaMax = *std::max_element(fEta.begin(), fEta.end());
+  }
+  fEtaMin = etaMin;
+  fNEtaCells = TMath::Max(1, TMath::Min(1000, TMath::CeilNint((etaMax - etaMin) / cellSize)));
+  fEtaWidth = etaMax > etaMin ? (etaMax - etaMin) / fNEtaCells : cellSize;
+  fNPhiCells = TMath::Max(1, TMath::Min(1000, TMath::FloorNint(TMath::TwoPi() / cellSize)));
+  fPhiWidth = TMath::TwoPi() / fNPhiCells;
+
+  // counting sort of the entries by cell
+  const Int_t ncells = fNEtaCells * fNPhiCells;
+  fCellOffsets.assign(ncells + 1, 0);
+  fScratch.resize(n);
+  for (Int_t i = 0; i < n; i++) {
+    fScratch[i] = EtaCell(fEta[i]) * fNPhiCells + PhiCell(fPhi[i]);
+    fCellOffsets[fScratch[i] + 1]++;
+  }
+  for (Int_t icell = 0; icell < ncells; icell++) fCellOffsets[icell + 1] += fCellOffsets[icell];
+
+  std::vector<Int_t> ids(n);
+  std::vector<Double_t> eta(n), phi(n);
+  std::vector<Int_t> pos(fCellOffsets.begin(), fCellOffsets.end() - 1);
+  for (Int_t i = 0; i < n; i++) {
+    Int_t j = pos[fScratch[i]]++;
+    ids[j] = fIds[i];
+    eta[j] = fEta[i];
+    phi[j] = fPhi[i];
+  }
+  fIds.swap(ids);
+  fEta.swap(eta);
+  fPhi.swap(phi);
+
+  fBuilt = kTRUE;
+}
+
+/**
+ * Finds the nearest object.
+ * @param[in] eta Pseudo-rapidity of the query direction
+ * @param[in] phi Azimuthal angle of the query direction
+ * @param[in] maxDist Maximum distance (negative = unlimited)
+ * @param[out] dist If not NULL, distance of the nearest object
+ * @return Identifier of the nearest object, -1 if none is found
+ */
+Int_t AliEmcalSpatialIndex::FindNearest(Double_t eta, Double_t phi, Double_t maxDist, Double_t *dist) const
+{
+  Int_t id = -1;
+  Double_t d = -1;
+  if (FindNearestNeighbors(eta, phi, 1, &id, &d, maxDist) < 1) return -1;
+  if (dist) *dist = d;
+  return id;
+}
+
+/**
+ * Finds the k nearest objects, sorted by increasing distance.
+ * The grid is searched in rings of cells around the query cell; the search stops as
+ * soon as no cell of the next ring can contain a closer object.
+ * @param[in] eta Pseudo-rapidity of the query direction
+ * @param[in] phi Azimuthal angle of the query direction
+ * @param[in] k Maximum number of objects returned
+ * @param[out] ids Identifiers of the objects found (at least k entries)
+ * @param[out] dists Distances of the objects found (at least k entries)
+ * @param[in] maxDist Maximum distance (negative = unlimited)
+ * @return Number of objects found (<= k)
+ */
+Int_t AliEmcalSpatialIndex::FindNearestNeighbors(Double_t eta, Double_t phi, Int_t k, Int_t *ids, Double_t *dists, Double_t maxDist) const
+{
+  if (!fBuilt || k < 1 || fIds.empty()) return 0;
+
+  phi = TVector2::Phi_0_2pi(phi);
+  const Double_t maxDist2 = maxDist < 0 ? DBL_MAX : maxDist * maxDist;
+  const Int_t ieta0 = EtaCell(eta), iphi0 = PhiCell(phi);
+  // phi cell offsets are limited to [-lowPhi, highPhi] so that each cell is visited once
+  const Int_t lowPhi = (fNPhiCells - 1) / 2, highPhi = fNPhiCells - 1 - lowPhi;
+  const Int_t maxRing = TMath::Max(TMath::Max(ieta0, fNEtaCells - 1 - ieta0), highPhi);
+  const Double_t minWidth = TMath::Min(fEtaWidth, fPhiWidth);
+
+  Int_t nFound = 0;
+  for (Int_t ring = 0; ring <= maxRing; ring++) {
+    if (ring > 1) {
+      // all objects in this ring are at least (ring - 1) cells away from the query direction
+      Double_t bound2 = (ring - 1) * minWidth * (ring - 1) * minWidth;
+      if (bound2 > maxDist2) break;
+      if (nFound == k && bound2 > dists[k - 1]) break;
+    }
+    for (Int_t deta = -ring; deta <= ring; deta++) {
+      Int_t ieta = ieta0 + deta;
+      if (ieta < 0 || ieta >= fNEtaCells) continue;
+      for (Int_t dphi = -TMath::Min(ring, lowPhi); dphi <= TMath::Min(ring, highPhi); dphi++) {
+        if (TMath::Abs(deta) != ring && TMath::Abs(dphi) != ring) continue;
+        Int_t iphi = (iphi0 + dphi + fNPhiCells) % fNPhiCells;
+        nFound = VisitCell(ieta, iphi, eta, phi, maxDist2, k, ids, dists, nFound);
+      }
+    }
+  }
+
+  for (Int_t i = 0; i < nFound; i++) dists[i] = TMath::Sqrt(dists[i]);
+  return nFound;
+}
+
+/**
+ * Finds all objects within a radius.
+ * @param[in] eta Pseudo-rapidity of the query direction
+ * @param[in] phi Azimuthal angle of the query direction
+ * @param[in] radius Search radius
+ * @param[out] ids Identifiers of the objects found (cleared first), in grid order
+ * @return Number of objects found
+ */
+Int_t AliEmcalSpatialIndex::FindWithinRadius(Double_t eta, Double_t phi, Double_t radius, std::vector<Int_t> &ids) const
+{
+  ids.clear();
+  if (!fBuilt || fIds.empty() || radius < 0) return 0;
+
+  phi = TVector2::Phi_0_2pi(phi);
+  const Double_t r2 = radius * radius;
+  const Int_t ietaMin = EtaCell(eta - radius), ietaMax = EtaCell(eta + radius);
+  Int_t iphiMin = TMath::FloorNint((phi - radius) / fPhiWidth);
+  Int_t iphiMax = TMath::FloorNint((phi + radius) / fPhiWidth);
+  if (iphiMax - iphiMin + 1 >= fNPhiCells) {
+    iphiMin = 0;
+    iphiMax = fNPhiCells - 1;
+  }
+
+  for (Int_t ieta = ietaMin; ieta <= ietaMax; ieta++) {
+    for (Int_t icell = iphiMin; icell <= iphiMax; icell++) {
+      Int_t iphi = ((icell % fNPhiCells) + fNPhiCells) % fNPhiCells;
+      Int_t cell = ieta * fNPhiCells + iphi;
+      for (Int_t i = fCellOffsets[cell]; i < fCellOffsets[cell + 1]; i++) {
+        Double_t deta = fEta[i] - eta, dphi = DeltaPhi(fPhi[i], phi);
+        if (deta * deta + dphi * dphi <= r2) ids.push_back(fIds[i]);
+      }
+    }
+  }
+
+  return ids.size();
+}
+
+/**
+ * Azimuthal difference wrapped into [-pi, pi).
+ * @param phi1 First angle
+ * @param phi2 Second angle
+ * @return phi1 - phi2 in [-pi, pi)
+ */
+Double_t AliEmcalSpatialIndex::DeltaPhi(Double_t phi1, Double_t phi2)
+{
+  Double_t dphi = TVector2::Phi_0_2pi(phi1 - phi2);
+  if (dphi >= TMath::Pi()) dphi -= TMath::TwoPi();
+  return dphi;
+}
+
+/**
+ * Eta cell of a given pseudo-rapidity, clamped to the grid.
+ */
+Int_t AliEmcalSpatialIndex::EtaCell(Double_t eta) const
+{
+  Int_t ieta = TMath::FloorNint((eta - fEtaMin) / fEtaWidth);
+  return TMath::Max(0, TMath::Min(fNEtaCells - 1, ieta));
+}
+
+/**
+ * Phi cell of a given azimuthal angle in [0, 2 pi).
+ */
+Int_t AliEmcalSpatialIndex::PhiCell(Double_t phi) const
+{
+  Int_t iphi = TMath::FloorNint(phi / fPhiWidth);
+  return TMath::Max(0, TMath::Min(fNPhiCells - 1, iphi));
+}
+
+/**
+ * Merges the entries of a cell into the sorted list of the k nearest objects found so far.
+ * @return Updated number of objects found
+ */
+Int_t AliEmcalSpatialIndex::VisitCell(Int_t ieta, Int_t iphi, Double_t eta, Double_t phi, Double_t maxDist2,
+                                      Int_t k, Int_t *ids, Double_t *dists2, Int_t nFound) const
+{
+  const Int_t cell = ieta * fNPhiCells + iphi;
+  for (Int_t i = fCellOffsets[cell]; i < fCellOffsets[cell + 1]; i++) {
+    Double_t deta = fEta[i] - eta, dphi = DeltaPhi(fPhi[i], phi);
+    Double_t d2 = deta * deta + dphi * dphi;
+    if (d2 > maxDist2) continue;
+    if (nFound == k && d2 >= dists2[k - 1]) continue;
+    Int_t j = nFound < k ? nFound++ : k - 1;
+    while (j > 0 && dists2[j - 1] > d2) {
+      ids[j] = ids[j - 1];
+      dists2[j] = dists2[j - 1];
+      j--;
+    }
+    ids[j] = fIds[i];
+    dists2[j] = d2;
+  }
+  return nFound;
+}
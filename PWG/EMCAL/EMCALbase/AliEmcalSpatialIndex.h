@@ -0,0 +1,105 @@
+/************************************************************************************
+ * Copyright (C) 2018, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALSPATIALINDEX_H
+#define ALIEMCALSPATIALINDEX_H
+
+#include <vector>
+
+#include <Rtypes.h>
+
+/**
+ * @class AliEmcalSpatialIndex
+ * @ingroup EMCALCOREFW
+ * @brief Binned eta-phi index for geometric matching
+ *
+ * Objects (jets, particles, clusters) are added with an identifier (usually their
+ * index in the container) and their (eta, phi) direction. Build() sorts them into
+ * a regular eta-phi grid (counting sort, no per-cell allocation). Queries then only
+ * visit the cells which can contain a candidate:
+ *  - FindNearest() / FindNearestNeighbors(): k nearest objects, optionally within a maximum distance
+ *  - FindWithinRadius(): all objects within a radius
+ *
+ * Distances are \f$\sqrt{\Delta\eta^2 + \Delta\varphi^2}\f$ with \f$\Delta\varphi\f$ wrapped
+ * into \f$[-\pi, \pi)\f$, i.e. objects on both sides of \f$\varphi = 0\f$ are neighbours.
+ *
+ * AliParticleContainer (and therefore AliJetContainer) builds an index over its accepted
+ * objects once per event on first request, see AliParticleContainer::GetSpatialIndex().
+ * With the accept cache enabled, containers with the same cut configuration share it:
+ * ~~~{.cxx}
+ * const AliEmcalSpatialIndex &tagIndex = tagJets->GetSpatialIndex();
+ * for (auto jet : baseJets->accepted()) {
+ *   Double_t dist = 0;
+ *   Int_t itag = tagIndex.FindNearest(jet->Eta(), jet->Phi(), maxDist, &dist);
+ *   if (itag >= 0) ... tagJets->GetJet(itag) ...
+ * }
+ * ~~~
+ */
+class AliEmcalSpatialIndex {
+ public:
+  AliEmcalSpatialIndex(Double_t cellSize = 0.2);
+  virtual ~AliEmcalSpatialIndex() {;}
+
+  void                        SetCellSize(Double_t size)                  { fCellSize = size; }
+  Double_t                    GetCellSize()                         const { return fCellSize; }
+
+  void                        Clear();
+  void                        Add(Int_t id, Double_t eta, Double_t phi);
+  void                        Build();
+
+  Bool_t                      IsBuilt()                             const { return fBuilt; }
+  Int_t                       GetNEntries()                         const { return fIds.size(); }
+  Int_t                       GetId(Int_t i)                        const { return fIds[i]; }
+  Double_t                    GetEta(Int_t i)                       const { return fEta[i]; }
+  Double_t                    GetPhi(Int_t i)                       const { return fPhi[i]; }
+
+  Int_t                       FindNearest(Double_t eta, Double_t phi, Double_t maxDist = -1, Double_t *dist = 0) const;
+  Int_t                       FindNearestNeighbors(Double_t eta, Double_t phi, Int_t k, Int_t *ids, Double_t *dists, Double_t maxDist = -1) const;
+  Int_t                       FindWithinRadius(Double_t eta, Double_t phi, Double_t radius, std::vector<Int_t> &ids) const;
+
+  static Double_t             DeltaPhi(Double_t phi1, Double_t phi2);
+
+ protected:
+  Int_t                       EtaCell(Double_t eta)                 const;
+  Int_t                       PhiCell(Double_t phi)                 const;
+  Int_t                       VisitCell(Int_t ieta, Int_t iphi, Double_t eta, Double_t phi, Double_t maxDist2,
+                                        Int_t k, Int_t *ids, Double_t *dists2, Int_t nFound) const;
+
+  Double_t                    fCellSize;          ///< requested cell size in eta and phi
+  Bool_t                      fBuilt;             ///< whether the grid is up to date with the entries
+  Int_t                       fNEtaCells;         ///< number of cells in eta
+  Int_t                       fNPhiCells;         ///< number of cells in phi (covering 2 pi)
+  Double_t                    fEtaMin;            ///< lower edge of the eta grid
+  Double_t                    fEtaWidth;          ///< cell width in eta
+  Double_t                    fPhiWidth;          ///< cell width in phi
+  std::vector<Int_t>          fIds;               ///< identifiers, grouped by cell after Build()
+  std::vector<Double_t>       fEta;               ///< eta, grouped by cell after Build()
+  std::vector<Double_t>       fPhi;               ///< phi in [0, 2 pi), grouped by cell after Build()
+  std::vector<Int_t>          fCellOffsets;       ///< offsets of the cells in the entry arrays (size ncells+1)
+  std::vector<Int_t>          fScratch;           ///< cell of each entry during Build()
+};
+
+#endif
@@ -14,13 +14,16 @@
  **************************************************************************/
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <vector>
 #include <TClonesArray.h>
 
 #include "AliVEvent.h"
 #include "AliLog.h"
+#include "AliAnalysisManager.h"
 
 #include "AliTLorentzVector.h"
+#include "AliEmcalSpatialIndex.h"
 #include "AliParticleContainer.h"
 
 /// \cond CLASSIMP
@@ -30,6 +33,18 @@ ClassImp(AliParticleContainer);
 // Properly instantiate the object
 AliEmcalContainerIndexMap <TClonesArray, AliVParticle> AliParticleContainer::fgEmcalContainerIndexMap;
 
+namespace {
+  /// Spatial index of one event shared by the containers with the same cut configuration
+  struct AliEmcalSharedSpatialIndex {
+    AliEmcalSharedSpatialIndex() : fIndex(), fArray(0), fNEntries(-1), fEvent(-1) {}
+
+    AliEmcalSpatialIndex        fIndex;     ///< index of the accepted objects
+    const TClonesArray         *fArray;     ///< array the index refers to
+    Int_t                       fNEntries;  ///< number of objects in the array
+    Long64_t                    fEvent;     ///< event the index refers to
+  };
+}
+
 /**
  * Default constructor.
  */
@@ -37,7 +52,10 @@ AliParticleContainer::AliParticleContainer():
   AliEmcalContainer(),
   fMinDistanceTPCSectorEdge(-1),
   fChargeCut(kNoChargeCut),
-  fGeneratorIndex(-1)
+  fGeneratorIndex(-1),
+  fSpatialIndexCellSize(0.2),
+  fSpatialIndex(0),
+  fSpatialIndexValid(kFALSE)
 {
   fBaseClassName = "AliVParticle";
   SetClassName("AliVParticle");
@@ -51,12 +69,92 @@ AliParticleContainer::AliParticleContainer(const char *name) :
   AliEmcalContainer(name),
   fMinDistanceTPCSectorEdge(-1),
   fChargeCut(kNoChargeCut),
-  fGeneratorIndex(-1)
+  fGeneratorIndex(-1),
+  fSpatialIndexCellSize(0.2),
+  fSpatialIndex(0),
+  fSpatialIndexValid(kFALSE)
 {
   fBaseClassName = "AliVParticle";
   SetClassName("AliVParticle");
 }
 
+/**
+ * Destructor.
+ */
+AliParticleContainer::~AliParticleContainer()
+{
+  delete fSpatialIndex;
+}
+
+/**
+ * Calls the base class method, then invalidates the spatial index which is
+ * rebuilt on first use in the new event.
+ * @param event Pointer to the current event
+ */
+void AliParticleContainer::NextEvent(const AliVEvent * event)
+{
+  AliEmcalContainer::NextEvent(event);
+
+  fSpatialIndexValid = kFALSE;
+}
+
+/**
+ * Returns the eta-phi index of the accepted objects of the current event. The
+ * identifiers in the index are the positions of the objects in the container.
+ * The index is built on the first call in each event. If the accept cache is
+ * enabled (see AliEmcalContainer::SetUseAcceptCache()), it is shared through a
+ * static registry by all containers with the same cut configuration (including
+ * the cell size), i.e. by all the tasks of a train which use the same container
+ * setup. Otherwise each container builds its own index; call ResetSpatialIndex()
+ * after changing the cuts within an event.
+ * @return Spatial index of the accepted objects
+ */
+const AliEmcalSpatialIndex &AliParticleContainer::GetSpatialIndex()
+{
+  const AliEmcalContainerAcceptCache *cache = GetAcceptCache();
+  if (cache) {
+    // the accept caches are unique per cut configuration and never deleted
+    static std::map<const AliEmcalContainerAcceptCache*, AliEmcalSharedSpatialIndex> indices;
+    AliEmcalSharedSpatialIndex &shared = indices[cache];
+    const Long64_t event = AliAnalysisManager::GetAnalysisManager()->GetNcalls();
+    if (shared.fEvent != event || shared.fArray != fClArray || shared.fNEntries != GetNEntries()) {
+      FillSpatialIndex(shared.fIndex, cache);
+      shared.fArray = fClArray;
+      shared.fNEntries = GetNEntries();
+      shared.fEvent = event;
+    }
+    return shared.fIndex;
+  }
+
+  if (!fSpatialIndex) fSpatialIndex = new AliEmcalSpatialIndex(fSpatialIndexCellSize);
+
+  if (!fSpatialIndexValid) {
+    FillSpatialIndex(*fSpatialIndex, 0);
+    fSpatialIndexValid = kTRUE;
+  }
+
+  return *fSpatialIndex;
+}
+
+/**
+ * Fills an eta-phi index with the accepted objects of the current event.
+ * @param[out] index Spatial index to be filled
+ * @param[in] cache Accept cache of the current event, NULL to evaluate the cuts
+ */
+void AliParticleContainer::FillSpatialIndex(AliEmcalSpatialIndex &index, const AliEmcalContainerAcceptCache *cache) const
+{
+  index.Clear();
+  index.SetCellSize(fSpatialIndexCellSize);
+  AliTLorentzVector mom;
+  for (Int_t i = 0; i < GetNEntries(); i++) {
+    UInt_t rejectionReason = 0;
+    if (cache ? !cache->IsAccepted(i) : !AcceptObject(i, rejectionReason)) continue;
+    GetMomentum(mom, i);
+    index.Add(i, mom.Eta(), mom.Phi());
+  }
+  index.Build();
+}
+
 /**
  * Get the leading particle in the container. If "p" is contained in the parameter opt,
  * then the absolute momentum is use instead of the transverse momentum.
@@ -8,6 +8,7 @@
 
 class AliVEvent;
 class AliTLorentzVector;
+class AliEmcalSpatialIndex;
 
 #include "AliEmcalContainer.h"
 #if !(defined(__CINT__) || defined(__MAKECINT__))
@@ -34,7 +35,7 @@ class AliParticleContainer : public AliEmcalContainer {
 
   AliParticleContainer();
   AliParticleContainer(const char *name);
-  virtual ~AliParticleContainer(){;}
+  virtual ~AliParticleContainer();
 
   /**
    * Index operator: Providing access to track in the container with the
@@ -76,6 +77,11 @@ class AliParticleContainer : public AliEmcalContainer {
   void                        SelectHIJING(Bool_t s)                            { if (s) fGeneratorIndex = 0; else fGeneratorIndex = -1; }
   void                        SetGeneratorIndex(Short_t i)                      { fGeneratorIndex = i  ; }
   void                        SetArray(const AliVEvent * event);
+  virtual void                NextEvent(const AliVEvent * event);
+
+  const AliEmcalSpatialIndex &GetSpatialIndex()                                 ;
+  void                        ResetSpatialIndex()                               { fSpatialIndexValid = kFALSE; }
+  void                        SetSpatialIndexCellSize(Double_t s)               { fSpatialIndexCellSize = s; }
 
   const char*                 GetTitle() const;
 
@@ -91,6 +97,7 @@ class AliParticleContainer : public AliEmcalContainer {
 #endif
 
  protected:
+  void                        FillSpatialIndex(AliEmcalSpatialIndex &index, const AliEmcalContainerAcceptCache *cache) const;
 
 #if !(defined(__CINT__) || defined(__MAKECINT__))
   static AliEmcalContainerIndexMap <TClonesArray, AliVParticle> fgEmcalContainerIndexMap; //!<! Mapping from containers to indices
@@ -99,13 +106,16 @@ class AliParticleContainer : public AliEmcalContainer {
   Double_t                    fMinDistanceTPCSectorEdge;      ///< require minimum distance to edge of TPC sector edge
   EChargeCut_t                fChargeCut;                     ///< select particles according to their charge
   Short_t                     fGeneratorIndex;                ///< select MC particles with generator index (default = -1 = switch off selection)
+  Double_t                    fSpatialIndexCellSize;          ///< cell size in eta and phi of the spatial index
+  AliEmcalSpatialIndex       *fSpatialIndex;                  //!<! eta-phi index of the accepted objects of the current event (if not shared)
+  Bool_t                      fSpatialIndexValid;             //!<! whether the spatial index has been built for the current event
 
  private:
   AliParticleContainer(const AliParticleContainer& obj); // copy constructor
   AliParticleContainer& operator=(const AliParticleContainer& other); // assignment
 
   /// \cond CLASSIMP
-  ClassDef(AliParticleContainer,11);
+  ClassDef(AliParticleContainer,12);
   /// \endcond
 
 };
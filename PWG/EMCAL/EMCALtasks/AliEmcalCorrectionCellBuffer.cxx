@@ -0,0 +1,65 @@
+// AliEmcalCorrectionCellBuffer
+//
+
+#include "AliEmcalCorrectionCellBuffer.h"
+
+#include <AliVCaloCells.h>
+
+/**
+ * Default constructor
+ */
+AliEmcalCorrectionCellBuffer::AliEmcalCorrectionCellBuffer():
+  fCells(nullptr),
+  fModified(kFALSE),
+  fAbsIds(),
+  fAmplitudes(),
+  fTimes(),
+  fMCLabels(),
+  fEFractions(),
+  fHighGain()
+{
+}
+
+/**
+ * Copy the content of the cells object into the columns.
+ * The buffer remembers the cells object such that Store() can write it back.
+ *
+ * @param[in] cells Cells object to be loaded
+ */
+void AliEmcalCorrectionCellBuffer::Load(AliVCaloCells * cells)
+{
+  fCells = cells;
+  fModified = kFALSE;
+
+  Int_t ncells = cells ? cells->GetNumberOfCells() : 0;
+  fAbsIds.resize(ncells);
+  fAmplitudes.resize(ncells);
+  fTimes.resize(ncells);
+  fMCLabels.resize(ncells);
+  fEFractions.resize(ncells);
+  fHighGain.resize(ncells);
+
+  for (Int_t iCell = 0; iCell < ncells; iCell++) {
+    cells->GetCell(iCell, fAbsIds[iCell], fAmplitudes[iCell], fTimes[iCell], fMCLabels[iCell], fEFractions[iCell]);
+    fHighGain[iCell] = cells->GetHighGain(iCell);
+  }
+}
+
+/**
+ * Write the columns back to the cells object they were loaded from (only if
+ * they were modified) and sort the cells. Afterwards the buffer is not loaded
+ * anymore, but keeps its memory for the next event.
+ */
+void AliEmcalCorrectionCellBuffer::Store()
+{
+  if (fCells && fModified) {
+    Int_t ncells = fAbsIds.size();
+    for (Int_t iCell = 0; iCell < ncells; iCell++) {
+      fCells->SetCell(iCell, fAbsIds[iCell], fAmplitudes[iCell], fTimes[iCell], fMCLabels[iCell], fEFractions[iCell], fHighGain[iCell]);
+    }
+    fCells->Sort();
+  }
+
+  fCells = nullptr;
+  fModified = kFALSE;
+}
@@ -0,0 +1,68 @@
+#ifndef ALIEMCALCORRECTIONCELLBUFFER_H
+#define ALIEMCALCORRECTIONCELLBUFFER_H
+
+#include <vector>
+
+#include <Rtypes.h>
+
+class AliVCaloCells;
+
+/**
+ * @class AliEmcalCorrectionCellBuffer
+ * @ingroup EMCALCORRECTIONFW
+ * @brief Columnar copy of a cells object shared by the cell correction components
+ *
+ * Holds the content of an AliVCaloCells object as one array per cell property
+ * (absolute ID, energy, time, MC label, energy fraction and high gain flag).
+ * The correction task loads the buffer once per event before the first cell
+ * component which supports it, the components then work on the arrays in bulk
+ * (see AliEMCALRecoUtils::RecalibrateCells(Int_t, ...)), and the task writes the
+ * buffer back to the cells object once, before any component which reads the
+ * cells object directly and at the end of the event.
+ *
+ * The arrays keep their capacity between events, so no allocation is done
+ * once the largest event has been seen.
+ *
+ * @date Oct 18, 2026
+ */
+class AliEmcalCorrectionCellBuffer {
+ public:
+  AliEmcalCorrectionCellBuffer();
+  ~AliEmcalCorrectionCellBuffer() {}
+
+  void Load(AliVCaloCells * cells);
+  void Store();
+
+  /// Cells object the buffer was loaded from, nullptr if not loaded
+  AliVCaloCells *GetCells()                  const { return fCells                 ; }
+  /// True if the buffer holds the content of a cells object
+  Bool_t         IsLoaded()                  const { return fCells != nullptr      ; }
+  /// Flag the buffer to be written back to the cells object in Store()
+  void           SetModified()                     { fModified = kTRUE             ; }
+  Bool_t         IsModified()                const { return fModified              ; }
+  Int_t          GetNumberOfCells()          const { return fAbsIds.size()         ; }
+
+  Short_t       *GetAbsIds()                       { return fAbsIds.data()         ; }
+  Double_t      *GetAmplitudes()                   { return fAmplitudes.data()     ; }
+  Double_t      *GetTimes()                        { return fTimes.data()          ; }
+  Int_t         *GetMCLabels()                     { return fMCLabels.data()       ; }
+  Double_t      *GetEFractions()                   { return fEFractions.data()     ; }
+  UChar_t       *GetHighGain()                     { return fHighGain.data()       ; }
+  const Double_t *GetAmplitudes()            const { return fAmplitudes.data()     ; }
+  const Double_t *GetTimes()                 const { return fTimes.data()          ; }
+
+ private:
+  AliVCaloCells          *fCells;         ///< Cells object the buffer was loaded from
+  Bool_t                  fModified;      ///< Whether the columns changed since Load()
+  std::vector<Short_t>    fAbsIds;        ///< Cell absolute IDs
+  std::vector<Double_t>   fAmplitudes;    ///< Cell energies
+  std::vector<Double_t>   fTimes;         ///< Cell times
+  std::vector<Int_t>      fMCLabels;      ///< Cell MC labels
+  std::vector<Double_t>   fEFractions;    ///< Cell energy fractions from embedding
+  std::vector<UChar_t>    fHighGain;      ///< Cell high gain flags (0 for low gain)
+
+  AliEmcalCorrectionCellBuffer(const AliEmcalCorrectionCellBuffer &);               // Not implemented
+  AliEmcalCorrectionCellBuffer &operator=(const AliEmcalCorrectionCellBuffer &);    // Not implemented
+};
+
+#endif /* ALIEMCALCORRECTIONCELLBUFFER_H */
@@ -32,6 +32,7 @@ class AliEmcalCorrectionCellTimeCalib : public AliEmcalCorrectionComponent {
   void UserCreateOutputObjects();
   Bool_t Run();
   Bool_t CheckIfRunChanged();
+  Bool_t UsesCellBuffer() const { return kTRUE; }
   
 protected:
   TH1F* fCellTimeDistBefore;            //!<! cell energy distribution, before time calibration
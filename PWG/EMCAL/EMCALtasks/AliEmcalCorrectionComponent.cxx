@@ -3,6 +3,8 @@
 
 #include "AliEmcalCorrectionComponent.h"
 
+#include <algorithm>
+
 #include <TFile.h>
 #include <TH1.h>
 
@@ -16,6 +18,7 @@
 #include "AliParticleContainer.h"
 #include "AliMCParticleContainer.h"
 #include "AliDataFile.h"
+#include "AliEmcalCorrectionCellBuffer.h"
 
 /// \cond CLASSIMP
 ClassImp(AliEmcalCorrectionComponent);
@@ -49,6 +52,7 @@ AliEmcalCorrectionComponent::AliEmcalCorrectionComponent() :
   fClusterCollArray(),
   fParticleCollArray(),
   fCaloCells(0),
+  fCellBuffer(0),
   fRecoUtils(0),
   fOutput(0),
   fBasePath(""),
@@ -85,6 +89,7 @@ AliEmcalCorrectionComponent::AliEmcalCorrectionComponent(const char * name) :
   fClusterCollArray(),
   fParticleCollArray(),
   fCaloCells(0),
+  fCellBuffer(0),
   fRecoUtils(0),
   fOutput(0),
   fBasePath(""),
@@ -200,6 +205,9 @@ void AliEmcalCorrectionComponent::GetEtaPhiDiff(const AliVTrack *t, const AliVCl
 /**
  * Remove bad cells from the cell list
  * Recalibrate energy and time cells
+ *
+ * If the correction task provided a cell buffer, the cells are corrected in the
+ * buffer and written back to the cells object (and sorted) by the task.
  */
 void AliEmcalCorrectionComponent::UpdateCells()
 {
@@ -222,9 +230,23 @@ void AliEmcalCorrectionComponent::UpdateCells()
     }
     //end of PAR run settings
 
-    fRecoUtils->RecalibrateCells(fCaloCells, bunchCrossNo);
+    if (fCellBuffer) {
+      Bool_t recalibrated = fRecoUtils->RecalibrateCells(fCellBuffer->GetNumberOfCells(), fCellBuffer->GetAbsIds(), fCellBuffer->GetHighGain(),
+                                                         fCellBuffer->GetAmplitudes(), fCellBuffer->GetTimes(), bunchCrossNo);
+      // RecalibrateCells(cells, bc) rewrites the cells without the gain flag, which
+      // leaves all of them flagged low gain. Do the same, such that both paths agree.
+      // If nothing was recalibrated the cells (and their gain flags) stay as they are.
+      if (recalibrated) {
+        std::fill(fCellBuffer->GetHighGain(), fCellBuffer->GetHighGain() + fCellBuffer->GetNumberOfCells(), 0);
+        fCellBuffer->SetModified();
+      }
+    }
+    else {
+      fRecoUtils->RecalibrateCells(fCaloCells, bunchCrossNo);
+    }
   }
-  fCaloCells->Sort();
+  if (!fCellBuffer)
+    fCaloCells->Sort();
 }
 
 /**
@@ -303,6 +325,17 @@ void AliEmcalCorrectionComponent::GetPass()
 void AliEmcalCorrectionComponent::FillCellQA(TH1F* h){
   TString name = h->GetName();
   
+  if (fCellBuffer) {
+    const Double_t * values = 0;
+    if(name.Contains("Energy"))
+      values = fCellBuffer->GetAmplitudes();
+    else if(name.Contains("Time"))
+      values = fCellBuffer->GetTimes();
+    if (values)
+      h->FillN(fCellBuffer->GetNumberOfCells(), values, 0);
+    return;
+  }
+  
   Short_t  absId  =-1;
   Double_t ecell = 0;
   Double_t tcell = 0;
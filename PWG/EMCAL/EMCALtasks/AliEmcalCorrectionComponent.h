@@ -9,6 +9,7 @@ class TH1F;
 
 class AliMCEvent;
 class AliEMCALRecoUtils;
+class AliEmcalCorrectionCellBuffer;
 class AliVCaloCells;
 class AliVTrack;
 class AliVCluster;
@@ -53,6 +54,8 @@ class AliEmcalCorrectionComponent : public TNamed {
   virtual Bool_t Run();
   virtual Bool_t UserNotify();
   virtual Bool_t CheckIfRunChanged();
+  /// True if the component can work on the columnar cell buffer instead of the cells object
+  virtual Bool_t UsesCellBuffer() const { return kFALSE; }
   
   void GetEtaPhiDiff(const AliVTrack *t, const AliVCluster *v, Double_t &phidiff, Double_t &etadiff);
   void UpdateCells();
@@ -81,9 +84,12 @@ class AliEmcalCorrectionComponent : public TNamed {
   void                    RemoveClusterContainer(Int_t i=0)                      { fClusterCollArray.RemoveAt(i)                       ; }
   AliEMCALRecoUtils      *GetRecoUtils()  const { return fRecoUtils; }
   AliVCaloCells          *GetCaloCells()  const { return fCaloCells; }
+  AliEmcalCorrectionCellBuffer *GetCellBuffer() const { return fCellBuffer; }
   TList                  *GetOutputList() const { return fOutput; }
   
   void SetCaloCells(AliVCaloCells * cells) { fCaloCells = cells; }
+  /// Set the columnar buffer holding the content of fCaloCells for this event (set by the correction task)
+  void SetCellBuffer(AliEmcalCorrectionCellBuffer * buffer) { fCellBuffer = buffer; }
   void SetRecoUtils(AliEMCALRecoUtils *ru) { fRecoUtils = ru; }
 
   void SetInputEvent(AliVEvent * event) { fEventManager.SetInputEvent(event); }
@@ -131,6 +137,7 @@ class AliEmcalCorrectionComponent : public TNamed {
   TObjArray               fClusterCollArray;              ///< Cluster collection array
   TObjArray               fParticleCollArray;             ///< Particle/track collection array
   AliVCaloCells          *fCaloCells;                     //!<! Pointer to CaloCells
+  AliEmcalCorrectionCellBuffer *fCellBuffer;              //!<! Columnar copy of fCaloCells, if provided by the correction task
   AliEMCALRecoUtils      *fRecoUtils;                     ///<  Pointer to RecoUtils
   TList                  *fOutput;                        //!<! List of output histograms
   
@@ -142,7 +149,7 @@ class AliEmcalCorrectionComponent : public TNamed {
   AliEmcalCorrectionComponent &operator=(const AliEmcalCorrectionComponent &);    // Not implemented
   
   /// \cond CLASSIMP
-  ClassDef(AliEmcalCorrectionComponent, 9); // EMCal correction component
+  ClassDef(AliEmcalCorrectionComponent, 10); // EMCal correction component
   /// \endcond
 };
 
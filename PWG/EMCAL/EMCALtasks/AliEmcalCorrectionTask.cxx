@@ -5,6 +5,7 @@
 
 #include "AliEmcalCorrectionTask.h"
 #include "AliEmcalCorrectionComponent.h"
+#include "AliEmcalCorrectionCellBuffer.h"
 
 #include <vector>
 #include <set>
@@ -14,6 +15,8 @@
 #include <algorithm>
 
 #include <TChain.h>
+#include <TH1F.h>
+#include <TStopwatch.h>
 
 #include <AliAnalysisManager.h>
 #include <AliVEventHandler.h>
@@ -64,7 +67,12 @@ AliEmcalCorrectionTask::AliEmcalCorrectionTask() :
   fParticleCollArray(),
   fClusterCollArray(),
   fCellCollArray(),
-  fOutput(0)
+  fUseCellBuffer(kTRUE),
+  fCellBuffers(),
+  fOutput(0),
+  fHistCPUTime(0),
+  fHistRealTime(0),
+  fTimer(0)
 {
   // Default constructor
   AliDebug(3, Form("%s", __PRETTY_FUNCTION__));
@@ -109,7 +117,12 @@ AliEmcalCorrectionTask::AliEmcalCorrectionTask(const char * name) :
   fParticleCollArray(),
   fClusterCollArray(),
   fCellCollArray(),
-  fOutput(0)
+  fUseCellBuffer(kTRUE),
+  fCellBuffers(),
+  fOutput(0),
+  fHistCPUTime(0),
+  fHistRealTime(0),
+  fTimer(0)
 {
   // Standard constructor
   AliDebug(3, Form("%s", __PRETTY_FUNCTION__));
@@ -153,7 +166,12 @@ AliEmcalCorrectionTask::AliEmcalCorrectionTask(const AliEmcalCorrectionTask & ta
   fGeom(task.fGeom),
   fParticleCollArray(*(static_cast<TObjArray *>(task.fParticleCollArray.Clone()))),
   fClusterCollArray(*(static_cast<TObjArray *>(task.fClusterCollArray.Clone()))),
-  fOutput(task.fOutput)                           // TODO: More care is needed here!
+  fUseCellBuffer(task.fUseCellBuffer),
+  fCellBuffers(),
+  fOutput(task.fOutput),                          // TODO: More care is needed here!
+  fHistCPUTime(task.fHistCPUTime),
+  fHistRealTime(task.fHistRealTime),
+  fTimer(task.fTimer ? new TStopwatch() : 0) // the timer is not shared, only its measurements are stored
 {
   // Vertex position
   std::copy(std::begin(task.fVertex), std::end(task.fVertex), std::begin(fVertex));
@@ -217,7 +235,12 @@ void swap(AliEmcalCorrectionTask & first, AliEmcalCorrectionTask & second)
   swap(first.fParticleCollArray, second.fParticleCollArray);
   swap(first.fClusterCollArray, second.fClusterCollArray);
   swap(first.fCellCollArray, second.fCellCollArray);
+  swap(first.fUseCellBuffer, second.fUseCellBuffer);
+  swap(first.fCellBuffers, second.fCellBuffers);
   swap(first.fOutput, second.fOutput);
+  swap(first.fHistCPUTime, second.fHistCPUTime);
+  swap(first.fHistRealTime, second.fHistRealTime);
+  swap(first.fTimer, second.fTimer);
 }
 
 /**
@@ -227,6 +250,11 @@ void swap(AliEmcalCorrectionTask & first, AliEmcalCorrectionTask & second)
 AliEmcalCorrectionTask::~AliEmcalCorrectionTask()
 {
   // Destructor
+  for (auto buffer : fCellBuffers)
+  {
+    delete buffer;
+  }
+  delete fTimer;
 }
 
 void AliEmcalCorrectionTask::Initialize(bool removeDummyTask)
@@ -1036,6 +1064,13 @@ void AliEmcalCorrectionTask::UserCreateOutputObjects()
   fOutput = new TList();
   fOutput->SetOwner();
 
+  // Time spent in the components per event
+  fHistCPUTime = new TH1F("hCorrectionTaskCPUTime","hCorrectionTaskCPUTime;CPU Time (ms)", 2000, 0, 1000);
+  fOutput->Add(fHistCPUTime);
+  fHistRealTime = new TH1F("hCorrectionTaskRealTime","hCorrectionTaskRealTime;Real Time (ms)", 2000, 0, 1000);
+  fOutput->Add(fHistRealTime);
+  fTimer = new TStopwatch();
+
   UserCreateOutputObjectsComponents();
 
   PostData(1, fOutput);
@@ -1296,6 +1331,9 @@ Bool_t AliEmcalCorrectionTask::RetrieveEventObjects()
  */
 Bool_t AliEmcalCorrectionTask::Run()
 {
+  // The timer is created in UserCreateOutputObjects()
+  if (fTimer) fTimer->Start(kTRUE);
+
   // Run the initialization for all derived classes.
   for (auto component : fCorrectionComponents)
   {
@@ -1305,14 +1343,79 @@ Bool_t AliEmcalCorrectionTask::Run()
     component->SetCentrality(fCent);
     component->SetVertex(fVertex);
 
+    PrepareCellBuffer(component);
+
     component->Run();
   }
 
+  // Write the corrected cells back once at the end of the event
+  StoreCellBuffers();
+
+  if (fTimer) {
+    fTimer->Stop();
+    fHistCPUTime->Fill(fTimer->CpuTime() * 1000.);
+    fHistRealTime->Fill(fTimer->RealTime() * 1000.);
+  }
+
   PostData(1, fOutput);
 
   return kTRUE;
 }
 
+/**
+ * Provide the cells of the component as a columnar buffer if the component supports it.
+ * The buffer is loaded from the cells object the first time it is needed in the event,
+ * and shared by all following cell components using the same cells object. Before a
+ * component which does not support the buffer (clusterizer, cell combination, ...) is
+ * run, all buffers are written back, as such a component may read any cells object.
+ *
+ * @param[in] component Correction component which is about to be run
+ */
+void AliEmcalCorrectionTask::PrepareCellBuffer(AliEmcalCorrectionComponent * component)
+{
+  AliVCaloCells * cells = component->GetCaloCells();
+  if (!fUseCellBuffer || !cells || !component->UsesCellBuffer())
+  {
+    StoreCellBuffers();
+    component->SetCellBuffer(0);
+    return;
+  }
+
+  AliEmcalCorrectionCellBuffer * buffer = 0;
+  AliEmcalCorrectionCellBuffer * unused = 0;
+  for (auto candidate : fCellBuffers)
+  {
+    if (candidate->GetCells() == cells) {
+      buffer = candidate;
+      break;
+    }
+    if (!unused && !candidate->IsLoaded()) unused = candidate;
+  }
+
+  if (!buffer)
+  {
+    buffer = unused;
+    if (!buffer) {
+      buffer = new AliEmcalCorrectionCellBuffer();
+      fCellBuffers.push_back(buffer);
+    }
+    buffer->Load(cells);
+  }
+
+  component->SetCellBuffer(buffer);
+}
+
+/**
+ * Write all loaded cell buffers back to their cells objects.
+ */
+void AliEmcalCorrectionTask::StoreCellBuffers()
+{
+  for (auto buffer : fCellBuffers)
+  {
+    if (buffer->IsLoaded()) buffer->Store();
+  }
+}
+
 /**
  * Executed when the file is changed. Also calls UserNotify() for each component.
  */
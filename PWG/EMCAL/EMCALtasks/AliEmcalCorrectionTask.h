@@ -1,10 +1,13 @@
 #ifndef ALIEMCALCORRECTIONTASK_H
 #define ALIEMCALCORRECTIONTASK_H
 
+class AliEmcalCorrectionCellBuffer;
 class AliEmcalCorrectionCellContainer;
 class AliEmcalCorrectionComponent;
 class AliEMCALGeometry;
 class AliVEvent;
+class TH1F;
+class TStopwatch;
 
 #include <AliAnalysisTaskSE.h>
 #include <AliVCluster.h>
@@ -100,6 +103,8 @@ class AliEmcalCorrectionTask : public AliAnalysisTaskSE {
   // Set
   void                        SetForceBeamType(BeamType f)                          { fForceBeamType     = f                              ; }
   void                        SetNeedEmcalGeometry(Bool_t b)                        { fNeedEmcalGeom     = b                              ; }
+  /// Let the cell components work on a columnar copy of the cells which is written back once per event
+  void                        SetUseCellBuffer(Bool_t b)                            { fUseCellBuffer     = b                              ; }
   // Centrality options
   void                        SetUseNewCentralityEstimation(Bool_t b)               { fUseNewCentralityEstimation = b                     ; }
   void                        SetCentralityEstimator(const char * c)                { fCentEst           = c                              ; }
@@ -190,6 +195,9 @@ class AliEmcalCorrectionTask : public AliAnalysisTaskSE {
 
   // Execute component functions
   void UserCreateOutputObjectsComponents();
+  // Cell buffer handling
+  void PrepareCellBuffer(AliEmcalCorrectionComponent * component);
+  void StoreCellBuffers();
   void ExecOnceComponents();
 
   // Initialization functions
@@ -246,10 +254,16 @@ class AliEmcalCorrectionTask : public AliAnalysisTaskSE {
   TObjArray                   fClusterCollArray;           ///< Cluster collection array
   std::vector <AliEmcalCorrectionCellContainer *> fCellCollArray; ///< Cells collection array
   
+  Bool_t                      fUseCellBuffer;              ///< Run the cell components on a columnar copy of the cells
+  std::vector <AliEmcalCorrectionCellBuffer *> fCellBuffers; //!<! Columnar cell buffers, one per cells object
+  
   TList *                     fOutput;                     //!<! Output for histograms
+  TH1F *                      fHistCPUTime;                //!<! CPU time per event for running all components
+  TH1F *                      fHistRealTime;               //!<! Real time per event for running all components
+  TStopwatch *                fTimer;                      //!<! Timer for running all components
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalCorrectionTask, 9); // EMCal correction task
+  ClassDef(AliEmcalCorrectionTask, 10); // EMCal correction task
   /// \endcond
 };
 
@@ -137,6 +137,8 @@ AliFlowAnalysisWithQCumulants::AliFlowAnalysisWithQCumulants():
  fReQ(NULL),
  fImQ(NULL),
  fSpk(NULL),
+ fRPPhiEBE(),
+ fRPWeightEBE(),
  fIntFlowCorrelationsEBE(NULL),
  fIntFlowEventWeightsForCorrelationsEBE(NULL),
  fIntFlowCorrelationsAllEBE(NULL),
@@ -362,7 +364,12 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
  Double_t wPt  = 1.; // pt weight
  Double_t wEta = 1.; // eta weight
  Double_t wTrack = 1.; // track weight
+ Double_t dWeight = 1.; // product of all weights for this particle
+ Double_t dCos[4] = {0.}; // cos((m+1)*n*dPhi) for differential flow
+ Double_t dSin[4] = {0.}; // sin((m+1)*n*dPhi) for differential flow
+ Double_t dWeightPow[9] = {0.}; // dWeight^k for differential flow
  Int_t nCounterNoRPs = 0; // needed only for shuffling
+ Int_t nRPs = 0; // number of RPs stored for the calculation of Q-vectors
  fNumberOfRPsEBE = anEvent->GetNumberOfRPs(); // number of RPs (i.e. number of reference particles)
  if(fExactNoRPs > 0 && fNumberOfRPsEBE<fExactNoRPs){return;}
  fNumberOfPOIsEBE = anEvent->GetNumberOfPOIs(); // number of POIs (i.e. number of particles of interest)
@@ -377,6 +384,11 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
                                                                                                                                                                                                                                                                                         
  // d) Loop over data and calculate e-b-e quantities Q_{n,k}, S_{p,k} and s_{p,k}:
  Int_t nPrim = anEvent->NumberOfTracks();  // nPrim = total number of primary tracks
+ if(fRPPhiEBE.GetSize()<nPrim) // phi and weights of RPs are stored in arrays, Q_{n,k} and S_{p,k} are calculated after the loop in CalculateQVectors()
+ {
+  fRPPhiEBE.Set(nPrim);
+  fRPWeightEBE.Set(nPrim);
+ }
  AliFlowTrackSimple *aftsTrack = NULL;
  Int_t n = fHarmonic; // shortcut for the harmonic 
  for(Int_t i=0;i<nPrim;i++) 
@@ -409,28 +421,26 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     {
      wTrack = aftsTrack->Weight(); 
     }
-    // Calculate Re[Q_{m*n,k}] and Im[Q_{m*n,k}] for this event (m = 1,2,...,12, k = 0,1,...,8):
-    for(Int_t m=0;m<12;m++) // to be improved - hardwired 6 
-    {
-     for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
-     {
-      (*fReQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1)*n*dPhi); 
-      (*fImQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1)*n*dPhi); 
-     } 
-    }
-    // Calculate S_{p,k} for this event (Remark: final calculation of S_{p,k} follows after the loop over data bellow):
-    for(Int_t p=0;p<8;p++)
-    {
-     for(Int_t k=0;k<9;k++)
-     {     
-      (*fSpk)(p,k)+=pow(wPhi*wPt*wEta*wTrack,k);
-     }
-    } 
+    dWeight = wPhi*wPt*wEta*wTrack;
+    // Store phi and weight for the calculation of Re[Q_{m*n,k}], Im[Q_{m*n,k}] and S_{p,k} after the loop over data:
+    fRPPhiEBE[nRPs] = dPhi;
+    fRPWeightEBE[nRPs] = dWeight;
+    nRPs++;
     // Differential flow:
     if(fCalculateDiffFlow || fCalculate2DDiffFlow)
     {
      ptEta[0] = dPt; 
      ptEta[1] = dEta; 
+     // cos, sin and powers of weight needed below are evaluated only once for this particle:
+     for(Int_t m=0;m<4;m++)
+     {
+      dCos[m] = TMath::Cos((m+1.)*n*dPhi);
+      dSin[m] = TMath::Sin((m+1.)*n*dPhi);
+     }
+     for(Int_t k=0;k<9;k++)
+     {
+      dWeightPow[k] = pow(dWeight,k);
+     }
      // Calculate r_{m*n,k} and s_{p,k} (r_{m,k} is 'p-vector' for RPs): 
      for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
      {
@@ -440,21 +450,21 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
        {
         for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
         {
-         fReRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-         fImRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
+         fReRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],dWeightPow[k]*dCos[m],1.);
+         fImRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],dWeightPow[k]*dSin[m],1.);          
          if(m==0) // s_{p,k} does not depend on index m
          {
-          fs1dEBE[0][pe][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k),1.);
+          fs1dEBE[0][pe][k]->Fill(ptEta[pe],dWeightPow[k],1.);
          } // end of if(m==0) // s_{p,k} does not depend on index m
         } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
        } // end of if(fCalculateDiffFlow) 
        if(fCalculate2DDiffFlow)
        {
-        fReRPQ2dEBE[0][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-        fImRPQ2dEBE[0][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
+        fReRPQ2dEBE[0][m][k]->Fill(dPt,dEta,dWeightPow[k]*dCos[m],1.);
+        fImRPQ2dEBE[0][m][k]->Fill(dPt,dEta,dWeightPow[k]*dSin[m],1.);      
         if(m==0) // s_{p,k} does not depend on index m
         {
-         fs2dEBE[0][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k),1.);
+         fs2dEBE[0][k]->Fill(dPt,dEta,dWeightPow[k],1.);
         } // end of if(m==0) // s_{p,k} does not depend on index m
        } // end of if(fCalculate2DDiffFlow)
       } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
@@ -471,21 +481,21 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
         {
          for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
          {
-          fReRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-          fImRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
+          fReRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],dWeightPow[k]*dCos[m],1.);
+          fImRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],dWeightPow[k]*dSin[m],1.);          
           if(m==0) // s_{p,k} does not depend on index m
           {
-           fs1dEBE[2][pe][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k),1.);
+           fs1dEBE[2][pe][k]->Fill(ptEta[pe],dWeightPow[k],1.);
           } // end of if(m==0) // s_{p,k} does not depend on index m
          } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
         } // end of if(fCalculateDiffFlow) 
         if(fCalculate2DDiffFlow)
         {
-         fReRPQ2dEBE[2][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-         fImRPQ2dEBE[2][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
+         fReRPQ2dEBE[2][m][k]->Fill(dPt,dEta,dWeightPow[k]*dCos[m],1.);
+         fImRPQ2dEBE[2][m][k]->Fill(dPt,dEta,dWeightPow[k]*dSin[m],1.);      
          if(m==0) // s_{p,k} does not depend on index m
          {
-          fs2dEBE[2][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k),1.);
+          fs2dEBE[2][k]->Fill(dPt,dEta,dWeightPow[k],1.);
          } // end of if(m==0) // s_{p,k} does not depend on index m
         } // end of if(fCalculate2DDiffFlow)
        } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
@@ -521,6 +531,20 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     }
     ptEta[0] = dPt;
     ptEta[1] = dEta;
+    dWeight = wPhi*wPt*wEta*wTrack;
+    if(fCalculateDiffFlow || fCalculate2DDiffFlow)
+    {
+     // cos, sin and powers of weight needed below are evaluated only once for this particle:
+     for(Int_t m=0;m<4;m++)
+     {
+      dCos[m] = TMath::Cos((m+1.)*n*dPhi);
+      dSin[m] = TMath::Sin((m+1.)*n*dPhi);
+     }
+     for(Int_t k=0;k<9;k++)
+     {
+      dWeightPow[k] = pow(dWeight,k);
+     }
+    }
     // Calculate p_{m*n,k} ('p-vector' for POIs): 
     for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
     {
@@ -530,14 +554,14 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
       {
        for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
        {
-        fReRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-        fImRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
+        fReRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],dWeightPow[k]*dCos[m],1.);
+        fImRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],dWeightPow[k]*dSin[m],1.);          
        } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
       } // end of if(fCalculateDiffFlow) 
       if(fCalculate2DDiffFlow)
       {
-       fReRPQ2dEBE[1][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-       fImRPQ2dEBE[1][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
+       fReRPQ2dEBE[1][m][k]->Fill(dPt,dEta,dWeightPow[k]*dCos[m],1.);
+       fImRPQ2dEBE[1][m][k]->Fill(dPt,dEta,dWeightPow[k]*dSin[m],1.);      
       } // end of if(fCalculate2DDiffFlow)
      } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
     } // end of for(Int_t k=0;k<9;k++) // to be improved - hardwired 9    
@@ -548,6 +572,9 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     }
  } // end of for(Int_t i=0;i<nPrim;i++) 
 
+ // Calculate Re[Q_{m*n,k}], Im[Q_{m*n,k}] and S_{p,k} (before finalizing, see below) from the stored RPs:
+ this->CalculateQVectors(nRPs,fRPPhiEBE.GetArray(),fRPWeightEBE.GetArray());
+
  // e) Calculate the final expressions for S_{p,k} and s_{p,k} (important !!!!):
  for(Int_t p=0;p<8;p++)
  {
@@ -698,6 +725,59 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
  
 } // end of AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
 
+//================================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::CalculateQVectors(Int_t nRPs, const Double_t *phi, const Double_t *weight)
+{
+ // Calculate Re[Q_{m*n,k}], Im[Q_{m*n,k}] (m = 1,2,...,12, k = 0,1,...,8) and the sums entering S_{p,k} (p = 0,1,...,7)
+ // for RPs given as arrays of azimuthal angles and particle weights. 
+
+ // Remarks:
+ // a) For each RP cos(m*n*phi), sin(m*n*phi) and w^k are evaluated only once, with the same expressions as in the
+ //    original track-by-track loop, and RPs are added in the same order => fReQ, fImQ and fSpk (and therefore all 
+ //    cumulants) are bit-by-bit the same as before. The recursion cos((m+1)x) = f(cos(mx),sin(mx)) is not used for 
+ //    this reason, since it changes the results in the last digits;
+ // b) Elements of TMatrixD are accessed directly (row-major, i.e. [m][k] is at 9*m+k) and each element has its own
+ //    accumulator, so the inner loops can be vectorized by the compiler without changing the order of additions.
+
+ Int_t n = fHarmonic; // shortcut for the harmonic 
+ Double_t *reQ = fReQ->GetMatrixArray(); // [m][k], 12 x 9
+ Double_t *imQ = fImQ->GetMatrixArray(); // [m][k], 12 x 9
+ Double_t *spk = fSpk->GetMatrixArray(); // [p][k], 8 x 9
+ Double_t dCos[12] = {0.}; // cos((m+1)*n*phi)
+ Double_t dSin[12] = {0.}; // sin((m+1)*n*phi)
+ Double_t dWeightPow[9] = {0.}; // w^k
+ for(Int_t i=0;i<nRPs;i++)
+ {
+  for(Int_t m=0;m<12;m++)
+  {
+   dCos[m] = TMath::Cos((m+1)*n*phi[i]);
+   dSin[m] = TMath::Sin((m+1)*n*phi[i]);
+  }
+  for(Int_t k=0;k<9;k++)
+  {
+   dWeightPow[k] = pow(weight[i],k);
+  }
+  for(Int_t m=0;m<12;m++)
+  {
+   for(Int_t k=0;k<9;k++)
+   {
+    reQ[9*m+k] += dWeightPow[k]*dCos[m];
+    imQ[9*m+k] += dWeightPow[k]*dSin[m];
+   }
+  }
+  // final calculation of S_{p,k} follows in Make() after this method:
+  for(Int_t p=0;p<8;p++)
+  {
+   for(Int_t k=0;k<9;k++)
+   {
+    spk[9*p+k] += dWeightPow[k];
+   }
+  }
+ } // end of for(Int_t i=0;i<nRPs;i++)
+
+} // end of void AliFlowAnalysisWithQCumulants::CalculateQVectors(Int_t nRPs, const Double_t *phi, const Double_t *weight)
+
 //=======================================================================================================================
 
 void AliFlowAnalysisWithQCumulants::Finish()
@@ -0,0 +1,200 @@
+/************************************************************************************
+ * Copyright (C) 2018, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <algorithm>
+
+#include "AliEmcalJet.h"
+
+#include "AliEmcalJetTable.h"
+
+/// \cond CLASSIMP
+ClassImp(AliEmcalJetTable);
+/// \endcond
+
+/**
+ * Default constructor (for ROOT I/O).
+ */
+AliEmcalJetTable::AliEmcalJetTable() :
+  TNamed(),
+  fPt(),
+  fEta(),
+  fPhi(),
+  fM(),
+  fArea(),
+  fAreaEmc(),
+  fNEF(),
+  fMaxTrackPt(),
+  fMaxClusterPt(),
+  fBits(),
+  fAcceptanceType(),
+  fFlavour(),
+  fTrackOffsets(1, 0),
+  fTrackIndices(),
+  fClusterOffsets(1, 0),
+  fClusterIndices(),
+  fHasJetObjects(kTRUE)
+{
+}
+
+/**
+ * Standard constructor.
+ * @param name Name of the table, see GetTableName()
+ */
+AliEmcalJetTable::AliEmcalJetTable(const char *name) :
+  TNamed(name, name),
+  fPt(),
+  fEta(),
+  fPhi(),
+  fM(),
+  fArea(),
+  fAreaEmc(),
+  fNEF(),
+  fMaxTrackPt(),
+  fMaxClusterPt(),
+  fBits(),
+  fAcceptanceType(),
+  fFlavour(),
+  fTrackOffsets(1, 0),
+  fTrackIndices(),
+  fClusterOffsets(1, 0),
+  fClusterIndices(),
+  fHasJetObjects(kTRUE)
+{
+}
+
+/**
+ * Removes all jets. The capacity of the columns is kept.
+ */
+void AliEmcalJetTable::Clear(Option_t * /*option*/)
+{
+  fPt.clear();
+  fEta.clear();
+  fPhi.clear();
+  fM.clear();
+  fArea.clear();
+  fAreaEmc.clear();
+  fNEF.clear();
+  fMaxTrackPt.clear();
+  fMaxClusterPt.clear();
+  fBits.clear();
+  fAcceptanceType.clear();
+  fFlavour.clear();
+  fTrackOffsets.resize(1);
+  fTrackIndices.clear();
+  fClusterOffsets.resize(1);
+  fClusterIndices.clear();
+}
+
+/**
+ * Reserves memory for a given number of jets and constituents.
+ * @param nJets Number of jets
+ * @param nConstituents Total number of constituents (tracks and clusters) of all jets
+ */
+void AliEmcalJetTable::Reserve(Int_t nJets, Int_t nConstituents)
+{
+  fPt.reserve(nJets);
+  fEta.reserve(nJets);
+  fPhi.reserve(nJets);
+  fM.reserve(nJets);
+  fArea.reserve(nJets);
+  fAreaEmc.reserve(nJets);
+  fNEF.reserve(nJets);
+  fMaxTrackPt.reserve(nJets);
+  fMaxClusterPt.reserve(nJets);
+  fBits.reserve(nJets);
+  fAcceptanceType.reserve(nJets);
+  fFlavour.reserve(nJets);
+  fTrackOffsets.reserve(nJets + 1);
+  fTrackIndices.reserve(nConstituents);
+  fClusterOffsets.reserve(nJets + 1);
+  fClusterIndices.reserve(nConstituents);
+}
+
+/**
+ * Appends a jet to the table.
+ * @param jet Jet whose properties and constituent indices are copied
+ * @return Index of the jet in the table
+ */
+Int_t AliEmcalJetTable::AddJet(const AliEmcalJet &jet)
+{
+  Int_t ijet = AddJet(jet.Pt(), jet.Eta(), jet.Phi(), jet.M(), jet.Area(),
+                      jet.TestBits(0xffffffff), jet.GetJetAcceptanceType(), jet.GetFlavour());
+
+  for (Int_t i = 0; i < jet.GetNumberOfTracks(); i++) AddTrackIndex(jet.TrackAt(i));
+  for (Int_t i = 0; i < jet.GetNumberOfClusters(); i++) AddClusterIndex(jet.ClusterAt(i));
+  FinishJet(jet.AreaEmc(), jet.NEF(), jet.MaxTrackPt(), jet.MaxClusterPt());
+
+  return ijet;
+}
+
+/**
+ * Starts a new jet in the table. The constituent indices are then added with
+ * AddTrackIndex() and AddClusterIndex(), and the jet is completed by FinishJet().
+ * @param pt Transverse momentum
+ * @param eta Pseudo-rapidity
+ * @param phi Azimuthal angle in [0, 2pi)
+ * @param m Mass
+ * @param area Jet area
+ * @param bits TObject status bits
+ * @param acceptanceType Acceptance type, see AliEmcalJet::JetAcceptanceType
+ * @param flavour Flavour tag, see AliEmcalJet::EFlavourTag
+ * @return Index of the jet in the table
+ */
+Int_t AliEmcalJetTable::AddJet(Double_t pt, Double_t eta, Double_t phi, Double_t m, Double_t area,
+                               UInt_t bits, UInt_t acceptanceType, Int_t flavour)
+{
+  fPt.push_back(pt);
+  fEta.push_back(eta);
+  fPhi.push_back(phi);
+  fM.push_back(m);
+  fArea.push_back(area);
+  fBits.push_back(bits);
+  fAcceptanceType.push_back(acceptanceType);
+  fFlavour.push_back(flavour);
+
+  return fPt.size() - 1;
+}
+
+/**
+ * Completes the jet started by the last AddJet(): the constituent indices added
+ * since then are sorted (as in AliEmcalJet::SortConstituents()) and assigned to it.
+ * @param areaEmc Jet area within the EMCal acceptance
+ * @param nef Neutral energy fraction
+ * @param maxTrackPt Pt of the leading track constituent
+ * @param maxClusterPt Pt of the leading cluster constituent
+ */
+void AliEmcalJetTable::FinishJet(Double_t areaEmc, Double_t nef, Double_t maxTrackPt, Double_t maxClusterPt)
+{
+  fAreaEmc.push_back(areaEmc);
+  fNEF.push_back(nef);
+  fMaxTrackPt.push_back(maxTrackPt);
+  fMaxClusterPt.push_back(maxClusterPt);
+
+  std::sort(fTrackIndices.begin() + fTrackOffsets.back(), fTrackIndices.end());
+  fTrackOffsets.push_back(fTrackIndices.size());
+  std::sort(fClusterIndices.begin() + fClusterOffsets.back(), fClusterIndices.end());
+  fClusterOffsets.push_back(fClusterIndices.size());
+}
@@ -0,0 +1,138 @@
+/************************************************************************************
+ * Copyright (C) 2018, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALJETTABLE_H
+#define ALIEMCALJETTABLE_H
+
+#include <vector>
+
+#include <TNamed.h>
+#include <TString.h>
+
+class AliEmcalJet;
+
+/**
+ * @class AliEmcalJetTable
+ * @brief Column (structure-of-arrays) store of the jets of one jet branch
+ * @ingroup JETFW
+ *
+ * The table keeps one column per jet observable used by the jet selection
+ * (pt, eta, phi, mass, area, NEF, leading constituent pt, TObject bits,
+ * acceptance type, flavour) and two flat constituent index tables (tracks and
+ * clusters) addressed by per-jet offsets. It is published in the event by
+ * AliEmcalJetTask next to (or instead of) the TClonesArray of AliEmcalJet
+ * objects, under the name returned by GetTableName(), and read via
+ * AliJetContainer::LoadJetTable(). Loops over the columns do not touch the
+ * AliEmcalJet objects at all.
+ *
+ * A jet is either copied from an AliEmcalJet object, or filled column by
+ * column (without creating the object): AddJet() with the kinematics, then
+ * AddTrackIndex() / AddClusterIndex() for the constituents, then FinishJet().
+ *
+ * The table is cleared at the beginning of each event: the capacity of the
+ * columns is kept, so that after the first events no further allocation
+ * takes place.
+ */
+class AliEmcalJetTable : public TNamed {
+ public:
+  AliEmcalJetTable();
+  AliEmcalJetTable(const char *name);
+  virtual ~AliEmcalJetTable() {;}
+
+  void                        Clear(Option_t *option="");
+  void                        Reserve(Int_t nJets, Int_t nConstituents);
+  Int_t                       AddJet(const AliEmcalJet &jet);
+  Int_t                       AddJet(Double_t pt, Double_t eta, Double_t phi, Double_t m, Double_t area,
+                                     UInt_t bits, UInt_t acceptanceType, Int_t flavour);
+  void                        AddTrackIndex(Int_t index)          { fTrackIndices.push_back(index)   ; }
+  void                        AddClusterIndex(Int_t index)        { fClusterIndices.push_back(index) ; }
+  void                        FinishJet(Double_t areaEmc, Double_t nef, Double_t maxTrackPt, Double_t maxClusterPt);
+
+  void                        SetHasJetObjects(Bool_t b)          { fHasJetObjects = b               ; }
+  Bool_t                      HasJetObjects()               const { return fHasJetObjects            ; }
+
+  Int_t                       GetNJets()                    const { return (Int_t)fPt.size()          ; }
+  Bool_t                      IsEmpty()                     const { return fPt.empty()                ; }
+
+  /// Columns, valid up to the next call to AddJet() or Clear()
+  const Double_t             *GetPt()                       const { return fPt.data()                 ; }
+  const Double_t             *GetEta()                      const { return fEta.data()                ; }
+  const Double_t             *GetPhi()                      const { return fPhi.data()                ; }
+  const Double_t             *GetM()                        const { return fM.data()                  ; }
+  const Double_t             *GetArea()                     const { return fArea.data()               ; }
+  const Double_t             *GetAreaEmc()                  const { return fAreaEmc.data()            ; }
+  const Double_t             *GetNEF()                      const { return fNEF.data()                ; }
+  const Double_t             *GetMaxTrackPt()               const { return fMaxTrackPt.data()         ; }
+  const Double_t             *GetMaxClusterPt()             const { return fMaxClusterPt.data()       ; }
+  const UInt_t               *GetBits()                     const { return fBits.data()               ; }
+  const UInt_t               *GetAcceptanceType()           const { return fAcceptanceType.data()     ; }
+  const Int_t                *GetFlavour()                  const { return fFlavour.data()            ; }
+
+  Double_t                    Pt(Int_t i)                   const { return fPt[i]                     ; }
+  Double_t                    Eta(Int_t i)                  const { return fEta[i]                    ; }
+  Double_t                    Phi(Int_t i)                  const { return fPhi[i]                    ; }
+  Double_t                    M(Int_t i)                    const { return fM[i]                      ; }
+  Double_t                    Area(Int_t i)                 const { return fArea[i]                   ; }
+
+  Int_t                       GetNumberOfTracks(Int_t i)    const { return fTrackOffsets[i+1] - fTrackOffsets[i]     ; }
+  Int_t                       GetNumberOfClusters(Int_t i)  const { return fClusterOffsets[i+1] - fClusterOffsets[i] ; }
+  Int_t                       GetNumberOfConstituents(Int_t i) const { return GetNumberOfTracks(i) + GetNumberOfClusters(i); }
+  const Int_t                *GetTrackIndices(Int_t i)      const { return fTrackIndices.data() + fTrackOffsets[i]     ; }
+  const Int_t                *GetClusterIndices(Int_t i)    const { return fClusterIndices.data() + fClusterOffsets[i] ; }
+  const Int_t                *GetTrackOffsets()             const { return fTrackOffsets.data()       ; }
+  const Int_t                *GetClusterOffsets()           const { return fClusterOffsets.data()     ; }
+
+  static TString              GetTableName(const char *jetsName)  { return TString::Format("%s_table", jetsName); }
+
+ protected:
+  std::vector<Double_t>       fPt;                   //!<! jet transverse momentum
+  std::vector<Double_t>       fEta;                  //!<! jet pseudo-rapidity
+  std::vector<Double_t>       fPhi;                  //!<! jet azimuthal angle
+  std::vector<Double_t>       fM;                    //!<! jet mass
+  std::vector<Double_t>       fArea;                 //!<! jet area
+  std::vector<Double_t>       fAreaEmc;              //!<! jet area within the EMCal acceptance
+  std::vector<Double_t>       fNEF;                  //!<! neutral energy fraction
+  std::vector<Double_t>       fMaxTrackPt;           //!<! pt of the leading track constituent
+  std::vector<Double_t>       fMaxClusterPt;         //!<! pt of the leading cluster constituent
+  std::vector<UInt_t>         fBits;                 //!<! TObject status bits of the jet
+  std::vector<UInt_t>         fAcceptanceType;       //!<! acceptance type, see AliEmcalJet::JetAcceptanceType
+  std::vector<Int_t>          fFlavour;              //!<! flavour tag, see AliEmcalJet::EFlavourTag
+  std::vector<Int_t>          fTrackOffsets;         //!<! offsets of the jets in fTrackIndices (size n+1)
+  std::vector<Int_t>          fTrackIndices;         //!<! track constituent indices of all jets
+  std::vector<Int_t>          fClusterOffsets;       //!<! offsets of the jets in fClusterIndices (size n+1)
+  std::vector<Int_t>          fClusterIndices;       //!<! cluster constituent indices of all jets
+  Bool_t                      fHasJetObjects;        //!<! whether the jet branch holds the AliEmcalJet objects as well
+
+ private:
+  AliEmcalJetTable(const AliEmcalJetTable&);             // not implemented
+  AliEmcalJetTable& operator=(const AliEmcalJetTable&);  // not implemented
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalJetTable, 1);
+  /// \endcond
+};
+
+#endif
@@ -22,6 +22,8 @@
 #include "AliClusterContainer.h"
 #include "AliLocalRhoParameter.h"
 #include "AliTLorentzVector.h"
+#include "AliEmcalContainerUtils.h"
+#include "AliEmcalJetTable.h"
 
 #include "AliJetContainer.h"
 
@@ -66,7 +68,12 @@ AliJetContainer::AliJetContainer():
   fGeom(0),
   fRunNumber(0),
   fTpcHolePos(0),
-  fTpcHoleWidth(0)
+  fTpcHoleWidth(0),
+  fUseJetTable(kFALSE),
+  fJetTable(0),
+  fTableAcceptMask(),
+  fTableAcceptedJets(),
+  fTableAcceptMaskValid(kFALSE)
 {
   fBaseClassName = "AliEmcalJet";
   SetClassName("AliEmcalJet");
@@ -110,7 +117,12 @@ AliJetContainer::AliJetContainer(const char *name):
   fGeom(0),
   fRunNumber(0),
   fTpcHolePos(0),
-  fTpcHoleWidth(0)
+  fTpcHoleWidth(0),
+  fUseJetTable(kFALSE),
+  fJetTable(0),
+  fTableAcceptMask(),
+  fTableAcceptedJets(),
+  fTableAcceptMaskValid(kFALSE)
 {
   fBaseClassName = "AliEmcalJet";
   SetClassName("AliEmcalJet");
@@ -163,7 +175,12 @@ AliJetContainer::AliJetContainer(EJetType_t jetType, EJetAlgo_t jetAlgo, ERecoSc
   fLocalRho(0),
   fRhoMass(0),
   fGeom(0),
-  fRunNumber(0)
+  fRunNumber(0),
+  fUseJetTable(kFALSE),
+  fJetTable(0),
+  fTableAcceptMask(),
+  fTableAcceptedJets(),
+  fTableAcceptMaskValid(kFALSE)
 {
   fBaseClassName = "AliEmcalJet";
   SetClassName("AliEmcalJet");
@@ -179,6 +196,198 @@ void AliJetContainer::SetArray(const AliVEvent *event)
   // Set jet array
 
   AliEmcalContainer::SetArray(event);
+
+  if (fUseJetTable) LoadJetTable(event);
+}
+
+/**
+ * Calls the base class method, then invalidates the accept mask of the jet table
+ * which is rebuilt on first use in the new event.
+ * @param event Pointer to the current event
+ */
+void AliJetContainer::NextEvent(const AliVEvent *event)
+{
+  AliParticleContainer::NextEvent(event);
+
+  fTableAcceptMaskValid = kFALSE;
+}
+
+/**
+ * Loads the column store (AliEmcalJetTable) of the jet branch from the provided event.
+ * The table is published by AliEmcalJetTask (see AliEmcalJetTask::SetJetTableMode)
+ * under the name AliEmcalJetTable::GetTableName(jet branch name).
+ * @param event Valid pointer to a AliVEvent object from which the object is to be retrieved
+ */
+void AliJetContainer::LoadJetTable(const AliVEvent *event)
+{
+  if (fJetTable || fClArrayName.IsNull()) return;
+
+  event = AliEmcalContainerUtils::GetEvent(event, fIsEmbedding);
+  if (!event) return;
+
+  TString tableName = AliEmcalJetTable::GetTableName(fClArrayName);
+  fJetTable = dynamic_cast<AliEmcalJetTable*>(event->FindListObject(tableName));
+  if (!fJetTable) {
+    AliError(Form("%s: Could not retrieve jet table %s!", GetName(), tableName.Data()));
+    return;
+  }
+  if (!fJetTable->HasJetObjects() && HasObjectOnlyCuts()) {
+    AliFatal(Form("%s: The cuts on z,leading and on the tag status need the jet objects, but the jet branch %s is filled only as a jet table!", GetName(), fClArrayName.Data()));
+  }
+  fTableAcceptMaskValid = kFALSE;
+}
+
+/**
+ * Checks if the jet at position i in the jet table passes the cuts. The
+ * selection is the same as in AcceptJet(), evaluated on the table columns.
+ * The cuts on the momentum fraction of the leading constituent and on the
+ * tag status need the AliEmcalJet objects: if they are set, the jet object is
+ * selected with AcceptJet() instead. Without the objects (jet task in the
+ * kJetTableOnly mode) this configuration is rejected in LoadJetTable().
+ * @param[in] i Index position in the jet table
+ * @param[out] rejectionReason Rejection reason bit in case the jet does not pass the cuts
+ * @return kTRUE if jet passes the cuts, kFALSE otherwise
+ */
+Bool_t AliJetContainer::AcceptTableJet(Int_t i, UInt_t &rejectionReason) const
+{
+  if (!fJetTable || i < 0 || i >= fJetTable->GetNJets()) {
+    rejectionReason |= kNullObject;
+    return kFALSE;
+  }
+
+  if (HasObjectOnlyCuts()) {
+    if (GetNEntries() == fJetTable->GetNJets()) return AcceptJet(i, rejectionReason);
+    AliFatal(Form("%s: The cuts on z,leading and on the tag status need the jet objects, they cannot be applied on the jet table!", GetName()));
+  }
+
+  if (fTpcHolePos>0) {
+    Double_t disthole = RelativePhi(fJetTable->Phi(i), fTpcHolePos);
+    if (TMath::Abs(disthole) < (fTpcHoleWidth + fJetRadius)) {
+      rejectionReason |= kOverlapTpcHole;
+      return kFALSE;
+    }
+  }
+
+  if ((fJetTable->GetBits()[i] & fBitMap) != fBitMap) {
+    rejectionReason |= kBitMapCut;
+    return kFALSE;
+  }
+
+  if (fJetTable->GetArea()[i] <= fJetAreaCut) {
+    rejectionReason |= kAreaCut;
+    return kFALSE;
+  }
+
+  if (fJetTable->GetAreaEmc()[i] < fAreaEmcCut) {
+    rejectionReason |= kAreaEmcCut;
+    return kFALSE;
+  }
+
+  Double_t nef = fJetTable->GetNEF()[i];
+  if (nef < fNEFMinCut || nef > fNEFMaxCut) {
+    rejectionReason |= kNEFCut;
+    return kFALSE;
+  }
+
+  if (fMinNConstituents > 0 && fJetTable->GetNumberOfConstituents(i) < fMinNConstituents) {
+    rejectionReason |= kMinNConstituents;
+    return kFALSE;
+  }
+
+  Double_t maxTrackPt = fJetTable->GetMaxTrackPt()[i];
+  Double_t maxClusterPt = fJetTable->GetMaxClusterPt()[i];
+  Bool_t biasTrack = maxTrackPt >= fMinTrackPt;
+  Bool_t biasCluster = maxClusterPt >= fMinClusterPt;
+  if ((fLeadingHadronType == 0 && !biasTrack) || (fLeadingHadronType == 1 && !biasCluster) ||
+      (fLeadingHadronType != 0 && fLeadingHadronType != 1 && !biasTrack && !biasCluster)) {
+    rejectionReason |= kMinLeadPtCut;
+    return kFALSE;
+  }
+
+  if (maxTrackPt > fMaxTrackPt) {
+    rejectionReason |= kMaxTrackPtCut;
+    return kFALSE;
+  }
+
+  if (maxClusterPt > fMaxClusterPt) {
+    rejectionReason |= kMaxClusterPtCut;
+    return kFALSE;
+  }
+
+  if (fFlavourSelection != 0 && !(fJetTable->GetFlavour()[i] & fFlavourSelection)) {
+    rejectionReason |= kFlavourCut;
+    return kFALSE;
+  }
+
+  if (fJetAcceptanceType != 0 && !(fJetTable->GetAcceptanceType()[i] & fJetAcceptanceType)) {
+    return kFALSE;
+  }
+
+  Double_t pt = fJetTable->Pt(i), eta = fJetTable->Eta(i), phi = fJetTable->Phi(i);
+  Double_t mass = fMassHypothesis >= 0 ? fMassHypothesis : fJetTable->M(i);
+  Double_t p = pt*TMath::CosH(eta);
+  AliTLorentzVector mom;
+  mom.SetPtEtaPhiE(pt, eta, phi, TMath::Sqrt(mass*mass + p*p));
+
+  return ApplyKinematicCuts(mom, rejectionReason);
+}
+
+/**
+ * Builds the accept mask of the jet table for the current event. If the
+ * TClonesArray of the jet branch is filled as well, the full selection of
+ * AcceptJet() is used, otherwise AcceptTableJet().
+ */
+void AliJetContainer::BuildTableAcceptMask()
+{
+  fTableAcceptMask.clear();
+  fTableAcceptedJets.clear();
+  fTableAcceptMaskValid = kTRUE;
+  if (!fJetTable) return;
+
+  const Int_t n = fJetTable->GetNJets();
+  const Bool_t useObjects = GetNEntries() == n;
+  const AliEmcalContainerAcceptCache *cache = useObjects ? GetAcceptCache() : 0;
+  fTableAcceptMask.resize(n, 0);
+  for (Int_t i = 0; i < n; i++) {
+    UInt_t rejectionReason = 0;
+    Bool_t accept = false;
+    if (cache) accept = cache->IsAccepted(i);
+    else accept = useObjects ? AcceptJet(i, rejectionReason) : AcceptTableJet(i, rejectionReason);
+    if (!accept) continue;
+    fTableAcceptMask[i] = 1;
+    fTableAcceptedJets.push_back(i);
+  }
+}
+
+/**
+ * Returns the accept mask of the jet table (one entry per jet, 1 if the jet is accepted).
+ * The mask is built once per event and cached; call ResetTableAcceptMask() after
+ * changing the cuts within an event.
+ * @return Pointer to the first entry of the mask, or NULL if the jet table is not loaded
+ */
+const UChar_t* AliJetContainer::GetTableAcceptMask()
+{
+  if (!fTableAcceptMaskValid) BuildTableAcceptMask();
+  return fJetTable ? fTableAcceptMask.data() : 0;
+}
+
+/**
+ * Returns the indices of the accepted jets in the jet table, in table (pt-ordered) order.
+ * Typical use:
+ * ~~~{.cxx}
+ * const AliEmcalJetTable *table = jetCont->GetJetTable();
+ * for (Int_t ijet : jetCont->GetTableAcceptedJets()) {
+ *   Double_t pt = table->Pt(ijet);
+ *   const Int_t *tracks = table->GetTrackIndices(ijet);
+ *   ...
+ * }
+ * ~~~
+ * @return Cached list of accepted jet indices of the current event
+ */
+const std::vector<Int_t>& AliJetContainer::GetTableAcceptedJets()
+{
+  if (!fTableAcceptMaskValid) BuildTableAcceptMask();
+  return fTableAcceptedJets;
 }
 
 /**
@@ -806,6 +1015,7 @@ void AliJetContainer::ResetCuts()
  */
 Int_t AliJetContainer::GetNAcceptedJets()
 {
+  if (fJetTable) return GetTableAcceptedJets().size();
   return accepted().GetEntries();
 }
 
@@ -12,6 +12,9 @@ class AliVEvent;
 class AliParticleContainer;
 class AliClusterContainer;
 class AliLocalRhoParameter;
+class AliEmcalJetTable;
+
+#include <vector>
 
 #include <TMath.h>
 #include <TLorentzVector.h>
@@ -130,6 +133,7 @@ class AliJetContainer : public AliParticleContainer {
     
   void                        SetTpcHolePos(Double_t b)                                {fTpcHolePos       =   b     ;}
   void                        SetTpcHoleWidth(Double_t b)                             {fTpcHoleWidth    =   b     ;} 
+  void                        SetUseJetTable(Bool_t b = kTRUE)                     { fUseJetTable    = b                ; }
 
 
   void                        ConnectParticleContainer(AliParticleContainer *c)    { fParticleContainer = c             ; }
@@ -185,6 +189,14 @@ class AliJetContainer : public AliParticleContainer {
   ERecoScheme_t               GetRecombinationScheme()              const    {return fRecombinationScheme; }
 
   void                        SetArray(const AliVEvent *event);
+  void                        NextEvent(const AliVEvent *event);
+  void                        LoadJetTable(const AliVEvent *event);
+  Bool_t                      GetUseJetTable()                      const    {return fUseJetTable; }
+  AliEmcalJetTable           *GetJetTable()                         const    {return fJetTable; }
+  Bool_t                      AcceptTableJet(Int_t i, UInt_t &rejectionReason) const;
+  const UChar_t              *GetTableAcceptMask();
+  const std::vector<Int_t>&   GetTableAcceptedJets();
+  void                        ResetTableAcceptMask()                         { fTableAcceptMaskValid = kFALSE; }
   AliParticleContainer       *GetParticleContainer() const                   {return fParticleContainer;}
   AliClusterContainer        *GetClusterContainer() const                    {return fClusterContainer;}
   Double_t                    GetFractionSharedPt(const AliEmcalJet *jet, AliParticleContainer *cont2 = 0x0) const;
@@ -235,11 +247,19 @@ class AliJetContainer : public AliParticleContainer {
   Int_t                       fRunNumber;            //!<! run number
   Double_t                    fTpcHolePos;           ///<   position(in radians) of the malfunctioning TPC sector
   Double_t                    fTpcHoleWidth;         ///<   width of the malfunctioning TPC area
+  Bool_t                      fUseJetTable;          ///<  connect to the column store of the jet branch (AliEmcalJetTable)
+  AliEmcalJetTable           *fJetTable;             //!<! column store of the jet branch
+  std::vector<UChar_t>        fTableAcceptMask;      //!<! per-jet accept flag of the current event
+  std::vector<Int_t>          fTableAcceptedJets;    //!<! indices of the accepted jets of the current event
+  Bool_t                      fTableAcceptMaskValid; //!<! whether the accept mask has been built for the current event
  private:
   AliJetContainer(const AliJetContainer& obj); // copy constructor
   AliJetContainer& operator=(const AliJetContainer& other); // assignment
 
-  ClassDef(AliJetContainer, 19);
+  void                        BuildTableAcceptMask();
+  Bool_t                      HasObjectOnlyCuts()                   const    { return fZLeadingChCut < 1 || fZLeadingEmcCut < 1 || fTagStatus > -1; }
+
+  ClassDef(AliJetContainer, 20);
 };
 
 #endif
@@ -28,6 +28,9 @@
 // the derivation from THnSparse is obviously against many OO rules. correct would be a common baseclass of THnSparse and THn.
 //
 // Templated version allows also the use of double as storage container
+//
+// Steps which stay mostly empty can be stored block-wise sparse (see SetSparseStorage): the global bins are grouped
+// in blocks and only blocks with at least one filled bin are allocated. FillParent converts both storage types losslessly.
 // 
 // Author: Jan Fiete Grosse-Oetringhaus
 
@@ -37,6 +40,7 @@
 #include "AliLog.h"
 #include "TArrayF.h"
 #include "TArrayD.h"
+#include "TArrayI.h"
 #include "THnSparse.h"
 #include "TMath.h"
 
@@ -50,10 +54,17 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT() :
   fNSteps(0),
   fValues(0),
   fSumw2(0),
+  fBlockSize(0),
+  fBlockIndex(0),
+  fNUsedBlocks(0),
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fMinCache(0),
+  fMaxCache(0),
+  fEdgesCache(0)
 {
   // Constructor
 }
@@ -66,10 +77,17 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const Char_t* name, const Char_t*
   fNSteps(nSelStep),
   fValues(0),
   fSumw2(0),
+  fBlockSize(0),
+  fBlockIndex(0),
+  fNUsedBlocks(0),
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fMinCache(0),
+  fMaxCache(0),
+  fEdgesCache(0)
 {
   // Constructor
 
@@ -87,11 +105,15 @@ void AliTHnT<TemplateArray, TemplateType>::AliTHnT::Init()
   
   fValues = new TemplateArray*[fNSteps];
   fSumw2 = new TemplateArray*[fNSteps];
+  fBlockIndex = new TArrayI*[fNSteps];
+  fNUsedBlocks = new Int_t[fNSteps];
   
   for (Int_t i=0; i<fNSteps; i++)
   {
     fValues[i] = 0;
     fSumw2[i] = 0;
+    fBlockIndex[i] = 0;
+    fNUsedBlocks[i] = 0;
   }
 } 
 
@@ -103,10 +125,17 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
   fNSteps(c.fNSteps),
   fValues(new TemplateArray*[c.fNSteps]),
   fSumw2(new TemplateArray*[c.fNSteps]),
+  fBlockSize(c.fBlockSize),
+  fBlockIndex(new TArrayI*[c.fNSteps]),
+  fNUsedBlocks(new Int_t[c.fNSteps]),
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fMinCache(0),
+  fMaxCache(0),
+  fEdgesCache(0)
 {
   //
   // AliTHnT copy constructor
@@ -114,10 +143,16 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
 
   memset(fValues,0,fNSteps*sizeof(TemplateArray*));
   memset(fSumw2,0,fNSteps*sizeof(TemplateArray*));
+  memset(fBlockIndex,0,fNSteps*sizeof(TArrayI*));
+  memset(fNUsedBlocks,0,fNSteps*sizeof(Int_t));
 
   for (Int_t i=0; i<fNSteps; i++) {
     if (c.fValues[i]) fValues[i] = new TemplateArray(*(c.fValues[i]));
     if (c.fSumw2[i])  fSumw2[i]  = new TemplateArray(*(c.fSumw2[i]));
+    if (c.IsSparse(i)) {
+      fBlockIndex[i] = new TArrayI(*(c.fBlockIndex[i]));
+      fNUsedBlocks[i] = c.fNUsedBlocks[i];
+    }
   }
 
 }
@@ -129,12 +164,15 @@ AliTHnT<TemplateArray, TemplateType>::~AliTHnT()
   
   DeleteContainers();
   
+  for (Int_t i=0; i<fNSteps; i++)
+    if (fBlockIndex)
+      delete fBlockIndex[i];
+
   delete[] fValues;
   delete[] fSumw2;
-  delete[] axisCache;
-  delete[] fNbinsCache;
-  delete[] fLastVars;
-  delete[] fLastBins;
+  delete[] fBlockIndex;
+  delete[] fNUsedBlocks;
+  DeleteCache();
 }
 
 template <class TemplateArray, typename TemplateType>
@@ -155,9 +193,105 @@ void AliTHnT<TemplateArray, TemplateType>::DeleteContainers()
       delete fSumw2[i];
       fSumw2[i] = 0;
     }
+
+    // sparse steps stay sparse, but release all blocks
+    if (IsSparse(i))
+    {
+      fBlockIndex[i]->Reset(-1);
+      fNUsedBlocks[i] = 0;
+    }
   }
 }
 
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::DeleteCache()
+{
+  // deletes the axis caches, they are filled again at the next Fill
+
+  delete[] axisCache;
+  delete[] fNbinsCache;
+  delete[] fLastVars;
+  delete[] fLastBins;
+  delete[] fUniformCache;
+  delete[] fMinCache;
+  delete[] fMaxCache;
+  delete[] fEdgesCache;
+
+  axisCache = 0;
+  fNbinsCache = 0;
+  fLastVars = 0;
+  fLastBins = 0;
+  fUniformCache = 0;
+  fMinCache = 0;
+  fMaxCache = 0;
+  fEdgesCache = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::SetSparseStorage(Int_t step, Int_t blockSize)
+{
+  // stores step <step> (all steps for -1) block-wise sparse: the global bins are grouped in blocks of <blockSize>
+  // consecutive bins, and only blocks containing at least one filled bin are allocated
+  // use this for steps which stay mostly empty; the steps must not be filled yet
+  // the block size is the same for all sparse steps
+  
+  if (blockSize < 1)
+  {
+    AliError(Form("Invalid block size %d", blockSize));
+    return;
+  }
+
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (IsSparse(i) && blockSize != fBlockSize)
+    {
+      AliError(Form("Block size %d differs from block size %d of the sparse steps", blockSize, fBlockSize));
+      return;
+    }
+  }
+
+  if (!fBlockIndex)
+  {
+    // objects read from files written before sparse storage existed
+    fBlockIndex = new TArrayI*[fNSteps];
+    fNUsedBlocks = new Int_t[fNSteps];
+    memset(fBlockIndex,0,fNSteps*sizeof(TArrayI*));
+    memset(fNUsedBlocks,0,fNSteps*sizeof(Int_t));
+  }
+
+  fBlockSize = blockSize;
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (step >= 0 && i != step)
+      continue;
+
+    if (fValues[i])
+    {
+      AliError(Form("Step %d already filled, keeping its storage", i));
+      continue;
+    }
+
+    if (!fBlockIndex[i])
+      fBlockIndex[i] = new TArrayI((fNBins + fBlockSize - 1) / fBlockSize);
+    fBlockIndex[i]->Reset(-1);
+    fNUsedBlocks[i] = 0;
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::GetAllocatedBins(Int_t step) const
+{
+  // returns the number of bins allocated for step <step>
+
+  if (!fValues[step])
+    return 0;
+
+  if (IsSparse(step))
+    return (Long64_t) fNUsedBlocks[step] * fBlockSize;
+
+  return fNBins;
+}
+
 //____________________________________________________________________
 template <class TemplateArray, typename TemplateType>
 AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::operator=(const AliTHnT<TemplateArray, TemplateType> &c)
@@ -172,28 +306,41 @@ AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::oper
       for(Int_t i=0; i< fNSteps; ++i) {
 	delete fValues[i];
 	delete fSumw2[i];
+	if (fBlockIndex) delete fBlockIndex[i];
       }
       delete [] fValues;
       delete [] fSumw2;
+      delete [] fBlockIndex;
+      delete [] fNUsedBlocks;
     }
     fNSteps=c.fNSteps;
+    fBlockSize=c.fBlockSize;
     if(fNSteps) {
       fValues=new TemplateArray*[fNSteps];
       fSumw2=new TemplateArray*[fNSteps];
+      fBlockIndex=new TArrayI*[fNSteps];
+      fNUsedBlocks=new Int_t[fNSteps];
       memset(fValues,0,fNSteps*sizeof(TemplateArray*));
       memset(fSumw2,0,fNSteps*sizeof(TemplateArray*));
+      memset(fBlockIndex,0,fNSteps*sizeof(TArrayI*));
+      memset(fNUsedBlocks,0,fNSteps*sizeof(Int_t));
 
       for (Int_t i=0; i<fNSteps; i++) {
 	if (c.fValues[i]) fValues[i] = new TemplateArray(*(c.fValues[i]));
 	if (c.fSumw2[i])  fSumw2[i]  = new TemplateArray(*(c.fSumw2[i]));
+	if (c.IsSparse(i)) {
+	  fBlockIndex[i] = new TArrayI(*(c.fBlockIndex[i]));
+	  fNUsedBlocks[i] = c.fNUsedBlocks[i];
+	}
       }
     } else {
       fValues = 0;
       fSumw2 = 0;
+      fBlockIndex = 0;
+      fNUsedBlocks = 0;
     }
-    delete [] axisCache;
-    axisCache = new TAxis*[fNVars];
-    memcpy(axisCache, c.axisCache, fNVars*sizeof(TAxis*));
+    // axes belong to the base class, the caches are filled again at the next Fill
+    DeleteCache();
   }
   return *this;
 }
@@ -211,6 +358,7 @@ void AliTHnT<TemplateArray, TemplateType>::Copy(TObject& c) const
   target.fNSteps = fNSteps;
   target.fNBins = fNBins;
   target.fNVars = fNVars;
+  target.fBlockSize = fBlockSize;
   
   target.Init();
 
@@ -225,6 +373,12 @@ void AliTHnT<TemplateArray, TemplateType>::Copy(TObject& c) const
       target.fSumw2[i] = new TemplateArray(*(fSumw2[i]));
     else
       target.fSumw2[i] = 0;
+
+    if (IsSparse(i))
+    {
+      target.fBlockIndex[i] = new TArrayI(*(fBlockIndex[i]));
+      target.fNUsedBlocks[i] = fNUsedBlocks[i];
+    }
   }
 }
 
@@ -256,22 +410,55 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
 
     for (Int_t i=0; i<fNSteps; i++)
     {
-      if (entry->fValues[i])
+      if (!IsSparse(i) && !entry->IsSparse(i))
       {
-	if (!fValues[i])
-	  fValues[i] = new TemplateArray(fNBins);
+	if (entry->fValues[i])
+	{
+	  if (!fValues[i])
+	    fValues[i] = new TemplateArray(fNBins);
       
-	for (Long64_t l = 0; l<fNBins; l++)
-	  fValues[i]->GetArray()[l] += entry->fValues[i]->GetArray()[l];
+	  for (Long64_t l = 0; l<fNBins; l++)
+	    fValues[i]->GetArray()[l] += entry->fValues[i]->GetArray()[l];
+	}
+
+	if (entry->fSumw2[i])
+	{
+	  if (!fSumw2[i])
+	    fSumw2[i] = new TemplateArray(fNBins);
+      
+	  for (Long64_t l = 0; l<fNBins; l++)
+	    fSumw2[i]->GetArray()[l] += entry->fSumw2[i]->GetArray()[l];
+	}
+	continue;
       }
 
-      if (entry->fSumw2[i])
+      // at least one of the two steps is sparse: add bin by bin, skipping blocks which are not allocated
+      if (!entry->fValues[i])
+	continue;
+
+      if (!fValues[i])
+	CreateStep(i);
+      if (entry->fSumw2[i] && !fSumw2[i])
+	fSumw2[i] = new TemplateArray(fValues[i]->GetSize());
+
+      const TemplateType* sourceValues = entry->fValues[i]->GetArray();
+      const TemplateType* sourceSumw2 = (entry->fSumw2[i]) ? entry->fSumw2[i]->GetArray() : 0;
+      for (Long64_t l = 0; l<fNBins; l++)
       {
-	if (!fSumw2[i])
-	  fSumw2[i] = new TemplateArray(fNBins);
-      
-	for (Long64_t l = 0; l<fNBins; l++)
-	  fSumw2[i]->GetArray()[l] += entry->fSumw2[i]->GetArray()[l];
+	Long64_t source = entry->GetStorageIndex(i, l, kFALSE);
+	if (source < 0)
+	{
+	  // jump to the last bin of the block
+	  l += entry->fBlockSize - 1 - l % entry->fBlockSize;
+	  continue;
+	}
+	if (sourceValues[source] == 0 && (!sourceSumw2 || sourceSumw2[source] == 0))
+	  continue;
+
+	Long64_t target = GetStorageIndex(i, l, kTRUE);
+	fValues[i]->GetArray()[target] += sourceValues[source];
+	if (sourceSumw2)
+	  fSumw2[i]->GetArray()[target] += sourceSumw2[source];
       }
     }
     
@@ -282,33 +469,90 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
 }
 
 template <class TemplateArray, typename TemplateType>
-void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep, Double_t weight)
+void AliTHnT<TemplateArray, TemplateType>::InitCache()
 {
-  // fills an entry
+  // fills the axis caches
+
+  axisCache = new TAxis*[fNVars];
+  fNbinsCache = new Int_t[fNVars];
+  fUniformCache = new Bool_t[fNVars];
+  fMinCache = new Double_t[fNVars];
+  fMaxCache = new Double_t[fNVars];
+  fEdgesCache = new const Double_t*[fNVars];
+  for (Int_t i=0; i<fNVars; i++)
+  {
+    axisCache[i] = GetAxis(i, 0);
+    fNbinsCache[i] = axisCache[i]->GetNbins();
+    fMinCache[i] = axisCache[i]->GetXmin();
+    fMaxCache[i] = axisCache[i]->GetXmax();
+    fEdgesCache[i] = 0;
+    fUniformCache[i] = !axisCache[i]->CanExtend() && !axisCache[i]->IsAlphanumeric();
+
+    // axes defined by bin limits are treated as equidistant if the limits agree up to rounding,
+    // the bin limits are then used to correct the calculated bin (see FindAxisBin)
+    const TArrayD* edges = axisCache[i]->GetXbins();
+    if (edges->GetSize() > 0)
+    {
+      fEdgesCache[i] = edges->GetArray();
+      Double_t width = (fMaxCache[i] - fMinCache[i]) / fNbinsCache[i];
+      for (Int_t j=0; j<=fNbinsCache[i]; j++)
+	if (TMath::Abs(fEdgesCache[i][j] - (fMinCache[i] + j * width)) > 1e-6 * width)
+	  fUniformCache[i] = kFALSE;
+    }
+  }
+
+  fLastVars = new Double_t[fNVars];
+  fLastBins = new Int_t[fNVars];
+}
+
+template <class TemplateArray, typename TemplateType>
+inline Int_t AliTHnT<TemplateArray, TemplateType>::FindAxisBin(Int_t i, Double_t var)
+{
+  // returns the bin of <var> on axis <i>, identical to TAxis::FindBin
+  // for equidistant axes the bin is calculated instead of calling TAxis::FindBin
+
+  if (!fUniformCache[i])
+    return axisCache[i]->FindBin(var);
+
+  // same order of checks as in TAxis::FindBin (also catches NaN)
+  if (var < fMinCache[i])
+    return 0;
+  if (!(var < fMaxCache[i]))
+    return fNbinsCache[i] + 1;
+
+  Int_t bin = 1 + Int_t(fNbinsCache[i] * (var - fMinCache[i]) / (fMaxCache[i] - fMinCache[i]));
+
+  // move to the bin the binary search on the bin limits would give
+  const Double_t* edges = fEdgesCache[i];
+  if (edges)
+  {
+    while (bin > 1 && var < edges[bin-1])
+      bin--;
+    while (bin < fNbinsCache[i] && var >= edges[bin])
+      bin++;
+  }
+
+  return bin;
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::FindGlobalBin(const Double_t *var)
+{
+  // calculates global bin index, returns -1 if any of the values is in the under/overflow bin
 
   // fill axis cache
   if (!axisCache)
   {
-    axisCache = new TAxis*[fNVars];
-    fNbinsCache = new Int_t[fNVars];
-    for (Int_t i=0; i<fNVars; i++)
-    {
-      axisCache[i] = GetAxis(i, 0);
-      fNbinsCache[i] = axisCache[i]->GetNbins();
-    }
-    
-    fLastVars = new Double_t[fNVars];
-    fLastBins = new Int_t[fNVars];
+    InitCache();
     
     // initial values to prevent checking for 0 below
     for (Int_t i=0; i<fNVars; i++)
     {
-      fLastBins[i] = axisCache[i]->FindBin(var[i]);
+      fLastBins[i] = FindAxisBin(i, var[i]);
       fLastVars[i] = var[i];
     }
   }
   
-  // calculate global bin index
   Long64_t bin = 0;
   for (Int_t i=0; i<fNVars; i++)
   {
@@ -319,7 +563,7 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
       tmpBin = fLastBins[i];
     else
     {
-      tmpBin = axisCache[i]->FindBin(var[i]);
+      tmpBin = FindAxisBin(i, var[i]);
       fLastBins[i] = tmpBin;
       fLastVars[i] = var[i];
     }
@@ -327,19 +571,68 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 
     // under/overflow not supported
     if (tmpBin < 1 || tmpBin > fNbinsCache[i])
-      return;
+      return -1;
     
     // bins start from 0 here
     bin += tmpBin - 1;
 //     Printf("%lld", bin);
   }
 
-  if (!fValues[istep])
-  {
+  return bin;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::CreateStep(Int_t istep)
+{
+  // creates the values container for step <istep>, sparse steps start without any allocated block
+
+  if (IsSparse(istep))
+    fValues[istep] = new TemplateArray(0);
+  else
     fValues[istep] = new TemplateArray(fNBins);
-    AliInfo(Form("Created values container for step %d", istep));
+  AliInfo(Form("Created values container for step %d", istep));
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::GetStorageIndex(Int_t istep, Long64_t bin, Bool_t allocate)
+{
+  // returns the position of the global bin <bin> in the containers of step <istep>
+  // for sparse steps the block of the bin is allocated if needed and <allocate> is set, otherwise -1 is returned
+
+  if (!IsSparse(istep))
+    return bin;
+
+  Int_t* blockIndex = fBlockIndex[istep]->GetArray();
+  Int_t block = bin / fBlockSize;
+  if (blockIndex[block] < 0)
+  {
+    if (!allocate)
+      return -1;
+
+    // the containers grow by a factor 2, TArray::Set initializes the new entries with 0
+    Long64_t size = (Long64_t) (fNUsedBlocks[istep] + 1) * fBlockSize;
+    if (size > fValues[istep]->GetSize())
+    {
+      Long64_t newSize = TMath::Max(2 * (Long64_t) fValues[istep]->GetSize(), size);
+      newSize = TMath::Min(newSize, (Long64_t) fBlockIndex[istep]->GetSize() * fBlockSize);
+      fValues[istep]->Set(newSize);
+      if (fSumw2[istep])
+	fSumw2[istep]->Set(newSize);
+    }
+    blockIndex[block] = fNUsedBlocks[istep]++;
   }
 
+  return (Long64_t) blockIndex[block] * fBlockSize + bin % fBlockSize;
+}
+
+template <class TemplateArray, typename TemplateType>
+inline void AliTHnT<TemplateArray, TemplateType>::FillBin(Long64_t bin, Int_t istep, Double_t weight)
+{
+  // fills global bin <bin>
+
+  if (!fValues[istep])
+    CreateStep(istep);
+
   if (weight != 1)
   {
     // initialize with already filled entries (which have been filled with weight == 1), in this case fSumw2 := fValues
@@ -350,16 +643,49 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
     }
   }
 
-  fValues[istep]->GetArray()[bin] += weight;
+  Long64_t index = GetStorageIndex(istep, bin, kTRUE);
+  fValues[istep]->GetArray()[index] += weight;
   if (fSumw2[istep])
-    fSumw2[istep]->GetArray()[bin] += weight * weight;
+    fSumw2[istep]->GetArray()[index] += weight * weight;
   
 //   Printf("%f", fValues[istep][bin]);
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep, Double_t weight)
+{
+  // fills an entry
+
+  Long64_t bin = FindGlobalBin(var);
+
+  // under/overflow not supported
+  if (bin < 0)
+    return;
+
+  FillBin(bin, istep, weight);
   
   // debug
 //   AliCFContainer::Fill(var, istep, weight);
 }
 
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight)
+{
+  // fills <n> entries, the values of entry i are var[i*nVars] ... var[i*nVars+nVars-1]
+  // <weight> is an optional array of <n> weights (weight 1 if not given)
+
+  for (Int_t i=0; i<n; i++)
+  {
+    Long64_t bin = FindGlobalBin(var + (Long64_t) i * fNVars);
+
+    // under/overflow not supported
+    if (bin < 0)
+      continue;
+
+    FillBin(bin, istep, (weight) ? weight[i] : 1.);
+  }
+}
+
 template <class TemplateArray, typename TemplateType>
 Long64_t AliTHnT<TemplateArray, TemplateType>::GetGlobalBinIndex(const Int_t* binIdx)
 {
@@ -405,38 +731,72 @@ void AliTHnT<TemplateArray, TemplateType>::FillContainer(AliCFContainer* cont)
     
     Long64_t count = 0;
     
-    while (1)
+    if (IsSparse(i))
     {
-//       for (Int_t j=0; j<fNVars; j++)
-// 	printf("%d ", binIdx[j]);
-      
-      Long64_t globalBin = GetGlobalBinIndex(binIdx);
-//       Printf(" --> %lld", globalBin);
-      
-      if (source[globalBin] != 0)
+      // loop over the allocated blocks in the order of the global bins, the bin indexes are calculated from the global bin
+      Int_t nBlocks = fBlockIndex[i]->GetSize();
+      for (Int_t block=0; block<nBlocks; block++)
       {
-	target->SetBinContent(binIdx, source[globalBin]);
-	target->SetBinError(binIdx, TMath::Sqrt(sourceSumw2[globalBin]));
+	Int_t position = fBlockIndex[i]->At(block);
+	if (position < 0)
+	  continue;
+
+	Long64_t lastBin = TMath::Min((Long64_t) (block + 1) * fBlockSize, fNBins);
+	for (Long64_t globalBin = (Long64_t) block * fBlockSize; globalBin < lastBin; globalBin++)
+	{
+	  Long64_t index = (Long64_t) position * fBlockSize + globalBin % fBlockSize;
+	  if (source[index] == 0)
+	    continue;
+
+	  Long64_t tmpBin = globalBin;
+	  for (Int_t j=fNVars-1; j>=0; j--)
+	  {
+	    binIdx[j] = tmpBin % nBins[j] + 1;
+	    tmpBin /= nBins[j];
+	  }
+
+	  target->SetBinContent(binIdx, source[index]);
+	  target->SetBinError(binIdx, TMath::Sqrt(sourceSumw2[index]));
 	
-	count++;
+	  count++;
+	}
       }
+    }
+    else
+    {
+      while (1)
+      {
+//         for (Int_t j=0; j<fNVars; j++)
+// 	  printf("%d ", binIdx[j]);
       
-      binIdx[fNVars-1]++;
+	Long64_t globalBin = GetGlobalBinIndex(binIdx);
+//         Printf(" --> %lld", globalBin);
       
-      for (Int_t j=fNVars-1; j>0; j--)
-      {
-	if (binIdx[j] > nBins[j])
+	if (source[globalBin] != 0)
 	{
-	  binIdx[j] = 1;
-	  binIdx[j-1]++;
+	  target->SetBinContent(binIdx, source[globalBin]);
+	  target->SetBinError(binIdx, TMath::Sqrt(sourceSumw2[globalBin]));
+	
+	  count++;
 	}
-      }
       
-      if (binIdx[0] > nBins[0])
-	break;
+	binIdx[fNVars-1]++;
+      
+	for (Int_t j=fNVars-1; j>0; j--)
+	{
+	  if (binIdx[j] > nBins[j])
+	  {
+	    binIdx[j] = 1;
+	    binIdx[j-1]++;
+	  }
+	}
+      
+	if (binIdx[0] > nBins[0])
+	  break;
+      }
     }
     
-    AliInfo(Form("Step %d: copied %lld entries out of %lld bins", i, count, GetGlobalBinIndex(binIdx)));
+    AliInfo(Form("Step %d: copied %lld entries out of %lld bins", i, count, fNBins));
 
     delete[] binIdx;
     delete[] nBins;
@@ -464,11 +824,6 @@ void AliTHnT<TemplateArray, TemplateType>::ReduceAxis()
     if (!fValues[i])
       continue;
       
-    TemplateType* source = fValues[i]->GetArray();
-    TemplateType* sourceSumw2 = 0;
-    if (fSumw2[i])
-      sourceSumw2 = fSumw2[i]->GetArray();
-    
     THnSparse* target = GetGrid(i)->GetGrid();
     
     Int_t* binIdx = new Int_t[fNVars];
@@ -484,27 +839,35 @@ void AliTHnT<TemplateArray, TemplateType>::ReduceAxis()
     while (1)
     {
       // sum over axis <axis>
+      // the containers are accessed via GetStorageIndex, for sparse steps only allocated blocks are read
       TemplateType sumValues = 0;
       TemplateType sumSumw2 = 0;
       for (Int_t j=1; j<=nBins[axis]; j++)
       {
 	binIdx[axis] = j;
-	Long64_t globalBin = GetGlobalBinIndex(binIdx);
-	sumValues += source[globalBin];
-	source[globalBin] = 0;
+	Long64_t index = GetStorageIndex(i, GetGlobalBinIndex(binIdx), kFALSE);
+	if (index < 0)
+	  continue;
 
-	if (sourceSumw2)
+	sumValues += fValues[i]->GetArray()[index];
+	fValues[i]->GetArray()[index] = 0;
+
+	if (fSumw2[i])
 	{
-	  sumSumw2 += sourceSumw2[globalBin];
-	  sourceSumw2[globalBin] = 0;
+	  sumSumw2 += fSumw2[i]->GetArray()[index];
+	  fSumw2[i]->GetArray()[index] = 0;
 	}
       }
       binIdx[axis] = 1;
 	
-      Long64_t globalBin = GetGlobalBinIndex(binIdx);
-      source[globalBin] = sumValues;
-      if (sourceSumw2)
-	sourceSumw2[globalBin] = sumSumw2;
+      // a block of a sparse step is only allocated if there is something to store
+      Long64_t index = GetStorageIndex(i, GetGlobalBinIndex(binIdx), sumValues != 0 || sumSumw2 != 0);
+      if (index >= 0)
+      {
+	fValues[i]->GetArray()[index] = sumValues;
+	if (fSumw2[i])
+	  fSumw2[i]->GetArray()[index] = sumSumw2;
+      }
 
       count++;
 
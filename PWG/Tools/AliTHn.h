@@ -9,6 +9,8 @@
 // Use AliTHn instead of AliCFContainer and your memory consumption will be drastically reduced
 // As AliTHn derives from AliCFContainer, you can just replace your current AliCFContainer object by AliTHn
 // Once you have the merged output, call FillParent() and you can use AliCFContainer as usual
+//
+// Steps which stay mostly empty can be stored block-wise sparse, see SetSparseStorage()
 
 #include "TObject.h"
 #include "TString.h"
@@ -17,6 +19,7 @@
 class TArray;
 class TArrayF;
 class TArrayD;
+class TArrayI;
 class TCollection;
 
 class AliTHnBase : public AliCFContainer
@@ -26,6 +29,7 @@ public:
   AliTHnBase(const Char_t* name, const Char_t* title,const Int_t nSelStep, const Int_t nVarIn, const Int_t* nBinIn) : AliCFContainer(name, title, nSelStep, nVarIn, nBinIn) { }
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) = 0;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight=0) = 0;
   virtual void FillParent() = 0;
   virtual void FillContainer(AliCFContainer* cont) = 0;
 
@@ -48,6 +52,7 @@ class AliTHnT : public AliTHnBase
   virtual ~AliTHnT();
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) ;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight=0);
   virtual void FillParent();
   virtual void FillContainer(AliCFContainer* cont);
   
@@ -56,6 +61,10 @@ class AliTHnT : public AliTHnBase
   
   virtual void DeleteContainers();
   virtual void ReduceAxis();
+
+  void SetSparseStorage(Int_t step=-1, Int_t blockSize=1024);
+  Bool_t IsSparse(Int_t step) const { return fBlockIndex && fBlockIndex[step]; }
+  Long64_t GetAllocatedBins(Int_t step) const;
   
   AliTHnT(const AliTHnT &c);
   AliTHnT& operator=(const AliTHnT& corr);
@@ -65,20 +74,34 @@ class AliTHnT : public AliTHnBase
   
 protected:
   void Init();
+  void InitCache();
+  void DeleteCache();
   Long64_t GetGlobalBinIndex(const Int_t* binIdx);
+  Int_t FindAxisBin(Int_t i, Double_t var);
+  Long64_t FindGlobalBin(const Double_t *var);
+  void FillBin(Long64_t bin, Int_t istep, Double_t weight);
+  void CreateStep(Int_t istep);
+  Long64_t GetStorageIndex(Int_t istep, Long64_t bin, Bool_t allocate);
   
   Long64_t fNBins;   // number of total bins
   Int_t    fNVars;   // number of variables
   Int_t    fNSteps;  // number of selection steps
   TemplateArray **fValues;  //[fNSteps] data container
   TemplateArray **fSumw2;   //[fNSteps] data container
+  Int_t    fBlockSize;       // number of bins per block in sparse steps
+  TArrayI **fBlockIndex;     //[fNSteps] position of each block in fValues/fSumw2 (-1 if not allocated), only for sparse steps
+  Int_t*   fNUsedBlocks;     //[fNSteps] number of allocated blocks in fValues/fSumw2, only for sparse steps
   
   TAxis** axisCache; //! cache axis pointers (about 50% of the time in Fill is spent in GetAxis otherwise)
   Int_t* fNbinsCache; //! cache Nbins per axis
   Double_t* fLastVars; //! caching of last used bins (in many loops some vars are the same for a while)
   Int_t* fLastBins; //! caching of last used bins (in many loops some vars are the same for a while)
+  Bool_t* fUniformCache; //! axes with (nearly) equidistant bins, for which the bin is calculated instead of searched
+  Double_t* fMinCache; //! cache lower axis limit
+  Double_t* fMaxCache; //! cache upper axis limit
+  const Double_t** fEdgesCache; //! cache bin edges of equidistant axes defined by bin limits (0 for fixed bins)
   
-  ClassDef(AliTHnT, 5) // THn like container
+  ClassDef(AliTHnT, 6) // THn like container
 };
 
 typedef AliTHnT<TArrayF, Float_t> AliTHn;
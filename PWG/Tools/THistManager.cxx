@@ -18,6 +18,7 @@
 #include <sstream>
 #include <string>
 #include <exception>
+#include <thread>     // for unit tests
 #include <vector>
 #include <TArrayD.h>
 #include <TAxis.h>
@@ -26,10 +27,12 @@
 #include <TH3.h>
 #include <THnSparse.h>
 #include <THashList.h>
+#include <TList.h>
 #include <TMath.h>
 #include <TObjArray.h>
 #include <TObjString.h>
 #include <TProfile.h>
+#include <TROOT.h>
 #include <TString.h>
 
 #include "TBinning.h"
@@ -42,14 +45,20 @@ ClassImp(THistManager)
 THistManager::THistManager():
 		TNamed(),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHistEntries(),
+		fHandleIndex(),
+		fNThreadBuffers(0)
 {
 }
 
 THistManager::THistManager(const char *name):
 		TNamed(name, Form("Histogram container %s", name)),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHistEntries(),
+		fHandleIndex(),
+		fNThreadBuffers(0)
 {
 	fHistos = new THashList();
 	fHistos->SetName(Form("histos%s", name));
@@ -57,6 +66,9 @@ THistManager::THistManager(const char *name):
 }
 
 THistManager::~THistManager(){
+	for(auto &entry : fHistEntries){
+		for(auto shadow : entry.fShadows) delete shadow;
+	}
 	if(fHistos && fIsOwner) delete fHistos;
 }
 
@@ -409,64 +421,40 @@ void THistManager::SetObject(TObject * const o, const char *group) {
 }
 
 void THistManager::FillTH1(const char *name, double x, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH1", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH1 *hist = dynamic_cast<TH1 *>(parent->FindObject(hname));
-	if(!hist){
-		Fatal("THistManager::FillTH1", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-		return;
-	}
+	HistHandle handle = ResolveHandle(name, kTH1Type, "THistManager::FillTH1");
+	if(!handle.IsValid()) return;
 	TString optionstring(opt);
 	if(optionstring.Contains("w")){
 	  // use bin width as weight
+	  TH1 *hist = static_cast<TH1 *>(fHistEntries[handle.fIndex].fObject);
 	  Int_t bin = hist->GetXaxis()->FindBin(x);
 	  // check if not overflow or underflow bin
 	  if(bin != 0 && bin != hist->GetXaxis()->GetNbins())
 	    weight = 1./hist->GetXaxis()->GetBinWidth(bin);
 	}
-	hist->Fill(x, weight);
+	FillTH1(handle, x, weight);
 }
 
 void THistManager::FillTH1(const char *name, const char *label, double weight, Option_t *opt) {
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent){
-    Fatal("THistManager::FillTH1", "Parent group %s does not exist", dirname.Data());
-    return;
-  }
-  TH1 *hist = dynamic_cast<TH1 *>(parent->FindObject(hname));
-  if(!hist){
-    Fatal("THistManager::FillTH1", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-    return;
-  }
+  HistHandle handle = ResolveHandle(name, kTH1Type, "THistManager::FillTH1");
+  if(!handle.IsValid()) return;
 	TString optionstring(opt);
 	if(optionstring.Contains("w")){
 	  // use bin width as weight
+	  TH1 *hist = static_cast<TH1 *>(fHistEntries[handle.fIndex].fObject);
 	  // get bin for label
 	  Int_t bin = hist->GetXaxis()->FindBin(label);
 	  // check if not overflow or underflow bin
 	  if(bin != 0 && bin != hist->GetXaxis()->GetNbins())
 	    weight = 1./hist->GetXaxis()->GetBinWidth(bin);
 	}
-  hist->Fill(label, weight);
+  FillTH1(handle, label, weight);
 }
 
 void THistManager::FillTH2(const char *name, double x, double y, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
-	if(!hist){
-		Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-		return;
-	}
+	HistHandle handle = ResolveHandle(name, kTH2Type, "THistManager::FillTH2");
+	if(!handle.IsValid()) return;
+	TH2 *hist = static_cast<TH2 *>(fHistEntries[handle.fIndex].fObject);
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	if(optstring.Contains("wx")){
@@ -477,21 +465,13 @@ void THistManager::FillTH2(const char *name, double x, double y, double weight,
 	  Int_t biny = hist->GetYaxis()->FindBin(y);
 	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
 	}
-	hist->Fill(x, y, myweight);
+	FillTH2(handle, x, y, myweight);
 }
 
 void THistManager::FillTH2(const char *name, double *point, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
-	if(!hist){
-		Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-		return;
-	}
+	HistHandle handle = ResolveHandle(name, kTH2Type, "THistManager::FillTH2");
+	if(!handle.IsValid()) return;
+	TH2 *hist = static_cast<TH2 *>(fHistEntries[handle.fIndex].fObject);
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	if(optstring.Contains("wx")){
@@ -502,21 +482,13 @@ void THistManager::FillTH2(const char *name, double *point, double weight, Optio
 	  Int_t biny = hist->GetYaxis()->FindBin(point[1]);
 	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
 	}
-	hist->Fill(point[0], point[1], weight);
+	FillTH2(handle, point[0], point[1], weight);
 }
 
 void THistManager::FillTH2(const char *name, const char *labelX, const char *labelY, double weight, Option_t *opt) {
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent){
-    Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
-    return;
-  }
-  TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
-  if(!hist){
-    Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-    return;
-  }
+  HistHandle handle = ResolveHandle(name, kTH2Type, "THistManager::FillTH2");
+  if(!handle.IsValid()) return;
+  TH2 *hist = static_cast<TH2 *>(fHistEntries[handle.fIndex].fObject);
   TString optstring(opt);
   Double_t myweight = optstring.Contains("w") ? 1. : weight;
   if(optstring.Contains("wx")){
@@ -527,21 +499,13 @@ void THistManager::FillTH2(const char *name, const char *labelX, const char *lab
     Int_t biny = hist->GetYaxis()->FindBin(labelX);
     if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
   }
-  hist->Fill(labelX, labelY, weight);
+  FillTH2(handle, labelX, labelY, weight);
 }
 
 void THistManager::FillTH3(const char* name, double x, double y, double z, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH3", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH3 *hist = dynamic_cast<TH3 *>(parent->FindObject(hname));
-	if(!hist){
-		Fatal("THistManager::FillTH3", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-		return;
-	}
+	HistHandle handle = ResolveHandle(name, kTH3Type, "THistManager::FillTH3");
+	if(!handle.IsValid()) return;
+	TH3 *hist = static_cast<TH3 *>(fHistEntries[handle.fIndex].fObject);
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	if(optstring.Contains("wx")){
@@ -556,21 +520,13 @@ void THistManager::FillTH3(const char* name, double x, double y, double z, doubl
 	  Int_t binz = hist->GetZaxis()->FindBin(z);
 	  if(binz != 0 && binz != hist->GetZaxis()->GetNbins()) myweight *= 1./hist->GetZaxis()->GetBinWidth(binz);
 	}
-	hist->Fill(x, y, z, weight);
+	FillTH3(handle, x, y, z, weight);
 }
 
 void THistManager::FillTH3(const char* name, const double* point, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH3", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH3 *hist = dynamic_cast<TH3 *>(parent->FindObject(hname));
-	if(!hist){
-		Fatal("THistManager::FillTH3", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-		return;
-	}
+	HistHandle handle = ResolveHandle(name, kTH3Type, "THistManager::FillTH3");
+	if(!handle.IsValid()) return;
+	TH3 *hist = static_cast<TH3 *>(fHistEntries[handle.fIndex].fObject);
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	if(optstring.Contains("wx")){
@@ -585,21 +541,13 @@ void THistManager::FillTH3(const char* name, const double* point, double weight,
 	  Int_t binz = hist->GetZaxis()->FindBin(point[2]);
 	  if(binz != 0 && binz != hist->GetZaxis()->GetNbins()) myweight *= 1./hist->GetZaxis()->GetBinWidth(binz);
 	}
-	hist->Fill(point[0], point[1], point[2], weight);
+	FillTH3(handle, point[0], point[1], point[2], weight);
 }
 
 void THistManager::FillTHnSparse(const char *name, const double *x, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTHnSparse", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	THnSparseD *hist = dynamic_cast<THnSparseD *>(parent->FindObject(hname));
-	if(!hist){
-		Fatal("THistManager::FillTHnSparse", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-		return;
-	}
+	HistHandle handle = ResolveHandle(name, kTHnSparseType, "THistManager::FillTHnSparse");
+	if(!handle.IsValid()) return;
+	THnSparse *hist = static_cast<THnSparse *>(fHistEntries[handle.fIndex].fObject);
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	for(Int_t iaxis = 0; iaxis < hist->GetNdimensions(); iaxis++){
@@ -611,18 +559,108 @@ void THistManager::FillTHnSparse(const char *name, const double *x, double weigh
 	  }
 	}
 
-	hist->Fill(x, weight);
+	FillTHnSparse(handle, x, weight);
 }
 
 void THistManager::FillProfile(const char* name, double x, double y, double weight){
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent)
-		Fatal("THistManager::FillTProfile", "Parent group %s does not exist", dirname.Data());
-  TProfile *hist = dynamic_cast<TProfile *>(parent->FindObject(hname));
-  if(!hist)
-		Fatal("THistManager::FillTProfile", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-  hist->Fill(x, y, weight);
+  HistHandle handle = ResolveHandle(name, kTProfileType, "THistManager::FillTProfile");
+  if(!handle.IsValid()) return;
+  FillProfile(handle, x, y, weight);
+}
+
+THistManager::HistHandle THistManager::GetHistHandle(const char *name) {
+  auto found = fHandleIndex.find(name);
+  if(found != fHandleIndex.end()) return HistHandle(found->second, -1);
+
+  TObject *o = FindObject(name);
+  if(!o || !(dynamic_cast<TH1 *>(o) || dynamic_cast<THnBase *>(o))) return HistHandle();
+  // Same histogram might have been requested already under a different notation
+  Int_t index = -1;
+  for(size_t ientry = 0; ientry < fHistEntries.size(); ientry++){
+    if(fHistEntries[ientry].fObject == o){
+      index = ientry;
+      break;
+    }
+  }
+  if(index < 0){
+    HistEntry entry;
+    entry.fObject = o;
+    entry.fTypes = 0;
+    if(dynamic_cast<TH1 *>(o)) entry.fTypes |= kTH1Type;
+    if(dynamic_cast<TH2 *>(o)) entry.fTypes |= kTH2Type;
+    if(dynamic_cast<TH3 *>(o)) entry.fTypes |= kTH3Type;
+    if(dynamic_cast<THnSparseD *>(o)) entry.fTypes |= kTHnSparseType;
+    if(dynamic_cast<TProfile *>(o)) entry.fTypes |= kTProfileType;
+    for(Int_t ithread = 0; ithread < fNThreadBuffers; ithread++) entry.fShadows.push_back(CreateShadow(o));
+    index = fHistEntries.size();
+    fHistEntries.push_back(entry);
+  }
+  fHandleIndex[name] = index;
+  return HistHandle(index, -1);
+}
+
+void THistManager::FillTH1(const HistHandle &handle, double x, double weight) {
+  TH1 *hist = static_cast<TH1 *>(GetHandleObject(handle, kTH1Type, "THistManager::FillTH1"));
+  if(hist) hist->Fill(x, weight);
+}
+
+void THistManager::FillTH1(const HistHandle &handle, const char *label, double weight) {
+  TH1 *hist = static_cast<TH1 *>(GetHandleObject(handle, kTH1Type, "THistManager::FillTH1"));
+  if(hist) hist->Fill(label, weight);
+}
+
+void THistManager::FillTH2(const HistHandle &handle, double x, double y, double weight) {
+  TH2 *hist = static_cast<TH2 *>(GetHandleObject(handle, kTH2Type, "THistManager::FillTH2"));
+  if(hist) hist->Fill(x, y, weight);
+}
+
+void THistManager::FillTH2(const HistHandle &handle, const char *labelX, const char *labelY, double weight) {
+  TH2 *hist = static_cast<TH2 *>(GetHandleObject(handle, kTH2Type, "THistManager::FillTH2"));
+  if(hist) hist->Fill(labelX, labelY, weight);
+}
+
+void THistManager::FillTH3(const HistHandle &handle, double x, double y, double z, double weight) {
+  TH3 *hist = static_cast<TH3 *>(GetHandleObject(handle, kTH3Type, "THistManager::FillTH3"));
+  if(hist) hist->Fill(x, y, z, weight);
+}
+
+void THistManager::FillTHnSparse(const HistHandle &handle, const double *x, double weight) {
+  THnSparse *hist = static_cast<THnSparse *>(GetHandleObject(handle, kTHnSparseType, "THistManager::FillTHnSparse"));
+  if(hist) hist->Fill(x, weight);
+}
+
+void THistManager::FillProfile(const HistHandle &handle, double x, double y, double weight) {
+  TProfile *hist = static_cast<TProfile *>(GetHandleObject(handle, kTProfileType, "THistManager::FillTProfile"));
+  if(hist) hist->Fill(x, y, weight);
+}
+
+void THistManager::SetNumberOfThreadBuffers(Int_t nthreads) {
+  if(nthreads < 0) nthreads = 0;
+  for(auto &entry : fHistEntries){
+    while(static_cast<Int_t>(entry.fShadows.size()) > nthreads){
+      delete entry.fShadows.back();
+      entry.fShadows.pop_back();
+    }
+    while(static_cast<Int_t>(entry.fShadows.size()) < nthreads) entry.fShadows.push_back(CreateShadow(entry.fObject));
+  }
+  fNThreadBuffers = nthreads;
+}
+
+void THistManager::MergeThreadBuffers() {
+  for(auto &entry : fHistEntries){
+    if(!entry.fShadows.size()) continue;
+    TList mergelist;
+    for(auto shadow : entry.fShadows) mergelist.Add(shadow);
+    TH1 *hist = dynamic_cast<TH1 *>(entry.fObject);
+    if(hist) {
+      hist->Merge(&mergelist);
+      for(auto shadow : entry.fShadows) static_cast<TH1 *>(shadow)->Reset();
+    } else {
+      THnBase *hsparse = static_cast<THnBase *>(entry.fObject);
+      hsparse->Merge(&mergelist);
+      for(auto shadow : entry.fShadows) static_cast<THnBase *>(shadow)->Reset();
+    }
+  }
 }
 
 TObject *THistManager::FindObject(const char *name) const {
@@ -647,6 +685,49 @@ THashList *THistManager::FindGroup(const char *dirname) const {
 	return nullptr;
 }
 
+THistManager::HistHandle THistManager::ResolveHandle(const char *name, Int_t type, const char *caller) {
+  HistHandle handle = GetHistHandle(name);
+  if(!handle.IsValid() || !(fHistEntries[handle.fIndex].fTypes & type)){
+    TString dirname(basename(name)), hname(histname(name));
+    if(!FindGroup(dirname))
+      Fatal(caller, "Parent group %s does not exist", dirname.Data());
+    else
+      Fatal(caller, "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+    return HistHandle();
+  }
+  return handle;
+}
+
+TObject *THistManager::GetHandleObject(const HistHandle &handle, Int_t type, const char *caller) const {
+  if(handle.fIndex < 0 || handle.fIndex >= static_cast<Int_t>(fHistEntries.size())){
+    Fatal(caller, "Invalid histogram handle");
+    return nullptr;
+  }
+  const HistEntry &entry = fHistEntries[handle.fIndex];
+  if(!(entry.fTypes & type)){
+    Fatal(caller, "Histogram %s does not match the type of the fill function", entry.fObject->GetName());
+    return nullptr;
+  }
+  if(handle.fThread < 0) return entry.fObject;
+  if(handle.fThread >= static_cast<Int_t>(entry.fShadows.size())){
+    Fatal(caller, "No thread buffer %d for histogram %s", handle.fThread, entry.fObject->GetName());
+    return nullptr;
+  }
+  return entry.fShadows[handle.fThread];
+}
+
+TObject *THistManager::CreateShadow(const TObject *o) const {
+  TObject *shadow = o->Clone();
+  TH1 *hist = dynamic_cast<TH1 *>(shadow);
+  if(hist){
+    hist->SetDirectory(nullptr);
+    hist->Reset();
+  } else {
+    static_cast<THnBase *>(shadow)->Reset();
+  }
+  return shadow;
+}
+
 TString THistManager::basename(const TString &path) const {
 	int index = path.Last('/');
 	if(index < 0) return "";  // no directory structure
@@ -1030,6 +1111,125 @@ namespace TestTHistManager {
     return success ? 0 : 1;
   }
 
+  int THistManagerTestSuite::TestFillHandleHistograms(){
+    THistManager testmgr("testmgr");
+
+    testmgr.CreateTH1("Test1", "Test fill 1D histogram", 1, 0., 1.);
+    testmgr.CreateTH2("Test2", "Test fill 2D histogram", 1, 0., 1., 1, 0., 1.);
+    testmgr.CreateTH3("Test3", "Test fill 3D histogram", 1, 0., 1., 1, 0., 1., 1, 0., 1.);
+    int nbins[4] = {1,1,1,1}; double min[4] = {0.,0.,0.,0.}, max[4] = {1.,1.,1.,1.};
+    testmgr.CreateTHnSparse("TestN", "Test Fill THnSparse", 4, nbins, min, max);
+    testmgr.CreateTProfile("Group1/TestProfile", "Test fill Profile histogram", 1, 0., 1.);
+
+    THistManager::HistHandle h1 = testmgr.GetHistHandle("Test1"),
+                             h2 = testmgr.GetHistHandle("Test2"),
+                             h3 = testmgr.GetHistHandle("Test3"),
+                             hN = testmgr.GetHistHandle("TestN"),
+                             hProfile = testmgr.GetHistHandle("Group1/TestProfile");
+
+    // Evaluate test
+    // tell user why test has failed
+    bool success(true);
+    if(!(h1.IsValid() && h2.IsValid() && h3.IsValid() && hN.IsValid() && hProfile.IsValid())){
+      std::cout << "Invalid handle for existing histogram" << std::endl;
+      return 1;
+    }
+    if(testmgr.GetHistHandle("Group1/TestNotExisting").IsValid()){
+      std::cout << "Valid handle for non-existing histogram" << std::endl;
+      success = false;
+    }
+
+    double point[4] = {0.5, 0.5, 0.5, 0.5};
+    for(int i = 0; i < 100; i++){
+      testmgr.FillTH1(h1, 0.5);
+      testmgr.FillTH2(h2, 0.5, 0.5);
+      testmgr.FillTH3(h3, 0.5, 0.5, 0.5);
+      testmgr.FillProfile(hProfile, 0.5, 1.);
+      testmgr.FillTHnSparse(hN, point);
+    }
+
+    TH1 *test1 = static_cast<TH1 *>(testmgr.FindObject("Test1"));
+    if(TMath::Abs(test1->GetBinContent(1) - 100) > DBL_EPSILON){
+      std::cout << "Test1: Mismatch in values, expected 100, found " <<  test1->GetBinContent(1) << std::endl;
+      success = false;
+    }
+
+    TH2 *test2 = static_cast<TH2 *>(testmgr.FindObject("Test2"));
+    if(TMath::Abs(test2->GetBinContent(1, 1) - 100) > DBL_EPSILON){
+      std::cout << "Test2: Mismatch in values, expected 100, found " <<  test2->GetBinContent(1,1) << std::endl;
+      success = false;
+    }
+
+    TH3 *test3 = static_cast<TH3 *>(testmgr.FindObject("Test3"));
+    if(TMath::Abs(test3->GetBinContent(1, 1, 1) - 100) > DBL_EPSILON){
+      std::cout << "Test3: Mismatch in values, expected 100, found " <<  test3->GetBinContent(1,1,1) << std::endl;
+      success = false;
+    }
+
+    THnSparse *testN = static_cast<THnSparse *>(testmgr.FindObject("TestN"));
+    int index[4] = {1,1,1,1};
+    if(TMath::Abs(testN->GetBinContent(index) - 100) > DBL_EPSILON){
+      std::cout << "TestN: Mismatch in values, expected 100, found " <<  testN->GetBinContent(index) << std::endl;
+      success = false;
+    }
+
+    TProfile *testProfile = static_cast<TProfile *>(testmgr.FindObject("Group1/TestProfile"));
+    if(TMath::Abs(testProfile->GetBinContent(1) - 1) > DBL_EPSILON){
+      std::cout << "Group1/TestProfile: Mismatch in values, expected 1, found " <<  testProfile->GetBinContent(1) << std::endl;
+      success = false;
+    }
+
+    return success ? 0 : 1;
+  }
+
+  int THistManagerTestSuite::TestMergeThreadBuffers(){
+    ROOT::EnableThreadSafety();
+    THistManager testmgr("testmgr");
+
+    testmgr.CreateTH1("Test1", "Test fill 1D histogram", 1, 0., 1.);
+    testmgr.CreateTH2("Group1/Test2", "Test fill 2D histogram", 1, 0., 1., 1, 0., 1.);
+
+    // Handles obtained before and after enabling the thread buffers
+    const int kNThreads = 4;
+    THistManager::HistHandle h1 = testmgr.GetHistHandle("Test1");
+    testmgr.SetNumberOfThreadBuffers(kNThreads);
+    THistManager::HistHandle h2 = testmgr.GetHistHandle("Group1/Test2");
+
+    std::vector<std::thread> workers;
+    for(int ithread = 0; ithread < kNThreads; ithread++){
+      workers.push_back(std::thread([&testmgr, h1, h2, ithread](){
+        THistManager::HistHandle myh1 = h1.ForThread(ithread), myh2 = h2.ForThread(ithread);
+        for(int i = 0; i < 100; i++){
+          testmgr.FillTH1(myh1, 0.5);
+          testmgr.FillTH2(myh2, 0.5, 0.5);
+        }
+      }));
+    }
+    for(auto &worker : workers) worker.join();
+
+    // Evaluate test
+    // tell user why test has failed
+    bool success(true);
+    TH1 *test1 = static_cast<TH1 *>(testmgr.FindObject("Test1"));
+    TH2 *test2 = static_cast<TH2 *>(testmgr.FindObject("Group1/Test2"));
+    if(test1->GetEntries() > 0 || test2->GetEntries() > 0){
+      std::cout << "Histograms filled before merge" << std::endl;
+      success = false;
+    }
+
+    testmgr.MergeThreadBuffers();
+    if(TMath::Abs(test1->GetBinContent(1) - 400) > DBL_EPSILON){
+      std::cout << "Test1: Mismatch in values, expected 400, found " <<  test1->GetBinContent(1) << std::endl;
+      success = false;
+    }
+    if(TMath::Abs(test2->GetBinContent(1, 1) - 400) > DBL_EPSILON){
+      std::cout << "Group1/Test2: Mismatch in values, expected 400, found " <<  test2->GetBinContent(1,1) << std::endl;
+      success = false;
+    }
+
+    return success ? 0 : 1;
+  }
+
   int TestRunAll(){
     int testresult(0);
     THistManagerTestSuite testsuite;
@@ -1050,6 +1250,14 @@ namespace TestTHistManager {
     testresult += testsuite.TestFillGroupedHistograms();
     std::cout << "Result after test: " << testresult << std::endl;
 
+    std::cout << "Running test: Fill Handles" << std::endl;
+    testresult += testsuite.TestFillHandleHistograms();
+    std::cout << "Result after test: " << testresult << std::endl;
+
+    std::cout << "Running test: Merge Thread Buffers" << std::endl;
+    testresult += testsuite.TestMergeThreadBuffers();
+    std::cout << "Result after test: " << testresult << std::endl;
+
     return testresult;
   }
 
@@ -1072,4 +1280,14 @@ namespace TestTHistManager {
     THistManagerTestSuite testsuite;
     return testsuite.TestFillGroupedHistograms();
   }
+
+  int TestRunFillHandles(){
+    THistManagerTestSuite testsuite;
+    return testsuite.TestFillHandleHistograms();
+  }
+
+  int TestRunMergeThreadBuffers(){
+    THistManagerTestSuite testsuite;
+    return testsuite.TestMergeThreadBuffers();
+  }
 }
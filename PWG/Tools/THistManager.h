@@ -7,6 +7,9 @@
 #include <TIterator.h>
 #include <TNamed.h>
 #include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class TArrayD;
 class TAxis;
@@ -95,6 +98,32 @@ class TProfile;
  * an argument for options. Automatic correction for the bin width is done when
  * specifying the argument *W*, followed by the direction. Adding multiple directions
  * the weight is calculated for all directions at the same time.
+ *
+ * # Filling via handles
+ *
+ * Each by-name Fill call has to resolve the histogram from its name. In tight
+ * loops this lookup can be avoided by requesting a handle once, after the
+ * histogram has been created, and filling via the handle:
+ *
+ * ~~~{.cxx}
+ * mgr.CreateTH1("hPt", "pt-distribution", TLinearBinning(100, 0., 100.));
+ * THistManager::HistHandle hPt = mgr.GetHistHandle("hPt");
+ * for(auto en : ROOT::TSeqI(0, 10000) {
+ *   mgr.FillTH1(hPt, gRandom->Exp(-1));
+ * }
+ * ~~~
+ *
+ * The by-name Fill functions are thin wrappers resolving the handle and
+ * applying the bin width options before filling via the handle.
+ *
+ * # Filling from multiple threads
+ *
+ * Optionally the histogram manager can keep one shadow copy of each histogram
+ * per thread (see SetNumberOfThreadBuffers). Each thread fills via its own
+ * handle obtained with HistHandle::ForThread, so no locking is needed. The
+ * shadow copies are added to the histograms in MergeThreadBuffers, which
+ * should be called once all threads have finished, i.e. in Terminate of
+ * the analysis driver. Handles have to be obtained before the threads start.
  */
 class THistManager : public TNamed {
 public:
@@ -229,6 +258,53 @@ public:
     iterator();
   };
 
+  /**
+   * @class HistHandle
+   * @brief Handle to a histogram inside the histogram manager
+   * @ingroup Histmanager
+   *
+   * Lightweight handle created by THistManager::GetHistHandle. The handle
+   * addresses the histogram by its position in the internal table of the
+   * histogram manager, so filling via the handle does not need any lookup
+   * by name. Handles are only valid for the histogram manager they were
+   * created from.
+   */
+  class HistHandle {
+  public:
+    /**
+     * @brief Default constructor, creating an invalid handle
+     */
+    HistHandle(): fIndex(-1), fThread(-1) {}
+
+    /**
+     * @brief Destructor
+     */
+    ~HistHandle() {}
+
+    /**
+     * @brief Check whether the handle points to a histogram
+     * @return True if the handle is valid
+     */
+    Bool_t IsValid() const { return fIndex >= 0; }
+
+    /**
+     * @brief Get the handle filling the shadow copy of a thread
+     *
+     * Requires that thread buffers are enabled in the histogram
+     * manager (see THistManager::SetNumberOfThreadBuffers).
+     * @param[in] ithread Index of the thread
+     * @return Handle to the shadow copy of the histogram for the thread
+     */
+    HistHandle ForThread(Int_t ithread) const { return HistHandle(fIndex, ithread); }
+
+  private:
+    friend class THistManager;
+    HistHandle(Int_t index, Int_t thread): fIndex(index), fThread(thread) {}
+
+    Int_t                       fIndex;               ///< Position of the histogram in the handle table
+    Int_t                       fThread;              ///< Thread buffer to fill (-1 for the histogram itself)
+  };
+
   /**
    * @brief Default constructor.
    *
@@ -634,6 +710,103 @@ public:
 	 */
   void FillProfile(const char *name, double x, double y, double weight = 1.);
 
+  /**
+   * @brief Get a handle to a histogram within the container.
+   *
+   * The histogram name also contains the parent group(s) according
+   * to the common group notation. The lookup is done only once per
+   * histogram, subsequent calls are served from a cache. In case thread
+   * buffers are enabled the shadow copies of the histogram are created.
+   * @param[in] name Name of the histogram
+   * @return Handle to the histogram (invalid if not found)
+   */
+  HistHandle GetHistHandle(const char *name);
+
+  /**
+   * @brief Fill a 1D histogram via its handle.
+   * @param[in] handle Handle to the histogram
+   * @param[in] x x-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH1(const HistHandle &handle, double x, double weight = 1.);
+
+  /**
+   * @brief Fill a 1D histogram via its handle using a bin label.
+   * @param[in] handle Handle to the histogram
+   * @param[in] label Label of the bin to fill
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH1(const HistHandle &handle, const char *label, double weight = 1.);
+
+  /**
+   * @brief Fill a 2D histogram via its handle.
+   * @param[in] handle Handle to the histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH2(const HistHandle &handle, double x, double y, double weight = 1.);
+
+  /**
+   * @brief Fill a 2D histogram via its handle using bin labels.
+   * @param[in] handle Handle to the histogram
+   * @param[in] labelX Label of the bin in x-direction
+   * @param[in] labelY Label of the bin in y-direction
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH2(const HistHandle &handle, const char *labelX, const char *labelY, double weight = 1.);
+
+  /**
+   * @brief Fill a 3D histogram via its handle.
+   * @param[in] handle Handle to the histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] z z-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH3(const HistHandle &handle, double x, double y, double z, double weight = 1.);
+
+  /**
+   * @brief Fill a nD histogram via its handle.
+   * @param[in] handle Handle to the histogram
+   * @param[in] x coordinates of the data
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTHnSparse(const HistHandle &handle, const double *x, double weight = 1.);
+
+  /**
+   * @brief Fill a profile histogram via its handle.
+   * @param[in] handle Handle to the profile histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillProfile(const HistHandle &handle, double x, double y, double weight = 1.);
+
+  /**
+   * @brief Enable shadow copies of the histograms for filling from multiple threads.
+   *
+   * For each histogram known to the handle table, and for each
+   * histogram requested via GetHistHandle later on, nthreads empty
+   * copies are created. Must be called before the threads start filling.
+   * @param[in] nthreads Number of threads filling the histograms
+   */
+  void SetNumberOfThreadBuffers(Int_t nthreads);
+
+  /**
+   * @brief Get the number of thread buffers per histogram
+   * @return Number of thread buffers (0 if disabled)
+   */
+  Int_t GetNumberOfThreadBuffers() const { return fNThreadBuffers; }
+
+  /**
+   * @brief Add the content of the thread buffers to the histograms.
+   *
+   * The thread buffers are reset afterwards. Must only be called
+   * when no thread is filling, i.e. in Terminate of the analysis driver.
+   */
+  void MergeThreadBuffers();
+
   /**
    * @brief Create forward iterator starting at the beginning of the
    * container
@@ -695,6 +868,59 @@ private:
 	THistManager(const THistManager &);
 	THistManager &operator=(const THistManager &);
 
+  /**
+   * @enum HistType_t
+   * @brief Histogram types an entry in the handle table can be filled as
+   */
+  enum HistType_t {
+    kTH1Type = 1 << 0,            ///< TH1
+    kTH2Type = 1 << 1,            ///< TH2
+    kTH3Type = 1 << 2,            ///< TH3
+    kTHnSparseType = 1 << 3,      ///< THnSparseD
+    kTProfileType = 1 << 4        ///< TProfile
+  };
+
+  /**
+   * @struct HistEntry
+   * @brief Entry in the handle table
+   */
+  struct HistEntry {
+    TObject                 *fObject;     ///< Histogram in the container
+    Int_t                    fTypes;      ///< Types the histogram can be filled as (see HistType_t)
+    std::vector<TObject *>   fShadows;    ///< Thread buffers of the histogram
+  };
+
+  /**
+   * @brief Get the handle for a by-name Fill function.
+   *
+   * Raises a fatal error if the histogram does not exist or is not
+   * of the type required by the caller.
+   * @param[in] name Name of the histogram
+   * @param[in] type Required histogram type (see HistType_t)
+   * @param[in] caller Name of the calling function, for the error message
+   * @return Handle to the histogram
+   */
+  HistHandle ResolveHandle(const char *name, Int_t type, const char *caller);
+
+  /**
+   * @brief Get the object to be filled for a handle.
+   *
+   * Raises a fatal error if the handle is not valid or the
+   * histogram is not of the type required by the caller.
+   * @param[in] handle Handle to the histogram
+   * @param[in] type Required histogram type (see HistType_t)
+   * @param[in] caller Name of the calling function, for the error message
+   * @return Histogram or thread buffer addressed by the handle
+   */
+  TObject *GetHandleObject(const HistHandle &handle, Int_t type, const char *caller) const;
+
+  /**
+   * @brief Create an empty shadow copy of a histogram
+   * @param[in] o Histogram to copy
+   * @return Empty copy, not attached to any directory
+   */
+  TObject *CreateShadow(const TObject *o) const;
+
 
 	/**
 	 * @brief Find histogram group.
@@ -721,9 +947,12 @@ private:
 
 	THashList *fHistos;                   ///< List of histograms
 	bool fIsOwner;                        ///< Set the ownership
+  std::vector<HistEntry> fHistEntries;  //!<! Handle table
+  std::unordered_map<std::string, Int_t> fHandleIndex; //!<! Position in the handle table by histogram name
+  Int_t fNThreadBuffers;                //!<! Number of thread buffers per histogram
 
   /// \cond CLASSIMP
-	ClassDef(THistManager, 1);  // Container for histograms
+	ClassDef(THistManager, 2);  // Container for histograms
   /// \endcond
 };
 
@@ -845,6 +1074,34 @@ public:
    * @return 0 if test is passed, 1 if it failed
    */
   int TestFillGroupedHistograms();
+
+  /**
+   * Purpose of the test: Check whether histograms are filled correctly via handles
+   * Relies on: TestFillSimpleHistograms
+   *
+   * Creating histograms of all types (one of them in a group) with 1 bin per dimension,
+   * obtaining handles and filling each 100 times the same value via the handle.
+   *
+   * Test passed:
+   * - All handles are valid, the handle for a non-existing histogram is invalid
+   * - All histograms need to have in its 1 bin the bin content 100 (1 for the profile)
+   * @return 0 if test is passed, 1 if it failed
+   */
+  int TestFillHandleHistograms();
+
+  /**
+   * Purpose of the test: Check whether histograms filled from multiple threads are merged correctly
+   * Relies on: TestFillHandleHistograms
+   *
+   * Enabling 4 thread buffers, filling a TH1 and a TH2 from 4 threads each 100 times
+   * via the thread handles, and merging the thread buffers.
+   *
+   * Test passed:
+   * - Before the merge the histograms are empty
+   * - After the merge the histograms have in its 1 bin the bin content 400
+   * @return 0 if test is passed, 1 if it failed
+   */
+  int TestMergeThreadBuffers();
 };
 
 /**
@@ -882,5 +1139,19 @@ int TestRunFillSimple();
  */
 int TestRunFillGrouped();
 
+/**
+ * Run the test for filling histograms via handles. See @ref THistManagerTestSuite
+ * for details.
+ * @return 0 if test is passed, 1 if failed
+ */
+int TestRunFillHandles();
+
+/**
+ * Run the test for filling histograms from multiple threads. See @ref THistManagerTestSuite
+ * for details.
+ * @return 0 if test is passed, 1 if failed
+ */
+int TestRunMergeThreadBuffers();
+
 }
 #endif
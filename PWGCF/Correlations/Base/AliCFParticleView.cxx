@@ -0,0 +1,87 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+//
+//
+// kinematics of a list of particles stored as one array per quantity
+//
+// The correlation code loops over all pairs of particles. Filling this object once per event
+// (from a list of AliCFParticle, AOD tracks or any other AliVParticle, or entry by entry)
+// replaces the virtual calls to Pt(), Eta(), Phi() and Charge() in the pair loop by
+// reading contiguous arrays. The particle objects are kept for the few checks which need them.
+//
+//
+
+#include "AliCFParticleView.h"
+
+#include "AliVParticle.h"
+
+#include "TObjArray.h"
+
+//____________________________________________________________________
+AliCFParticleView::AliCFParticleView() :
+  fEta(),
+  fPhi(),
+  fPt(),
+  fCharge(),
+  fParticles()
+{
+  // Constructor
+}
+
+//____________________________________________________________________
+void AliCFParticleView::Clear()
+{
+  // removes all entries, the memory is kept for the next event
+
+  fEta.clear();
+  fPhi.clear();
+  fPt.clear();
+  fCharge.clear();
+  fParticles.clear();
+}
+
+//____________________________________________________________________
+void AliCFParticleView::Add(Float_t eta, Double_t phi, Double_t pt, Short_t charge, AliVParticle* particle)
+{
+  // adds one particle
+
+  fEta.push_back(eta);
+  fPhi.push_back(phi);
+  fPt.push_back(pt);
+  fCharge.push_back(charge);
+  fParticles.push_back(particle);
+}
+
+//____________________________________________________________________
+void AliCFParticleView::Set(TObjArray* particles)
+{
+  // replaces the content by the particles in <particles> (list of AliVParticle)
+
+  Clear();
+
+  Int_t n = particles->GetEntriesFast();
+  fEta.reserve(n);
+  fPhi.reserve(n);
+  fPt.reserve(n);
+  fCharge.reserve(n);
+  fParticles.reserve(n);
+
+  for (Int_t i=0; i<n; i++)
+  {
+    AliVParticle* particle = (AliVParticle*) particles->UncheckedAt(i);
+    Add(particle->Eta(), particle->Phi(), particle->Pt(), particle->Charge(), particle);
+  }
+}
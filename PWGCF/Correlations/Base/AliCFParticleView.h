@@ -0,0 +1,45 @@
+#ifndef AliCFParticleView_H
+#define AliCFParticleView_H
+
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+// kinematics of a list of particles stored as one array per quantity
+
+#include <vector>
+
+#include "Rtypes.h"
+
+class TObjArray;
+class AliVParticle;
+
+class AliCFParticleView
+{
+ public:
+  AliCFParticleView();
+  ~AliCFParticleView() {}
+
+  void Set(TObjArray* particles);
+  void Clear();
+  void Add(Float_t eta, Double_t phi, Double_t pt, Short_t charge, AliVParticle* particle = 0);
+
+  Int_t GetEntries() const { return fEta.size(); }
+
+  const Float_t* GetEta() const { return fEta.data(); }
+  const Double_t* GetPhi() const { return fPhi.data(); }
+  const Double_t* GetPt() const { return fPt.data(); }
+  const Short_t* GetCharge() const { return fCharge.data(); }
+  AliVParticle* GetParticle(Int_t i) const { return fParticles[i]; }
+
+ private:
+  AliCFParticleView(const AliCFParticleView&);
+  AliCFParticleView& operator=(const AliCFParticleView&);
+
+  std::vector<Float_t> fEta;               // eta (as float, like it is used in the correlation)
+  std::vector<Double_t> fPhi;              // phi
+  std::vector<Double_t> fPt;               // pt
+  std::vector<Short_t> fCharge;            // charge
+  std::vector<AliVParticle*> fParticles;   // particle the entry was taken from (not owned, 0 if not available)
+};
+
+#endif
@@ -0,0 +1,221 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+//
+//
+// batched dphistar evaluation for the two-track efficiency cut
+//
+// AliUEHistograms::GetDPhiStar is a difference of two curvature terms, each depending
+// on a single track only. This class calculates these terms once per event and track
+// (at the minimal radius, at 2.5 m and, on demand, along the radius scan) from arrays
+// of phi, pt and charge, and evaluates the cut for one trigger against all associated
+// tracks in plain loops over these arrays. Types and the order of the operations are the
+// same as in the pair-by-pair calculation, so that the result is identical.
+//
+// Triggers and associated tracks are kept as separate sets, so that the same object can
+// be used for mixed events. If the same arrays are given for both, the terms are shared.
+//
+//
+
+#include "AliTwoTrackDPhiStar.h"
+
+//____________________________________________________________________
+AliTwoTrackDPhiStar::AliTwoTrackDPhiStar() :
+  fBSign(0),
+  fMinRadius(0),
+  fRadii(),
+  fEta(0),
+  fAssociated(0),
+  fTerms(),
+  fSelected(),
+  fScan()
+{
+  // Constructor
+
+  for (Int_t set=0; set<2; set++)
+  {
+    fN[set] = 0;
+    fPhi[set] = 0;
+    fPt[set] = 0;
+    fCharge[set] = 0;
+  }
+}
+
+//____________________________________________________________________
+void AliTwoTrackDPhiStar::Init(Float_t minRadius, Float_t bSign)
+{
+  // sets the radius range and the field for a new event
+  // the radii are generated with the same loop as in the scalar scan
+
+  fBSign = bSign;
+  fMinRadius = minRadius;
+
+  fRadii.clear();
+  for (Double_t rad=minRadius; rad<2.51; rad+=0.01)
+    fRadii.push_back(rad);
+
+  fScan.resize(fRadii.size());
+  fTerms.clear();
+
+  for (Int_t set=0; set<2; set++)
+    fN[set] = 0;
+}
+
+//____________________________________________________________________
+Double_t AliTwoTrackDPhiStar::Term(Int_t set, Int_t k, Float_t radius) const
+{
+  // curvature term of track k as it appears in AliUEHistograms::GetDPhiStar
+
+  return fCharge[set][k] * fBSign * TMath::ASin(0.075 * radius / fPt[set][k]);
+}
+
+//____________________________________________________________________
+void AliTwoTrackDPhiStar::SetTriggers(Int_t n, const Float_t* phi, const Float_t* pt, const Float_t* charge)
+{
+  // sets the trigger particles and calculates their terms at the boundaries of the radius range
+  // the arrays are not copied and have to stay valid while the object is used
+
+  fN[0] = n;
+  fPhi[0] = phi;
+  fPt[0] = pt;
+  fCharge[0] = charge;
+
+  fTermMin[0].resize(n);
+  fTermMax[0].resize(n);
+  for (Int_t k=0; k<n; k++)
+  {
+    fTermMin[0][k] = Term(0, k, fMinRadius);
+    fTermMax[0][k] = Term(0, k, 2.5);
+  }
+
+  fRowOffset[0].assign(n, -1);
+  fTerms.clear();
+}
+
+//____________________________________________________________________
+void AliTwoTrackDPhiStar::SetAssociated(Int_t n, const Float_t* eta, const Float_t* phi, const Float_t* pt, const Float_t* charge)
+{
+  // sets the associated particles, to be called after SetTriggers
+  // if the arrays are the ones of the triggers (same event), the terms of the triggers are used
+
+  fEta = eta;
+  fSelected.resize(n);
+
+  if (n == fN[0] && phi == fPhi[0] && pt == fPt[0] && charge == fCharge[0])
+  {
+    fAssociated = 0;
+    return;
+  }
+
+  fAssociated = 1;
+  fN[1] = n;
+  fPhi[1] = phi;
+  fPt[1] = pt;
+  fCharge[1] = charge;
+
+  fTermMin[1].resize(n);
+  fTermMax[1].resize(n);
+  for (Int_t k=0; k<n; k++)
+  {
+    fTermMin[1][k] = Term(1, k, fMinRadius);
+    fTermMax[1][k] = Term(1, k, 2.5);
+  }
+
+  fRowOffset[1].assign(n, -1);
+}
+
+//____________________________________________________________________
+void AliTwoTrackDPhiStar::FillRow(Int_t set, Int_t k)
+{
+  // calculates the terms of track k along the radius scan
+
+  const Int_t nRadii = fRadii.size();
+
+  fRowOffset[set][k] = fTerms.size();
+  fTerms.resize(fTerms.size() + nRadii);
+
+  Double_t* row = &fTerms[fRowOffset[set][k]];
+  for (Int_t r=0; r<nRadii; r++)
+    row[r] = Term(set, k, fRadii[r]);
+}
+
+//____________________________________________________________________
+void AliTwoTrackDPhiStar::SelectPairs(Int_t i, Float_t triggerEta, Float_t cutValue)
+{
+  // flags the associated tracks for which the radius scan has to be done for trigger i
+  // (same conditions as the pair-by-pair optimization in AliUEHistograms::FillCorrelations)
+
+  const Int_t a = fAssociated;
+  const Int_t n = fSelected.size();
+
+  const Double_t kEtaLimit = cutValue * 2.5 * 3;
+  const Float_t kLimit = cutValue * 3;
+
+  const Float_t phi1 = fPhi[0][i];
+  const Double_t termMin1 = fTermMin[0][i];
+  const Double_t termMax1 = fTermMax[0][i];
+
+  const Float_t* eta = fEta;
+  const Float_t* phi2 = fPhi[a];
+  const Double_t* termMin2 = fTermMin[a].data();
+  const Double_t* termMax2 = fTermMax[a].data();
+  UChar_t* selected = fSelected.data();
+
+  for (Int_t j=0; j<n; j++)
+  {
+    Float_t deta = triggerEta - eta[j];
+    Float_t dphistar1 = Wrap(phi1 - phi2[j] - termMin1 + termMin2[j]);
+    Float_t dphistar2 = Wrap(phi1 - phi2[j] - termMax1 + termMax2[j]);
+
+    selected[j] = (TMath::Abs(deta) < kEtaLimit) & ((TMath::Abs(dphistar1) < kLimit) | (TMath::Abs(dphistar2) < kLimit) | (dphistar1 * dphistar2 < 0));
+  }
+}
+
+//____________________________________________________________________
+void AliTwoTrackDPhiStar::GetDPhiStarMin(Int_t i, Int_t j, Float_t& dphistarmin, Float_t& dphistarminabs)
+{
+  // finds the dphistar with the smallest absolute value along the radius scan for trigger i and associated j
+  // the first one is taken in case of equal values
+
+  const Int_t nRadii = fRadii.size();
+
+  // calculate the rows at first use (before taking pointers, filling may reallocate fTerms)
+  if (fRowOffset[0][i] < 0)
+    FillRow(0, i);
+  if (fRowOffset[fAssociated][j] < 0)
+    FillRow(fAssociated, j);
+
+  const Double_t* row1 = &fTerms[fRowOffset[0][i]];
+  const Double_t* row2 = &fTerms[fRowOffset[fAssociated][j]];
+  const Float_t phi1 = fPhi[0][i];
+  const Float_t phi2 = fPhi[fAssociated][j];
+  Float_t* scan = fScan.data();
+
+  for (Int_t r=0; r<nRadii; r++)
+    scan[r] = Wrap(phi1 - phi2 - row1[r] + row2[r]);
+
+  dphistarminabs = 1e5;
+  dphistarmin = 1e5;
+  for (Int_t r=0; r<nRadii; r++)
+  {
+    Float_t dphistarabs = TMath::Abs(scan[r]);
+
+    if (dphistarabs < dphistarminabs)
+    {
+      dphistarmin = scan[r];
+      dphistarminabs = dphistarabs;
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#ifndef AliTwoTrackDPhiStar_H
+#define AliTwoTrackDPhiStar_H
+
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+// batched dphistar evaluation for the two-track efficiency cut
+
+#include <vector>
+
+#include "Rtypes.h"
+#include "TMath.h"
+
+class AliTwoTrackDPhiStar
+{
+ public:
+  AliTwoTrackDPhiStar();
+  ~AliTwoTrackDPhiStar() {}
+
+  void Init(Float_t minRadius, Float_t bSign);
+  void SetTriggers(Int_t n, const Float_t* phi, const Float_t* pt, const Float_t* charge);
+  void SetAssociated(Int_t n, const Float_t* eta, const Float_t* phi, const Float_t* pt, const Float_t* charge);
+
+  void SelectPairs(Int_t i, Float_t triggerEta, Float_t cutValue);
+  Bool_t IsSelected(Int_t j) const { return fSelected[j]; }
+
+  void GetDPhiStarMin(Int_t i, Int_t j, Float_t& dphistarmin, Float_t& dphistarminabs);
+
+  inline static Float_t Wrap(Float_t dphistar);
+
+ private:
+  AliTwoTrackDPhiStar(const AliTwoTrackDPhiStar&);
+  AliTwoTrackDPhiStar& operator=(const AliTwoTrackDPhiStar&);
+
+  Double_t Term(Int_t set, Int_t k, Float_t radius) const;
+  void FillRow(Int_t set, Int_t k);
+
+  Float_t fBSign;                          // sign of the magnetic field
+  Float_t fMinRadius;                      // minimal radius of the scan
+  std::vector<Float_t> fRadii;             // radii of the scan, as in the scalar loop
+
+  Int_t fN[2];                             // number of tracks per set (0 = triggers, 1 = associated)
+  const Float_t* fPhi[2];                  // phi per set (not owned)
+  const Float_t* fPt[2];                   // pt per set (not owned)
+  const Float_t* fCharge[2];               // charge per set (not owned)
+  const Float_t* fEta;                     // eta of the associated tracks (not owned)
+  Int_t fAssociated;                       // set holding the associated tracks (0 if same event)
+
+  std::vector<Double_t> fTermMin[2];       // curvature term at the minimal radius per track
+  std::vector<Double_t> fTermMax[2];       // curvature term at 2.5 m per track
+  std::vector<Int_t> fRowOffset[2];        // offset of the track row in fTerms, -1 if not yet calculated
+  std::vector<Double_t> fTerms;            // curvature terms along the radius scan, one row per track
+  std::vector<UChar_t> fSelected;          // associated tracks of the current trigger which need the radius scan
+  std::vector<Float_t> fScan;              // scratch for the radius scan
+};
+
+Float_t AliTwoTrackDPhiStar::Wrap(Float_t dphistar)
+{
+  // brings dphistar into [-pi, pi] exactly like AliUEHistograms::GetDPhiStar
+  // written with conditional expressions so that loops over it can be vectorized
+
+  static const Double_t kPi = TMath::Pi();
+
+  dphistar = (dphistar > kPi) ? (Float_t) (kPi * 2 - dphistar) : dphistar;
+  dphistar = (dphistar < -kPi) ? (Float_t) (-kPi * 2 - dphistar) : dphistar;
+  dphistar = (dphistar > kPi) ? (Float_t) (kPi * 2 - dphistar) : dphistar; // might look funny but is needed
+
+  return dphistar;
+}
+
+#endif
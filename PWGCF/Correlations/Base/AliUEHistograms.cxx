@@ -23,8 +23,11 @@
 // Author: Jan Fiete Grosse-Oetringhaus, Sara Vallero
 
 #include "AliUEHistograms.h"
+#include "AliTwoTrackDPhiStar.h"
+#include "AliCFParticleView.h"
 
 #include "AliCFContainer.h"
+#include "AliTHn.h"
 #include "AliBasicParticle.h"
 #include "AliVParticle.h"
 #include "AliAODTrack.h"
@@ -37,6 +40,9 @@
 #include "TMath.h"
 #include "TLorentzVector.h"
 
+#include <algorithm>
+#include <vector>
+
 ClassImp(AliUEHistograms)
 
 const Int_t AliUEHistograms::fgkUEHists = 3;
@@ -574,6 +580,27 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
   //
   // if mixed is non-0, mixed events are filled, the trigger particle is from particles, the associated from mixed
   // if weight < 0, then the pt of the associated particle is filled as weight
+  //
+  // the kinematics are copied once into arrays, see the AliCFParticleView overload below
+  
+  AliCFParticleView particleView;
+  AliCFParticleView mixedView;
+  if (particles)
+    particleView.Set(particles);
+  if (mixed)
+    mixedView.Set(mixed);
+  
+  FillCorrelations(centrality, zVtx, step, (particles) ? &particleView : 0, (mixed) ? &mixedView : 0, weight, firstTime, twoTrackEfficiencyCut, bSign, twoTrackEfficiencyCutValue, applyEfficiency);
+}
+
+//____________________________________________________________________
+void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, const AliCFParticleView* particles, const AliCFParticleView* mixed, Float_t weight, Bool_t firstTime, Bool_t twoTrackEfficiencyCut, Float_t bSign, Float_t twoTrackEfficiencyCutValue, Bool_t applyEfficiency)
+{
+  // fills the fNumberDensityPhi histogram
+  //
+  // same as above, with the particles given as arrays of their kinematics
+  // the particle objects are only needed (and used if available) for fCheckEventNumberInCorrelation and to remove
+  // identical particles in the mixed event
   
   Bool_t fillpT = kFALSE;
   if (weight < 0)
@@ -591,18 +618,49 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
     TH1::AddDirectory(oldStatus);
   }
 
-  // Eta() is extremely time consuming, therefore cache it for the inner loop here:
-  TObjArray* input = (mixed) ? mixed : particles;
-  TArrayF eta(input->GetEntriesFast());
-  for (Int_t i=0; i<input->GetEntriesFast(); i++)
-    eta[i] = ((AliVParticle*) input->UncheckedAt(i))->Eta();
+  // associated particles
+  const AliCFParticleView* input = (mixed) ? mixed : particles;
+  const Float_t* eta = input->GetEta();
+  const Double_t* phi = input->GetPhi();
+  const Double_t* pt = input->GetPt();
+  const Short_t* charge = input->GetCharge();
+  
+  // the two-track efficiency cut works on arrays of phi, pt and charge (index 0: triggers, 1: associated from the mixed event)
+  // the single-track terms of dphistar are calculated once per event, see AliTwoTrackDPhiStar
+  AliTwoTrackDPhiStar dphiStar;
+  TArrayF trackPhi[2], trackPt[2], trackCharge[2];
+  if (particles && twoTrackEfficiencyCut)
+  {
+    const AliCFParticleView* sets[2] = { particles, mixed };
+    for (Int_t set=0; set<2; set++)
+    {
+      if (!sets[set])
+        continue;
+
+      Int_t n = sets[set]->GetEntries();
+      trackPhi[set].Set(n);
+      trackPt[set].Set(n);
+      trackCharge[set].Set(n);
+      for (Int_t k=0; k<n; k++)
+      {
+        trackPhi[set][k] = sets[set]->GetPhi()[k];
+        trackPt[set][k] = sets[set]->GetPt()[k];
+        trackCharge[set][k] = sets[set]->GetCharge()[k];
+      }
+    }
+
+    Int_t associated = (mixed) ? 1 : 0;
+    dphiStar.Init(fTwoTrackCutMinRadius, bSign);
+    dphiStar.SetTriggers(trackPhi[0].GetSize(), trackPhi[0].GetArray(), trackPt[0].GetArray(), trackCharge[0].GetArray());
+    dphiStar.SetAssociated(trackPhi[associated].GetSize(), eta, trackPhi[associated].GetArray(), trackPt[associated].GetArray(), trackCharge[associated].GetArray());
+  }
   
   // if particles is not set, just fill event statistics
   if (particles)
   {
-    Int_t jMax = particles->GetEntriesFast();
+    Int_t jMax = particles->GetEntries();
     if (mixed)
-      jMax = mixed->GetEntriesFast();
+      jMax = mixed->GetEntries();
     
     TH1* triggerWeighting = 0;
     if (fWeightPerEvent)
@@ -610,12 +668,10 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       TAxis* axis = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->GetGrid(0)->GetGrid()->GetAxis(2);
       triggerWeighting = new TH1F("triggerWeighting", "", axis->GetNbins(), axis->GetXbins()->GetArray());
     
-      for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+      for (Int_t i=0; i<particles->GetEntries(); i++)
       {
-	AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
-	
 	// some optimization
-	Float_t triggerEta = triggerParticle->Eta();
+	Float_t triggerEta = particles->GetEta()[i];
 
 	if (fTriggerRestrictEta > 0 && TMath::Abs(triggerEta) > fTriggerRestrictEta)
 	  continue;
@@ -627,16 +683,19 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 	
 	if (fTriggerSelectCharge != 0)
-	  if (triggerParticle->Charge() * fTriggerSelectCharge < 0)
+	  if (particles->GetCharge()[i] * fTriggerSelectCharge < 0)
 	    continue;
 	
-	triggerWeighting->Fill(triggerParticle->Pt());
+	triggerWeighting->Fill(particles->GetPt()[i]);
       }
     }
     
     // identify K, Lambda candidates and flag those particles
-    // a TObject bit is used for this
-    const UInt_t kResonanceDaughterFlag = 1 << 14;
+    // (triggers at index i, associated particles at index associatedOffset + j; in the same event both are the same)
+    // as the flag was a bit of the particle object before, the flag is shared by all entries of the same object
+    const Int_t associatedOffset = (mixed) ? particles->GetEntries() : 0;
+    std::vector<Bool_t> resonanceDaughter;
+    std::vector<AliVParticle*> resonanceDaughterParticles;
     if (fRejectResonanceDaughters > 0)
     {
       Double_t resonanceMass = -1;
@@ -652,26 +711,22 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	default: AliFatal(Form("Invalid setting %d", fRejectResonanceDaughters));
       }
 
-      for (Int_t i=0; i<particles->GetEntriesFast(); i++)
-	particles->UncheckedAt(i)->ResetBit(kResonanceDaughterFlag);
-      if (mixed)
-	for (Int_t i=0; i<jMax; i++)
-	  mixed->UncheckedAt(i)->ResetBit(kResonanceDaughterFlag);
+      resonanceDaughter.assign(associatedOffset + jMax, kFALSE);
       
-      for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+      for (Int_t i=0; i<particles->GetEntries(); i++)
       {
-	AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
+	AliVParticle* triggerParticle = particles->GetParticle(i);
+	Float_t triggerEta = particles->GetEta()[i];
+	Double_t triggerPhi = particles->GetPhi()[i];
+	Double_t triggerPt = particles->GetPt()[i];
+	Short_t triggerCharge = particles->GetCharge()[i];
 	
 	for (Int_t j=0; j<jMax; j++)
 	{
 	  if (!mixed && i == j)
 	    continue;
 	
-	  AliVParticle* particle = 0;
-	  if (!mixed)
-	    particle = (AliVParticle*) particles->UncheckedAt(j);
-	  else
-	    particle = (AliVParticle*) mixed->UncheckedAt(j);
+	  AliVParticle* particle = input->GetParticle(j);
 	  
 	  // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
 	  if (fCheckEventNumberInCorrelation)
@@ -687,36 +742,65 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	    if(triggerParticleBasic->IsInSameEvent(particleBasic))
 	      continue;
 	  }
-	  else if (mixed && triggerParticle->IsEqual(particle))
+	  else if (mixed && triggerParticle && particle && triggerParticle->IsEqual(particle))
 	    continue;
 	  
-	  if (triggerParticle->Charge() * particle->Charge() > 0)
+	  if (triggerCharge * charge[j] > 0)
 	    continue;
       
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerParticle->Eta(), triggerParticle->Phi(), particle->Pt(), particle->Eta(), particle->Phi(), massDaughter1, massDaughter2);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], massDaughter1, massDaughter2);
 	      
 	  if (TMath::Abs(mass - resonanceMass*resonanceMass) < interval*5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerParticle->Eta(), triggerParticle->Phi(), particle->Pt(), particle->Eta(), particle->Phi(), massDaughter1, massDaughter2);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], massDaughter1, massDaughter2);
 
 	    if (mass > (resonanceMass-interval)*(resonanceMass-interval) && mass < (resonanceMass+interval)*(resonanceMass+interval))
 	    {
-	      triggerParticle->SetBit(kResonanceDaughterFlag);
-	      particle->SetBit(kResonanceDaughterFlag);
+	      resonanceDaughter[i] = kTRUE;
+	      resonanceDaughter[associatedOffset + j] = kTRUE;
+	      if (triggerParticle)
+		resonanceDaughterParticles.push_back(triggerParticle);
+	      if (particle)
+		resonanceDaughterParticles.push_back(particle);
 	      
 // 	      Printf("Flagged %d %d %f", i, j, TMath::Sqrt(mass));
 	    }
 	  }
 	}
       }
+      
+      // propagate the flags to all entries of the flagged objects (e.g. a particle which is both in the trigger and in the mixed list)
+      if (resonanceDaughterParticles.size() > 0)
+      {
+	std::sort(resonanceDaughterParticles.begin(), resonanceDaughterParticles.end());
+	
+	for (Int_t k=0; k<associatedOffset + jMax; k++)
+	{
+	  AliVParticle* particle = (k < associatedOffset) ? particles->GetParticle(k) : input->GetParticle(k - associatedOffset);
+	  if (particle && std::binary_search(resonanceDaughterParticles.begin(), resonanceDaughterParticles.end(), particle))
+	    resonanceDaughter[k] = kTRUE;
+	}
+      }
     }
     
-    for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+    // the pairs of one trigger particle are collected and filled at once
+    AliCFContainer* trackHist = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward);
+    AliTHnBase* trackHistTHn = dynamic_cast<AliTHnBase*> (trackHist);
+    const Int_t nTrackVars = trackHist->GetNVar();
+    std::vector<Double_t> pairVars;
+    std::vector<Double_t> pairWeights;
+    pairVars.reserve(jMax * nTrackVars);
+    pairWeights.reserve(jMax);
+    
+    for (Int_t i=0; i<particles->GetEntries(); i++)
     {
-      AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
+      AliVParticle* triggerParticle = particles->GetParticle(i);
       
       // some optimization
-      Float_t triggerEta = triggerParticle->Eta();
+      Float_t triggerEta = particles->GetEta()[i];
+      Double_t triggerPhi = particles->GetPhi()[i];
+      Double_t triggerPt = particles->GetPt()[i];
+      Short_t triggerCharge = particles->GetCharge()[i];
       
       if (fTriggerRestrictEta > 0 && TMath::Abs(triggerEta) > fTriggerRestrictEta)
 	continue;
@@ -728,26 +812,29 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
       
       if (fTriggerSelectCharge != 0)
-	if (triggerParticle->Charge() * fTriggerSelectCharge < 0)
+	if (triggerCharge * fTriggerSelectCharge < 0)
 	  continue;
 	
       if (fRejectResonanceDaughters > 0)
-	if (triggerParticle->TestBit(kResonanceDaughterFlag))
+	if (resonanceDaughter[i])
 	{
 // 	  Printf("Skipped i=%d", i);
 	  continue;
 	}
 	
+      // check dphistar at the boundaries of the radius range against all associated particles at once
+      if (twoTrackEfficiencyCut)
+        dphiStar.SelectPairs(i, triggerEta, twoTrackEfficiencyCutValue);
+	
+      pairVars.clear();
+      pairWeights.clear();
+      
       for (Int_t j=0; j<jMax; j++)
       {
         if (!mixed && i == j)
           continue;
       
-        AliVParticle* particle = 0;
-        if (!mixed)
-          particle = (AliVParticle*) particles->UncheckedAt(j);
-        else
-          particle = (AliVParticle*) mixed->UncheckedAt(j);
+        AliVParticle* particle = input->GetParticle(j);
         
         // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
         if (fCheckEventNumberInCorrelation)
@@ -760,25 +847,25 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
           if(triggerParticleBasic->IsInSameEvent(particleBasic))
             continue;
         }
-        else if (mixed && triggerParticle->IsEqual(particle))
+        else if (mixed && triggerParticle && particle && triggerParticle->IsEqual(particle))
           continue;
         
         if (fPtOrder)
-	  if (particle->Pt() >= triggerParticle->Pt())
+	  if (pt[j] >= triggerPt)
 	    continue;
 	
 	if (fAssociatedSelectCharge != 0)
-	  if (particle->Charge() * fAssociatedSelectCharge < 0)
+	  if (charge[j] * fAssociatedSelectCharge < 0)
 	    continue;
 
         if (fSelectCharge > 0)
         {
           // skip like sign
-          if (fSelectCharge == 1 && particle->Charge() * triggerParticle->Charge() > 0)
+          if (fSelectCharge == 1 && charge[j] * triggerCharge > 0)
             continue;
             
           // skip unlike sign
-          if (fSelectCharge == 2 && particle->Charge() * triggerParticle->Charge() < 0)
+          if (fSelectCharge == 2 && charge[j] * triggerCharge < 0)
             continue;
         }
         
@@ -795,20 +882,20 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 
 	if (fRejectResonanceDaughters > 0)
-	  if (particle->TestBit(kResonanceDaughterFlag))
+	  if (resonanceDaughter[associatedOffset + j])
 	  {
 // 	    Printf("Skipped j=%d", j);
 	    continue;
 	  }
 
 	// conversions
-	if (fCutConversionsV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutConversionsV > 0 && charge[j] * triggerCharge < 0)
 	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.510e-3, 0.510e-3);
 	  
 	  if (mass < fCutConversionsV * 5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.510e-3, 0.510e-3);
 	    
 	    fControlConvResoncances->Fill(0.0, mass);
 
@@ -818,15 +905,15 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 	
 	// K0s
-	if (fCutK0sV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutK0sV > 0 && charge[j] * triggerCharge < 0)
 	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	  
 	  const Float_t kK0smass = 0.4976;
 	  
 	  if (TMath::Abs(mass - kK0smass*kK0smass) < fCutK0sV * 5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	    
 	    fControlConvResoncances->Fill(1, mass - kK0smass*kK0smass);
 
@@ -836,16 +923,16 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 
 	// Lambda
-	if (fCutLambdaV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutLambdaV > 0 && charge[j] * triggerCharge < 0)
 	{
-	  Float_t mass1 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
-	  Float_t mass2 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
+	  Float_t mass1 = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.9383);
+	  Float_t mass2 = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.9383, 0.1396);
 	  
 	  const Float_t kLambdaMass = 1.115;
 
 	  if (TMath::Abs(mass1 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
 	  {
-	    mass1 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
+	    mass1 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.9383);
 
 	    fControlConvResoncances->Fill(2, mass1 - kLambdaMass*kLambdaMass);
 	    
@@ -854,7 +941,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  }
 	  if (TMath::Abs(mass2 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
 	  {
-	    mass2 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
+	    mass2 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.9383, 0.1396);
 
 	    fControlConvResoncances->Fill(2, mass2 - kLambdaMass*kLambdaMass);
 
@@ -864,15 +951,15 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 
         // Phi
-	if (fCutPhiV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutPhiV > 0 && charge[j] * triggerCharge < 0)
 	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.4937, 0.4937);
 	  
 	  const Float_t kPhimass = 1.019;
 	  
 	  if (TMath::Abs(mass - kPhimass*kPhimass) < fCutPhiV * 5)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.4937, 0.4937);
 	    
 	    fControlConvResoncances->Fill(3, mass - kPhimass*kPhimass);
 	    
@@ -882,15 +969,15 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}	
 
         // Rho
-	if (fCutRhoV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutRhoV > 0 && charge[j] * triggerCharge < 0)
         {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	  
 	  const Float_t kRhomass = 0.770;
 	  
 	  if (TMath::Abs(mass - kRhomass*kRhomass) < fCutRhoV * 5)
           {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], 0.1396, 0.1396);
 	    
 	    fControlConvResoncances->Fill(4, mass - kRhomass*kRhomass);
 	    
@@ -900,13 +987,13 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
 
         // User-defined cut
-	if (fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	if (fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && charge[j] * triggerCharge < 0)
         {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
+	  Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], fCutCustomFirst, fCutCustomSecond);
 	  
 	  if (TMath::Abs(mass - fCutCustomMass*fCutCustomMass) < fCutCustomV * 5)
           {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
+	    mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], eta[j], phi[j], fCutCustomFirst, fCutCustomSecond);
 	    
 	    fControlConvResoncances->Fill(5, mass - fCutCustomMass*fCutCustomMass);
 	    
@@ -915,66 +1002,40 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  }
 	}
 
-	if (twoTrackEfficiencyCut)
+	if (twoTrackEfficiencyCut && dphiStar.IsSelected(j))
 	{
 	  // the variables & cuthave been developed by the HBT group 
 	  // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
+	  
+	  // optimization: only pairs for which dphistar at the boundaries is small or changes sign are selected (see above)
+	  // for these, find the minimum along the radius range
 
-	  Float_t phi1 = triggerParticle->Phi();
-	  Float_t pt1 = triggerParticle->Pt();
-	  Float_t charge1 = triggerParticle->Charge();
-	    
-	  Float_t phi2 = particle->Phi();
-	  Float_t pt2 = particle->Pt();
-	  Float_t charge2 = particle->Charge();
+	  Float_t pt1 = triggerPt;
+	  Float_t pt2 = pt[j];
 	      
 	  Float_t deta = triggerEta - eta[j];
 	      
-	  // optimization
-	  if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
-	  {
-	    // check first boundaries to see if is worth to loop and find the minimum
-	    Float_t dphistar1 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fTwoTrackCutMinRadius, bSign);
-	    Float_t dphistar2 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, 2.5, bSign);
-	    
-	    const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
-
-	    Float_t dphistarminabs = 1e5;
-	    Float_t dphistarmin = 1e5;
-	    if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
-	    {
-	      for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01) 
-	      {
-		Float_t dphistar = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, rad, bSign);
-
-		Float_t dphistarabs = TMath::Abs(dphistar);
-		
-		if (dphistarabs < dphistarminabs)
-		{
-		  dphistarmin = dphistar;
-		  dphistarminabs = dphistarabs;
-		}
-	      }
+	  Float_t dphistarminabs = 1e5;
+	  Float_t dphistarmin = 1e5;
+	  dphiStar.GetDPhiStarMin(i, j, dphistarmin, dphistarminabs);
 	      
-	      fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+	  fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
 	      
-	      if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
-	      {
-// 		Printf("Removed track pair %d %d with %f %f %f %f %f %f %f %f %f", i, j, deta, dphistarminabs, phi1, pt1, charge1, phi2, pt2, charge2, bSign);
-		continue;
-	      }
-
-    	      fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
-	    }
+	  if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
+	  {
+// 	    Printf("Removed track pair %d %d with %f %f %f %f %f", i, j, deta, dphistarminabs, pt1, pt2, bSign);
+	    continue;
 	  }
+
+	  fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
 	}
         
         Double_t vars[6];
         vars[0] = triggerEta - eta[j];
-        vars[1] = particle->Pt();
-        vars[2] = triggerParticle->Pt();
+        vars[1] = pt[j];
+        vars[2] = triggerPt;
         vars[3] = centrality;
-        vars[4] = triggerParticle->Phi() - particle->Phi();
+        vars[4] = triggerPhi - phi[j];
         if (vars[4] > 1.5 * TMath::Pi()) 
           vars[4] -= TMath::TwoPi();
         if (vars[4] < -0.5 * TMath::Pi())
@@ -982,7 +1043,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	vars[5] = zVtx;
 	
 	if (fillpT)
-	  weight = particle->Pt();
+	  weight = pt[j];
 	
 	Double_t useWeight = weight;
 	if (applyEfficiency)
@@ -1020,16 +1081,23 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
     
         // fill all in toward region and do not use the other regions
-	fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->Fill(vars, step, useWeight);
+	pairVars.insert(pairVars.end(), vars, vars + nTrackVars);
+	pairWeights.push_back(useWeight);
 
 // 	Printf("%.2f %.2f --> %.2f", triggerEta, eta[j], vars[0]);
       }
+      
+      if (trackHistTHn)
+	trackHistTHn->FillN(pairWeights.size(), pairVars.data(), step, pairWeights.data());
+      else
+	for (UInt_t k=0; k<pairWeights.size(); k++)
+	  trackHist->Fill(&pairVars[k * nTrackVars], step, pairWeights[k]);
  
       if (firstTime)
       {
         // once per trigger particle
         Double_t vars[3];
-        vars[0] = triggerParticle->Pt();
+        vars[0] = triggerPt;
         vars[1] = centrality;
 	vars[2] = zVtx;
 
@@ -1046,8 +1114,8 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
 	}
 
-	if (TMath::Abs(triggerEta) < 0.8 && triggerParticle->Pt() > 0)
-	  fInvYield2->Fill(centrality, triggerParticle->Pt(), useWeight / triggerParticle->Pt());
+	if (TMath::Abs(triggerEta) < 0.8 && triggerPt > 0)
+	  fInvYield2->Fill(centrality, triggerPt, useWeight / triggerPt);
 
 	if (fWeightPerEvent)
 	{
@@ -1060,14 +1128,14 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
         fNumberDensityPhi->GetEventHist()->Fill(vars, step, useWeight);
 
 	// QA
-        fCorrelationpT->Fill(centrality, triggerParticle->Pt());
+        fCorrelationpT->Fill(centrality, triggerPt);
         fCorrelationEta->Fill(centrality, triggerEta);
-        fCorrelationPhi->Fill(centrality, triggerParticle->Phi());
-	fYields->Fill(centrality, triggerParticle->Pt(), triggerEta);
-	fYieldsEtaPhiPT->Fill(triggerParticle->Pt(), triggerEta, triggerParticle->Phi());
+        fCorrelationPhi->Fill(centrality, triggerPhi);
+	fYields->Fill(centrality, triggerPt, triggerEta);
+	fYieldsEtaPhiPT->Fill(triggerPt, triggerEta, triggerPhi);
 	
 /*        if (dynamic_cast<AliAODTrack*>(triggerParticle))
-          fITSClusterMap->Fill(((AliAODTrack*) triggerParticle)->GetITSClusterMap(), centrality, triggerParticle->Pt());*/
+          fITSClusterMap->Fill(((AliAODTrack*) triggerParticle)->GetITSClusterMap(), centrality, triggerPt);*/
       }
     }
     
@@ -1079,7 +1147,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
   }
   
   fCentralityDistribution->Fill(centrality);
-  fCentralityCorrelation->Fill(centrality, particles->GetEntriesFast());
+  fCentralityCorrelation->Fill(centrality, particles->GetEntries());
   FillEvent(centrality, step);
 }
   
@@ -410,11 +410,15 @@ void AliAnalysisTaskGFWFlow::UserExec(Option_t*) {
     //V_2{n}, full acceptance
     // mywatchStore.Start(kFALSE);
     Bool_t filled;
+    fEvHandles.clear();
+    fEvValues.clear();
+    fEvWeights.clear();
     for(Int_t l_ind=0; l_ind<corrconfigs.size(); l_ind++) {
       //Bool_t DisableOL=kFALSE;
       //if(l_ind<14) DisableOL = (l_ind%2); //Only for 1, 3, 5 ... 13
-      filled = FillFCs(corrconfigs.at(l_ind),cent,rndmn);//,DisableOL);
+      filled = FillFCs(corrconfigs.at(l_ind),fFCHandles.at(l_ind),cent,rndmn);//,DisableOL);
     };
+    fFC->FillProfiles(fEvHandles.size(),fEvHandles.data(),cent,fEvValues.data(),fEvWeights.data(),rndmn);
     // mywatchStore.Stop();
     PostData(1,fFC);
     if(fAddQA) PostData(2,fQAList);
@@ -606,14 +610,18 @@ Bool_t AliAnalysisTaskGFWFlow::FillFCs(TString head, TString hn, Double_t cent,
   };
   return kTRUE;
 };
-Bool_t AliAnalysisTaskGFWFlow::FillFCs(AliGFW::CorrConfig corconf, Double_t cent, Double_t rndmn, Bool_t DisableOverlap) {
+Bool_t AliAnalysisTaskGFWFlow::FillFCs(const AliGFW::CorrConfig &corconf, const vector<Int_t> &handles, Double_t cent, Double_t rndmn, Bool_t DisableOverlap) {
+  //Values are collected in fEv* and filled to fFC for all correlators at once
   Double_t dnx, val;
   dnx = fGFW->Calculate(corconf,0,kTRUE).Re();
   if(dnx==0) return kFALSE;
   if(!corconf.pTDif) {
     val = fGFW->Calculate(corconf,0,kFALSE).Re()/dnx;
-    if(TMath::Abs(val)<1)
-      fFC->FillProfile(corconf.Head.Data(),cent,val,dnx,rndmn);
+    if(TMath::Abs(val)<1) {
+      fEvHandles.push_back(handles[0]);
+      fEvValues.push_back(val);
+      fEvWeights.push_back(dnx);
+    };
     return kTRUE;
   };
   /*Int_t binDisableOLFrom = fPtAxis->GetNbins()+1;
@@ -625,8 +633,11 @@ Bool_t AliAnalysisTaskGFWFlow::FillFCs(AliGFW::CorrConfig corconf, Double_t cent
     dnx = fGFW->Calculate(corconf,i-1,kTRUE,NeedToDisable).Re();
     if(dnx==0) continue;
     val = fGFW->Calculate(corconf,i-1,kFALSE,NeedToDisable).Re()/dnx;
-    if(TMath::Abs(val)<1)
-      fFC->FillProfile(Form("%s_pt_%i",corconf.Head.Data(),i),cent,val,dnx,rndmn);
+    if(TMath::Abs(val)<1) {
+      fEvHandles.push_back(handles[i]);
+      fEvValues.push_back(val);
+      fEvWeights.push_back(dnx);
+    };
   };
   return kTRUE;
 };
@@ -704,5 +715,14 @@ void AliAnalysisTaskGFWFlow::CreateCorrConfigs() {
   corrconfigs.push_back(GetConf("MidGapNV52","poiGapNeg refGapNeg {5} refGapPos {-5}", kTRUE));
   corrconfigs.push_back(GetConf("MidGapPV52","refGapPos {5} refGapNeg {-5}", kFALSE));
   corrconfigs.push_back(GetConf("MidGapPV52","poiGapPos refGapPos {5} refGapNeg {-5}", kTRUE));
-
+  //Resolve the profile bins once, so that filling does not need to look up labels
+  fFCHandles.clear();
+  for(Int_t l_ind=0; l_ind<(Int_t)corrconfigs.size(); l_ind++) {
+    vector<Int_t> l_handles(fPtAxis->GetNbins()+1,-1);
+    if(!corrconfigs.at(l_ind).pTDif)
+      l_handles[0] = fFC->GetBinHandle(corrconfigs.at(l_ind).Head.Data());
+    else for(Int_t i=1;i<=fPtAxis->GetNbins();i++)
+      l_handles[i] = fFC->GetBinHandle(Form("%s_pt_%i",corrconfigs.at(l_ind).Head.Data(),i));
+    fFCHandles.push_back(l_handles);
+  };
 }
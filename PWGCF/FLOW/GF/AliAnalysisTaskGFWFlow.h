@@ -94,12 +94,16 @@ class AliAnalysisTaskGFWFlow : public AliAnalysisTaskSE {
   Bool_t AcceptParticle(AliVParticle *mPa);
   Bool_t InitRun();
   Bool_t LoadWeights(Int_t runno);
-  Bool_t FillFCs(AliGFW::CorrConfig corconf, Double_t cent, Double_t rndm, Bool_t DisableOverlap=kFALSE);
+  Bool_t FillFCs(const AliGFW::CorrConfig &corconf, const vector<Int_t> &handles, Double_t cent, Double_t rndm, Bool_t DisableOverlap=kFALSE);
+  vector<vector<Int_t> > fFCHandles; //! fFC bins of corrconfigs: [config][0 = pt-integrated, i = pt bin i]
+  vector<Int_t> fEvHandles; //! Correlators of the current event, filled at once
+  vector<Double_t> fEvValues; //!
+  vector<Double_t> fEvWeights; //!
   Bool_t FillFCs(TString head, TString hn, Double_t cent, Bool_t diff, Double_t rndmn);
  // TStopwatch mywatch;
  // TStopwatch mywatchFill;
  // TStopwatch mywatchStore;
-  ClassDef(AliAnalysisTaskGFWFlow,1);
+  ClassDef(AliAnalysisTaskGFWFlow,2);
 };
 
 #endif
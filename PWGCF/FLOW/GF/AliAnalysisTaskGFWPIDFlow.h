@@ -86,8 +86,8 @@ class AliAnalysisTaskGFWPIDFlow : public AliAnalysisTaskSE {
   AliGFWFlowContainer *fFC;
   AliGFW *fGFW; //! not stored
   vector<AliGFW::CorrConfig> corrconfigs; //! do not store
-  Bool_t FillFCs(AliGFW::CorrConfig corconf, Double_t cent, Double_t rndmn, Bool_t EnableDebug=kFALSE); //Pending implementation: possibility to pass pre-calculated values (e.g. for ref flow)
-  Bool_t FillCovariance(AliGFW::CorrConfig corconf, Double_t cent, Double_t d_mpt, Double_t dw_mpt);
+  Bool_t FillFCs(const AliGFW::CorrConfig &corconf, Double_t cent, Double_t rndmn, Bool_t EnableDebug=kFALSE); //Pending implementation: possibility to pass pre-calculated values (e.g. for ref flow)
+  Bool_t FillCovariance(const AliGFW::CorrConfig &corconf, Double_t cent, Double_t d_mpt, Double_t dw_mpt);
   Bool_t AcceptAODTrack(AliAODTrack *lTr, Double_t*);
   //In development
   TH2D **fZMWeights; //
@@ -98,7 +98,7 @@ class AliAnalysisTaskGFWPIDFlow : public AliAnalysisTaskSE {
   Bool_t devAcceptAODTrack(AliAODTrack *lTr, Double_t*);
   void AddToOBA(TObjArray *oba, TString l_name, Int_t nPT=0);
   TAxis *fPtAxis; //!
-  Bool_t GetIntValAndDNX(AliGFW::CorrConfig corconf, Double_t &l_val, Double_t &l_dnx);
+  Bool_t GetIntValAndDNX(const AliGFW::CorrConfig &corconf, Double_t &l_val, Double_t &l_dnx);
   TRandom *fRndm; //!
   ClassDef(AliAnalysisTaskGFWPIDFlow,1);
 };
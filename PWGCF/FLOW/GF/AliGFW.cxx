@@ -94,64 +94,132 @@ void AliGFW::Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t
       fCumulants.at(i).FillArray(eta,ptin,phi,weight);
   };
 };
-TComplex AliGFW::TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant *r1, AliGFWCumulant *r2, AliGFWCumulant *r3) {
-  TComplex part1 = r1->Vec(n1,p1,ptbin);
-  TComplex part2 = r2->Vec(n2,p2,ptbin);
-  TComplex part3 = r3?r3->Vec(n1+n2,p1+p2,ptbin):TComplex(0,0);
-  TComplex formula = part1*part2-part3;
-  return formula;
+void AliGFW::Fill(Int_t n, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, const Int_t *mask) {
+  if(!fInitialized) CreateRegions();
+  if(!fInitialized) return;
+  fFillEta.resize(n);
+  fFillPt.resize(n);
+  fFillPhi.resize(n);
+  fFillWeight.resize(n);
+  for(Int_t i=0;i<(Int_t)fRegions.size();++i) {
+    const Region &reg = fRegions.at(i);
+    Int_t nsel=0;
+    for(Int_t j=0;j<n;j++) {
+      if(!(reg.EtaMin<eta[j] && reg.EtaMax>eta[j] && (reg.BitMask&mask[j]))) continue;
+      fFillEta[nsel] = eta[j];
+      fFillPt[nsel] = ptin[j];
+      fFillPhi[nsel] = phi[j];
+      fFillWeight[nsel] = weight[j];
+      nsel++;
+    };
+    if(nsel) fCumulants.at(i).FillArrays(fFillEta.data(),fFillPt.data(),fFillPhi.data(),fFillWeight.data(),nsel);
+  };
+};
+AliGFW::CorrProgram AliGFW::CompileCorr(Int_t poi, Int_t ref, vector<Int_t> hars, Bool_t SetHarmsToZero) {
+  CorrProgram prog;
+  if(hars.size()==0) {
+    printf("AliGFW::CompileCorr: no harmonics given!\n");
+    return prog;
+  };
+  if(SetHarmsToZero) for(Int_t i=0;i<(Int_t)hars.size();i++) hars.at(i) = 0;
+  vector<Int_t> pows(hars.size(),1); //Powers are always 1 for now
+  prog.Poi = poi;
+  prog.Ref = ref;
+  CorrMemo_t memo;
+  RecursiveCorr(prog, memo, hars, pows);
+  return prog;
 };
-TComplex AliGFW::RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> hars, vector<Int_t> pows) {
-  if(pows.size()==0) //if powers are not initialized, initialize them to 1
-    for(Int_t i=0; i<(Int_t)hars.size(); i++)
-      pows.push_back(1);
-  if(hars.size()<2) return qpoi->Vec(hars.at(0),pows.at(0),ptbin);
-  if(hars.size()<3) return TwoRec(hars.at(0), hars.at(1),pows.at(0),pows.at(1), ptbin, qpoi, qref, qol);
-  Int_t harlast=hars.at(hars.size()-1);
-  Int_t powlast=pows.at(pows.size()-1);
-  hars.erase(hars.end()-1);
-  pows.erase(pows.end()-1);
-  TComplex formula = RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows)*qref->Vec(harlast,powlast);
-  for(Int_t i=0;i<(Int_t)hars.size();i++) {
-    vector<Int_t> lhars = hars;
-    vector<Int_t> lpows = pows;
-    lhars.at(i)+=harlast;
-    lpows.at(i)+=powlast;
-    //The issue is here. In principle, if i=0 (dif), then the overlap is only qpoi (0, if no overlap);
-    //Otherwise, if we are not working with the 1st entry (dif.), then overlap will always be from qref
-    //One should thus (probably) make a check if i=0, then qovl=qpoi, otherwise qovl=qref. But need to think more
-    formula-=RecursiveCorr(qpoi, qref, qol, ptbin, lhars, lpows);
+Int_t AliGFW::RecursiveCorr(CorrProgram &prog, CorrMemo_t &memo, const vector<Int_t> &hars, const vector<Int_t> &pows) {
+  //Same recursion as the direct calculation, but every (harmonics, powers) combination is only added once
+  vector<Int_t> key(hars);
+  key.insert(key.end(),pows.begin(),pows.end());
+  CorrMemo_t::iterator found = memo.find(key);
+  if(found!=memo.end()) return found->second;
+  CorrNode node;
+  Int_t nhars = hars.size();
+  if(nhars<2) { //POI Q-vector
+    node.Type = CorrNode::kSingle;
+    node.Har = hars.at(0);
+    node.Pow = pows.at(0);
+  } else if(nhars<3) { //POI x Ref. - overlap
+    node.Type = CorrNode::kTwo;
+    node.Har = hars.at(0);
+    node.Pow = pows.at(0);
+    node.Har2 = hars.at(1);
+    node.Pow2 = pows.at(1);
+  } else { //(n-1)-particle x Ref. - sum of merged (n-1)-particle terms
+    node.Type = CorrNode::kRecursive;
+    node.Har = hars.at(nhars-1);
+    node.Pow = pows.at(nhars-1);
+    vector<Int_t> lhars(hars.begin(),hars.end()-1);
+    vector<Int_t> lpows(pows.begin(),pows.end()-1);
+    node.Prefix = RecursiveCorr(prog, memo, lhars, lpows);
+    for(Int_t i=0;i<nhars-1;i++) {
+      lhars.at(i)+=node.Har;
+      lpows.at(i)+=node.Pow;
+      //The issue is here. In principle, if i=0 (dif), then the overlap is only qpoi (0, if no overlap);
+      //Otherwise, if we are not working with the 1st entry (dif.), then overlap will always be from qref
+      //One should thus (probably) make a check if i=0, then qovl=qpoi, otherwise qovl=qref. But need to think more
+      node.Subtract.push_back(RecursiveCorr(prog, memo, lhars, lpows));
+      lhars.at(i)-=node.Har;
+      lpows.at(i)-=node.Pow;
+    };
   };
-  return formula;
+  prog.Nodes.push_back(node);
+  Int_t index = prog.Nodes.size()-1;
+  memo[key] = index;
+  return index;
+};
+TComplex AliGFW::RunCorr(const CorrProgram &prog, Int_t ptbin, Bool_t DisableOverlap) {
+  if(prog.Poi<0) return TComplex(0,0);
+  AliGFWCumulant *qpoi = &fCumulants.at(prog.Poi);
+  AliGFWCumulant *qref = &fCumulants.at(prog.Ref);
+  Int_t nNodes = prog.Nodes.size();
+  if((Int_t)fNodeValues.size()<nNodes) fNodeValues.resize(nNodes);
+  for(Int_t i=0;i<nNodes;i++) {
+    const CorrNode &node = prog.Nodes[i];
+    if(node.Type==CorrNode::kSingle) {
+      fNodeValues[i] = qpoi->Vec(node.Har,node.Pow,ptbin);
+    } else if(node.Type==CorrNode::kTwo) {
+      TComplex part1 = qpoi->Vec(node.Har,node.Pow,ptbin);
+      TComplex part2 = qref->Vec(node.Har2,node.Pow2,ptbin);
+      TComplex part3 = DisableOverlap?TComplex(0,0):qpoi->Vec(node.Har+node.Har2,node.Pow+node.Pow2,ptbin);
+      fNodeValues[i] = part1*part2-part3;
+    } else {
+      TComplex formula = fNodeValues[node.Prefix]*qref->Vec(node.Har,node.Pow);
+      for(Int_t j=0;j<(Int_t)node.Subtract.size();j++) formula-=fNodeValues[node.Subtract[j]];
+      fNodeValues[i] = formula;
+    };
+  };
+  return fNodeValues[nNodes-1];
 };
 void AliGFW::Clear() {
   for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs();
-  fCalculatedNames.clear();
-  fCalculatedQs.clear();
 };
 TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   if(config.EqualTo("")) {
     printf("Configuration empty!\n");
     return TComplex(0,0);
   };
-  TString tmp;
-  Ssiz_t sz1=0;
-  TComplex ret(1,0);
-  while(config.Tokenize(tmp,sz1,"}")) {
-    if(SetHarmsToZero) SetHarmonicsToZero(tmp);
-    /*Int_t ind=FindCalculated(tmp);
-    if(ind>=0) {
-      ret*=fCalculatedQs.at(ind);
-      continue;
-    };*/
-    TComplex val=CalculateSingle(tmp);
-    ret*=val;
-    fCalculatedQs.push_back(val);
-    fCalculatedNames.push_back(tmp);
+  //Parse the configuration only the first time it is seen
+  std::map<TString, vector<std::pair<Int_t, CorrProgram> > > &plans = fStringPlans[SetHarmsToZero?1:0];
+  auto found = plans.find(config);
+  if(found==plans.end()) {
+    vector<std::pair<Int_t, CorrProgram> > lPlan;
+    TString tmp;
+    Ssiz_t sz1=0;
+    while(config.Tokenize(tmp,sz1,"}")) {
+      if(SetHarmsToZero) SetHarmonicsToZero(tmp);
+      lPlan.push_back(CompileSingle(tmp));
+    };
+    found = plans.insert(std::make_pair(config,lPlan)).first;
   };
+  TComplex ret(1,0);
+  for(auto pItr=found->second.begin(); pItr!=found->second.end(); ++pItr)
+    ret*=RunCorr(pItr->second,pItr->first);
   return ret;
 };
-TComplex AliGFW::CalculateSingle(TString config) {
+std::pair<Int_t, AliGFW::CorrProgram> AliGFW::CompileSingle(TString config) {
   //First remove all ; and ,:
   config.ReplaceAll(","," ");
   config.ReplaceAll(";"," ");
@@ -172,7 +240,7 @@ TComplex AliGFW::CalculateSingle(TString config) {
   if(sz1<0) sz1=0;
   if(!config.Tokenize(ts,szend,"{")) {
     printf("Could not find harmonics!\n");
-    return TComplex(0,0);
+    return std::make_pair(0,CorrProgram());
   };
   //Fetch regions
   while(ts.Tokenize(ts2,sz1," ")) {
@@ -187,8 +255,12 @@ TComplex AliGFW::CalculateSingle(TString config) {
   };
   //Fetch harmonics
   while(config.Tokenize(ts,szend," ")) hars.push_back(ts.Atoi());
-  if(regs.size()==1) return Calculate(regs.at(0),hars);
-  return Calculate(regs.at(0),regs.at(1),hars,ptbin);
+  if(regs.size()==0) {
+    printf("Could not find any regions in %s!\n",config.Data());
+    return std::make_pair(0,CorrProgram());
+  };
+  if(regs.size()==1) return std::make_pair(0,CompileCorr(regs.at(0),regs.at(0),hars)); //For integrated case
+  return std::make_pair(ptbin,CompileCorr(regs.at(0),regs.at(1),hars)); //For differential, need POI and reference
 };
 AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Bool_t ptdif) {
   //First remove all ; and ,:
@@ -245,52 +317,47 @@ AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Boo
   };
   ReturnConfig.Head = head;
   ReturnConfig.pTDif = ptdif;
+  CompileCorrelatorConfig(ReturnConfig);
   return ReturnConfig;
 };
-
-TComplex AliGFW::Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin) {
-  AliGFWCumulant *qref = &fCumulants.at(ref);
-  AliGFWCumulant *qpoi = &fCumulants.at(poi);
-  AliGFWCumulant *qovl = qpoi;
-  return RecursiveCorr(qpoi, qref, qovl, ptbin, hars);
+void AliGFW::CompileCorrelatorConfig(CorrConfig &corconf) {
+  corconf.Prog = CorrProgram();
+  corconf.ProgZero = CorrProgram();
+  corconf.Prog2 = CorrProgram();
+  corconf.Prog2Zero = CorrProgram();
+  if(corconf.Regs.size()) {
+    Int_t poi = corconf.Regs.at(0);
+    Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
+    corconf.Prog = CompileCorr(poi, ref, corconf.Hars);
+    corconf.ProgZero = CompileCorr(poi, ref, corconf.Hars, kTRUE);
+  };
+  if(corconf.Regs2.size()) {
+    Int_t poi = corconf.Regs2.at(0);
+    Int_t ref = (corconf.Regs2.size()>1)?corconf.Regs2.at(1):corconf.Regs2.at(0);
+    corconf.Prog2 = CompileCorr(poi, ref, corconf.Hars2);
+    corconf.Prog2Zero = CompileCorr(poi, ref, corconf.Hars2, kTRUE);
+  };
+  corconf.Compiled = kTRUE;
 };
-TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
+
+TComplex AliGFW::Calculate(const CorrConfig &corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
   if(corconf.Regs.size()==0) return TComplex(0,0);
-  Int_t poi = corconf.Regs.at(0);
-  Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
-  AliGFWCumulant *qref = &fCumulants.at(ref);
-  AliGFWCumulant *qpoi = &fCumulants.at(poi);
-  if(!qpoi->IsPtBinFilled(ptbin)) return TComplex(0,0);
+  if(!corconf.Compiled) { //Configuration not obtained from GetCorrelatorConfig; compile a temporary copy
+    CorrConfig lConf(corconf);
+    CompileCorrelatorConfig(lConf);
+    return Calculate(lConf, ptbin, SetHarmsToZero, DisableOverlap);
+  };
+  if(!fCumulants.at(corconf.Regs.at(0)).IsPtBinFilled(ptbin)) return TComplex(0,0);
   //if(!qref->IsPtBinFilled(ptbin)) return TComplex(0,0);
-  AliGFWCumulant *qovl = DisableOverlap?0:qpoi;
-  if(SetHarmsToZero) for(Int_t i=0;i<(Int_t)corconf.Hars.size();i++) corconf.Hars.at(i) = 0;
-  TComplex retval = RecursiveCorr(qpoi, qref, qovl, ptbin, corconf.Hars);
+  TComplex retval = RunCorr(SetHarmsToZero?corconf.ProgZero:corconf.Prog, ptbin, DisableOverlap);
   if(corconf.Regs2.size()==0) return retval;
-  poi = corconf.Regs2.at(0);
-  ref = (corconf.Regs2.size()>1)?corconf.Regs2.at(1):corconf.Regs2.at(0);
-  qref = &fCumulants.at(ref);
-  qpoi = &fCumulants.at(poi);
-  qovl = qpoi;
-  if(SetHarmsToZero) for(Int_t i=0;i<(Int_t)corconf.Hars2.size();i++) corconf.Hars2.at(i) = 0;
-  retval*=RecursiveCorr(qpoi, qref, qovl, 0, corconf.Hars2);
+  retval*=RunCorr(SetHarmsToZero?corconf.Prog2Zero:corconf.Prog2, 0);
   return retval;
 };
-
-TComplex AliGFW::Calculate(Int_t poi, vector<Int_t> hars) {
-  AliGFWCumulant *qpoi = &fCumulants.at(poi);
-  return RecursiveCorr(qpoi, qpoi, qpoi, 0, hars);
-};
 Int_t AliGFW::FindRegionByName(TString refName) {
   for(Int_t i=0;i<(Int_t)fRegions.size();i++) if(fRegions.at(i).rName.EqualTo(refName)) return i;
   return -1;
 };
-Int_t AliGFW::FindCalculated(TString identifier) {
-  if(fCalculatedNames.size()==0) return -1;
-  for(Int_t i=0;i<(Int_t)fCalculatedNames.size();i++) {
-    if(fCalculatedNames.at(i).EqualTo(identifier)) return i;
-  };
-  return -1;
-};
 Bool_t AliGFW::SetHarmonicsToZero(TString &instr) {
   TString tmp;
   Ssiz_t sz1=0, sz2;
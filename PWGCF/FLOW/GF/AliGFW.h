@@ -4,6 +4,7 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <map>
 #include "TString.h"
 #include "TObjArray.h"
 using std::vector;
@@ -33,6 +34,20 @@ class AliGFW {
     };
     void PrintStructure() {printf("%s: eta [%f.. %f].",rName.Data(),EtaMin,EtaMax); };
   };
+  //One step of a compiled correlator. Nodes only refer to nodes stored before them, so a program is evaluated front to back
+  struct CorrNode {
+    enum NodeType_t {kSingle=0, kTwo=1, kRecursive=2};
+    Int_t Type=kSingle;
+    Int_t Har=0, Pow=1; //kSingle, kTwo: POI Q-vector; kRecursive: last (ref.) Q-vector
+    Int_t Har2=0, Pow2=1; //kTwo: ref. Q-vector
+    Int_t Prefix=-1; //kRecursive: node with the last harmonic removed
+    vector<Int_t> Subtract {}; //kRecursive: nodes with the last harmonic merged into one of the others
+  };
+  struct CorrProgram {
+    Int_t Poi=-1; //POI region, -1 if the program is empty
+    Int_t Ref=-1; //Ref. region
+    vector<CorrNode> Nodes {}; //Last node is the result
+  };
   struct CorrConfig {
     vector<Int_t> Regs {};
     vector<Int_t> Hars {};
@@ -40,6 +55,12 @@ class AliGFW {
     vector<Int_t> Hars2 {};
     Bool_t pTDif=kFALSE;
     TString Head="";
+    //Compiled in GetCorrelatorConfig; if not, Calculate compiles a temporary copy
+    Bool_t Compiled=kFALSE;
+    CorrProgram Prog {}; //Regs, Hars
+    CorrProgram ProgZero {}; //Regs, Hars set to zero
+    CorrProgram Prog2 {}; //Regs2, Hars2
+    CorrProgram Prog2Zero {}; //Regs2, Hars2 set to zero
   };
   AliGFW();
   ~AliGFW();
@@ -50,29 +71,36 @@ class AliGFW {
   void AddRegion(TString refName, Int_t lNhar, Int_t *lNparVec, Double_t lEtaMin, Double_t lEtaMax, Int_t lNpT=1, Int_t BitMask=1);
   Int_t CreateRegions();
   void Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask);
+  void Fill(Int_t n, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, const Int_t *mask); //Bulk fill of n tracks
   void Clear();// { for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs(); };
   AliGFWCumulant GetCumulant(Int_t index) { return fCumulants.at(index); };
   TComplex Calculate(TString config, Bool_t SetHarmsToZero=kFALSE);
   CorrConfig GetCorrelatorConfig(TString config, TString head = "", Bool_t ptdif=kFALSE);
-  TComplex Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
+  void CompileCorrelatorConfig(CorrConfig &corconf);
+  TComplex Calculate(const CorrConfig &corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
  private:
   Bool_t fInitialized;
   void SplitRegions();
   AliGFWCumulant fEmptyCumulant;
-  TComplex TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant*, AliGFWCumulant*, AliGFWCumulant*);
-  TComplex RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> hars, vector<Int_t> pows={}); //POI, Ref. flow, overlapping region
+  //Compiling and running correlators:
+  typedef std::map<vector<Int_t>, Int_t> CorrMemo_t; //(harmonics, powers) -> node index
+  CorrProgram CompileCorr(Int_t poi, Int_t ref, vector<Int_t> hars, Bool_t SetHarmsToZero=kFALSE);
+  Int_t RecursiveCorr(CorrProgram &prog, CorrMemo_t &memo, const vector<Int_t> &hars, const vector<Int_t> &pows); //Adds the nodes, returns the index of the result
+  TComplex RunCorr(const CorrProgram &prog, Int_t ptbin, Bool_t DisableOverlap=kFALSE);
+  vector<TComplex> fNodeValues; //! scratch for RunCorr
+  //Scratch for the bulk fill, tracks selected for one region:
+  vector<Double_t> fFillEta; //!
+  vector<Int_t> fFillPt; //!
+  vector<Double_t> fFillPhi; //!
+  vector<Double_t> fFillWeight; //!
   //Deprecated and not used (for now):
-  void AddRegion(Region inreg) { fRegions.push_back(inreg); };
+  void AddRegion(Region inreg) { fRegions.push_back(inreg); fStringPlans[0].clear(); fStringPlans[1].clear(); };
   Region GetRegion(Int_t index) { return fRegions.at(index); };
   Int_t FindRegionByName(TString refName);
-  vector<TString> fCalculatedNames;
-  vector<TComplex> fCalculatedQs;
-  Int_t FindCalculated(TString identifier);
-  //Calculateing functions:
-  TComplex Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin=0); //For differential, need POI and reference
-  TComplex Calculate(Int_t poi, vector<Int_t> hars); //For integrated case
-  //Process one string (= one region)
-  TComplex CalculateSingle(TString config);
+  //Compiled string configurations, (pT bin, program) per "}"-separated part. Indexed by SetHarmsToZero
+  std::map<TString, vector<std::pair<Int_t, CorrProgram> > > fStringPlans[2]; //!
+  //Compile one string (= one region)
+  std::pair<Int_t, CorrProgram> CompileSingle(TString config);
 
   Bool_t SetHarmonicsToZero(TString &instr);
 
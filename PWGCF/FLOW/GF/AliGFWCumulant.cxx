@@ -1,7 +1,14 @@
 #include "AliGFWCumulant.h"
+#include <cstring>
 
 AliGFWCumulant::AliGFWCumulant():
-  fQvector(0),
+  fQRe(0),
+  fQIm(0),
+  fOffset(),
+  fStride(0),
+  fMaxPow(0),
+  fTrig(),
+  fWPow(),
   fUsed(kBlank),
   fNEntries(-1),
   fN(1),
@@ -18,46 +25,75 @@ AliGFWCumulant::~AliGFWCumulant()
   //DestroyComplexVectorArray();
 };
 void AliGFWCumulant::FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t weight) {
+  FillArrays(&eta,&ptin,&phi,&weight,1);
+};
+void AliGFWCumulant::FillArrays(const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, Int_t n) {
   if(!fInitialized)
     CreateComplexVectorArray(1,1,1);
-  if(fPt==1) ptin=0; //If one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill
-  else if(ptin<0 || ptin>=fPt) return;
-  fFilledPts[ptin] = kTRUE;
-  for(Int_t lN = 0; lN<fN; lN++) {
-    Double_t lSin = TMath::Sin(lN*phi); //No need to recalculate for each power
-    Double_t lCos = TMath::Cos(lN*phi); //No need to recalculate for each power
-    for(Int_t lPow=0; lPow<PW(lN); lPow++) {
-      Double_t lPrefactor = TMath::Power(weight, lPow); //Dont calculate it twice; multiplication is cheaper that power
-      Double_t qsin = lPrefactor * lSin;
-      Double_t qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow](fQvector[ptin][lN][lPow].Re()+qcos,fQvector[ptin][lN][lPow].Im()+qsin);//+=TComplex(qcos,qsin);
+  const Int_t lBlock = kFillBlock;
+  Double_t *lCos = fTrig.data();
+  Double_t *lSin = lCos + fN*lBlock;
+  Double_t *lWPow = fWPow.data();
+  for(Int_t lFirst=0; lFirst<n; lFirst+=lBlock) {
+    Int_t lNTr = TMath::Min(lBlock, n-lFirst);
+    const Double_t *lPhi = phi+lFirst;
+    const Double_t *lW = weight+lFirst;
+    //Trigonometric functions and weight powers for the whole block, per harmonic and power (contiguous in tracks).
+    //Harmonic 0 and powers 0 and 1 are exact, so they need no function calls
+    for(Int_t i=0; i<lNTr; i++) {
+      lSin[i] = 0;
+      lCos[i] = 1;
+    };
+    for(Int_t lN = 1; lN<fN; lN++) {
+      for(Int_t i=0; i<lNTr; i++) {
+        lSin[lN*lBlock+i] = TMath::Sin(lN*lPhi[i]);
+        lCos[lN*lBlock+i] = TMath::Cos(lN*lPhi[i]);
+      };
+    };
+    for(Int_t lPow=0; lPow<fMaxPow; lPow++) {
+      Double_t *lWP = lWPow+lPow*lBlock;
+      if(lPow==0) for(Int_t i=0; i<lNTr; i++) lWP[i] = 1;
+      else if(lPow==1) for(Int_t i=0; i<lNTr; i++) lWP[i] = lW[i];
+      else for(Int_t i=0; i<lNTr; i++) lWP[i] = TMath::Power(lW[i], lPow);
+    };
+    //Accumulate track by track, so that the order of additions is the same as for single fills
+    for(Int_t i=0; i<lNTr; i++) {
+      Int_t lPt = ptin[lFirst+i];
+      if(fPt==1) lPt=0; //If one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill
+      else if(lPt<0 || lPt>=fPt) continue;
+      fFilledPts[lPt] = kTRUE;
+      Double_t *lRe = fQRe + lPt*fStride;
+      Double_t *lIm = fQIm + lPt*fStride;
+      for(Int_t lN = 0; lN<fN; lN++) {
+        Double_t lc = lCos[lN*lBlock+i];
+        Double_t ls = lSin[lN*lBlock+i];
+        Double_t *lReN = lRe + fOffset[lN];
+        Double_t *lImN = lIm + fOffset[lN];
+        for(Int_t lPow=0; lPow<PW(lN); lPow++) {
+          lReN[lPow] += lWPow[lPow*lBlock+i] * lc;
+          lImN[lPow] += lWPow[lPow*lBlock+i] * ls;
+        };
+      };
+      Inc();
     };
   };
-  Inc();
 };
 void AliGFWCumulant::ResetQs() {
   if(!fNEntries) return; //If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
+  //Only filled pt bins can be non-zero
   for(Int_t i=0; i<fPt; i++) {
+    if(!fFilledPts[i]) continue;
     fFilledPts[i] = kFALSE;
-    for(Int_t lN=0;lN<fN;lN++) {
-      for(Int_t lPow=0;lPow<PW(lN);lPow++) {
-  	       fQvector[i][lN][lPow](0.,0.);
-      };
-    };
+    memset(fQRe + i*fStride, 0, fStride*sizeof(Double_t));
+    memset(fQIm + i*fStride, 0, fStride*sizeof(Double_t));
   };
   fNEntries=0;
 };
 void AliGFWCumulant::DestroyComplexVectorArray() {
   if(!fInitialized) return;
-  for(Int_t l_n = 0; l_n<fN; l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      delete [] fQvector[i][l_n];
-    };
-  };
-  for(Int_t i=0;i<fPt;i++) {
-    delete [] fQvector[i];
-  };
-  delete [] fQvector;
+  delete [] fQRe;
+  fQRe=0;
+  fQIm=0;
   delete [] fFilledPts;
   fInitialized=kFALSE;
   fNEntries=-1;
@@ -76,21 +112,27 @@ void AliGFWCumulant::CreateComplexVectorArrayVarPower(Int_t N, vector<Int_t> Pow
   fPt=Pt;
   fFilledPts = new Bool_t[Pt];
   fPowVec = PowVec;
-  fQvector = new TComplex**[fPt];
-  for(Int_t i=0;i<fPt;i++) {
-    fQvector[i] = new TComplex*[fN];
-  };
+  fOffset.resize(fN);
+  fStride=0;
+  fMaxPow=0;
   for(Int_t l_n=0;l_n<fN;l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      fQvector[i][l_n] = new TComplex[PW(l_n)];
-    };
+    fOffset[l_n] = fStride;
+    fStride += PW(l_n);
+    if(PW(l_n)>fMaxPow) fMaxPow=PW(l_n);
   };
-  ResetQs();
+  fStride = (fStride+3)/4*4;
+  fQRe = new Double_t[2*fPt*fStride];
+  fQIm = fQRe + fPt*fStride;
+  memset(fQRe, 0, 2*fPt*fStride*sizeof(Double_t));
+  for(Int_t i=0;i<fPt;i++) fFilledPts[i] = kFALSE;
+  fTrig.resize(2*fN*kFillBlock);
+  fWPow.resize(fMaxPow*kFillBlock);
+  fNEntries=0;
   fInitialized=kTRUE;
 };
 TComplex AliGFWCumulant::Vec(Int_t n, Int_t p, Int_t ptbin) {
   if(!fInitialized) return 0;
   if(ptbin>=fPt || ptbin<0) ptbin=0;
-  if(n>=0) return fQvector[ptbin][n][p];
-  return TComplex::Conjugate(fQvector[ptbin][-n][p]);
+  if(n>=0) return TComplex(fQRe[ptbin*fStride+fOffset[n]+p],fQIm[ptbin*fStride+fOffset[n]+p]);
+  return TComplex(fQRe[ptbin*fStride+fOffset[-n]+p],-fQIm[ptbin*fStride+fOffset[-n]+p]);
 };
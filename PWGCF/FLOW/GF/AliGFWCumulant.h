@@ -11,12 +11,22 @@ class AliGFWCumulant {
   ~AliGFWCumulant();
   void ResetQs();
   void FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t weight=1);
+  void FillArrays(const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, Int_t n); //Bulk fill of n tracks
   enum UsedFlags_t {kBlank = 0, kFull=1, kPt=2};
+  enum { kFillBlock = 64 }; //Tracks processed together in FillArrays
   void SetType(UInt_t infl) { DestroyComplexVectorArray(); fUsed = infl; };
   void Inc() { fNEntries++; };
   Int_t GetN() { return fNEntries; };
   // protected:
-  TComplex ***fQvector;
+  //Q-vectors are stored in one block: all real parts, then all imaginary parts.
+  //Within a plane, index = ptbin*fStride + fOffset[harmonic] + power
+  Double_t *fQRe; //! real parts
+  Double_t *fQIm; //! imaginary parts (points into the same block as fQRe)
+  vector<Int_t> fOffset; //! start of each harmonic within a pt bin
+  Int_t fStride; //! size of one pt bin, padded to a multiple of 4
+  Int_t fMaxPow; //! largest number of powers
+  vector<Double_t> fTrig; //! scratch for FillArrays: cos and sin for a block of tracks
+  vector<Double_t> fWPow; //! scratch for FillArrays: powers of the weight for a block of tracks
   UInt_t fUsed;
   Int_t fNEntries;
   //Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
@@ -1,4 +1,5 @@
 #include "AliGFWFlowContainer.h"
+#include "TBuffer.h"
 
 AliGFWFlowContainer::AliGFWFlowContainer():
   TNamed("",""),
@@ -11,7 +12,12 @@ AliGFWFlowContainer::AliGFWFlowContainer():
   fXAxis(0),
   fNbinsPt(0),
   fbinsPt(0),
-  fPropagateErrors(kFALSE)
+  fPropagateErrors(kFALSE),
+  fSubRows(),
+  fSubSums(),
+  fSubStats(),
+  fSubFilled(kFALSE),
+  fMissingLabels()
 {
 };
 AliGFWFlowContainer::AliGFWFlowContainer(const char *name):
@@ -25,7 +31,12 @@ AliGFWFlowContainer::AliGFWFlowContainer(const char *name):
   fXAxis(0),
   fNbinsPt(0),
   fbinsPt(0),
-  fPropagateErrors(kFALSE)
+  fPropagateErrors(kFALSE),
+  fSubRows(),
+  fSubSums(),
+  fSubStats(),
+  fSubFilled(kFALSE),
+  fMissingLabels()
 {
 };
 AliGFWFlowContainer::~AliGFWFlowContainer() {
@@ -45,15 +56,8 @@ void AliGFWFlowContainer::Initialize(TObjArray *inputList, Int_t nMultiBins, Dou
   for(Int_t i=0;i<inputList->GetEntries();i++)
     fProf->GetYaxis()->SetBinLabel(i+1,inputList->At(i)->GetName());
   fProf->Sumw2();
-  if(nRandom) {
-    fNRandom=nRandom;
-    fProfRand = new TObjArray();
-    fProfRand->SetOwner(kTRUE);
-    for(Int_t i=0;i<nRandom;i++) {
-      fProfRand->Add((TProfile2D*)fProf->Clone(Form("%s_Rand_%i",fProf->GetName(),i)));
-      ((TProfile2D*)fProfRand->At(i))->Sumw2();
-    };
-  };
+  //Subsample profiles are created in FlushSubSamples
+  fNRandom=nRandom;
 };
 void AliGFWFlowContainer::Initialize(TObjArray *inputList, Int_t nMultiBins, Double_t MultiMin, Double_t MultiMax, Int_t nRandom) {
   if(!inputList) {
@@ -69,15 +73,8 @@ void AliGFWFlowContainer::Initialize(TObjArray *inputList, Int_t nMultiBins, Dou
   fProf->Sumw2();
   for(Int_t i=0;i<inputList->GetEntries();i++)
     fProf->GetYaxis()->SetBinLabel(i+1,inputList->At(i)->GetName());
-  if(nRandom) {
-    fNRandom=nRandom;
-    fProfRand = new TObjArray();
-    fProfRand->SetOwner(kTRUE);
-    for(Int_t i=0;i<nRandom;i++) {
-      fProfRand->Add((TProfile2D*)fProf->Clone(Form("%s_Rand_%i",fProf->GetName(),i)));
-      ((TProfile2D*)fProfRand->At(i))->Sumw2();
-    };
-  };
+  //Subsample profiles are created in FlushSubSamples
+  fNRandom=nRandom;
 };
 Bool_t AliGFWFlowContainer::CreateBinsFromAxis(TAxis *inax) {
   if(!inax) return kFALSE;
@@ -107,19 +104,130 @@ void AliGFWFlowContainer::SetXAxis() {
     }
 }
 Int_t AliGFWFlowContainer::FillProfile(const char *hname, Double_t multi, Double_t corr, Double_t w, Double_t rn) {
+  if(!fProf) return -1;
+  Int_t yin = GetBinHandle(hname);
+  if(yin<0) return -1;
+  return FillProfile(yin,multi,corr,w,rn);
+};
+Int_t AliGFWFlowContainer::GetBinHandle(const char *hname) {
   if(!fProf) return -1;
   Int_t yin = fProf->GetYaxis()->FindBin(hname);
-  if(!yin) {
+  if(yin<=0) {
+    //Report a missing label only once, the by-name FillProfile asks for it on every fill
+    for(Int_t i=0;i<(Int_t)fMissingLabels.size();i++) if(fMissingLabels[i]==hname) return -1;
+    fMissingLabels.push_back(hname);
     printf("Could not find bin %s\n",hname);
     return -1;
   };
-  fProf->Fill(multi,yin,corr,w);
-  if(fNRandom) {
-    Double_t rnind = rn*fNRandom;
-    ((TProfile2D*)fProfRand->At((Int_t)rnind))->Fill(multi,yin,corr,w);
+  return yin;
+};
+Int_t AliGFWFlowContainer::FillProfiles(Int_t n, const Int_t *handles, Double_t multi, const Double_t *corr, const Double_t *w, Double_t rn) {
+  if(!fProf) return -1;
+  for(Int_t i=0;i<n;i++) if(handles[i]>0) fProf->Fill(multi,handles[i],corr[i],w[i]);
+  if(!fNRandom) return 0;
+  //Same sums as TProfile2D::Fill would accumulate in the subsample profile
+  //One row (all x-bins of a correlator) per subsample is allocated when the correlator is first filled
+  Int_t nBinsX = fProf->GetNbinsX();
+  Int_t nBinsY = fProf->GetNbinsY();
+  Int_t nRow = (nBinsX+2)*kNSubSums;
+  if(fSubRows.empty()) {
+    fSubRows.assign(fNRandom*(nBinsY+2),-1);
+    fSubStats.assign(fNRandom*kNSubStats,0);
   };
+  Int_t rnind = (Int_t)(rn*fNRandom);
+  if(rnind<0 || rnind>=fNRandom) return -1;
+  Int_t *lRows = &fSubRows[rnind*(nBinsY+2)];
+  Double_t *lStats = &fSubStats[rnind*kNSubStats];
+  Int_t binx = fProf->GetXaxis()->FindBin(multi);
+  Bool_t lStatX = (binx>0 && binx<=nBinsX) || TH1::StatOverflows();
+  for(Int_t i=0;i<n;i++) {
+    if(handles[i]<=0) continue;
+    Double_t y = handles[i];
+    Double_t u = w[i];
+    Double_t z = corr[i];
+    if(lRows[handles[i]]<0) {
+      lRows[handles[i]] = fSubSums.size();
+      fSubSums.resize(fSubSums.size()+nRow,0);
+    };
+    //Pointer taken after the allocation, resizing may move fSubSums
+    Double_t *lBin = &fSubSums[lRows[handles[i]]+binx*kNSubSums];
+    lStats[kSubEntries]++;
+    lBin[kSubSumWY] += u*z;
+    lBin[kSubSumWY2] += u*z*z;
+    lBin[kSubSumW2] += u*u;
+    lBin[kSubSumW] += u;
+    if(!lStatX) continue;
+    lStats[0] += u;
+    lStats[1] += u*u;
+    lStats[2] += u*multi;
+    lStats[3] += u*multi*multi;
+    lStats[4] += u*y;
+    lStats[5] += u*y*y;
+    lStats[6] += u*multi*y;
+    lStats[7] += u*z;
+    lStats[8] += u*z*z;
+  };
+  fSubFilled = kTRUE;
   return 0;
 };
+void AliGFWFlowContainer::FlushSubSamples() {
+  if(!fProf || !fNRandom) return;
+  if(!fProfRand) {
+    fProfRand = new TObjArray();
+    fProfRand->SetOwner(kTRUE);
+    for(Int_t i=0;i<fNRandom;i++) {
+      TProfile2D *lProf = (TProfile2D*)fProf->Clone(Form("%s_Rand_%i",fProf->GetName(),i));
+      lProf->SetDirectory(0);
+      lProf->Reset();
+      fProfRand->Add(lProf);
+    };
+  };
+  if(!fSubFilled) return;
+  Int_t nBinsX = fProf->GetNbinsX();
+  Int_t nBinsY = fProf->GetNbinsY();
+  for(Int_t i=0;i<fNRandom && i<fProfRand->GetEntries();i++) {
+    TProfile2D *lProf = (TProfile2D*)fProfRand->At(i);
+    Double_t *lStats = &fSubStats[i*kNSubStats];
+    if(!lStats[kSubEntries]) continue;
+    //Statistics taken before the bins are modified: on an empty profile GetStats recomputes them from the bin contents
+    Double_t lProfStats[kSubEntries];
+    lProf->GetStats(lProfStats);
+    const Int_t *lRows = &fSubRows[i*(nBinsY+2)];
+    Double_t *lSumWY = lProf->fArray;
+    Double_t *lSumWY2 = lProf->GetSumw2()->fArray;
+    Double_t *lSumW2 = lProf->GetBinSumw2()->fArray;
+    for(Int_t biny=0;biny<nBinsY+2;biny++) {
+      if(lRows[biny]<0) continue;
+      const Double_t *lRow = &fSubSums[lRows[biny]];
+      for(Int_t binx=0;binx<nBinsX+2;binx++) {
+        const Double_t *lBin = lRow + binx*kNSubSums;
+        if(!lBin[kSubSumW] && !lBin[kSubSumW2]) continue;
+        Int_t bin = biny*(nBinsX+2)+binx;
+        lSumWY[bin] += lBin[kSubSumWY];
+        lSumWY2[bin] += lBin[kSubSumWY2];
+        if(lSumW2) lSumW2[bin] += lBin[kSubSumW2];
+        lProf->SetBinEntries(bin,lProf->GetBinEntries(bin)+lBin[kSubSumW]);
+      };
+    };
+    for(Int_t j=0;j<kSubEntries;j++) lProfStats[j] += lStats[j];
+    lProf->PutStats(lProfStats);
+    lProf->SetEntries(lProf->GetEntries()+lStats[kSubEntries]);
+  };
+  //Release the sums; they are allocated again by the next fill
+  std::vector<Int_t>().swap(fSubRows);
+  std::vector<Double_t>().swap(fSubSums);
+  std::vector<Double_t>().swap(fSubStats);
+  fSubFilled = kFALSE;
+};
+void AliGFWFlowContainer::Streamer(TBuffer &R__b) {
+  //Custom streamer to write out the subsamples filled since the last flush
+  if(R__b.IsReading()) {
+    R__b.ReadClassBuffer(AliGFWFlowContainer::Class(),this);
+  } else {
+    FlushSubSamples();
+    R__b.WriteClassBuffer(AliGFWFlowContainer::Class(),this);
+  };
+};
 void AliGFWFlowContainer::OverrideProfileErrors(TProfile2D *inpf) {
   Int_t nBinsX = fProf->GetNbinsX();
   Int_t nBinsY = fProf->GetNbinsY();
@@ -162,6 +270,7 @@ Long64_t AliGFWFlowContainer::Merge(TCollection *collist) {
   Long64_t nmerged=0;
   AliGFWFlowContainer *l_FC = 0;
   TIter all_FC(collist);
+  FlushSubSamples();
   //TProfile2D *spro = lfc->GetProfile();
   while (l_FC = ((AliGFWFlowContainer*) all_FC())) {
     TProfile2D *tpro = GetProfile();
@@ -218,6 +327,7 @@ void AliGFWFlowContainer::PickAndMerge(TFile *tfi) {
     printf("Could not pick up the %s from %s\n",this->GetName(),tfi->GetName());
     return;
   };
+  FlushSubSamples();
   TProfile2D *spro = lfc->GetProfile();
   TProfile2D *tpro = GetProfile();
   if(!tpro) {
@@ -246,6 +356,7 @@ void AliGFWFlowContainer::PickAndMerge(TFile *tfi) {
   //printf("After merge: %i in target, %i in source\n",fProfRand->GetEntries(),tarr->GetEntries());
 };
 Bool_t AliGFWFlowContainer::OverrideMainWithSub(Int_t ind, Bool_t ExcludeChosen) {
+  FlushSubSamples();
   if(!fProfRand) {
     printf("Cannot override main profile with a randomized one. Random profile array does not exist.\n");
     return kFALSE;
@@ -276,6 +387,7 @@ Bool_t AliGFWFlowContainer::OverrideMainWithSub(Int_t ind, Bool_t ExcludeChosen)
   };
 };
 Bool_t AliGFWFlowContainer::RandomizeProfile(Int_t nSubsets) {
+  FlushSubSamples();
   if(!fProfRand) {
     printf("Cannot randomize profile, random array does not exist.\n");
     return kFALSE;
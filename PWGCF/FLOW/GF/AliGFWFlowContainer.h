@@ -15,6 +15,7 @@
 #include "TString.h"
 #include "TCollection.h"
 #include "TAxis.h"
+#include <vector>
 
 class AliGFWFlowContainer:public TNamed {
  public:
@@ -27,10 +28,14 @@ class AliGFWFlowContainer:public TNamed {
   Bool_t CreateBinsFromAxis(TAxis *inax);
   void SetXAxis(TAxis *inax);
   void SetXAxis();
-  void RebinMulti(Int_t rN) { if(fProf) fProf->RebinX(rN); };
+  void RebinMulti(Int_t rN) { FlushSubSamples(); if(fProf) fProf->RebinX(rN); };
   Int_t GetNMultiBins() { return fProf->GetNbinsX(); };
   Double_t GetMultiAtBin(Int_t bin) { return fProf->GetXaxis()->GetBinCenter(bin); };
   Int_t FillProfile(const char *hname, Double_t multi, Double_t y, Double_t w, Double_t rn);
+  Int_t GetBinHandle(const char *hname); //y-bin of the correlator hname, -1 if not found. To be obtained once at setup
+  Int_t FillProfile(Int_t handle, Double_t multi, Double_t y, Double_t w, Double_t rn) { return FillProfiles(1,&handle,multi,&y,&w,rn); };
+  Int_t FillProfiles(Int_t n, const Int_t *handles, Double_t multi, const Double_t *y, const Double_t *w, Double_t rn); //All correlators of one event
+  void FlushSubSamples(); //Add the subsample sums to the profiles in fProfRand
   TProfile2D *GetProfile() { return fProf; };
   void OverrideProfileErrors(TProfile2D *inpf);
   void ReadAndMerge(const char *infile);
@@ -38,7 +43,7 @@ class AliGFWFlowContainer:public TNamed {
   Bool_t OverrideMainWithSub(Int_t subind, Bool_t ExcludeChosen);
   Bool_t RandomizeProfile(Int_t nSubsets=0);
   Bool_t CreateStatisticsProfile(StatisticsType StatType, Int_t arg);
-  TObjArray *GetSubProfiles() { return fProfRand; };
+  TObjArray *GetSubProfiles() { FlushSubSamples(); return fProfRand; };
   Long64_t Merge(TCollection *collist);
   void SetIDName(TString newname); //! do not store
   void SetPtRebin(Int_t newval) { fPtRebin=newval; };
@@ -140,7 +145,15 @@ class AliGFWFlowContainer:public TNamed {
   Double_t *fbinsPt; //! Do not store; stored in fXAxis
   Bool_t fPropagateErrors; //! do not store
   TProfile *GetRefFlowProfile(const char *order, Double_t m1=-1, Double_t m2=-1);
-  ClassDef(AliGFWFlowContainer, 2);
+  //Subsamples are filled into plain sums and only moved to fProfRand by FlushSubSamples (called before writing and merging)
+  enum { kSubSumW=0, kSubSumWY, kSubSumWY2, kSubSumW2, kNSubSums };
+  enum { kSubEntries=9, kNSubStats }; //TProfile2D::GetStats(), then number of entries
+  std::vector<Int_t> fSubRows; //! [subsample][y-bin of fProf] offset of the row in fSubSums, -1 if not filled
+  std::vector<Double_t> fSubSums; //! rows of [x-bin of fProf][kNSubSums], one per filled correlator and subsample
+  std::vector<Double_t> fSubStats; //! [subsample][kNSubStats]
+  Bool_t fSubFilled; //! Something to flush
+  std::vector<TString> fMissingLabels; //! Labels already reported as not found by GetBinHandle
+  ClassDef(AliGFWFlowContainer, 3);
 };
 
 
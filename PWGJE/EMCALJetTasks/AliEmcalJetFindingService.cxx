@@ -0,0 +1,222 @@
+/**************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                   *
+ * All rights reserved.                                                               *
+ *                                                                                    *
+ * Redistribution and use in source and binary forms, with or without                 *
+ * modification, are permitted provided that the following conditions are met:        *
+ *     * Redistributions of source code must retain the above copyright               *
+ *       notice, this list of conditions and the following disclaimer.                *
+ *     * Redistributions in binary form must reproduce the above copyright            *
+ *       notice, this list of conditions and the following disclaimer in the          *
+ *       documentation and/or other materials provided with the distribution.         *
+ *     * Neither the name of the <organization> nor the                               *
+ *       names of its contributors may be used to endorse or promote products         *
+ *       derived from this software without specific prior written permission.        *
+ *                                                                                    *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND    *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED      *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE             *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY                *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES         *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;       *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND        *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT         *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS      *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ **************************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <TError.h>
+#include <TMath.h>
+
+#include "AliFJWrapper.h"
+#include "AliEmcalJetFindingService.h"
+
+std::map<std::string, AliEmcalJetFindingService*> AliEmcalJetFindingService::fgServices;
+
+/**
+ * Constructor, only used by Connect.
+ * @param group Name of the group
+ * @param inputSignature Description of the constituent selection shared by the group
+ */
+AliEmcalJetFindingService::AliEmcalJetFindingService(const char *group, const char *inputSignature) :
+  fName(group),
+  fInputSignature(inputSignature),
+  fNConnections(0),
+  fNThreads(1),
+  fEvent(-1),
+  fInputVectors(),
+  fJetFinders(),
+  fStatus(),
+  fDone()
+{
+}
+
+/**
+ * Destructor, deletes the jet finders.
+ */
+AliEmcalJetFindingService::~AliEmcalJetFindingService()
+{
+  for (auto jetFinder : fJetFinders) delete jetFinder;
+}
+
+/**
+ * Connects a task to the service of a group, creating the service if needed.
+ * All the tasks of a group must use the same constituents: a task whose
+ * constituent selection differs from the one of the group is refused.
+ * @param group Name of the group
+ * @param inputSignature Description of the constituent selection of the task
+ * @return Pointer to the service, or null if the constituent selection does not match
+ */
+AliEmcalJetFindingService* AliEmcalJetFindingService::Connect(const char *group, const char *inputSignature)
+{
+  AliEmcalJetFindingService *service = Find(group);
+  if (!service) {
+    service = new AliEmcalJetFindingService(group, inputSignature);
+    fgServices[group] = service;
+  }
+  else if (service->fInputSignature != inputSignature) {
+    ::Error("AliEmcalJetFindingService::Connect", "Constituents '%s' differ from the ones of the jet finding group '%s' ('%s').",
+        inputSignature, group, service->fInputSignature.Data());
+    return 0;
+  }
+  service->fNConnections++;
+  return service;
+}
+
+/**
+ * Finds the service of a group.
+ * @param group Name of the group
+ * @return Pointer to the service, or null if no task is connected to the group
+ */
+AliEmcalJetFindingService* AliEmcalJetFindingService::Find(const char *group)
+{
+  auto it = fgServices.find(group);
+  if (it == fgServices.end()) return 0;
+  return it->second;
+}
+
+/**
+ * Disconnects a task from its service. The service is deleted with
+ * its last task.
+ * @param service Service the task was connected to (can be null)
+ */
+void AliEmcalJetFindingService::Disconnect(AliEmcalJetFindingService *service)
+{
+  if (!service) return;
+  if (--service->fNConnections > 0) return;
+  fgServices.erase(service->fName.Data());
+  delete service;
+}
+
+/**
+ * Registers a jet definition. A jet finder with the same settings is reused
+ * if already registered, otherwise a new one is created.
+ * @param settings Jet finder whose settings (algorithm, R, recombination scheme, area definition) are used
+ * @return Index of the jet finder
+ */
+Int_t AliEmcalJetFindingService::AddJetFinder(const AliFJWrapper& settings)
+{
+  for (UInt_t i = 0; i < fJetFinders.size(); i++) {
+    if (fJetFinders[i]->HasSameSettings(settings)) return i;
+  }
+
+  AliFJWrapper *jetFinder = new AliFJWrapper(TString::Format("%s_%d", fName.Data(), (Int_t)fJetFinders.size()),
+      settings.GetName());
+  jetFinder->CopySettingsFrom(settings);
+  fJetFinders.push_back(jetFinder);
+  fStatus.push_back(-1);
+  fDone.push_back(kFALSE);
+
+  return fJetFinders.size() - 1;
+}
+
+/**
+ * Sets the number of threads used to run the jet finders. The largest
+ * number requested by the tasks of the group is used.
+ * @param n Number of threads (0 = one per core)
+ */
+void AliEmcalJetFindingService::SetNThreads(Int_t n)
+{
+  if (n <= 0) n = std::max(1u, std::thread::hardware_concurrency());
+  if (n > fNThreads) fNThreads = n;
+}
+
+/**
+ * Finds the jet finder with a given jet definition, e.g. the kt jets
+ * needed for a background estimate.
+ * @param algo Jet algorithm
+ * @param r Jet radius
+ * @param reco Recombination scheme
+ * @return Index of the jet finder, or -1 if not registered
+ */
+Int_t AliEmcalJetFindingService::FindJetFinder(fastjet::JetAlgorithm algo, Double_t r, fastjet::RecombinationScheme reco) const
+{
+  for (UInt_t i = 0; i < fJetFinders.size(); i++) {
+    if (fJetFinders[i]->GetAlgorithm() == algo && TMath::Abs(fJetFinders[i]->GetR() - r) < 1e-6 &&
+        fJetFinders[i]->GetRecombScheme() == reco) return i;
+  }
+  return -1;
+}
+
+/**
+ * Sets the input vectors of a new event. The jet finders are run
+ * the first time the jets of one of them are requested.
+ * @param event Event identifier
+ * @param input Input vectors
+ */
+void AliEmcalJetFindingService::SetInput(Long64_t event, const std::vector<fastjet::PseudoJet>& input)
+{
+  fEvent = event;
+  fInputVectors = input;
+  std::fill(fDone.begin(), fDone.end(), kFALSE);
+}
+
+/**
+ * Runs the jet finder i on the input vectors of the current event,
+ * together with all the jet finders which have not yet been run.
+ * @param i Index of the jet finder
+ * @return Status of AliFJWrapper::Run for jet finder i (-1 if there is no input)
+ */
+Int_t AliEmcalJetFindingService::Run(Int_t i)
+{
+  if (fInputVectors.empty()) return -1;
+  if (fDone[i]) return fStatus[i];
+
+  std::vector<Int_t> todo;
+  for (UInt_t j = 0; j < fJetFinders.size(); j++) {
+    if (!fDone[j]) todo.push_back(j);
+  }
+
+  Int_t nThreads = std::min<Int_t>(fNThreads, todo.size());
+  if (nThreads <= 1) {
+    for (auto j : todo) RunJetFinder(j);
+  }
+  else {
+    std::atomic<UInt_t> next(0);
+    std::vector<std::thread> threads;
+    for (Int_t ithread = 0; ithread < nThreads; ithread++) {
+      threads.emplace_back([this, &todo, &next]() {
+        for (UInt_t k = next++; k < todo.size(); k = next++) RunJetFinder(todo[k]);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+  for (auto j : todo) fDone[j] = kTRUE;
+
+  return fStatus[i];
+}
+
+/**
+ * Runs jet finder i on the input vectors of the current event.
+ * @param i Index of the jet finder
+ */
+void AliEmcalJetFindingService::RunJetFinder(Int_t i)
+{
+  AliFJWrapper *jetFinder = fJetFinders[i];
+  jetFinder->Clear();
+  jetFinder->AddInputVectors(fInputVectors);
+  fStatus[i] = jetFinder->Run();
+}
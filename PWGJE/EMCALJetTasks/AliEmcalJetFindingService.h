@@ -0,0 +1,103 @@
+/**************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                   *
+ * All rights reserved.                                                               *
+ *                                                                                    *
+ * Redistribution and use in source and binary forms, with or without                 *
+ * modification, are permitted provided that the following conditions are met:        *
+ *     * Redistributions of source code must retain the above copyright               *
+ *       notice, this list of conditions and the following disclaimer.                *
+ *     * Redistributions in binary form must reproduce the above copyright            *
+ *       notice, this list of conditions and the following disclaimer in the          *
+ *       documentation and/or other materials provided with the distribution.         *
+ *     * Neither the name of the <organization> nor the                               *
+ *       names of its contributors may be used to endorse or promote products         *
+ *       derived from this software without specific prior written permission.        *
+ *                                                                                    *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND    *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED      *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE             *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY                *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES         *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;       *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND        *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT         *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS      *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ **************************************************************************************/
+#ifndef ALIEMCALJETFINDINGSERVICE_H
+#define ALIEMCALJETFINDINGSERVICE_H
+
+#if !defined(__CINT__)
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <TString.h>
+
+#include "FJ_includes.h"
+
+class AliFJWrapper;
+
+/**
+ * @class AliEmcalJetFindingService
+ * @brief Event-level jet finding shared by several AliEmcalJetTask instances
+ * @ingroup PWGJEBASE
+ *
+ * Jet finder tasks running on the same constituents (e.g. anti-kt jets with
+ * several radii and the kt jets used for the background estimate) can be put
+ * in the same group with AliEmcalJetTask::SetJetFindingGroup. The first task of
+ * the group executed in an event builds the list of input vectors, which is then
+ * clustered with all the jet definitions registered in the group, optionally
+ * on several threads. Tasks requesting the same jet definition share the same
+ * cluster sequence, and other tasks (e.g. rho tasks) can retrieve the cluster
+ * sequence of a given definition with FindJetFinder.
+ *
+ * Running on several threads requires FastJet to be built with thread safety
+ * enabled.
+ */
+class AliEmcalJetFindingService {
+ public:
+  static AliEmcalJetFindingService* Connect(const char *group, const char *inputSignature);
+  static AliEmcalJetFindingService* Find(const char *group);
+  static void                       Disconnect(AliEmcalJetFindingService *service);
+
+  Int_t                  AddJetFinder(const AliFJWrapper& settings);
+  void                   SetNThreads(Int_t n);
+
+  const char*            GetName()                      const { return fName.Data()            ; }
+  const char*            GetInputSignature()            const { return fInputSignature.Data()  ; }
+  Int_t                  GetNThreads()                  const { return fNThreads               ; }
+  Int_t                  GetNJetFinders()               const { return fJetFinders.size()      ; }
+  AliFJWrapper*          GetJetFinder(Int_t i)          const { return fJetFinders[i]          ; }
+  Int_t                  FindJetFinder(fastjet::JetAlgorithm algo, Double_t r, fastjet::RecombinationScheme reco) const;
+
+  Bool_t                 HasInput(Long64_t event)       const { return fEvent == event         ; }
+  const std::vector<fastjet::PseudoJet>& GetInputVectors() const { return fInputVectors        ; }
+  void                   SetInput(Long64_t event, const std::vector<fastjet::PseudoJet>& input);
+  Int_t                  Run(Int_t i);
+
+ protected:
+  AliEmcalJetFindingService(const char *group, const char *inputSignature);
+  virtual ~AliEmcalJetFindingService();
+
+  void                   RunJetFinder(Int_t i);
+
+  TString                          fName;            ///< name of the group
+  TString                          fInputSignature;  ///< description of the constituent selection shared by the group
+  Int_t                            fNConnections;    ///< number of tasks connected to the service
+  Int_t                            fNThreads;        ///< number of threads used to run the jet finders
+  Long64_t                         fEvent;           ///< event of the current input vectors
+  std::vector<fastjet::PseudoJet>  fInputVectors;    ///< input vectors of the current event
+  std::vector<AliFJWrapper*>       fJetFinders;      ///< one jet finder per jet definition (owned)
+  std::vector<Int_t>               fStatus;          ///< status of AliFJWrapper::Run for each jet finder
+  std::vector<Bool_t>              fDone;            ///< whether each jet finder has run on the current input
+
+  static std::map<std::string, AliEmcalJetFindingService*> fgServices; ///< services by group name
+
+ private:
+  AliEmcalJetFindingService(const AliEmcalJetFindingService&);            // not implemented
+  AliEmcalJetFindingService &operator=(const AliEmcalJetFindingService&); // not implemented
+};
+#endif
+#endif
@@ -31,10 +31,10 @@
 #include <TH2.h>
 #include <TH3.h>
 #include <THnSparse.h>
-#include <TKDTree.h>
 
 #include "AliAnalysisManager.h"
 #include "AliEmcalJet.h"
+#include "AliEmcalSpatialIndex.h"
 #include "AliLog.h"
 #include "AliJetContainer.h"
 #include "AliParticleContainer.h"
@@ -212,8 +212,8 @@ namespace PWGJE {
 #ifdef JETTAGGERFAST_TEST
     fIndexErrorRateBase = new TH1F("indexErrorsBase", "Index errors nearest neighbor base jets", 1, 0.5, 1.5);
     fIndexErrorRateTag = new TH1F("indexErrorsTag", "Index errors nearest neighbors tag jets", 1, 0.5, 1.5);
-    fContainerErrorRateBase = new TH1F("containerErrorsBase", "Matching errors container - kdtree base jets", 1, 0.5, 1.5);
-    fContainerErrorRateTag = new TH1F("containerErrorsTag", "Matching errors container - kdtree tag jets", 1, 0.5, 1.5);
+    fContainerErrorRateBase = new TH1F("containerErrorsBase", "Matching errors container - spatial index base jets", 1, 0.5, 1.5);
+    fContainerErrorRateTag = new TH1F("containerErrorsTag", "Matching errors container - spatial index tag jets", 1, 0.5, 1.5);
     fOutput->Add(fIndexErrorRateBase);
     fOutput->Add(fIndexErrorRateTag);
     fOutput->Add(fContainerErrorRateBase);
@@ -365,118 +365,88 @@ namespace PWGJE {
   }
 
   bool AliEmcalJetTaggerTaskFast::MatchJetsGeo(AliJetContainer &contBase, AliJetContainer &contTag, Float_t maxDist) const {
-    const Int_t kNacceptedBase = contBase.GetNAcceptedJets(),
-                kNacceptedTag = contTag.GetNAcceptedJets();
+    // The spatial indices contain the accepted jets, identified by their position in the container.
+    // They are built once per event, and shared by containers with the same cuts if the accept cache is enabled.
+    const AliEmcalSpatialIndex &indexBase = contBase.GetSpatialIndex(),
+                               &indexTag = contTag.GetSpatialIndex();
+    const Int_t kNacceptedBase = indexBase.GetNEntries(),
+                kNacceptedTag = indexTag.GetNEntries();
     if(!(kNacceptedBase && kNacceptedTag)) return false;
 
-    // Build kd-trees
-    TArrayD etaBase(kNacceptedBase), phiBase(kNacceptedBase),
-            etaTag(kNacceptedTag), phiTag(kNacceptedTag);
-    std::vector<AliEmcalJet *> jetsBase(kNacceptedBase), jetsTag(kNacceptedTag); // the storages are needed later for applying the tagging, in order to avoid multiple occurrence of jet selection
-
-    int countBase(0), countTag(0);
-    for(auto jb : contBase.accepted()) {
-      etaBase[countBase] = jb->Eta();
-      phiBase[countBase] = jb->Phi();
-      jetsBase[countBase] = jb;
-      countBase++;
-    }
-    for(auto jt : contTag.accepted()) {
-      etaTag[countTag] = jt->Eta();
-      phiTag[countTag] = jt->Phi();
-      jetsTag[countTag] = jt;
-      countTag++;
-    }
-    TKDTreeID treeBase(etaBase.GetSize(), 2, 1), treeTag(etaTag.GetSize(), 2, 1);
-    treeBase.SetData(0, etaBase.GetArray());
-    treeBase.SetData(1, phiBase.GetArray());
-    treeBase.Build();
-    treeTag.SetData(0, etaTag.GetArray());
-    treeTag.SetData(1, phiTag.GetArray());
-    treeTag.Build();
-
-    TArrayI faMatchIndexTag(kNacceptedBase), faMatchIndexBase(kNacceptedTag);
-    faMatchIndexBase.Reset(-1);
-    faMatchIndexTag.Reset(-1);
+    std::vector<Int_t> faMatchIndexTag(contBase.GetNJets(), -1), faMatchIndexBase(contTag.GetNJets(), -1);
 
     // find the closest distance to the full jet
-    countBase = 0;
-    for(auto j : contBase.accepted()) {
-      Double_t point[2] = {j->Eta(), j->Phi()};
-      Int_t index(-1); Double_t distance(-1);
-      treeTag.FindNearestNeighbors(point, 1, &index, &distance);
+    for(int ibase = 0; ibase < kNacceptedBase; ibase++) {
+      Int_t jetIndex = indexBase.GetId(ibase);
+      Double_t distance(-1);
+      Int_t index = indexTag.FindNearest(indexBase.GetEta(ibase), indexBase.GetPhi(ibase), maxDist, &distance);
       // test whether indices are matching:
       if(index >= 0 && distance < maxDist){
-        AliDebugStream(1) << "Found closest tag jet for " << countBase << " with match index " << index << " and distance " << distance << std::endl;
-        faMatchIndexTag[countBase]=index;
+        AliDebugStream(1) << "Found closest tag jet for " << jetIndex << " with match index " << index << " and distance " << distance << std::endl;
+        faMatchIndexTag[jetIndex]=index;
       } else {
-        AliDebugStream(1) << "Not found closest tag jet for " << countBase << ", distance to closest " << distance << std::endl;
+        AliDebugStream(1) << "Not found closest tag jet for " << jetIndex << std::endl;
       }
 
 #ifdef JETTAGGERFAST_TEST
       if(index>-1){
-        Double_t distanceTest(-1);
-        distanceTest = TMath::Sqrt(TMath::Power(etaTag[index] - j->Eta(), 2) +  TMath::Power(phiTag[index] - j->Phi(), 2));
-        if(TMath::Abs(distanceTest - distance) > DBL_EPSILON){
-          AliDebugStream(1) << "Mismatch in distance from tag jet with index from tree: " << distanceTest << ", distance from tree " << distance << std::endl;
+        AliEmcalJet *jetBase = contBase.GetJet(jetIndex), *jetTag = contTag.GetJet(index);
+        Double_t dPhi = AliEmcalSpatialIndex::DeltaPhi(jetTag->Phi(), jetBase->Phi());
+        Double_t distanceTest = TMath::Sqrt(TMath::Power(jetTag->Eta() - jetBase->Eta(), 2) + dPhi*dPhi);
+        if(TMath::Abs(distanceTest - distance) > 1e-9){
+          AliDebugStream(1) << "Mismatch in distance from tag jet with index from spatial index: " << distanceTest << ", distance from index " << distance << std::endl;
           fIndexErrorRateBase->Fill(1);
         }
       }
 #endif
-
-      countBase++;
     }
 
     // other way around
-    countTag = 0;
-    for(auto j : contTag.accepted()){
-      Double_t point[2] = {j->Eta(), j->Phi()};
-      Int_t index(-1); Double_t distance(-1);
-      treeBase.FindNearestNeighbors(point, 1, &index, &distance);
+    for(int itag = 0; itag < kNacceptedTag; itag++){
+      Int_t jetIndex = indexTag.GetId(itag);
+      Double_t distance(-1);
+      Int_t index = indexBase.FindNearest(indexTag.GetEta(itag), indexTag.GetPhi(itag), maxDist, &distance);
       if(index >= 0 && distance < maxDist){
-        AliDebugStream(1) << "Found closest base jet for " << countBase << " with match index " << index << " and distance " << distance << std::endl;
-        faMatchIndexBase[countTag]=index;
+        AliDebugStream(1) << "Found closest base jet for " << jetIndex << " with match index " << index << " and distance " << distance << std::endl;
+        faMatchIndexBase[jetIndex]=index;
       } else {
-        AliDebugStream(1) << "Not found closest tag jet for " << countBase << ", distance to closest " << distance << std::endl;
+        AliDebugStream(1) << "Not found closest base jet for " << jetIndex << std::endl;
       }
 
 #ifdef JETTAGGERFAST_TEST
       if(index>-1){
-        Double_t distanceTest(-1);
-        distanceTest = TMath::Sqrt(TMath::Power(etaBase[index] - j->Eta(), 2) +  TMath::Power(phiBase[index] - j->Phi(), 2));
-        if(TMath::Abs(distanceTest - distance) > DBL_EPSILON){
-          AliDebugStream(1) << "Mismatch in distance from base jet with index from tree: " << distanceTest << ", distance from tree " << distance << std::endl;
+        AliEmcalJet *jetTag = contTag.GetJet(jetIndex), *jetBase = contBase.GetJet(index);
+        Double_t dPhi = AliEmcalSpatialIndex::DeltaPhi(jetBase->Phi(), jetTag->Phi());
+        Double_t distanceTest = TMath::Sqrt(TMath::Power(jetBase->Eta() - jetTag->Eta(), 2) + dPhi*dPhi);
+        if(TMath::Abs(distanceTest - distance) > 1e-9){
+          AliDebugStream(1) << "Mismatch in distance from base jet with index from spatial index: " << distanceTest << ", distance from index " << distance << std::endl;
           fIndexErrorRateTag->Fill(1);
         }
       }
 #endif
-
-      countTag++;
     }
 
     // check for "true" correlations
     // these are pairs where the base jet is the closest to the tag jet and vice versa
     // As the lists are linear a loop over the outer base jet is sufficient.
     AliDebugStream(1) << "Starting true jet loop: nbase(" << kNacceptedBase << "), ntag(" << kNacceptedTag << ")\n";
-    for(int ibase = 0; ibase < kNacceptedBase; ibase++) {
-      AliDebugStream(2) << "base jet " << ibase << ": match index in tag jet container " << faMatchIndexTag[ibase] << "\n";
-      if(faMatchIndexTag[ibase] > -1){
-       AliDebugStream(2) << "tag jet " << faMatchIndexTag[ibase] << ": matched base jet " << faMatchIndexBase[faMatchIndexTag[ibase]] << "\n";
-      }
-      if(faMatchIndexTag[ibase] > -1 && faMatchIndexBase[faMatchIndexTag[ibase]] == ibase) {
+    for(int ibase = 0; ibase < static_cast<int>(faMatchIndexTag.size()); ibase++) {
+      Int_t itag = faMatchIndexTag[ibase];
+      if(itag < 0) continue;
+      AliDebugStream(2) << "base jet " << ibase << ": match index in tag jet container " << itag << ", matched base jet " << faMatchIndexBase[itag] << "\n";
+      if(faMatchIndexBase[itag] == ibase) {
         AliDebugStream(2) << "found a true match \n";
-        AliEmcalJet *jetBase = jetsBase[ibase],
-                    *jetTag = jetsTag[faMatchIndexTag[ibase]];
+        AliEmcalJet *jetBase = contBase.GetJet(ibase),
+                    *jetTag = contTag.GetJet(itag);
         if(jetBase && jetTag) {
 #ifdef JETTAGGERFAST_TEST
-          if(TMath::Abs(etaBase[ibase] - jetBase->Eta()) > DBL_EPSILON || TMath::Abs(phiBase[ibase] - jetBase->Phi()) > DBL_EPSILON){
-            AliErrorStream() << "Selected incorrect base jet for tagging : eta test(" << jetBase->Eta() << ")/true(" << etaBase[ibase]
-                             << "), phi test(" << jetBase->Phi() << ")/true(" << phiBase[ibase] << ")\n";
+          UInt_t rejectionReason = 0;
+          if(!contBase.AcceptJet(ibase, rejectionReason)){
+            AliErrorStream() << "Selected rejected base jet for tagging: " << ibase << "\n";
             fContainerErrorRateBase->Fill(1);
           }
-          if(TMath::Abs(etaTag[faMatchIndexTag[ibase]] - jetTag->Eta()) > DBL_EPSILON || TMath::Abs(phiTag[faMatchIndexTag[ibase]] - jetTag->Phi()) > DBL_EPSILON){
-            AliErrorStream() << "Selected incorrect tag jet for tagging : eta test(" << jetTag->Eta() << ")/true(" << etaTag[faMatchIndexTag[ibase]]
-                             << "), phi test(" << jetTag->Phi() << ")/true(" << phiTag[faMatchIndexTag[ibase]] << ")\n";
+          if(!contTag.AcceptJet(itag, rejectionReason)){
+            AliErrorStream() << "Selected rejected tag jet for tagging: " << itag << "\n";
             fContainerErrorRateTag->Fill(1);
           }
 #endif
@@ -48,7 +48,8 @@ namespace EMCALJetTasks {
  * @since Nov 8, 2017
  *
  * Class based on AliAnalysisTaskEmcalJetTagger. Navigation finding closest neighbor
- * however is based on a kd-tree.
+ * however is based on the eta-phi spatial index of the jet containers
+ * (AliEmcalSpatialIndex), which also handles the phi wrap-around.
  *
  */
 class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
@@ -226,10 +227,10 @@ class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
   TH3             *fh3PtJetAreaDRConst;          //!<! \f$ p_{t}\f$ jet vs Area vs delta R of constituents
   TH1             *fNAccJets;                    //!<! number of jets per event
 #ifdef JETTAGGERFAST_TEST
-  TH1             *fIndexErrorRateBase;          //!<! Monitoring number of errors between index in kd-tree and data block for base jets
-  TH1             *fIndexErrorRateTag;           //!<! Monitoring number of errors between index in kd-tree and data block for tag jets
-  TH1             *fContainerErrorRateBase;      //!<! Monitoring number of errors between index in kd-tree and jet vector for base jets
-  TH1             *fContainerErrorRateTag;       //!<! Monitoring number of errors between index in kd-tree and jet vector for tag jets
+  TH1             *fIndexErrorRateBase;          //!<! Monitoring number of errors between index in spatial index and jet position for base jets
+  TH1             *fIndexErrorRateTag;           //!<! Monitoring number of errors between index in spatial index and jet position for tag jets
+  TH1             *fContainerErrorRateBase;      //!<! Monitoring number of errors between matched jets and jet selection for base jets
+  TH1             *fContainerErrorRateTag;       //!<! Monitoring number of errors between matched jets and jet selection for tag jets
 #endif
   AliEmcalJetTaggerTaskFast(const AliEmcalJetTaggerTaskFast&);            // not implemented
   AliEmcalJetTaggerTaskFast &operator=(const AliEmcalJetTaggerTaskFast&); // not implemented
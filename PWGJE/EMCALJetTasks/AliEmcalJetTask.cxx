@@ -28,6 +28,7 @@
 
 #include <TClonesArray.h>
 #include <TMath.h>
+#include <TVector2.h>
 #include <TRandom3.h>
 #include <TGrid.h>
 #include <TFile.h>
@@ -45,6 +46,8 @@
 #include "AliEmcalJet.h"
 #include "AliEmcalParticle.h"
 #include "AliFJWrapper.h"
+#include "AliEmcalJetFindingService.h"
+#include "AliEmcalJetTable.h"
 #include "AliEmcalJetUtility.h"
 #include "AliParticleContainer.h"
 #include "AliClusterContainer.h"
@@ -98,8 +101,15 @@ AliEmcalJetTask::AliEmcalJetTask() :
   fEnableAliBasicParticleCompatibility(kFALSE),
   fLegacyMode(kFALSE),
   fFillGhost(kFALSE),
+  fJetFindingGroup(),
+  fJetFindingThreads(1),
+  fJetTableMode(kNoJetTable),
   fJets(0),
+  fJetTable(0),
   fFastJetWrapper("AliEmcalJetTask","AliEmcalJetTask"),
+  fJetFinder(&fFastJetWrapper),
+  fJetFindingService(0),
+  fJetFindingIndex(-1),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap()
 {
@@ -140,8 +150,15 @@ AliEmcalJetTask::AliEmcalJetTask(const char *name) :
   fEnableAliBasicParticleCompatibility(kFALSE),
   fLegacyMode(kFALSE),
   fFillGhost(kFALSE),
+  fJetFindingGroup(),
+  fJetFindingThreads(1),
+  fJetTableMode(kNoJetTable),
   fJets(0),
+  fJetTable(0),
   fFastJetWrapper(name,name),
+  fJetFinder(&fFastJetWrapper),
+  fJetFindingService(0),
+  fJetFindingIndex(-1),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap()
 {
@@ -152,6 +169,7 @@ AliEmcalJetTask::AliEmcalJetTask(const char *name) :
  */
 AliEmcalJetTask::~AliEmcalJetTask()
 {
+  AliEmcalJetFindingService::Disconnect(fJetFindingService);
 }
 
 /**
@@ -235,6 +253,7 @@ Bool_t AliEmcalJetTask::Run()
   InitEvent();
   // clear the jet array (normally a null operation)
   fJets->Delete();
+  if (fJetTable) fJetTable->Clear();
   Int_t n = FindJets();
 
   if (n == 0) return kFALSE;
@@ -258,8 +277,25 @@ Int_t AliEmcalJetTask::FindJets()
     return 0;
   }
 
+  if (fJetFindingService) return FindJetsShared();
+
   fFastJetWrapper.Clear();
+  FillJetFinderInput();
+
+  if (fFastJetWrapper.GetInputVectors().size() == 0) return 0;
 
+  // run jet finder
+  fFastJetWrapper.Run();
+
+  return fFastJetWrapper.GetInclusiveJets().size();
+}
+
+/**
+ * This method fills the input vectors of the FastJet wrapper with all accepted
+ * objects (tracks, particles, clusters) of the particle and cluster containers.
+ */
+void AliEmcalJetTask::FillJetFinderInput()
+{
   AliDebug(2,Form("Jet type = %d", fJetType));
 
   Int_t iColl = 1;
@@ -319,37 +355,58 @@ Int_t AliEmcalJetTask::FindJets()
     }
     iColl++;
   }
+}
 
-  if (fFastJetWrapper.GetInputVectors().size() == 0) return 0;
+/**
+ * Jet finding through the jet finding service of the group: the input vectors are
+ * filled by the first task of the group executed in the event, then the jet finders
+ * of the group are run (all together) the first time their jets are requested.
+ * @return Total number of jets found.
+ */
+Int_t AliEmcalJetTask::FindJetsShared()
+{
+  Long64_t event = AliAnalysisManager::GetAnalysisManager()->GetNcalls();
+  if (!fJetFindingService->HasInput(event)) {
+    fFastJetWrapper.Clear();
+    FillJetFinderInput();
+    fJetFindingService->SetInput(event, fFastJetWrapper.GetInputVectors());
+  }
 
-  // run jet finder
-  fFastJetWrapper.Run();
+  if (fJetFindingService->Run(fJetFindingIndex) != 0) return 0;
 
-  return fFastJetWrapper.GetInclusiveJets().size();
+  return fJetFinder->GetInclusiveJets().size();
 }
 
 /**
  * This method fills the jet output branch (TClonesArray) with the jet found by the FastJet
  * wrapper. Before filling the jet branch, the utilities are prepared. Then the utilities are
  * called for each jet and finally after jet finding the terminate method of all utilities is called.
+ * If requested, each jet is also appended to the column store (AliEmcalJetTable); in the
+ * kJetTableOnly mode only the column store is filled, see FillJetTable().
  */
 void AliEmcalJetTask::FillJetBranch()
 {
+  if (fJetTable && fJetTableMode == kJetTableOnly) {
+    FillJetTable();
+    return;
+  }
+
   PrepareUtilities();
 
   // loop over fastjet jets
-  std::vector<fastjet::PseudoJet> jets_incl = fFastJetWrapper.GetInclusiveJets();
+  const std::vector<fastjet::PseudoJet>& jets_incl = fJetFinder->GetInclusiveJets();
   // sort jets according to jet pt
   static Int_t indexes[9999] = {-1};
   GetSortedArray(indexes, jets_incl);
 
   AliDebug(1,Form("%d jets found", (Int_t)jets_incl.size()));
+  if (fJetTable) fJetTable->Reserve(jets_incl.size(), 0);
   for (UInt_t ijet = 0, jetCount = 0; ijet < jets_incl.size(); ++ijet) {
     Int_t ij = indexes[ijet];
-    AliDebug(3,Form("Jet pt = %f, area = %f", jets_incl[ij].perp(), fFastJetWrapper.GetJetArea(ij)));
+    AliDebug(3,Form("Jet pt = %f, area = %f", jets_incl[ij].perp(), fJetFinder->GetJetArea(ij)));
 
     if (jets_incl[ij].perp() < fMinJetPt) continue;
-    if (fFastJetWrapper.GetJetArea(ij) < fMinJetArea) continue;
+    if (fJetFinder->GetJetArea(ij) < fMinJetArea) continue;
     if ((jets_incl[ij].eta() < fJetEtaMin) || (jets_incl[ij].eta() > fJetEtaMax) ||
         (jets_incl[ij].phi() < fJetPhiMin) || (jets_incl[ij].phi() > fJetPhiMax))
       continue;
@@ -358,7 +415,7 @@ void AliEmcalJetTask::FillJetBranch()
     		          AliEmcalJet(jets_incl[ij].perp(), jets_incl[ij].eta(), jets_incl[ij].phi(), jets_incl[ij].m());
     jet->SetLabel(ij);
 
-    fastjet::PseudoJet area(fFastJetWrapper.GetJetAreaVector(ij));
+    fastjet::PseudoJet area(fJetFinder->GetJetAreaVector(ij));
     jet->SetArea(area.perp());
     jet->SetAreaEta(area.eta());
     jet->SetAreaPhi(area.phi());
@@ -366,8 +423,8 @@ void AliEmcalJetTask::FillJetBranch()
     jet->SetJetAcceptanceType(FindJetAcceptanceType(jet->Eta(), jet->Phi_0_2pi(), fRadius));
 
     // Fill constituent info
-    std::vector<fastjet::PseudoJet> constituents(fFastJetWrapper.GetJetConstituents(ij));
-    FillJetConstituents(jet, constituents, constituents);
+    AliFJWrapper::PseudoJetSpan constituents(fJetFinder->GetJetConstituentSpan(ij));
+    FillJetConstituents(jet, constituents.data(), constituents.size());
 
     if (fGeom) {
       if ((jet->Phi() > fGeom->GetArm1PhiMin() * TMath::DegToRad()) &&
@@ -379,6 +436,8 @@ void AliEmcalJetTask::FillJetBranch()
 
     ExecuteUtilities(jet, ij);
 
+    if (fJetTable) fJetTable->AddJet(*jet);
+
     AliDebug(2,Form("Added jet n. %d, pt = %f, area = %f, constituents = %d", jetCount, jet->Pt(), jet->Area(), jet->GetNumberOfConstituents()));
     jetCount++;
   }
@@ -386,13 +445,130 @@ void AliEmcalJetTask::FillJetBranch()
   TerminateUtilities();
 }
 
+/**
+ * This method fills the column store (AliEmcalJetTable) directly with the jets found by the
+ * FastJet wrapper, without creating the AliEmcalJet objects (kJetTableOnly mode, which is not
+ * available with jet utilities). The jet selection and the constituent loop are the ones of
+ * FillJetBranch() and FillJetConstituents(), restricted to the quantities stored in the table.
+ */
+void AliEmcalJetTask::FillJetTable()
+{
+  // TObject bits of a newly created jet
+  static const UInt_t jetBits = AliEmcalJet().TestBits(0xffffffff);
+
+  // loop over fastjet jets
+  const std::vector<fastjet::PseudoJet>& jets_incl = fJetFinder->GetInclusiveJets();
+  // sort jets according to jet pt
+  static Int_t indexes[9999] = {-1};
+  GetSortedArray(indexes, jets_incl);
+
+  AliDebug(1,Form("%d jets found", (Int_t)jets_incl.size()));
+  fJetTable->Reserve(jets_incl.size(), 0);
+  for (UInt_t ijet = 0; ijet < jets_incl.size(); ++ijet) {
+    Int_t ij = indexes[ijet];
+    const fastjet::PseudoJet& fjJet = jets_incl[ij];
+    AliDebug(3,Form("Jet pt = %f, area = %f", fjJet.perp(), fJetFinder->GetJetArea(ij)));
+
+    if (fjJet.perp() < fMinJetPt) continue;
+    if (fJetFinder->GetJetArea(ij) < fMinJetArea) continue;
+    if ((fjJet.eta() < fJetEtaMin) || (fjJet.eta() > fJetEtaMax) ||
+        (fjJet.phi() < fJetPhiMin) || (fjJet.phi() > fJetPhiMax))
+      continue;
+
+    Double_t phi = TVector2::Phi_0_2pi(fjJet.phi());
+    Double_t area = fJetFinder->GetJetAreaVector(ij).perp();
+    fJetTable->AddJet(fjJet.perp(), fjJet.eta(), phi, fjJet.m(), area,
+                      jetBits, FindJetAcceptanceType(fjJet.eta(), phi, fRadius), 0);
+
+    // constituent indices, neutral energy, leading constituents and ghosts (for the area in EMCal)
+    Double_t neutralE = 0.;
+    Double_t maxCh    = 0.;
+    Double_t maxNe    = 0.;
+    Int_t gall        = 0;
+    Int_t gemc        = 0;
+
+    AliFJWrapper::PseudoJetSpan constituents(fJetFinder->GetJetConstituentSpan(ij));
+    for (UInt_t ic = 0; ic < constituents.size(); ++ic) {
+      Int_t uid = constituents[ic].user_index();
+
+      if (uid == -1) { //ghost particle
+        ++gall;
+        if (fGeom) {
+          Double_t gphi = constituents[ic].phi();
+          if (gphi < 0) gphi += TMath::TwoPi();
+          gphi *= TMath::RadToDeg();
+          Double_t geta = constituents[ic].eta();
+          if ((gphi > fGeom->GetArm1PhiMin()) && (gphi < fGeom->GetArm1PhiMax()) &&
+              (geta > fGeom->GetArm1EtaMin()) && (geta < fGeom->GetArm1EtaMax()))
+            ++gemc;
+        }
+      }
+      else if (uid >= fgkConstIndexShift) { // track constituent
+        Int_t iColl = uid / fgkConstIndexShift;
+        Int_t tid = uid - iColl * fgkConstIndexShift;
+        iColl--;
+        AliParticleContainer* partCont = GetParticleContainer(iColl);
+        if (!partCont) {
+          AliError(Form("Could not find particle container %d",iColl));
+          continue;
+        }
+        AliVParticle *t = partCont->GetParticle(tid);
+        if (!t) {
+          AliError(Form("Could not find track %d",tid));
+          continue;
+        }
+
+        Double_t cPt = t->Pt();
+        if (t->Charge() == 0) {
+          if (!fEnableAliBasicParticleCompatibility) {
+            neutralE += t->P();
+          }
+          if (cPt > maxNe) maxNe = cPt;
+        } else {
+          if (cPt > maxCh) maxCh = cPt;
+        }
+
+        fJetTable->AddTrackIndex(fParticleContainerIndexMap.GlobalIndexFromLocalIndex(partCont, tid));
+      }
+      else if (uid <= -fgkConstIndexShift) { // cluster constituent
+        Int_t iColl = -uid / fgkConstIndexShift;
+        Int_t cid = -uid - iColl * fgkConstIndexShift;
+        iColl--;
+        AliClusterContainer* clusCont = GetClusterContainer(iColl);
+        AliVCluster *c = clusCont->GetCluster(cid);
+
+        if (!c) continue;
+
+        AliTLorentzVector nP;
+        clusCont->GetMomentum(nP, cid);
+
+        neutralE += nP.P();
+        if (nP.Pt() > maxNe) maxNe = nP.Pt();
+
+        fJetTable->AddClusterIndex(fClusterContainerIndexMap.GlobalIndexFromLocalIndex(clusCont, cid));
+      }
+      else {
+        AliError(Form("%s: No logical way to end up here (uid = %d).", GetName(), uid));
+        continue;
+      }
+    }
+
+    // same energy as AliEmcalJet::E()
+    Double_t p = fjJet.perp() * TMath::CosH(fjJet.eta());
+    Double_t e = TMath::Sqrt(fjJet.m() * fjJet.m() + p * p);
+    fJetTable->FinishJet(gall > 0 ? area * gemc / gall : -1, neutralE / e, maxCh, maxNe);
+
+    AliDebug(2,Form("Added jet n. %d to the jet table, pt = %f, area = %f", fJetTable->GetNJets() - 1, fjJet.perp(), area));
+  }
+}
+
 /**
  * Sorts jets by pT (decreasing)
  * @param[out] indexes This array is used to return the indexes of the jets ordered by pT
  * @param[in] array Vector containing the list of jets obtained by the FastJet wrapper
  * @return kTRUE if at least one jet was found in array; kFALSE otherwise
  */
-Bool_t AliEmcalJetTask::GetSortedArray(Int_t indexes[], std::vector<fastjet::PseudoJet> array) const
+Bool_t AliEmcalJetTask::GetSortedArray(Int_t indexes[], const std::vector<fastjet::PseudoJet>& array) const
 {
   static Float_t pt[9999] = {0};
 
@@ -460,6 +636,24 @@ void AliEmcalJetTask::ExecOnce()
     return;
   }
 
+  // add the column store of the jets to the event if requested
+  if (fJetTableMode != kNoJetTable) {
+    if (fJetTableMode == kJetTableOnly && fUtilities && fUtilities->GetEntriesFast() > 0) {
+      AliWarning(Form("%s: Jet utilities are used, filling the jet array as well as the jet table.", GetName()));
+      fJetTableMode = kJetTableAndArray;
+    }
+    TString tableName = AliEmcalJetTable::GetTableName(fJetsName);
+    if (!(InputEvent()->FindListObject(tableName))) {
+      fJetTable = new AliEmcalJetTable(tableName);
+      fJetTable->SetHasJetObjects(fJetTableMode != kJetTableOnly);
+      ::Info("AliEmcalJetTask::ExecOnce", "Jet table with name '%s' has been added to the event.", tableName.Data());
+      InputEvent()->AddObject(fJetTable);
+    }
+    else {
+      AliError(Form("%s: Object with name %s already in event! Not filling the jet table.", GetName(), tableName.Data()));
+    }
+  }
+
   // setup fj wrapper
   fFastJetWrapper.SetAreaType(fastjet::active_area_explicit_ghosts);
   fFastJetWrapper.SetGhostArea(fGhostArea);
@@ -482,6 +676,52 @@ void AliEmcalJetTask::ExecOnce()
   // containers' arrays are setup.
   fClusterContainerIndexMap.CopyMappingFrom(AliClusterContainer::GetEmcalContainerIndexMap(), fClusterCollArray);
   fParticleContainerIndexMap.CopyMappingFrom(AliParticleContainer::GetEmcalContainerIndexMap(), fParticleCollArray);
+
+  ConnectJetFindingService();
+}
+
+/**
+ * Connects the task to the jet finding service of its group, if any. Tasks using
+ * utilities, an artificial tracking inefficiency or a q/pt shift modify their
+ * input or their jet finder, therefore they keep a private jet finder.
+ * The constituent selection is described by the jet type and the titles of the
+ * particle and cluster containers: it must be the same for all tasks of a group.
+ */
+void AliEmcalJetTask::ConnectJetFindingService()
+{
+  fJetFinder = &fFastJetWrapper;
+  if (fJetFindingGroup.IsNull()) return;
+
+  if (fUtilities && fUtilities->GetEntriesFast() > 0) {
+    AliWarning(Form("%s: Jet utilities are used, not joining jet finding group '%s'.", GetName(), fJetFindingGroup.Data()));
+    return;
+  }
+  if (fApplyArtificialTrackingEfficiency || fApplyQoverPtShift) {
+    AliWarning(Form("%s: Track efficiency or q/pt shift applied, not joining jet finding group '%s'.", GetName(), fJetFindingGroup.Data()));
+    return;
+  }
+
+  TString inputSignature = TString::Format("%d", fJetType);
+  TIter nextPartColl(&fParticleCollArray);
+  AliParticleContainer* tracks = 0;
+  while ((tracks = static_cast<AliParticleContainer*>(nextPartColl()))) {
+    inputSignature += TString::Format("_%s_%d", tracks->GetTitle(), tracks->GetIsEmbedding());
+  }
+  TIter nextClusColl(&fClusterCollArray);
+  AliClusterContainer* clusters = 0;
+  while ((clusters = static_cast<AliClusterContainer*>(nextClusColl()))) {
+    inputSignature += TString::Format("_%s_%d", clusters->GetTitle(), clusters->GetIsEmbedding());
+  }
+
+  fJetFindingService = AliEmcalJetFindingService::Connect(fJetFindingGroup, inputSignature);
+  if (!fJetFindingService) {
+    AliError(Form("%s: Could not join jet finding group '%s', using a private jet finder.", GetName(), fJetFindingGroup.Data()));
+    return;
+  }
+  fJetFindingIndex = fJetFindingService->AddJetFinder(fFastJetWrapper);
+  fJetFindingService->SetNThreads(fJetFindingThreads);
+  fJetFinder = fJetFindingService->GetJetFinder(fJetFindingIndex);
+  AliInfo(Form("%s: Jet finding group '%s', jet finder %d.", GetName(), fJetFindingGroup.Data(), fJetFindingIndex));
 }
 
 /**
@@ -494,7 +734,22 @@ void AliEmcalJetTask::ExecOnce()
  * @param particles_sub Array containing subtracted constituents
  */
 void AliEmcalJetTask::FillJetConstituents(AliEmcalJet *jet, std::vector<fastjet::PseudoJet>& constituents,
-    std::vector<fastjet::PseudoJet>& constituents_unsub, Int_t flag, TString particlesSubName)
+    std::vector<fastjet::PseudoJet>& /*constituents_unsub*/, Int_t flag, TString particlesSubName)
+{
+  FillJetConstituents(jet, constituents.data(), constituents.size(), flag, particlesSubName);
+}
+
+/**
+ * This method is called for each jet. It loops over the jet constituents and
+ * adds them to the jet object.
+ * @param jet Pointer to the AliEmcalJet object where the jet constituents will be added
+ * @param constituents Pointer to the first jet constituent (e.g. from AliFJWrapper::GetJetConstituentSpan)
+ * @param nConstituents Number of jet constituents
+ * @param flag If kTRUE it means that the argument "constituents" is a list of subtracted constituents
+ * @param particlesSubName Name of the container of the subtracted constituents
+ */
+void AliEmcalJetTask::FillJetConstituents(AliEmcalJet *jet, const fastjet::PseudoJet *constituents, UInt_t nConstituents,
+    Int_t flag, TString particlesSubName)
 {
   Int_t nt            = 0;
   Int_t nc            = 0;
@@ -512,10 +767,10 @@ void AliEmcalJetTask::FillJetConstituents(AliEmcalJet *jet, std::vector<fastjet:
 
   Int_t uid   = -1;
 
-  jet->SetNumberOfTracks(constituents.size());
-  jet->SetNumberOfClusters(constituents.size());
+  jet->SetNumberOfTracks(nConstituents);
+  jet->SetNumberOfClusters(nConstituents);
 
-  for (UInt_t ic = 0; ic < constituents.size(); ++ic) {
+  for (UInt_t ic = 0; ic < nConstituents; ++ic) {
 
     if (flag == 0) {
       uid = constituents[ic].user_index();
@@ -31,6 +31,8 @@ class TClonesArray;
 class TObjArray;
 class AliVEvent;
 class AliEmcalJetUtility;
+class AliEmcalJetFindingService;
+class AliEmcalJetTable;
 
 #include "TF1.h"
 #include "TRandom3.h"
@@ -79,6 +81,16 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   typedef AliJetContainer::EJetAlgo_t EJetAlgo_t;
   typedef AliJetContainer::ERecoScheme_t ERecoScheme_t;
 
+  /**
+   * @enum EJetTableMode_t
+   * @brief Output format of the jets, see AliEmcalJetTable
+   */
+  enum EJetTableMode_t {
+    kNoJetTable        = 0,  ///< Jets only in the TClonesArray of AliEmcalJet objects (default)
+    kJetTableAndArray  = 1,  ///< Jets in the TClonesArray and in the column store
+    kJetTableOnly      = 2   ///< Jets only in the column store, the TClonesArray stays empty
+  };
+
 #if !defined(__CINT__) && !defined(__MAKECINT__)
   typedef fastjet::JetAlgorithm FJJetAlgo;
   typedef fastjet::RecombinationScheme FJRecoScheme;
@@ -108,6 +120,9 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   void                   SetLegacyMode(Bool_t mode)                 { if (IsLocked()) return; fLegacyMode       = mode  ; }
   void                   SetFillGhost(Bool_t b=kTRUE)               { if (IsLocked()) return; fFillGhost        = b     ; }
   void                   SetRadius(Double_t r)                      { if (IsLocked()) return; fRadius           = r     ; }
+  void                   SetJetFindingGroup(const char *g)          { if (IsLocked()) return; fJetFindingGroup  = g     ; }
+  void                   SetJetFindingThreads(Int_t n)              { if (IsLocked()) return; fJetFindingThreads = n    ; }
+  void                   SetJetTableMode(EJetTableMode_t m)         { if (IsLocked()) return; fJetTableMode     = m     ; }
 
   void                   SetEtaRange(Double_t emi, Double_t ema);
   void                   SetMinJetClusPt(Double_t min);
@@ -133,13 +148,19 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   Double_t               GetRadius()                      { return fRadius            ; }
   Int_t                  GetRecombScheme()                { return fRecombScheme      ; }
   Double_t               GetTrackEfficiency()             { return fTrackEfficiency   ; }
+  const char*            GetJetFindingGroup()             { return fJetFindingGroup.Data(); }
+  AliEmcalJetFindingService* GetJetFindingService()       { return fJetFindingService ; }
   Bool_t                 GetTrackEfficiencyOnlyForEmbedding() { return fTrackEfficiencyOnlyForEmbedding; }
 
   TClonesArray*          GetJets()                        { return fJets              ; }
+  AliEmcalJetTable*      GetJetTable()                    { return fJetTable          ; }
+  EJetTableMode_t        GetJetTableMode()                { return fJetTableMode      ; }
   TObjArray*             GetUtilities()                   { return fUtilities         ; }
 
   void                   FillJetConstituents(AliEmcalJet *jet, std::vector<fastjet::PseudoJet>& constituents,
                                              std::vector<fastjet::PseudoJet>& constituents_sub, Int_t flag = 0, TString particlesSubName = "");
+  void                   FillJetConstituents(AliEmcalJet *jet, const fastjet::PseudoJet *constituents, UInt_t nConstituents,
+                                             Int_t flag = 0, TString particlesSubName = "");
 
   UInt_t                 FindJetAcceptanceType(Double_t eta, Double_t phi, Double_t r);
   
@@ -183,14 +204,18 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
  protected:
 
   Int_t                  FindJets();
+  Int_t                  FindJetsShared();
+  void                   FillJetFinderInput();
+  void                   ConnectJetFindingService();
   void                   FillJetBranch();
+  void                   FillJetTable();
   void                   ExecOnce();
   void                   InitEvent();
   void                   InitUtilities();
   void                   PrepareUtilities();
   void                   ExecuteUtilities(AliEmcalJet* jet, Int_t ij);
   void                   TerminateUtilities();
-  Bool_t                 GetSortedArray(Int_t indexes[], std::vector<fastjet::PseudoJet> array) const;
+  Bool_t                 GetSortedArray(Int_t indexes[], const std::vector<fastjet::PseudoJet>& array) const;
   Bool_t                 IsJetInEmcal(Double_t eta, Double_t phi, Double_t r);
   Bool_t                 IsJetInDcal(Double_t eta, Double_t phi, Double_t r);
   Bool_t                 IsJetInDcalOnly(Double_t eta, Double_t phi, Double_t r);
@@ -227,9 +252,16 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   Bool_t                 fEnableAliBasicParticleCompatibility; ///< Flag to allow compatibility with AliBasicParticle constituents
   Bool_t                 fLegacyMode;             //!<!=true to enable FJ 2.x behavior
   Bool_t                 fFillGhost;              ///< =true ghost particles will be filled in AliEmcalJet obj
+  TString                fJetFindingGroup;        ///< jet finding group sharing the constituents and the clustering (empty = private jet finder)
+  Int_t                  fJetFindingThreads;      ///< number of threads requested for the jet finding group (0 = one per core)
+  EJetTableMode_t        fJetTableMode;           ///< whether the jets are also (or only) published as a column store
 
   TClonesArray          *fJets;                   //!<!jet collection
+  AliEmcalJetTable      *fJetTable;               //!<!jet collection as column store
   AliFJWrapper           fFastJetWrapper;         //!<!fastjet wrapper
+  AliFJWrapper          *fJetFinder;              //!<!fastjet wrapper holding the jets of the current event (own or shared)
+  AliEmcalJetFindingService *fJetFindingService;  //!<!jet finding service of the group
+  Int_t                  fJetFindingIndex;        //!<!index of the jet finder in the jet finding service
 
   static const Int_t     fgkConstIndexShift;      //!<!contituent index shift
 
@@ -244,7 +276,7 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   AliEmcalJetTask &operator=(const AliEmcalJetTask&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalJetTask, 30);
+  ClassDef(AliEmcalJetTask, 32);
   /// \endcond
 };
 #endif
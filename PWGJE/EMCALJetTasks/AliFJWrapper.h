@@ -13,6 +13,23 @@
 class AliFJWrapper
 {
  public:
+  // Read-only view on a contiguous range of pseudojets (e.g. the constituents of a jet
+  // stored in the constituent arena), valid until the next call to Run() or Clear().
+  class PseudoJetSpan {
+   public:
+    PseudoJetSpan() : fBegin(0), fEnd(0) {}
+    PseudoJetSpan(const fastjet::PseudoJet *b, const fastjet::PseudoJet *e) : fBegin(b), fEnd(e) {}
+    const fastjet::PseudoJet* begin()                 const { return fBegin;            }
+    const fastjet::PseudoJet* end()                   const { return fEnd;              }
+    const fastjet::PseudoJet* data()                  const { return fBegin;            }
+    UInt_t                    size()                  const { return fEnd - fBegin;     }
+    Bool_t                    empty()                 const { return fEnd == fBegin;    }
+    const fastjet::PseudoJet& operator[](UInt_t i)    const { return fBegin[i];         }
+   private:
+    const fastjet::PseudoJet *fBegin;
+    const fastjet::PseudoJet *fEnd;
+  };
+
   AliFJWrapper(const char *name, const char *title);
   virtual ~AliFJWrapper();
 
@@ -24,6 +41,7 @@ class AliFJWrapper
   virtual void  Clear(const Option_t* /*opt*/ = "");
   virtual void  ClearMemory();
   virtual void  CopySettingsFrom (const AliFJWrapper& wrapper);
+  virtual Bool_t HasSameSettings (const AliFJWrapper& wrapper) const;
   virtual void  GetMedianAndSigma(Double_t& median, Double_t& sigma, Int_t remove = 0) const;
   fastjet::ClusterSequenceArea*           GetClusterSequence() const   { return fClustSeq;                 }
   fastjet::ClusterSequence*               GetClusterSequenceSA() const { return fClustSeqSA;               }
@@ -35,6 +53,7 @@ class AliFJWrapper
   const std::vector<fastjet::PseudoJet>&  GetEventSubJets()   const { return fEventSubJets;              }
   const std::vector<fastjet::PseudoJet>&  GetFilteredJets()    const { return fFilteredJets;               }
   std::vector<fastjet::PseudoJet>         GetJetConstituents(UInt_t idx) const;
+  PseudoJetSpan                           GetJetConstituentSpan(UInt_t idx);
   std::vector<fastjet::PseudoJet>         GetEventSubJetConstituents(UInt_t idx) const;
   std::vector<fastjet::PseudoJet>         GetFilteredJetConstituents(UInt_t idx) const;
   Double_t                                GetMedianUsedForBgSubtraction() const { return fMedUsedForBgSub; }
@@ -49,41 +68,44 @@ class AliFJWrapper
   Double_t                                GetJetSubtractedPt (UInt_t idx) const;
   virtual std::vector<double>             GetSubtractedJetsPts(Double_t median_pt = -1, Bool_t sorted = kFALSE);
   Bool_t                                  GetLegacyMode()            { return fLegacyMode; }
+  fastjet::JetAlgorithm                   GetAlgorithm()       const { return fAlgor;                      }
+  fastjet::RecombinationScheme            GetRecombScheme()    const { return fScheme;                     }
+  Double_t                                GetR()               const { return fR;                          }
   Bool_t                                  GetDoFilterArea()          { return fDoFilterArea; }
   Double_t                                NSubjettiness(Int_t N, Int_t Algorithm, Double_t Radius, Double_t Beta, Int_t Option=0, Int_t Measure=0, Double_t Beta_SD=0.0, Double_t ZCut=0.1, Int_t SoftDropOn=0);
   Double32_t                              NSubjettinessDerivativeSub(Int_t N, Int_t Algorithm, Double_t Radius, Double_t Beta, Double_t JetR, fastjet::PseudoJet jet, Int_t Option=0, Int_t Measure=0, Double_t Beta_SD=0.0, Double_t ZCut=0.1, Int_t SoftDropOn=0);
 #ifdef FASTJET_VERSION
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetMass()        const {return fGenSubtractorInfoJetMass        ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetAngularity()  const {return fGenSubtractorInfoJetAngularity  ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetpTD()         const {return fGenSubtractorInfoJetpTD         ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetCircularity() const {return fGenSubtractorInfoJetCircularity ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetSigma2()      const {return fGenSubtractorInfoJetSigma2      ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetConstituent() const {return fGenSubtractorInfoJetConstituent ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetLeSub()       const {return fGenSubtractorInfoJetLeSub       ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet1subjettiness_kt()       const {return fGenSubtractorInfoJet1subjettiness_kt ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet2subjettiness_kt()       const {return fGenSubtractorInfoJet2subjettiness_kt ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet3subjettiness_kt()       const {return fGenSubtractorInfoJet3subjettiness_kt ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetOpeningAngle_kt()       const {return fGenSubtractorInfoJetOpeningAngle_kt ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet1subjettiness_ca()       const {return fGenSubtractorInfoJet1subjettiness_ca ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet2subjettiness_ca()       const {return fGenSubtractorInfoJet2subjettiness_ca ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetOpeningAngle_ca()       const {return fGenSubtractorInfoJetOpeningAngle_ca ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet1subjettiness_akt02()       const {return fGenSubtractorInfoJet1subjettiness_akt02 ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet2subjettiness_akt02()       const {return fGenSubtractorInfoJet2subjettiness_akt02 ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetOpeningAngle_akt02()       const {return fGenSubtractorInfoJetOpeningAngle_akt02 ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet1subjettiness_onepassca()       const {return fGenSubtractorInfoJet1subjettiness_onepassca ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJet2subjettiness_onepassca()       const {return fGenSubtractorInfoJet2subjettiness_onepassca ; }
-  const std::vector<fastjet::contrib::GenericSubtractorInfo> GetGenSubtractorInfoJetOpeningAngle_onepassca()       const {return fGenSubtractorInfoJetOpeningAngle_onepassca ; }
-  const std::vector<fastjet::PseudoJet>                      GetConstituentSubtrJets()            const {return fConstituentSubtrJets            ; }
-  const std::vector<fastjet::PseudoJet>                      GetGroomedJets()            const {return fGroomedJets            ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetMass()        const {return fGenSubtractorInfoJetMass        ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetAngularity()  const {return fGenSubtractorInfoJetAngularity  ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetpTD()         const {return fGenSubtractorInfoJetpTD         ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetCircularity() const {return fGenSubtractorInfoJetCircularity ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetSigma2()      const {return fGenSubtractorInfoJetSigma2      ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetConstituent() const {return fGenSubtractorInfoJetConstituent ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetLeSub()       const {return fGenSubtractorInfoJetLeSub       ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet1subjettiness_kt()       const {return fGenSubtractorInfoJet1subjettiness_kt ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet2subjettiness_kt()       const {return fGenSubtractorInfoJet2subjettiness_kt ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet3subjettiness_kt()       const {return fGenSubtractorInfoJet3subjettiness_kt ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetOpeningAngle_kt()       const {return fGenSubtractorInfoJetOpeningAngle_kt ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet1subjettiness_ca()       const {return fGenSubtractorInfoJet1subjettiness_ca ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet2subjettiness_ca()       const {return fGenSubtractorInfoJet2subjettiness_ca ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetOpeningAngle_ca()       const {return fGenSubtractorInfoJetOpeningAngle_ca ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet1subjettiness_akt02()       const {return fGenSubtractorInfoJet1subjettiness_akt02 ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet2subjettiness_akt02()       const {return fGenSubtractorInfoJet2subjettiness_akt02 ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetOpeningAngle_akt02()       const {return fGenSubtractorInfoJetOpeningAngle_akt02 ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet1subjettiness_onepassca()       const {return fGenSubtractorInfoJet1subjettiness_onepassca ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJet2subjettiness_onepassca()       const {return fGenSubtractorInfoJet2subjettiness_onepassca ; }
+  const std::vector<fastjet::contrib::GenericSubtractorInfo>& GetGenSubtractorInfoJetOpeningAngle_onepassca()       const {return fGenSubtractorInfoJetOpeningAngle_onepassca ; }
+  const std::vector<fastjet::PseudoJet>&                     GetConstituentSubtrJets()            const {return fConstituentSubtrJets            ; }
+  const std::vector<fastjet::PseudoJet>&                     GetGroomedJets()            const {return fGroomedJets            ; }
   Int_t CreateGenSub();          // fastjet::contrib::GenericSubtractor
   Int_t CreateConstituentSub();  // fastjet::contrib::ConstituentSubtractor
   Int_t CreateEventConstituentSub(); //fastjet::contrib::ConstituentSubtractor
   Int_t CreateSoftDrop();
 #endif
-  virtual std::vector<double>                                GetGRNumerator()                     const { return fGRNumerator                    ; }
-  virtual std::vector<double>                                GetGRDenominator()                   const { return fGRDenominator                  ; }
-  virtual std::vector<double>                                GetGRNumeratorSub()                  const { return fGRNumeratorSub                 ; }
-  virtual std::vector<double>                                GetGRDenominatorSub()                const { return fGRDenominatorSub               ; }
+  virtual const std::vector<double>&                         GetGRNumerator()                     const { return fGRNumerator                    ; }
+  virtual const std::vector<double>&                         GetGRDenominator()                   const { return fGRDenominator                  ; }
+  virtual const std::vector<double>&                         GetGRNumeratorSub()                  const { return fGRNumeratorSub                 ; }
+  virtual const std::vector<double>&                         GetGRDenominatorSub()                const { return fGRDenominatorSub               ; }
 
   virtual void RemoveLastInputVector();
 
@@ -158,6 +180,9 @@ class AliFJWrapper
   std::vector<double>                    fSubtractedJetsPt;   //!
   std::vector<fastjet::PseudoJet>        fConstituentSubtrJets; //!
   std::vector<fastjet::PseudoJet>        fGroomedJets;        //!
+  std::vector<fastjet::PseudoJet>        fConstituentArena;   //! constituents of all the inclusive jets, kept allocated between events
+  std::vector<UInt_t>                    fConstituentOffsets; //! offset of the constituents of each inclusive jet in fConstituentArena
+  Bool_t                                 fConstituentArenaFilled; //!
   fastjet::AreaDefinition               *fAreaDef;            //!
   fastjet::VoronoiAreaSpec              *fVorAreaSpec;        //!
   fastjet::GhostedAreaSpec              *fGhostedAreaSpec;    //!
@@ -238,6 +263,7 @@ class AliFJWrapper
   std::vector<double>                      fGRDenominatorSub; //!
 
   virtual void   SubtractBackground(const Double_t median_pt = -1);
+  void           FillConstituentArena();
 
  private:
   AliFJWrapper();
@@ -270,6 +296,10 @@ AliFJWrapper::AliFJWrapper(const char *name, const char *title)
   , fFilteredJets      ( )
   , fSubtractedJetsPt  ( )
   , fConstituentSubtrJets ( )
+  , fGroomedJets       ( )
+  , fConstituentArena  ( )
+  , fConstituentOffsets( )
+  , fConstituentArenaFilled(kFALSE)
   , fSoftDrop          ( )
   , fAreaDef           (0)
   , fVorAreaSpec       (0)
@@ -401,6 +431,29 @@ void AliFJWrapper::CopySettingsFrom(const AliFJWrapper& wrapper)
   fRhom             = wrapper.fRhom;
 }
 
+//_________________________________________________________________________________________________
+Bool_t AliFJWrapper::HasSameSettings(const AliFJWrapper& wrapper) const
+{
+  // Check whether the jet finding settings are the same as the ones of wrapper,
+  // i.e. whether Run() gives the same jets from the same input.
+
+  return fStrategy       == wrapper.fStrategy       &&
+         fAlgor          == wrapper.fAlgor          &&
+         fScheme         == wrapper.fScheme         &&
+         fAreaType       == wrapper.fAreaType       &&
+         fNGhostRepeats  == wrapper.fNGhostRepeats  &&
+         fGhostArea      == wrapper.fGhostArea      &&
+         fMaxRap         == wrapper.fMaxRap         &&
+         fR              == wrapper.fR              &&
+         fGridScatter    == wrapper.fGridScatter    &&
+         fKtScatter      == wrapper.fKtScatter      &&
+         fMeanGhostKt    == wrapper.fMeanGhostKt    &&
+         fPluginAlgor    == wrapper.fPluginAlgor    &&
+         fUseArea4Vector == wrapper.fUseArea4Vector &&
+         fLegacyMode     == wrapper.fLegacyMode     &&
+         fEventSub       == wrapper.fEventSub;
+}
+
 //_________________________________________________________________________________________________
 void AliFJWrapper::Clear(const Option_t */*opt*/)
 {
@@ -412,6 +465,7 @@ void AliFJWrapper::Clear(const Option_t */*opt*/)
   fEventSubInputVectors.clear();
   fInputGhosts.clear();
   fMedUsedForBgSub = 0;
+  fConstituentArenaFilled = kFALSE;
 
   // for the moment brute force delete everything
   ClearMemory();
@@ -629,6 +683,40 @@ AliFJWrapper::GetJetConstituents(UInt_t idx) const
   return retval;
 }
 
+//_________________________________________________________________________________________________
+AliFJWrapper::PseudoJetSpan AliFJWrapper::GetJetConstituentSpan(UInt_t idx)
+{
+  // Get jet constituents without copy.
+  // The constituents of all the inclusive jets are stored once per event in
+  // the constituent arena, whose memory is reused from one event to the next.
+
+  if ( idx >= fInclusiveJets.size() ) {
+    AliError(Form("[e] ::GetJetConstituentSpan wrong index: %d",idx));
+    return PseudoJetSpan();
+  }
+  if (!fConstituentArenaFilled) FillConstituentArena();
+
+  const fastjet::PseudoJet *first = fConstituentArena.data();
+  return PseudoJetSpan(first + fConstituentOffsets[idx], first + fConstituentOffsets[idx+1]);
+}
+
+//_________________________________________________________________________________________________
+void AliFJWrapper::FillConstituentArena()
+{
+  // Store the constituents of all the inclusive jets, one after the other,
+  // in the same order as returned by GetJetConstituents.
+
+  fConstituentArena.clear();
+  fConstituentOffsets.clear();
+  fConstituentOffsets.reserve(fInclusiveJets.size() + 1);
+  fConstituentOffsets.push_back(0);
+  for (UInt_t i = 0; i < fInclusiveJets.size(); ++i) {
+    fClustSeq->add_constituents(fInclusiveJets[i], fConstituentArena);
+    fConstituentOffsets.push_back(fConstituentArena.size());
+  }
+  fConstituentArenaFilled = kTRUE;
+}
+
 //_________________________________________________________________________________________________
 std::vector<fastjet::PseudoJet>
 AliFJWrapper::GetEventSubJetConstituents(UInt_t idx) const
@@ -767,6 +855,7 @@ Int_t AliFJWrapper::Run()
   // inclusive jets:
   fInclusiveJets.clear();
   fEventSubJets.clear();
+  fConstituentArenaFilled = kFALSE;
   fInclusiveJets = fClustSeq->inclusive_jets(0.0);
   if(fEventSub) fEventSubJets  = fClustSeqES->inclusive_jets(0.0);
 